@@ -0,0 +1,128 @@
+//
+// File: BinaryIOTools.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef _BINARYIOTOOLS_H_
+#define _BINARYIOTOOLS_H_
+
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace bpp
+{
+/**
+ * @brief Low-level tools shared by the binary formats of the library.
+ *
+ * All binary files start with an 8 bytes magic number identifying the format,
+ * followed by a byte order mark. Values are then stored in the native byte order
+ * of the machine that wrote them, the mark being used to detect files written
+ * with another byte order.
+ *
+ * This class is an implementation detail of the binary readers and writers,
+ * and is not meant to be used directly.
+ */
+class BinaryIOTools
+{
+public:
+  /**
+   * @brief Number of bytes of the magic numbers.
+   */
+  static const size_t MAGIC_SIZE = 8;
+
+  static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  /**
+   * @brief Size of the magic number and byte order mark written by writeHeader().
+   */
+  static const size_t HEADER_SIZE = MAGIC_SIZE + sizeof(uint32_t);
+
+public:
+  template<class T>
+  static void writeValue(std::ostream& out, T value)
+  {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template<class T>
+  static T readValue(std::istream& in)
+  {
+    T value = 0;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+  }
+
+  /**
+   * @brief Write the magic number of a format, followed by the byte order mark.
+   *
+   * @param out The stream.
+   * @param magic The magic number of the format, of size MAGIC_SIZE.
+   */
+  static void writeHeader(std::ostream& out, const char* magic)
+  {
+    out.write(magic, MAGIC_SIZE);
+    writeValue<uint32_t>(out, BYTE_ORDER_MARK);
+  }
+
+  /**
+   * @brief Read and check the magic number and byte order mark written by writeHeader().
+   *
+   * @param in The stream.
+   * @param magic The magic number of the expected format, of size MAGIC_SIZE.
+   * @param where The name of the calling method, for error messages.
+   * @param what A description of the format, for error messages.
+   * @throw IOException If the stream does not start with the magic number,
+   * or if it was written with another byte order.
+   */
+  static void readHeader(std::istream& in, const char* magic, const std::string& where, const std::string& what) throw (IOException)
+  {
+    char buffer[MAGIC_SIZE];
+    in.read(buffer, MAGIC_SIZE);
+    if (!in || std::memcmp(buffer, magic, MAGIC_SIZE) != 0)
+      throw IOException(where + ". Not a " + what + ".");
+    if (readValue<uint32_t>(in) != BYTE_ORDER_MARK)
+      throw IOException(where + ". The " + what + " was written with another byte order.");
+  }
+};
+} // end of namespace bpp.
+
+#endif // _BINARYIOTOOLS_H_
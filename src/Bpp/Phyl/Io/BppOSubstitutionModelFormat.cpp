@@ -45,6 +45,7 @@
 #include <Bpp/Text/StringTokenizer.h>
 #include <Bpp/Text/KeyvalTools.h>
 
+#include "../Model/AbstractSubstitutionModel.h"
 #include "../Model/WordSubstitutionModel.h"
 #include "../Model/KroneckerWordSubstitutionModel.h"
 #include "../Model/Codon/MG94.h"
@@ -1779,6 +1780,10 @@ void BppOSubstitutionModelFormat::initialize_(
   TransitionModel& model,
   const SiteContainer* data) throw (Exception)
 {
+  // Frequencies and parameters are all set before the model is
+  // diagonalized.
+  SubstitutionModelBatchUpdate batch(&model);
+
   string initFreqs = ApplicationTools::getStringParameter(model.getNamespace() + "initFreqs", unparsedArguments_, "", "", true, warningLevel_);
   if (verbose_)
     ApplicationTools::displayResult("External frequencies initialization for model", (initFreqs == "") ? "None" : initFreqs);
@@ -1847,6 +1852,7 @@ void BppOSubstitutionModelFormat::initialize_(
   }
   
   model.matchParametersValues(pl);
+  batch.commit();
 }
 
 
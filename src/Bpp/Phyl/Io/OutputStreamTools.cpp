@@ -0,0 +1,62 @@
+//
+// File: OutputStreamTools.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "OutputStreamTools.h"
+
+// From the STL:
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+void OutputStreamTools::seekOrExtend(ostream& out, streampos start, size_t offset)
+{
+  out.seekp(0, ios::end);
+  streamoff end = out.tellp() - start;
+  if (end < static_cast<streamoff>(offset))
+  {
+    vector<char> zeros(static_cast<size_t>(static_cast<streamoff>(offset) - end), 0);
+    out.write(&zeros[0], static_cast<streamsize>(zeros.size()));
+  }
+  else
+    out.seekp(start + static_cast<streamoff>(offset));
+}
+
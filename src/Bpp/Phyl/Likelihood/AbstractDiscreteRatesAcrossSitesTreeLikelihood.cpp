@@ -61,6 +61,15 @@ throw (Exception) :
 
 /******************************************************************************/
 
+void AbstractDiscreteRatesAcrossSitesTreeLikelihood::setRateDistribution(DiscreteDistribution* rDist) throw (Exception)
+{
+  if (rDist->getNumberOfCategories() != rateDistribution_->getNumberOfCategories())
+    throw Exception("AbstractDiscreteRatesAcrossSitesTreeLikelihood::setRateDistribution(). The number of rate classes must not change.");
+  rateDistribution_ = rDist;
+}
+
+/******************************************************************************/
+
 ParameterList AbstractDiscreteRatesAcrossSitesTreeLikelihood::getRateDistributionParameters() const
 {
   if (!initialized_)
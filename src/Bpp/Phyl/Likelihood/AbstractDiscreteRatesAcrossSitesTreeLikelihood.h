@@ -106,6 +106,18 @@ class AbstractDiscreteRatesAcrossSitesTreeLikelihood:
     const DiscreteDistribution* getRateDistribution() const { return rateDistribution_; }
           DiscreteDistribution* getRateDistribution()       { return rateDistribution_; }
     size_t getNumberOfClasses() const { return rateDistribution_->getNumberOfCategories(); } 
+
+    /**
+     * @brief Replace the rate distribution, which is not owned by this instance.
+     *
+     * The new distribution must have the same number of categories and the same
+     * parameters as the previous one: it is typically a copy of it, so that
+     * copies of this object do not share their distribution.
+     *
+     * @param rDist The new rate distribution.
+     * @throw Exception If the number of categories differs.
+     */
+    void setRateDistribution(DiscreteDistribution* rDist) throw (Exception);
     ParameterList getRateDistributionParameters() const;
     VVdouble getLikelihoodForEachSiteForEachRateClass() const;
     VVdouble getLogLikelihoodForEachSiteForEachRateClass() const;
@@ -184,7 +184,7 @@ void AbstractHomogeneousTreeLikelihood::setModel(TransitionModel* model) throw (
   if (data_)
   {
     if (model->getNumberOfStates() != model_->getNumberOfStates())
-      setData(*data_);                          // Have to reinitialize the whole data structure.
+      setData(*getData());                          // Have to reinitialize the whole data structure.
   }
 
   nbStates_ = model->getNumberOfStates();
@@ -358,38 +358,28 @@ void AbstractHomogeneousTreeLikelihood::computeTransitionProbabilitiesForNode(co
 {
   double l = node->getDistanceToFather();
 
-  // Computes all pxy and pyx once for all:
-  VVVdouble* pxy__node = &pxy_[node->getId()];
-  for (unsigned int c = 0; c < nbClasses_; c++)
-  {
-    VVdouble* pxy__node_c = &(*pxy__node)[c];
-    RowMatrix<double> Q = model_->getPij_t(l * rateDistribution_->getCategory(c));
+  // All rate classes are computed at once:
+  Vdouble rates = rateDistribution_->getCategories();
+  Vdouble times = rates * l;
 
-    for (unsigned int x = 0; x < nbStates_; x++)
-    {
-      Vdouble* pxy__node_c_x = &(*pxy__node_c)[x];
-      for (unsigned int y = 0; y < nbStates_; y++)
-      {
-        (*pxy__node_c_x)[y] = Q(x, y);
-      }
-    }
-  }
+  // Computes all pxy and pyx once for all:
+  model_->fillPij_t(times, pxy_[node->getId()]);
 
   if (computeFirstOrderDerivatives_)
   {
     // Computes all dpxy/dt once for all:
     VVVdouble* dpxy__node = &dpxy_[node->getId()];
+    model_->filldPij_dt(times, *dpxy__node);
     for (unsigned int c = 0; c < nbClasses_; c++)
     {
       VVdouble* dpxy__node_c = &(*dpxy__node)[c];
-      double rc = rateDistribution_->getCategory(c);
-      RowMatrix<double> dQ = model_->getdPij_dt(l * rc);
+      double rc = rates[c];
       for (unsigned int x = 0; x < nbStates_; x++)
       {
         Vdouble* dpxy__node_c_x = &(*dpxy__node_c)[x];
         for (unsigned int y = 0; y < nbStates_; y++)
         {
-          (*dpxy__node_c_x)[y] = rc * dQ(x, y);
+          (*dpxy__node_c_x)[y] *= rc;
         }
       }
     }
@@ -399,17 +389,17 @@ void AbstractHomogeneousTreeLikelihood::computeTransitionProbabilitiesForNode(co
   {
     // Computes all d2pxy/dt2 once for all:
     VVVdouble* d2pxy__node = &d2pxy_[node->getId()];
+    model_->filld2Pij_dt2(times, *d2pxy__node);
     for (unsigned int c = 0; c < nbClasses_; c++)
     {
       VVdouble* d2pxy__node_c = &(*d2pxy__node)[c];
-      double rc =  rateDistribution_->getCategory(c);
-      RowMatrix<double> d2Q = model_->getd2Pij_dt2(l * rc);
+      double rc2 = rates[c] * rates[c];
       for (unsigned int x = 0; x < nbStates_; x++)
       {
         Vdouble* d2pxy__node_c_x = &(*d2pxy__node_c)[x];
         for (unsigned int y = 0; y < nbStates_; y++)
         {
-          (*d2pxy__node_c_x)[y] = rc * rc * d2Q(x, y);
+          (*d2pxy__node_c_x)[y] *= rc2;
         }
       }
     }
@@ -179,7 +179,7 @@ public:
 
   const std::vector<double>& getRootFrequencies(size_t siteIndex) const { return model_->getFrequencies(); }
 
-  VVVdouble getTransitionProbabilitiesPerRateClass(int nodeId, size_t siteIndex) const { return pxy_[nodeId]; }
+  VVVdouble getTransitionProbabilitiesPerRateClass(int nodeId, size_t siteIndex) const { return pxy_.at(nodeId); }
 
   ConstBranchModelIterator* getNewBranchModelIterator(int nodeId) const
   {
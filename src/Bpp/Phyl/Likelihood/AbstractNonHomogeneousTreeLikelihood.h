@@ -205,7 +205,7 @@ class AbstractNonHomogeneousTreeLikelihood:
 
     const std::vector<double>& getRootFrequencies(size_t siteIndex) const { return rootFreqs_; }
     
-    VVVdouble getTransitionProbabilitiesPerRateClass(int nodeId, size_t siteIndex) const { return pxy_[nodeId]; }
+    VVVdouble getTransitionProbabilitiesPerRateClass(int nodeId, size_t siteIndex) const { return pxy_.at(nodeId); }
 
     ConstBranchModelIterator* getNewBranchModelIterator(int nodeId) const
     {
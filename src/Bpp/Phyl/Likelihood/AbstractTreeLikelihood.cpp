@@ -39,6 +39,9 @@ knowledge of the CeCILL license and that you accept its terms.
 
 #include "AbstractTreeLikelihood.h"
 
+//From bpp-seq:
+#include <Bpp/Seq/Container/VectorSiteContainer.h>
+
 using namespace bpp;
 
 /******************************************************************************/
@@ -95,3 +98,21 @@ VVdouble AbstractTreeLikelihood::getLogLikelihoodForEachSiteForEachState() const
 
 /******************************************************************************/
 
+
+void AbstractTreeLikelihood::expandData_() const
+{
+	VectorSiteContainer* sites = new VectorSiteContainer(data_->getNumberOfSequences(), data_->getAlphabet());
+	sites->setSequencesNames(data_->getSequencesNames(), false);
+	for (size_t i = 0; i < dataPatternLinks_.size(); i++)
+  {
+		Site site(data_->getSite(dataPatternLinks_[i]));
+		site.setPosition(static_cast<int>(i + 1));
+		sites->addSite(site, false);
+	}
+	delete data_;
+	data_ = sites;
+	dataPatternLinks_.clear();
+}
+
+/******************************************************************************/
+
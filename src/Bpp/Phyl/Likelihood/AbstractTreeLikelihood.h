@@ -226,7 +226,18 @@ namespace bpp
 
 
   protected:
-    const SiteContainer* data_;
+    /**
+     * @brief The data set, or only its distinct sites if
+     * dataPatternLinks_ is not empty (see setDataPatterns_()).
+     */
+    mutable const SiteContainer* data_;
+
+    /**
+     * @brief The index in data_ of each site, if data_ only holds
+     * distinct sites. Empty otherwise.
+     */
+    mutable std::vector<size_t> dataPatternLinks_;
+
     mutable TreeTemplate<Node>* tree_;
     bool computeFirstOrderDerivatives_;
     bool computeSecondOrderDerivatives_;
@@ -236,6 +247,7 @@ namespace bpp
     AbstractTreeLikelihood():
       AbstractParametrizable(""),
       data_(0),
+      dataPatternLinks_(),
       tree_(0),
       computeFirstOrderDerivatives_(true),
       computeSecondOrderDerivatives_(true),
@@ -244,6 +256,7 @@ namespace bpp
     AbstractTreeLikelihood(const AbstractTreeLikelihood & lik):
       AbstractParametrizable(lik),
       data_(0),
+      dataPatternLinks_(lik.dataPatternLinks_),
       tree_(0),
       computeFirstOrderDerivatives_(lik.computeFirstOrderDerivatives_),
       computeSecondOrderDerivatives_(lik.computeSecondOrderDerivatives_),
@@ -259,6 +272,7 @@ namespace bpp
       if (data_) delete data_;
       if (lik.data_) data_ = dynamic_cast<SiteContainer*>(lik.data_->clone());
       else           data_ = 0;
+      dataPatternLinks_ = lik.dataPatternLinks_;
       if (tree_) delete tree_;
       if (lik.tree_) tree_ = lik.tree_->clone();
       else           tree_ = 0;
@@ -285,13 +299,23 @@ namespace bpp
      *
      * @{
      */
-    const SiteContainer* getData() const { return data_; }
+    /**
+     * If only the distinct sites are stored, the full data set is
+     * built by the first call to this method, which hence must not be
+     * called concurrently.
+     */
+    const SiteContainer* getData() const
+    {
+      if (!dataPatternLinks_.empty())
+        expandData_();
+      return data_;
+    }
     const Alphabet* getAlphabet() const { return data_->getAlphabet(); }  
     Vdouble getLikelihoodForEachSite()                 const;
     Vdouble getLogLikelihoodForEachSite()              const;
     VVdouble getLikelihoodForEachSiteForEachState()    const;
     VVdouble getLogLikelihoodForEachSiteForEachState() const;
-    size_t getNumberOfSites() const { return data_->getNumberOfSites(); }
+    size_t getNumberOfSites() const { return dataPatternLinks_.empty() ? data_->getNumberOfSites() : dataPatternLinks_.size(); }
     const Tree& getTree() const { return *tree_; }
     void enableDerivatives(bool yn) { computeFirstOrderDerivatives_ = computeSecondOrderDerivatives_ = yn; }
     void enableFirstOrderDerivatives(bool yn) { computeFirstOrderDerivatives_ = yn; }
@@ -302,6 +326,27 @@ namespace bpp
     void initialize() throw (Exception) { initialized_ = true; }
     /** @} */
 
+  protected:
+    /**
+     * @brief Set the data set from its distinct sites only.
+     *
+     * The full data set is only built if getData() is called.
+     *
+     * @param sites The distinct sites. This object will own it.
+     * @param links The index in sites of each site of the data set.
+     */
+    void setDataPatterns_(const SiteContainer* sites, const std::vector<size_t>& links)
+    {
+      if (data_) delete data_;
+      data_ = sites;
+      dataPatternLinks_ = links;
+    }
+
+    /**
+     * @brief Build the full data set from the distinct sites.
+     */
+    void expandData_() const;
+
   };
 
 } //end of namespace bpp.
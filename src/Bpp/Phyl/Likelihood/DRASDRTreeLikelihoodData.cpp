@@ -50,25 +50,32 @@ using namespace bpp;
 
 void DRASDRTreeLikelihoodData::initLikelihoods(const SiteContainer& sites, const TransitionModel& model) throw (Exception)
 {
-  if (sites.getNumberOfSequences() == 1)
+  SitePatterns pattern(&sites);
+  initLikelihoods(pattern, model);
+}
+
+/******************************************************************************/
+
+void DRASDRTreeLikelihoodData::initLikelihoods(const SitePatterns& patterns, const TransitionModel& model) throw (Exception)
+{
+  if (shrunkData_)
+    delete shrunkData_;
+  shrunkData_ = patterns.getSites();
+  if (shrunkData_->getNumberOfSequences() == 1)
     throw Exception("Error, only 1 sequence!");
-  if (sites.getNumberOfSequences() == 0)
+  if (shrunkData_->getNumberOfSequences() == 0)
     throw Exception("Error, no sequence!");
-  if (sites.getAlphabet()->getAlphabetType()
+  if (shrunkData_->getAlphabet()->getAlphabetType()
       != model.getAlphabet()->getAlphabetType())
     throw AlphabetMismatchException("DRASDRTreeLikelihoodData::initLikelihoods. Data and model must have the same alphabet type.",
-                                    sites.getAlphabet(),
+                                    shrunkData_->getAlphabet(),
                                     model.getAlphabet());
-  alphabet_ = sites.getAlphabet();
+  alphabet_ = shrunkData_->getAlphabet();
   nbStates_ = model.getNumberOfStates();
-  nbSites_  = sites.getNumberOfSites();
+  nbSites_  = patterns.getIndices().size();
 
-  SitePatterns pattern(&sites);
-  if (shrunkData_)
-    delete shrunkData_;
-  shrunkData_       = pattern.getSites();
-  rootWeights_      = pattern.getWeights();
-  rootPatternLinks_ = pattern.getIndices();
+  rootWeights_      = patterns.getWeights();
+  rootPatternLinks_ = patterns.getIndices();
   nbDistinctSites_  = shrunkData_->getNumberOfSites();
 
   // Init data:
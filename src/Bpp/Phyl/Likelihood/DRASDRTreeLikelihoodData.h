@@ -187,9 +187,13 @@ class DRASDRTreeLikelihoodNodeData :
       return nodeLikelihoods_[neighborId];
     }
     
+    /**
+     * @return The array for the given neighbor, which must exist.
+     * Unlike the non-const version, this never modifies the data, so it can be called from several threads.
+     */
     const VVVdouble& getLikelihoodArrayForNeighbor(int neighborId) const
     {
-      return nodeLikelihoods_[neighborId];
+      return nodeLikelihoods_.at(neighborId);
     }
     
     Vdouble& getDLikelihoodArray() { return nodeDLikelihoods_;  }
@@ -308,9 +312,13 @@ class DRASDRTreeLikelihoodData :
       return nodeData_[nodeId];
     }
     
+    /**
+     * @return The data for the given inner node, which must exist.
+     * Unlike the non-const version, this never modifies the data, so it can be called from several threads.
+     */
     const DRASDRTreeLikelihoodNodeData& getNodeData(int nodeId) const
     { 
-      return nodeData_[nodeId];
+      return nodeData_.at(nodeId);
     }
     
     DRASDRTreeLikelihoodLeafData& getLeafData(int nodeId)
@@ -320,7 +328,7 @@ class DRASDRTreeLikelihoodData :
     
     const DRASDRTreeLikelihoodLeafData& getLeafData(int nodeId) const
     { 
-      return leafData_[nodeId];
+      return leafData_.at(nodeId);
     }
     
     size_t getArrayPosition(int parentId, int sonId, size_t currentPosition) const
@@ -330,7 +338,7 @@ class DRASDRTreeLikelihoodData :
 
     const std::map<int, VVVdouble>& getLikelihoodArrays(int nodeId) const 
     {
-      return nodeData_[nodeId].getLikelihoodArrays();
+      return nodeData_.at(nodeId).getLikelihoodArrays();
     }
     
     std::map<int, VVVdouble>& getLikelihoodArrays(int nodeId)
@@ -345,7 +353,7 @@ class DRASDRTreeLikelihoodData :
     
     const VVVdouble& getLikelihoodArray(int parentId, int neighborId) const
     {
-      return nodeData_[parentId].getLikelihoodArrayForNeighbor(neighborId);
+      return nodeData_.at(parentId).getLikelihoodArrayForNeighbor(neighborId);
     }
     
     Vdouble& getDLikelihoodArray(int nodeId)
@@ -355,7 +363,7 @@ class DRASDRTreeLikelihoodData :
     
     const Vdouble& getDLikelihoodArray(int nodeId) const
     {
-      return nodeData_[nodeId].getDLikelihoodArray();
+      return nodeData_.at(nodeId).getDLikelihoodArray();
     }
     
     Vdouble& getD2LikelihoodArray(int nodeId)
@@ -365,7 +373,7 @@ class DRASDRTreeLikelihoodData :
 
     const Vdouble& getD2LikelihoodArray(int nodeId) const
     {
-      return nodeData_[nodeId].getD2LikelihoodArray();
+      return nodeData_.at(nodeId).getD2LikelihoodArray();
     }
 
     VVdouble& getLeafLikelihoods(int nodeId)
@@ -375,7 +383,7 @@ class DRASDRTreeLikelihoodData :
     
     const VVdouble& getLeafLikelihoods(int nodeId) const
     {
-      return leafData_[nodeId].getLikelihoodArray();
+      return leafData_.at(nodeId).getLikelihoodArray();
     }
     
     VVVdouble& getRootLikelihoodArray() { return rootLikelihoods_; }
@@ -405,6 +413,18 @@ class DRASDRTreeLikelihoodData :
      * @throw Exception if an error occures.
      */
     void initLikelihoods(const SiteContainer& sites, const TransitionModel& model) throw (Exception);
+
+    /**
+     * @brief Resize and initialize all likelihood arrays according to already computed site patterns.
+     *
+     * The weights and positions of the patterns are used as they are,
+     * so that the data are only compressed once.
+     *
+     * @param patterns The site patterns to use as data.
+     * @param model    The substitution model to use.
+     * @throw Exception if an error occures.
+     */
+    void initLikelihoods(const SitePatterns& patterns, const TransitionModel& model) throw (Exception);
     
     /**
      * @brief Rebuild likelihood arrays at inner nodes.
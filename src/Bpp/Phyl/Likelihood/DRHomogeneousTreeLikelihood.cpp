@@ -137,6 +137,7 @@ void DRHomogeneousTreeLikelihood::setData(const SiteContainer& sites) throw (Exc
   if (data_)
     delete data_;
   data_ = PatternTools::getSequenceSubset(sites, *tree_->getRootNode());
+  dataPatternLinks_.clear();
   if (verbose_)
     ApplicationTools::displayTask("Initializing data structure");
   likelihoodData_->initLikelihoods(*data_, *model_);
@@ -155,6 +156,30 @@ void DRHomogeneousTreeLikelihood::setData(const SiteContainer& sites) throw (Exc
 
 /******************************************************************************/
 
+void DRHomogeneousTreeLikelihood::setSitePatterns(const SitePatterns& patterns) throw (Exception)
+{
+  // Only the distinct sites are kept, the full data set is built if requested:
+  SiteContainer* sites = patterns.getSites();
+  setDataPatterns_(PatternTools::getSequenceSubset(*sites, *tree_->getRootNode()), patterns.getIndices());
+  delete sites;
+  if (verbose_)
+    ApplicationTools::displayTask("Initializing data structure");
+  likelihoodData_->initLikelihoods(patterns, *model_);
+  if (verbose_)
+    ApplicationTools::displayTaskDone();
+
+  nbSites_ = likelihoodData_->getNumberOfSites();
+  nbDistinctSites_ = likelihoodData_->getNumberOfDistinctSites();
+  nbStates_ = likelihoodData_->getNumberOfStates();
+
+  if (verbose_)
+    ApplicationTools::displayResult("Number of distinct sites",
+                                    TextTools::toString(nbDistinctSites_));
+  initialized_ = false;
+}
+
+/******************************************************************************/
+
 double DRHomogeneousTreeLikelihood::getLikelihood() const
 {
   double l = 1.;
@@ -140,6 +140,7 @@ void DRNonHomogeneousTreeLikelihood::setData(const SiteContainer& sites) throw (
   if (data_)
     delete data_;
   data_ = PatternTools::getSequenceSubset(sites, *tree_->getRootNode());
+  dataPatternLinks_.clear();
   if (verbose_)
     ApplicationTools::displayTask("Initializing data structure");
   likelihoodData_->initLikelihoods(*data_, *modelSet_->getModel(0)); // We assume here that all models have the same number of states, and that they have the same 'init' method,
@@ -159,6 +160,30 @@ void DRNonHomogeneousTreeLikelihood::setData(const SiteContainer& sites) throw (
 
 /******************************************************************************/
 
+void DRNonHomogeneousTreeLikelihood::setSitePatterns(const SitePatterns& patterns) throw (Exception)
+{
+  // Only the distinct sites are kept, the full data set is built if requested:
+  SiteContainer* sites = patterns.getSites();
+  setDataPatterns_(PatternTools::getSequenceSubset(*sites, *tree_->getRootNode()), patterns.getIndices());
+  delete sites;
+  if (verbose_)
+    ApplicationTools::displayTask("Initializing data structure");
+  likelihoodData_->initLikelihoods(patterns, *modelSet_->getModel(0));
+  if (verbose_)
+    ApplicationTools::displayTaskDone();
+
+  nbSites_         = likelihoodData_->getNumberOfSites();
+  nbDistinctSites_ = likelihoodData_->getNumberOfDistinctSites();
+  nbStates_         = likelihoodData_->getNumberOfStates();
+
+  if (verbose_)
+    ApplicationTools::displayResult("Number of distinct sites",
+                                    TextTools::toString(nbDistinctSites_));
+  initialized_ = false;
+}
+
+/******************************************************************************/
+
 double DRNonHomogeneousTreeLikelihood::getLikelihood() const
 {
   double l = 1.;
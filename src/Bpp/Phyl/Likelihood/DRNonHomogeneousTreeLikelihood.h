@@ -154,6 +154,19 @@ class DRNonHomogeneousTreeLikelihood:
     size_t getSiteIndex(size_t site) const throw (IndexOutOfBoundsException) { return likelihoodData_->getRootArrayPosition(site); }
     /** @} */
 
+    /**
+     * @brief Set the dataset from already computed site patterns.
+     *
+     * This is equivalent to setData() with all the sites of the patterns,
+     * but the data are not compressed again. Only the distinct sites
+     * are stored: the full data set is built by the first call to
+     * getData().
+     *
+     * @param patterns The site patterns to use as data.
+     * @throw Exception if an error occures.
+     */
+    void setSitePatterns(const SitePatterns& patterns) throw (Exception);
+
     void computeTreeLikelihood();
 
     
@@ -38,6 +38,7 @@
  */
 
 #include "NNIHomogeneousTreeLikelihood.h"
+#include "../ParallelTools.h"
 
 #include <Bpp/Text/TextTools.h>
 #include <Bpp/App/ApplicationTools.h>
@@ -47,6 +48,7 @@ using namespace bpp;
 
 // From the STL:
 #include <iostream>
+#include <memory>
 
 using namespace std;
 
@@ -74,19 +76,7 @@ void BranchLikelihood::computeAllTransitionProbabilities()
   double l = getParameterValue("BrLen");
 
   // Computes all pxy once for all:
-  for (size_t c = 0; c < nbClasses_; c++)
-  {
-    VVdouble* pxy__c = &pxy_[c];
-    RowMatrix<double> Q = model_->getPij_t(l * rDist_->getCategory(c));
-    for (size_t x = 0; x < nbStates_; x++)
-    {
-      Vdouble* pxy__c_x = &(*pxy__c)[x];
-      for (size_t y = 0; y < nbStates_; y++)
-      {
-        (*pxy__c_x)[y] = Q(x, y);
-      }
-    }
-  }
+  model_->fillPij_t(rDist_->getCategories() * l, pxy_);
 }
 
 /*******************************************************************************/
@@ -205,6 +195,56 @@ NNIHomogeneousTreeLikelihood::~NNIHomogeneousTreeLikelihood()
 
 /******************************************************************************/
 double NNIHomogeneousTreeLikelihood::testNNI(int nodeId) const throw (NodeException)
+{
+  double length = 0;
+  double diff = testNNI_(nodeId, *brLikFunction_, *brentOptimizer_, model_, rateDistribution_, length);
+  brLenNNIValues_[nodeId] = length;
+  return diff;
+}
+
+/******************************************************************************/
+vector<double> NNIHomogeneousTreeLikelihood::testNNIs(const vector<int>& nodeIds, unsigned int nbThreads) const throw (NodeException)
+{
+  size_t n = nodeIds.size();
+  vector<double> diffs(n);
+  if (ParallelTools::getNumberOfBlocks(n, nbThreads) <= 1)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      diffs[i] = testNNI(nodeIds[i]);
+    }
+    return diffs;
+  }
+
+  vector<double> lengths(n);
+  ParallelTools::forEachBlock(n, nbThreads,
+    [&](size_t begin, size_t end, unsigned int)
+    {
+      // The model and the optimizer keep mutable buffers, each block works on its own copies:
+      unique_ptr<TransitionModel> model(model_->clone());
+      unique_ptr<DiscreteDistribution> rDist(rateDistribution_->clone());
+      BranchLikelihood brLikFunction(*brLikFunction_);
+      unique_ptr<BrentOneDimension> brentOptimizer(dynamic_cast<BrentOneDimension*>(brentOptimizer_->clone()));
+      for (size_t i = begin; i < end; i++)
+      {
+        diffs[i] = testNNI_(nodeIds[i], brLikFunction, *brentOptimizer, model.get(), rDist.get(), lengths[i]);
+      }
+    });
+  for (size_t i = 0; i < n; i++)
+  {
+    brLenNNIValues_[nodeIds[i]] = lengths[i];
+  }
+  return diffs;
+}
+
+/******************************************************************************/
+double NNIHomogeneousTreeLikelihood::testNNI_(
+  int nodeId,
+  BranchLikelihood& brLikFunction,
+  BrentOneDimension& brentOptimizer,
+  const TransitionModel* model,
+  const DiscreteDistribution* rDist,
+  double& length) const throw (NodeException)
 {
   const Node* son    = tree_->getNode(nodeId);
   if (!son->hasFather()) throw NodePException("DRHomogeneousTreeLikelihood::testNNI(). Node 'son' must not be the root node.", son);
@@ -218,7 +258,7 @@ double NNIHomogeneousTreeLikelihood::testNNI(int nodeId) const throw (NodeExcept
   // const Node * uncle = grandFather->getSon(parentPosition > 1 ? parentPosition - 1 : 1 - parentPosition);
   const Node* uncle = grandFather->getSon(parentPosition > 1 ? 0 : 1 - parentPosition);
 
-  // Retrieving arrays of interest:
+  // Retrieving arrays of interest (this may run on several threads, so maps are only read):
   const DRASDRTreeLikelihoodNodeData* parentData = &getLikelihoodData()->getNodeData(parent->getId());
   const VVVdouble* sonArray   = &parentData->getLikelihoodArrayForNeighbor(son->getId());
   vector<const Node*> parentNeighbors = TreeTemplateTools::getRemainingNeighbors(parent, grandFather, son);
@@ -231,7 +271,7 @@ double NNIHomogeneousTreeLikelihood::testNNI(int nodeId) const throw (NodeExcept
     parentArrays[k] = &parentData->getLikelihoodArrayForNeighbor(n->getId());
     // if(n != grandFather) parentTProbs[k] = & pxy_[n->getId()];
     // else                 parentTProbs[k] = & pxy_[parent->getId()];
-    parentTProbs[k] = &pxy_[n->getId()];
+    parentTProbs[k] = &pxy_.at(n->getId());
   }
 
   const DRASDRTreeLikelihoodNodeData* grandFatherData = &getLikelihoodData()->getNodeData(grandFather->getId());
@@ -246,7 +286,7 @@ double NNIHomogeneousTreeLikelihood::testNNI(int nodeId) const throw (NodeExcept
     if (grandFather->getFather() == NULL || n != grandFather->getFather())
     {
       grandFatherArrays.push_back(&grandFatherData->getLikelihoodArrayForNeighbor(n->getId()));
-      grandFatherTProbs.push_back(&pxy_[n->getId()]);
+      grandFatherTProbs.push_back(&pxy_.at(n->getId()));
     }
   }
 
@@ -254,10 +294,10 @@ double NNIHomogeneousTreeLikelihood::testNNI(int nodeId) const throw (NodeExcept
   VVVdouble array1 = *sonArray;
   resetLikelihoodArray(array1);
   grandFatherArrays.push_back(sonArray);
-  grandFatherTProbs.push_back(&pxy_[son->getId()]);
+  grandFatherTProbs.push_back(&pxy_.at(son->getId()));
   if (grandFather->hasFather())
   {
-    computeLikelihoodFromArrays(grandFatherArrays, grandFatherTProbs, &grandFatherData->getLikelihoodArrayForNeighbor(grandFather->getFather()->getId()), &pxy_[grandFather->getId()], array1, nbGrandFatherNeighbors, nbDistinctSites_, nbClasses_, nbStates_, false);
+    computeLikelihoodFromArrays(grandFatherArrays, grandFatherTProbs, &grandFatherData->getLikelihoodArrayForNeighbor(grandFather->getFather()->getId()), &pxy_.at(grandFather->getId()), array1, nbGrandFatherNeighbors, nbDistinctSites_, nbClasses_, nbStates_, false);
   }
   else
   {
@@ -280,12 +320,12 @@ double NNIHomogeneousTreeLikelihood::testNNI(int nodeId) const throw (NodeExcept
   VVVdouble array2 = *uncleArray;
   resetLikelihoodArray(array2);
   parentArrays.push_back(uncleArray);
-  parentTProbs.push_back(&pxy_[uncle->getId()]);
+  parentTProbs.push_back(&pxy_.at(uncle->getId()));
   computeLikelihoodFromArrays(parentArrays, parentTProbs, array2, nbParentNeighbors + 1, nbDistinctSites_, nbClasses_, nbStates_, false);
 
   // Initialize BranchLikelihood:
-  brLikFunction_->initModel(model_, rateDistribution_);
-  brLikFunction_->initLikelihoods(&array1, &array2);
+  brLikFunction.initModel(model, rDist);
+  brLikFunction.initLikelihoods(&array1, &array2);
   ParameterList parameters;
   size_t pos = 0;
   while (pos < nodes_.size() && nodes_[pos]->getId() != parent->getId()) pos++;
@@ -293,21 +333,21 @@ double NNIHomogeneousTreeLikelihood::testNNI(int nodeId) const throw (NodeExcept
   Parameter brLen = getParameter("BrLen" + TextTools::toString(pos));
   brLen.setName("BrLen");
   parameters.addParameter(brLen);
-  brLikFunction_->setParameters(parameters);
+  brLikFunction.setParameters(parameters);
 
   // Re-estimate branch length:
-  brentOptimizer_->setFunction(brLikFunction_);
-  brentOptimizer_->getStopCondition()->setTolerance(0.1);
-  brentOptimizer_->setInitialInterval(brLen.getValue(), brLen.getValue() + 0.01);
-  brentOptimizer_->init(parameters);
-  brentOptimizer_->optimize();
-  // brLenNNIValues_[nodeId] = brLikFunction_->getParameterValue("BrLen");
-  brLenNNIValues_[nodeId] = brentOptimizer_->getParameters().getParameter("BrLen").getValue();
-  brLikFunction_->resetLikelihoods(); // Array1 and Array2 will be destroyed after this function call.
-                                      // We should not keep pointers towards them...
+  brentOptimizer.setFunction(&brLikFunction);
+  brentOptimizer.getStopCondition()->setTolerance(0.1);
+  brentOptimizer.setInitialInterval(brLen.getValue(), brLen.getValue() + 0.01);
+  brentOptimizer.init(parameters);
+  brentOptimizer.optimize();
+  // length = brLikFunction.getParameterValue("BrLen");
+  length = brentOptimizer.getParameters().getParameter("BrLen").getValue();
+  brLikFunction.resetLikelihoods(); // Array1 and Array2 will be destroyed after this function call.
+                                    // We should not keep pointers towards them...
 
   // Return the resulting likelihood:
-  return brLikFunction_->getValue() - getValue();
+  return brLikFunction.getValue() - getValue();
 }
 
 /*******************************************************************************/
@@ -240,6 +240,13 @@ public:
     brLikFunction_ = new BranchLikelihood(getLikelihoodData()->getWeights());
   }
 
+  void setSitePatterns(const SitePatterns& patterns) throw (Exception)
+  {
+    DRHomogeneousTreeLikelihood::setSitePatterns(patterns);
+    if (brLikFunction_) delete brLikFunction_;
+    brLikFunction_ = new BranchLikelihood(getLikelihoodData()->getWeights());
+  }
+
   /**
    * @name The NNISearchable interface.
    *
@@ -257,6 +264,13 @@ public:
 
   double testNNI(int nodeId) const throw (NodeException);
 
+  /**
+   * NNIs are tested concurrently, each thread working on its own copies of the
+   * branch likelihood function, optimizer, substitution model and rate distribution.
+   * The results are the same as with testNNI().
+   */
+  std::vector<double> testNNIs(const std::vector<int>& nodeIds, unsigned int nbThreads = 1) const throw (NodeException);
+
   void doNNI(int nodeId) throw (NodeException);
 
   void topologyChangeTested(const TopologyChangeEvent& event)
@@ -272,6 +286,27 @@ public:
     brLenNNIValues_.clear();
   }
   /** @} */
+
+protected:
+  /**
+   * @brief Test a NNI with the given workspace.
+   *
+   * @param nodeId         The id of the node defining the NNI movement.
+   * @param brLikFunction  The function used to optimize the branch length.
+   * @param brentOptimizer The optimizer used.
+   * @param model          The substitution model to use in brLikFunction.
+   * @param rDist          The rate distribution to use in brLikFunction.
+   * @param length         [out] The branch length found.
+   * @return The score variation of the NNI.
+   * @throw NodeException If the node does not define a valid NNI.
+   */
+  double testNNI_(
+    int nodeId,
+    BranchLikelihood& brLikFunction,
+    BrentOneDimension& brentOptimizer,
+    const TransitionModel* model,
+    const DiscreteDistribution* rDist,
+    double& length) const throw (NodeException);
 };
 } // end of namespace bpp.
 
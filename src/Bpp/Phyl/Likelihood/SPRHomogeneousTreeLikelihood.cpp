@@ -0,0 +1,434 @@
+//
+// File: SPRHomogeneousTreeLikelihood.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#include "SPRHomogeneousTreeLikelihood.h"
+#include "../TreeTemplateTools.h"
+
+#include <Bpp/Text/TextTools.h>
+#include <Bpp/Numeric/VectorTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+
+using namespace std;
+
+/******************************************************************************/
+
+SPRHomogeneousTreeLikelihood::SPRHomogeneousTreeLikelihood(
+  const Tree& tree,
+  TransitionModel* model,
+  DiscreteDistribution* rDist,
+  bool checkRooted,
+  bool verbose)
+throw (Exception) :
+  NNIHomogeneousTreeLikelihood(tree, model, rDist, checkRooted, verbose),
+  brLenSPRValues_()
+{}
+
+/******************************************************************************/
+
+SPRHomogeneousTreeLikelihood::SPRHomogeneousTreeLikelihood(
+  const Tree& tree,
+  const SiteContainer& data,
+  TransitionModel* model,
+  DiscreteDistribution* rDist,
+  bool checkRooted,
+  bool verbose)
+throw (Exception) :
+  NNIHomogeneousTreeLikelihood(tree, data, model, rDist, checkRooted, verbose),
+  brLenSPRValues_()
+{}
+
+/******************************************************************************/
+
+void SPRHomogeneousTreeLikelihood::multiplyByNeighborArray_(const VVVdouble& iLik, bool rootSide, const VVVdouble& tProb, VVVdouble& oLik) const
+{
+  if (rootSide)
+  {
+    vector<const VVVdouble*> none;
+    computeLikelihoodFromArrays(none, none, &iLik, &tProb, oLik, 0, nbDistinctSites_, nbClasses_, nbStates_, false);
+  }
+  else
+  {
+    vector<const VVVdouble*> iLiks(1, &iLik);
+    vector<const VVVdouble*> tProbs(1, &tProb);
+    computeLikelihoodFromArrays(iLiks, tProbs, oLik, 1, nbDistinctSites_, nbClasses_, nbStates_, false);
+  }
+}
+
+/******************************************************************************/
+
+void SPRHomogeneousTreeLikelihood::multiplyByRootFrequencies_(VVVdouble& array) const
+{
+  for (size_t i = 0; i < nbDistinctSites_; i++)
+  {
+    for (size_t c = 0; c < nbClasses_; c++)
+    {
+      for (size_t x = 0; x < nbStates_; x++)
+      {
+        array[i][c][x] *= rootFreqs_[x];
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+bool SPRHomogeneousTreeLikelihood::computeRemainingArray_(
+  const Node* node,
+  const Node* from,
+  const Node* to,
+  const VVVdouble& fromArray,
+  bool fromRoot,
+  VVVdouble& array) const
+{
+  array = fromArray;
+  bool rootSide = fromRoot;
+  const DRASDRTreeLikelihoodNodeData* nodeData = &likelihoodData_->getNodeData(node->getId());
+  vector<const Node*> neighbors = node->getNeighbors();
+  for (size_t k = 0; k < neighbors.size(); k++)
+  {
+    const Node* n = neighbors[k];
+    if (n == from || n == to) continue;
+    bool isFather = (n == node->getFather());
+    multiplyByNeighborArray_(nodeData->getLikelihoodArrayForNeighbor(n->getId()), isFather, pxy_.at(isFather ? node->getId() : n->getId()), array);
+    rootSide = rootSide || isFather;
+  }
+  if (!node->hasFather())
+  {
+    // This is the root node, we have to account for the ancestral frequencies:
+    multiplyByRootFrequencies_(array);
+    rootSide = true;
+  }
+  return rootSide;
+}
+
+/******************************************************************************/
+
+void SPRHomogeneousTreeLikelihood::visitBranches_(
+  const Node* node,
+  const Node* from,
+  const VVVdouble& fromArray,
+  bool fromRoot,
+  unsigned int depth,
+  unsigned int radius,
+  const std::function<void (const Node*, const Node*, const VVVdouble&, bool)>& f) const
+{
+  if (depth > radius || node->isLeaf()) return;
+  vector<const Node*> neighbors = node->getNeighbors();
+  VVVdouble xArray, yArray;
+  for (size_t k = 0; k < neighbors.size(); k++)
+  {
+    const Node* son = neighbors[k];
+    if (son == from) continue;
+    // Subtree on the node side of the branch, not including the son:
+    bool xRoot = computeRemainingArray_(node, from, son, fromArray, fromRoot, xArray);
+    f(node, son, xArray, xRoot);
+    if (depth < radius && !son->isLeaf())
+    {
+      yArray = xArray;
+      resetLikelihoodArray(yArray);
+      multiplyByNeighborArray_(xArray, xRoot, pxy_.at(son == node->getFather() ? node->getId() : son->getId()), yArray);
+      visitBranches_(son, node, yArray, xRoot, depth + 1, radius, f);
+    }
+  }
+}
+
+/******************************************************************************/
+
+double SPRHomogeneousTreeLikelihood::optimizeBranchLength_(const VVVdouble& array1, const VVVdouble& array2, double& length, double tolerance) const
+{
+  length = max(minimumBrLen_, min(length, maximumBrLen_));
+  brLikFunction_->initModel(model_, rateDistribution_);
+  brLikFunction_->initLikelihoods(&array1, &array2);
+  ParameterList parameters;
+  parameters.addParameter(Parameter("BrLen", length, brLenConstraint_->clone(), true));
+  brLikFunction_->setParameters(parameters);
+
+  brentOptimizer_->setFunction(brLikFunction_);
+  brentOptimizer_->getStopCondition()->setTolerance(tolerance);
+  brentOptimizer_->setInitialInterval(length, length + 0.01);
+  brentOptimizer_->init(parameters);
+  brentOptimizer_->optimize();
+  // The function may have been evaluated last at another point:
+  brLikFunction_->setParameters(brentOptimizer_->getParameters());
+  length = brLikFunction_->getParameterValue("BrLen");
+  double value = brLikFunction_->getValue();
+  brLikFunction_->resetLikelihoods();
+  return value;
+}
+
+/******************************************************************************/
+
+double SPRHomogeneousTreeLikelihood::optimizeRegraftingBranches_(
+  const vector<const VVVdouble*>& arrays,
+  const vector<bool>& roots,
+  vector<double>& lengths,
+  size_t nbBranches,
+  double tolerance,
+  unsigned int nbRounds) const
+{
+  vector<VVVdouble> tProbs(3);
+  for (size_t j = 0; j < 3; j++)
+  {
+    model_->fillPij_t(rateDistribution_->getCategories() * lengths[j], tProbs[j]);
+  }
+  VVVdouble array;
+  double value = 0;
+  for (unsigned int r = 0; r < nbRounds; r++)
+  {
+    double previous = value;
+    for (size_t i = 0; i < nbBranches; i++)
+    {
+      // Likelihoods of the two other subtrees, at the regrafting point:
+      array = *arrays[i];
+      resetLikelihoodArray(array);
+      bool rootSide = false;
+      for (size_t j = 0; j < 3; j++)
+      {
+        if (j == i) continue;
+        multiplyByNeighborArray_(*arrays[j], roots[j], tProbs[j], array);
+        rootSide = rootSide || roots[j];
+      }
+      if (roots[i])
+        value = optimizeBranchLength_(*arrays[i], array, lengths[i], tolerance);
+      else
+      {
+        // If no array contains the root frequencies, the pruned node was attached to the root node:
+        if (!rootSide)
+          multiplyByRootFrequencies_(array);
+        value = optimizeBranchLength_(array, *arrays[i], lengths[i], tolerance);
+      }
+      model_->fillPij_t(rateDistribution_->getCategories() * lengths[i], tProbs[i]);
+    }
+    if (r > 0 && previous - value < tolerance) break;
+  }
+  return value;
+}
+
+/******************************************************************************/
+
+double SPRHomogeneousTreeLikelihood::getJoinedBranchLength_(const Node* father, const Node* pruned) const
+{
+  vector<const Node*> neighbors = TreeTemplateTools::getRemainingNeighbors(father, pruned, pruned);
+  return min(getBranchLength_(father, neighbors[0]) + getBranchLength_(father, neighbors[1]), maximumBrLen_);
+}
+
+/******************************************************************************/
+
+vector<SubtreeRearrangement> SPRHomogeneousTreeLikelihood::testSPRs(int nodeId, unsigned int radius) const throw (NodeException)
+{
+  const Node* pruned = tree_->getNode(nodeId);
+  if (!pruned->hasFather()) throw NodePException("SPRHomogeneousTreeLikelihood::testSPRs(). Node must not be the root node.", pruned);
+  const Node* father = pruned->getFather();
+  vector<SubtreeRearrangement> moves;
+  if (father->degree() != 3 || radius == 0) return moves;
+  const DRASDRTreeLikelihoodNodeData* fatherData = &likelihoodData_->getNodeData(father->getId());
+
+  vector<const VVVdouble*> arrays(3);
+  vector<bool> roots(3, false);
+  arrays[0] = &fatherData->getLikelihoodArrayForNeighbor(nodeId);
+  double prunedLength = pruned->getDistanceToFather();
+
+  // Remaining tree, with the father of the pruned subtree removed:
+  vector<const Node*> neighbors = TreeTemplateTools::getRemainingNeighbors(father, pruned, pruned);
+  VVVdouble joinedProbs;
+  model_->fillPij_t(rateDistribution_->getCategories() * getJoinedBranchLength_(father, pruned), joinedProbs);
+  VVVdouble fromArray;
+  for (size_t k = 0; k < 2; k++)
+  {
+    const Node* other = neighbors[1 - k];
+    bool otherRoot = (other == father->getFather());
+    fromArray = *arrays[0];
+    resetLikelihoodArray(fromArray);
+    multiplyByNeighborArray_(fatherData->getLikelihoodArrayForNeighbor(other->getId()), otherRoot, joinedProbs, fromArray);
+    visitBranches_(neighbors[k], father, fromArray, otherRoot, 1, radius,
+      [&](const Node* x, const Node* y, const VVVdouble& xArray, bool xRoot)
+      {
+        // The regrafting point splits the branch in two halves:
+        arrays[1] = &xArray;
+        roots[1]  = xRoot;
+        arrays[2] = &likelihoodData_->getNodeData(x->getId()).getLikelihoodArrayForNeighbor(y->getId());
+        roots[2]  = (y == x->getFather());
+        vector<double> lengths(3, max(getBranchLength_(x, y) / 2., minimumBrLen_));
+        lengths[0] = prunedLength;
+        double value = optimizeRegraftingBranches_(arrays, roots, lengths, 1, 0.1, 1);
+
+        SubtreeRearrangement move;
+        move.prunedNodeId   = nodeId;
+        move.regraftNodeId1 = x->getId();
+        move.regraftNodeId2 = y->getId();
+        move.scoreDifference = value - getValue();
+        moves.push_back(move);
+        brLenSPRValues_[getSPRKey_(move)] = lengths;
+      });
+  }
+  return moves;
+}
+
+/******************************************************************************/
+
+double SPRHomogeneousTreeLikelihood::testSPR(const SubtreeRearrangement& move) const throw (NodeException)
+{
+  const Node* pruned = tree_->getNode(move.prunedNodeId);
+  if (!pruned->hasFather()) throw NodePException("SPRHomogeneousTreeLikelihood::testSPR(). Node must not be the root node.", pruned);
+  if (move.rerootNodeId1 >= 0) throw NodePException("SPRHomogeneousTreeLikelihood::testSPR(). Rerooting of the pruned subtree is not supported.", pruned);
+  const Node* father = pruned->getFather();
+  if (father->degree() != 3) throw NodePException("SPRHomogeneousTreeLikelihood::testSPR(). Father node must have three neighbors.", father);
+  if (move.regraftNodeId1 < 0) return 0.;
+  const Node* x = tree_->getNode(move.regraftNodeId1);
+  const Node* y = tree_->getNode(move.regraftNodeId2);
+  if (x->getFather() != y && y->getFather() != x) throw NodePException("SPRHomogeneousTreeLikelihood::testSPR(). Invalid regrafting branch.", y);
+
+  // Path from the pruning point to the regrafting branch:
+  vector<const Node*> path(1, father), path2(1, x);
+  while (path.back()->hasFather()) path.push_back(path.back()->getFather());
+  while (path2.back()->hasFather()) path2.push_back(path2.back()->getFather());
+  while (path.size() > 1 && path2.size() > 1 && path[path.size() - 2] == path2[path2.size() - 2])
+  {
+    path.pop_back();
+    path2.pop_back();
+  }
+  path.insert(path.end(), path2.rbegin() + 1, path2.rend());
+  bool swapped = (path.size() > 1 && path[path.size() - 2] == y);
+  if (swapped)
+  {
+    swap(x, y);
+    path.pop_back();
+  }
+  if (path.size() < 2 || path[1] == pruned) throw NodePException("SPRHomogeneousTreeLikelihood::testSPR(). Invalid regrafting branch.", y);
+
+  // Compute the array of the remaining tree on the x side, along the path:
+  const DRASDRTreeLikelihoodNodeData* fatherData = &likelihoodData_->getNodeData(father->getId());
+  vector<const VVVdouble*> arrays(3);
+  vector<bool> roots(3, false);
+  arrays[0] = &fatherData->getLikelihoodArrayForNeighbor(pruned->getId());
+  vector<const Node*> neighbors = TreeTemplateTools::getRemainingNeighbors(father, pruned, path[1]);
+  VVVdouble tProbs;
+  model_->fillPij_t(rateDistribution_->getCategories() * getJoinedBranchLength_(father, pruned), tProbs);
+  VVVdouble fromArray = *arrays[0];
+  resetLikelihoodArray(fromArray);
+  bool xRoot = (neighbors[0] == father->getFather());
+  multiplyByNeighborArray_(fatherData->getLikelihoodArrayForNeighbor(neighbors[0]->getId()), xRoot, tProbs, fromArray);
+  VVVdouble xArray;
+  for (size_t i = 1; i < path.size(); i++)
+  {
+    const Node* to = (i + 1 < path.size() ? path[i + 1] : y);
+    xRoot = computeRemainingArray_(path[i], path[i - 1], to, fromArray, xRoot, xArray);
+    if (i + 1 < path.size())
+    {
+      resetLikelihoodArray(fromArray);
+      multiplyByNeighborArray_(xArray, xRoot, pxy_.at(to == path[i]->getFather() ? path[i]->getId() : to->getId()), fromArray);
+    }
+  }
+  arrays[1] = &xArray;
+  roots[1]  = xRoot;
+  arrays[2] = &likelihoodData_->getNodeData(x->getId()).getLikelihoodArrayForNeighbor(y->getId());
+  roots[2]  = (y == x->getFather());
+
+  // Start from the lengths found by testSPRs, if any:
+  vector<double> lengths(3, max(getBranchLength_(x, y) / 2., minimumBrLen_));
+  lengths[0] = pruned->getDistanceToFather();
+  map<vector<int>, vector<double> >::iterator it = brLenSPRValues_.find(getSPRKey_(move));
+  if (it != brLenSPRValues_.end())
+  {
+    lengths = it->second;
+    if (swapped) swap(lengths[1], lengths[2]);
+  }
+  double value = optimizeRegraftingBranches_(arrays, roots, lengths, 3, 0.001, 5);
+  if (swapped) swap(lengths[1], lengths[2]);
+  brLenSPRValues_[getSPRKey_(move)] = lengths;
+  return value - getValue();
+}
+
+/******************************************************************************/
+
+void SPRHomogeneousTreeLikelihood::doSPR(const SubtreeRearrangement& move) throw (NodeException)
+{
+  Node* pruned = tree_->getNode(move.prunedNodeId);
+  if (!pruned->hasFather()) throw NodePException("SPRHomogeneousTreeLikelihood::doSPR(). Node must not be the root node.", pruned);
+  if (move.rerootNodeId1 >= 0) throw NodePException("SPRHomogeneousTreeLikelihood::doSPR(). Rerooting of the pruned subtree is not supported.", pruned);
+  if (move.regraftNodeId1 < 0) return;
+  Node* father = pruned->getFather();
+  Node* x = tree_->getNode(move.regraftNodeId1);
+  Node* y = tree_->getNode(move.regraftNodeId2);
+  if (x->getFather() != y && y->getFather() != x) throw NodePException("SPRHomogeneousTreeLikelihood::doSPR(). Invalid regrafting branch.", y);
+  vector<const Node*> neighbors = TreeTemplateTools::getRemainingNeighbors(father, pruned, pruned);
+  Node* a = tree_->getNode(neighbors[0]->getId());
+  Node* b = tree_->getNode(neighbors[1]->getId());
+  double joinedLength = getJoinedBranchLength_(father, pruned);
+  vector<double> lengths(3, max(getBranchLength_(x, y) / 2., minimumBrLen_));
+  lengths[0] = pruned->getDistanceToFather();
+  map<vector<int>, vector<double> >::iterator it = brLenSPRValues_.find(getSPRKey_(move));
+  if (it != brLenSPRValues_.end())
+    lengths = it->second;
+
+  // Perform the topological move, and restore the root node, which is not associated to any branch length parameter:
+  Node* root = tree_->getRootNode();
+  move.apply(*tree_);
+  tree_->rootAt(root);
+  setBranchLength_(a, b, joinedLength);
+  setBranchLength_(father, pruned, lengths[0]);
+  setBranchLength_(father, x, lengths[1]);
+  setBranchLength_(father, y, lengths[2]);
+
+  // Nodes on the path to the root may have changed of branch:
+  for (size_t i = 0; i < nbNodes_; i++)
+  {
+    string name = "BrLen" + TextTools::toString(i);
+    double length = nodes_[i]->getDistanceToFather();
+    if (length == getParameterValue(name)) continue;
+    brLenParameters_.setParameterValue(name, length);
+    getParameter_(name).setValue(length);
+    if (brLenNNIParams_.hasParameter(name))
+      brLenNNIParams_.setParameterValue(name, length);
+    else
+    {
+      brLenNNIParams_.addParameter(brLenParameters_.getParameter(name));
+      // See doNNI:
+      brLenNNIParams_[brLenNNIParams_.size() - 1].removeConstraint();
+    }
+  }
+}
+
+/******************************************************************************/
+
@@ -0,0 +1,287 @@
+//
+// File: SPRHomogeneousTreeLikelihood.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#ifndef _SPRHOMOGENEOUSTREELIKELIHOOD_H_
+#define _SPRHOMOGENEOUSTREELIKELIHOOD_H_
+
+#include "NNIHomogeneousTreeLikelihood.h"
+#include "../SPRSearchable.h"
+
+// From the STL:
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief This class adds support for SPR topology estimation to the NNIHomogeneousTreeLikelihood class.
+ *
+ * SPRs are scored from the double-recursive arrays of the current tree:
+ * the arrays of the remaining tree pointing toward the pruning point are computed incrementally
+ * while visiting the regrafting branches at increasing distances,
+ * so that no full likelihood computation is needed.
+ *
+ * - testSPRs() splits each regrafting branch in two halves, and only optimizes (roughly)
+ *   the length of the branch leading to the pruned subtree.
+ * - testSPR() optimizes the three branches around the regrafting point in turn, until convergence.
+ *
+ * All other branch lengths, and the substitution model and rate distribution parameters, are kept at their current value.
+ * The branch joining the two remaining neighbors of the pruning point gets the sum of their lengths.
+ * The score variations returned are hence exact for the branch lengths found,
+ * which are the ones used when the SPR is performed.
+ *
+ * A reversible substitution model is assumed.
+ */
+class SPRHomogeneousTreeLikelihood :
+  public NNIHomogeneousTreeLikelihood,
+  public virtual SPRSearchable
+{
+protected:
+  /**
+   * @brief Branch lengths found when testing SPRs.
+   *
+   * Keys are the pruned node id and the two ids of the regrafting branch.
+   * Values are the lengths of the branches to the pruned node and to the two regrafting nodes.
+   */
+  mutable std::map<std::vector<int>, std::vector<double> > brLenSPRValues_;
+
+public:
+  /**
+   * @brief Build a new SPRHomogeneousTreeLikelihood object.
+   *
+   * @param tree The tree to use.
+   * @param model The substitution model to use.
+   * @param rDist The rate across sites distribution to use.
+   * @param checkRooted Tell if we have to check for the tree to be unrooted.
+   * If true, any rooted tree will be unrooted before likelihood computation.
+   * @param verbose Should I display some info?
+   * @throw Exception in an error occured.
+   */
+  SPRHomogeneousTreeLikelihood(
+    const Tree& tree,
+    TransitionModel* model,
+    DiscreteDistribution* rDist,
+    bool checkRooted = true,
+    bool verbose = true)
+  throw (Exception);
+
+  /**
+   * @brief Build a new SPRHomogeneousTreeLikelihood object.
+   *
+   * @param tree The tree to use.
+   * @param data Sequences to use.
+   * @param model The substitution model to use.
+   * @param rDist The rate across sites distribution to use.
+   * @param checkRooted Tell if we have to check for the tree to be unrooted.
+   * If true, any rooted tree will be unrooted before likelihood computation.
+   * @param verbose Should I display some info?
+   * @throw Exception in an error occured.
+   */
+  SPRHomogeneousTreeLikelihood(
+    const Tree& tree,
+    const SiteContainer& data,
+    TransitionModel* model,
+    DiscreteDistribution* rDist,
+    bool checkRooted = true,
+    bool verbose = true)
+  throw (Exception);
+
+  SPRHomogeneousTreeLikelihood(const SPRHomogeneousTreeLikelihood& lik) :
+    NNIHomogeneousTreeLikelihood(lik),
+    brLenSPRValues_(lik.brLenSPRValues_)
+  {}
+
+  SPRHomogeneousTreeLikelihood& operator=(const SPRHomogeneousTreeLikelihood& lik)
+  {
+    NNIHomogeneousTreeLikelihood::operator=(lik);
+    brLenSPRValues_ = lik.brLenSPRValues_;
+    return *this;
+  }
+
+  virtual ~SPRHomogeneousTreeLikelihood() {}
+
+  SPRHomogeneousTreeLikelihood* clone() const { return new SPRHomogeneousTreeLikelihood(*this); }
+
+public:
+  /**
+   * @name The SPRSearchable interface.
+   *
+   * Only SPRs are supported: the rerooting branch of the movements must not be set.
+   * @{
+   */
+  std::vector<SubtreeRearrangement> testSPRs(int nodeId, unsigned int radius) const throw (NodeException);
+
+  double testSPR(const SubtreeRearrangement& move) const throw (NodeException);
+
+  void doSPR(const SubtreeRearrangement& move) throw (NodeException);
+
+  const Tree& getTopology() const { return getTree(); }
+
+  double getTopologyValue() const throw (Exception) { return getValue(); }
+
+  void topologyChangeSuccessful(const TopologyChangeEvent& event)
+  {
+    NNIHomogeneousTreeLikelihood::topologyChangeSuccessful(event);
+    brLenSPRValues_.clear();
+  }
+  /** @} */
+
+protected:
+  /**
+   * @brief Multiply an array by the likelihood arrays of a neighbor, conditioned on the states of the node.
+   *
+   * @param iLik     The likelihood array at the neighbor.
+   * @param rootSide Tell if iLik contains the root frequencies, in which case the transition probabilities are used backward.
+   * @param tProb    The transition probabilities of the branch between the node and the neighbor.
+   * @param oLik     The array to update.
+   */
+  void multiplyByNeighborArray_(const VVVdouble& iLik, bool rootSide, const VVVdouble& tProb, VVVdouble& oLik) const;
+
+  /**
+   * @brief Multiply an array by the root frequencies.
+   */
+  void multiplyByRootFrequencies_(VVVdouble& array) const;
+
+  /**
+   * @brief Compute the conditional likelihoods at a node of the remaining tree, for the subtree not containing a given neighbor.
+   *
+   * @param node      The node.
+   * @param from      The neighbor on the side of the pruning point.
+   * @param to        The neighbor to exclude.
+   * @param fromArray The likelihoods of the subtree on the from side, already multiplied by the transition probabilities.
+   * @param fromRoot  Tell if fromArray contains the root frequencies.
+   * @param array     [out] The likelihoods of the subtree.
+   * @return True if the array contains the root frequencies.
+   */
+  bool computeRemainingArray_(const Node* node, const Node* from, const Node* to, const VVVdouble& fromArray, bool fromRoot, VVVdouble& array) const;
+
+  /**
+   * @brief Visit all branches within a given radius in the remaining tree, with the arrays toward the pruning point.
+   *
+   * For each branch (x, y), y being farther from the pruning point, f(x, y, array, rootSide) is called,
+   * where array holds the likelihoods of the subtree on the x side of the branch, at node x.
+   *
+   * @param node      The node to start from.
+   * @param from      The neighbor of node not to visit.
+   * @param fromArray The likelihoods of the subtree on the from side, already multiplied by the transition probabilities.
+   * @param fromRoot  Tell if fromArray contains the root frequencies.
+   * @param depth     The distance of the branches of node.
+   * @param radius    The maximum distance.
+   * @param f         The function to call on each branch.
+   */
+  void visitBranches_(
+    const Node* node,
+    const Node* from,
+    const VVVdouble& fromArray,
+    bool fromRoot,
+    unsigned int depth,
+    unsigned int radius,
+    const std::function<void (const Node*, const Node*, const VVVdouble&, bool)>& f) const;
+
+  /**
+   * @brief Optimize the length of a branch, given the likelihoods of the two subtrees it separates.
+   *
+   * @param array1    The likelihoods on one side of the branch, which must contain the root frequencies.
+   * @param array2    The likelihoods on the other side of the branch.
+   * @param length    [in,out] The length of the branch.
+   * @param tolerance The tolerance of the optimization.
+   * @return The negative log-likelihood for the length found.
+   */
+  double optimizeBranchLength_(const VVVdouble& array1, const VVVdouble& array2, double& length, double tolerance) const;
+
+  /**
+   * @brief Optimize the lengths of the branches around a regrafting point, in turn.
+   *
+   * @param arrays    The likelihoods of the pruned subtree, at its root,
+   * and of the two sides of the regrafting branch, at its two nodes.
+   * @param roots     Tell for each array if it contains the root frequencies.
+   * @param lengths   [in,out] The lengths of the branches from the regrafting point to each array.
+   * @param nbBranches The number of branches to optimize, starting from the one to the pruned subtree.
+   * @param tolerance The tolerance of the optimizations.
+   * @param nbRounds  The maximum number of rounds, which stop when the improvement is lower than the tolerance.
+   * @return The negative log-likelihood for the lengths found.
+   */
+  double optimizeRegraftingBranches_(
+    const std::vector<const VVVdouble*>& arrays,
+    const std::vector<bool>& roots,
+    std::vector<double>& lengths,
+    size_t nbBranches,
+    double tolerance,
+    unsigned int nbRounds) const;
+
+  /**
+   * @return The key of a SPR in brLenSPRValues_.
+   */
+  static std::vector<int> getSPRKey_(const SubtreeRearrangement& move)
+  {
+    std::vector<int> key(3);
+    key[0] = move.prunedNodeId;
+    key[1] = move.regraftNodeId1;
+    key[2] = move.regraftNodeId2;
+    return key;
+  }
+
+  /**
+   * @return The length of the branch between two neighbor nodes.
+   */
+  static double getBranchLength_(const Node* node1, const Node* node2)
+  {
+    return node1->getFather() == node2 ? node1->getDistanceToFather() : node2->getDistanceToFather();
+  }
+
+  /**
+   * @brief Set the length of the branch between two neighbor nodes.
+   */
+  static void setBranchLength_(Node* node1, Node* node2, double length)
+  {
+    if (node1->getFather() == node2) node1->setDistanceToFather(length);
+    else node2->setDistanceToFather(length);
+  }
+
+  /**
+   * @return The length of the branch joining the two remaining neighbors of the pruning point.
+   */
+  double getJoinedBranchLength_(const Node* father, const Node* pruned) const;
+};
+} // end of namespace bpp.
+
+#endif  // _SPRHOMOGENEOUSTREELIKELIHOOD_H_
+
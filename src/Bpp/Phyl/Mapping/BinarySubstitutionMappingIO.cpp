@@ -0,0 +1,254 @@
+//
+// File: BinarySubstitutionMappingIO.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "BinarySubstitutionMappingIO.h"
+#include "../Io/BinaryIOTools.h"
+#include "../Io/OutputStreamTools.h"
+
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <cstdint>
+
+using namespace std;
+
+/******************************************************************************/
+
+namespace
+{
+  const char MAGIC[BinaryIOTools::MAGIC_SIZE] = { 'B', 'P', 'P', 'S', 'M', 'A', 'P', '1' };
+
+  size_t getPadding_(size_t nbBranches, size_t nbSites)
+  {
+    return ((nbBranches + nbSites) % 2) * sizeof(int32_t);
+  }
+}
+
+/******************************************************************************/
+
+size_t BinarySubstitutionMappingFormat::getDataOffset(size_t nbBranches, size_t nbSites)
+{
+  return BinaryIOTools::HEADER_SIZE + sizeof(uint32_t) + 3 * sizeof(uint64_t)
+         + (nbBranches + nbSites) * sizeof(int32_t) + getPadding_(nbBranches, nbSites);
+}
+
+/******************************************************************************/
+
+BinarySubstitutionMappingWriter::BinarySubstitutionMappingWriter(
+  ostream& out,
+  const vector<int>& nodeIds,
+  const vector<int>& sitePositions,
+  size_t nbTypes) throw (IOException) :
+  out_(out),
+  start_(out.tellp()),
+  nodeIds_(nodeIds),
+  nbSites_(sitePositions.size()),
+  nbTypes_(nbTypes),
+  mutex_()
+{
+  if (!out_)
+    throw IOException("BinarySubstitutionMappingWriter. Can't write to stream.");
+  BinaryIOTools::writeHeader(out_, MAGIC);
+  BinaryIOTools::writeValue<uint32_t>(out_, 0);
+  BinaryIOTools::writeValue<uint64_t>(out_, nodeIds_.size());
+  BinaryIOTools::writeValue<uint64_t>(out_, nbSites_);
+  BinaryIOTools::writeValue<uint64_t>(out_, nbTypes_);
+  for (size_t j = 0; j < nodeIds_.size(); ++j)
+  {
+    BinaryIOTools::writeValue<int32_t>(out_, nodeIds_[j]);
+  }
+  for (size_t i = 0; i < nbSites_; ++i)
+  {
+    BinaryIOTools::writeValue<int32_t>(out_, sitePositions[i]);
+  }
+  if (getPadding_(nodeIds_.size(), nbSites_) > 0)
+    BinaryIOTools::writeValue<int32_t>(out_, 0);
+  if (!out_)
+    throw IOException("BinarySubstitutionMappingWriter. Could not write header.");
+}
+
+/******************************************************************************/
+
+size_t BinarySubstitutionMappingWriter::getBranchIndex(int nodeId) const throw (NodeNotFoundException)
+{
+  for (size_t j = 0; j < nodeIds_.size(); ++j)
+  {
+    if (nodeIds_[j] == nodeId)
+      return j;
+  }
+  throw NodeNotFoundException("BinarySubstitutionMappingWriter::getBranchIndex.", TextTools::toString(nodeId));
+}
+
+/******************************************************************************/
+
+void BinarySubstitutionMappingWriter::writeBranch(size_t branchIndex, const VVdouble& counts) throw (Exception)
+{
+  if (branchIndex >= nodeIds_.size())
+    throw IndexOutOfBoundsException("BinarySubstitutionMappingWriter::writeBranch. Bad branch index.", branchIndex, 0, nodeIds_.size() - 1);
+  if (counts.size() != nbTypes_)
+    throw DimensionException("BinarySubstitutionMappingWriter::writeBranch. Bad number of types.", counts.size(), nbTypes_);
+  for (size_t t = 0; t < nbTypes_; ++t)
+  {
+    if (counts[t].size() != nbSites_)
+      throw DimensionException("BinarySubstitutionMappingWriter::writeBranch. Bad number of sites.", counts[t].size(), nbSites_);
+  }
+
+  lock_guard<mutex> lock(mutex_);
+  size_t offset = BinarySubstitutionMappingFormat::getDataOffset(nodeIds_.size(), nbSites_)
+                  + BinarySubstitutionMappingFormat::getCountOffset(nbSites_, nbTypes_, branchIndex, 0, 0);
+  OutputStreamTools::seekOrExtend(out_, start_, offset);
+  for (size_t t = 0; nbSites_ > 0 && t < nbTypes_; ++t)
+  {
+    out_.write(reinterpret_cast<const char*>(&counts[t][0]), static_cast<streamsize>(nbSites_ * sizeof(double)));
+  }
+  if (!out_)
+    throw IOException("BinarySubstitutionMappingWriter::writeBranch. Could not write branch " + TextTools::toString(branchIndex) + ".");
+}
+
+/******************************************************************************/
+
+BinarySubstitutionMappingReader::BinarySubstitutionMappingReader(istream& in) throw (IOException) :
+  in_(in),
+  start_(in.tellg()),
+  nodeIds_(),
+  sitePositions_(),
+  nbTypes_(0)
+{
+  BinaryIOTools::readHeader(in_, MAGIC, "BinarySubstitutionMappingReader", "binary substitution mapping");
+  BinaryIOTools::readValue<uint32_t>(in_);
+  size_t nbBranches = static_cast<size_t>(BinaryIOTools::readValue<uint64_t>(in_));
+  size_t nbSites = static_cast<size_t>(BinaryIOTools::readValue<uint64_t>(in_));
+  nbTypes_ = static_cast<size_t>(BinaryIOTools::readValue<uint64_t>(in_));
+  if (!in_)
+    throw IOException("BinarySubstitutionMappingReader. Truncated header.");
+  nodeIds_.resize(nbBranches);
+  for (size_t j = 0; j < nbBranches; ++j)
+  {
+    nodeIds_[j] = BinaryIOTools::readValue<int32_t>(in_);
+  }
+  sitePositions_.resize(nbSites);
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    sitePositions_[i] = BinaryIOTools::readValue<int32_t>(in_);
+  }
+  if (!in_)
+    throw IOException("BinarySubstitutionMappingReader. Truncated header.");
+}
+
+/******************************************************************************/
+
+size_t BinarySubstitutionMappingReader::getBranchIndex(int nodeId) const throw (NodeNotFoundException)
+{
+  for (size_t j = 0; j < nodeIds_.size(); ++j)
+  {
+    if (nodeIds_[j] == nodeId)
+      return j;
+  }
+  throw NodeNotFoundException("BinarySubstitutionMappingReader::getBranchIndex.", TextTools::toString(nodeId));
+}
+
+/******************************************************************************/
+
+void BinarySubstitutionMappingReader::seek_(size_t offset) throw (IOException)
+{
+  in_.clear();
+  in_.seekg(start_ + static_cast<streamoff>(BinarySubstitutionMappingFormat::getDataOffset(nodeIds_.size(), sitePositions_.size()) + offset));
+  if (!in_)
+    throw IOException("BinarySubstitutionMappingReader. Could not seek in stream.");
+}
+
+/******************************************************************************/
+
+void BinarySubstitutionMappingReader::readCounts(size_t branchIndex, size_t type, size_t firstSite, size_t nbSites, Vdouble& counts) throw (Exception)
+{
+  if (branchIndex >= nodeIds_.size())
+    throw IndexOutOfBoundsException("BinarySubstitutionMappingReader::readCounts. Bad branch index.", branchIndex, 0, nodeIds_.size() - 1);
+  if (type >= nbTypes_)
+    throw IndexOutOfBoundsException("BinarySubstitutionMappingReader::readCounts. Bad substitution type.", type, 0, nbTypes_ - 1);
+  if (firstSite + nbSites > sitePositions_.size())
+    throw IndexOutOfBoundsException("BinarySubstitutionMappingReader::readCounts. Bad site range.", firstSite + nbSites, 0, sitePositions_.size());
+  counts.resize(nbSites);
+  if (nbSites == 0)
+    return;
+  seek_(BinarySubstitutionMappingFormat::getCountOffset(sitePositions_.size(), nbTypes_, branchIndex, type, firstSite));
+  in_.read(reinterpret_cast<char*>(&counts[0]), static_cast<streamsize>(nbSites * sizeof(double)));
+  if (!in_)
+    throw IOException("BinarySubstitutionMappingReader::readCounts. Could not read branch " + TextTools::toString(branchIndex) + ".");
+}
+
+/******************************************************************************/
+
+void BinarySubstitutionMappingReader::readBranch(size_t branchIndex, VVdouble& counts) throw (Exception)
+{
+  counts.resize(nbTypes_);
+  for (size_t t = 0; t < nbTypes_; ++t)
+  {
+    readCounts(branchIndex, t, 0, sitePositions_.size(), counts[t]);
+  }
+}
+
+/******************************************************************************/
+
+void BinarySubstitutionMappingReader::readMapping(ProbabilisticSubstitutionMapping& mapping) throw (Exception)
+{
+  if (mapping.getNumberOfSubstitutionTypes() != nbTypes_)
+    throw DimensionException("BinarySubstitutionMappingReader::readMapping. Bad number of substitution types.", mapping.getNumberOfSubstitutionTypes(), nbTypes_);
+  size_t nbSites = sitePositions_.size();
+  mapping.setNumberOfSites(nbSites);
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    mapping.setSitePosition(i, sitePositions_[i]);
+  }
+  VVdouble counts;
+  for (size_t j = 0; j < nodeIds_.size(); ++j)
+  {
+    size_t br = mapping.getNodeIndex(nodeIds_[j]);
+    readBranch(j, counts);
+    for (size_t t = 0; t < nbTypes_; ++t)
+    {
+      for (size_t i = 0; i < nbSites; ++i)
+      {
+        mapping(br, i, t) = counts[t][i];
+      }
+    }
+  }
+}
+
@@ -0,0 +1,232 @@
+//
+// File: BinarySubstitutionMappingIO.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef _BINARYSUBSTITUTIONMAPPINGIO_H_
+#define _BINARYSUBSTITUTIONMAPPINGIO_H_
+
+#include "ProbabilisticSubstitutionMapping.h"
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/VectorTools.h>
+
+// From the STL:
+#include <iostream>
+#include <vector>
+#include <mutex>
+
+namespace bpp
+{
+/**
+ * @brief Columnar binary format for probabilistic substitution mappings.
+ *
+ * The file starts with a fixed header:
+ * - the magic string "BPPSMAP1" (8 bytes),
+ * - the 32 bits integer 0x01020304, used to check the byte order,
+ *   followed by 4 reserved bytes,
+ * - the numbers of branches, sites and substitution types, as 64 bits
+ *   unsigned integers,
+ * - the node ids of the branches and the site positions, as 32 bits
+ *   integers, padded with zeros to a multiple of 8 bytes.
+ *
+ * Counts follow as doubles, by branch, then by type, then by site, so
+ * that the counts of a given type on a branch for a range of sites are
+ * contiguous. All values are stored with the byte order of the machine.
+ * As all offsets are fixed by the header, the data part can also be
+ * memory-mapped, starting at getDataOffset().
+ */
+class BinarySubstitutionMappingFormat
+{
+public:
+  /**
+   * @return The offset of the counts with respect to the start of the
+   * file.
+   */
+  static size_t getDataOffset(size_t nbBranches, size_t nbSites);
+
+  /**
+   * @return The offset of the counts of a given branch and type for a
+   * given site, with respect to the start of the counts.
+   */
+  static size_t getCountOffset(size_t nbSites, size_t nbTypes, size_t branchIndex, size_t type, size_t siteIndex)
+  {
+    return ((branchIndex * nbTypes + type) * nbSites + siteIndex) * sizeof(double);
+  }
+};
+
+/**
+ * @brief Write a probabilistic substitution mapping in the binary
+ * columnar format, branch by branch.
+ *
+ * The header is written on construction. Branches can then be written
+ * in any order, and from several threads: when a branch starts after
+ * the current end of the stream, the gap is first filled with zeros,
+ * to be overwritten by the missing branches.
+ *
+ * @see BinarySubstitutionMappingFormat
+ */
+class BinarySubstitutionMappingWriter
+{
+private:
+  std::ostream& out_;
+  std::streampos start_;
+  std::vector<int> nodeIds_;
+  size_t nbSites_;
+  size_t nbTypes_;
+  std::mutex mutex_;
+
+public:
+  /**
+   * @param out The stream to write to.
+   * @param nodeIds The ids of the nodes of the branches to write.
+   * @param sitePositions The positions of the sites.
+   * @param nbTypes The number of substitution types.
+   * @throw IOException If the header could not be written.
+   */
+  BinarySubstitutionMappingWriter(
+    std::ostream& out,
+    const std::vector<int>& nodeIds,
+    const std::vector<int>& sitePositions,
+    size_t nbTypes) throw (IOException);
+
+  virtual ~BinarySubstitutionMappingWriter() {}
+
+public:
+  size_t getNumberOfBranches() const { return nodeIds_.size(); }
+  size_t getNumberOfSites() const { return nbSites_; }
+  size_t getNumberOfSubstitutionTypes() const { return nbTypes_; }
+
+  /**
+   * @return The index of the branch leading to a given node.
+   * @throw NodeNotFoundException If no branch leads to this node.
+   */
+  size_t getBranchIndex(int nodeId) const throw (NodeNotFoundException);
+
+  /**
+   * @brief Write the counts of a branch.
+   *
+   * @param branchIndex The index of the branch.
+   * @param counts The counts, indexed by type then by site.
+   * @throw Exception If the index or the dimensions are wrong, or
+   * if writing failed.
+   */
+  void writeBranch(size_t branchIndex, const VVdouble& counts) throw (Exception);
+};
+
+/**
+ * @brief Read a probabilistic substitution mapping written in the
+ * binary columnar format.
+ *
+ * Only the header is read on construction: counts are then read
+ * selectively, by branch, type and range of sites.
+ *
+ * @see BinarySubstitutionMappingFormat
+ */
+class BinarySubstitutionMappingReader
+{
+private:
+  std::istream& in_;
+  std::streampos start_;
+  std::vector<int> nodeIds_;
+  std::vector<int> sitePositions_;
+  size_t nbTypes_;
+
+public:
+  /**
+   * @param in The stream to read from.
+   * @throw IOException If the header is not valid.
+   */
+  BinarySubstitutionMappingReader(std::istream& in) throw (IOException);
+
+  virtual ~BinarySubstitutionMappingReader() {}
+
+public:
+  size_t getNumberOfBranches() const { return nodeIds_.size(); }
+  size_t getNumberOfSites() const { return sitePositions_.size(); }
+  size_t getNumberOfSubstitutionTypes() const { return nbTypes_; }
+  const std::vector<int>& getNodeIds() const { return nodeIds_; }
+  const std::vector<int>& getSitePositions() const { return sitePositions_; }
+
+  /**
+   * @return The index of the branch leading to a given node.
+   * @throw NodeNotFoundException If no branch leads to this node.
+   */
+  size_t getBranchIndex(int nodeId) const throw (NodeNotFoundException);
+
+  /**
+   * @brief Read the counts of a given type on a branch, for a range of
+   * sites.
+   *
+   * @param branchIndex The index of the branch.
+   * @param type The substitution type (starting from 0).
+   * @param firstSite The index of the first site to read.
+   * @param nbSites The number of sites to read.
+   * @param counts The vector where to store the counts.
+   * @throw Exception If the indices are wrong or if reading failed.
+   */
+  void readCounts(size_t branchIndex, size_t type, size_t firstSite, size_t nbSites, Vdouble& counts) throw (Exception);
+
+  /**
+   * @brief Read all counts of a branch.
+   *
+   * @param branchIndex The index of the branch.
+   * @param counts The counts, indexed by type then by site.
+   * @throw Exception If the index is wrong or if reading failed.
+   */
+  void readBranch(size_t branchIndex, VVdouble& counts) throw (Exception);
+
+  /**
+   * @brief Read the whole file into a mapping.
+   *
+   * The mapping must be built on a tree with the same node ids, and
+   * with the same number of substitution types.
+   *
+   * @param mapping The mapping to fill.
+   * @throw Exception If the mapping does not match the file or if
+   * reading failed.
+   */
+  void readMapping(ProbabilisticSubstitutionMapping& mapping) throw (Exception);
+
+private:
+  void seek_(size_t offset) throw (IOException);
+};
+
+} // end of namespace bpp.
+
+#endif // _BINARYSUBSTITUTIONMAPPINGIO_H_
+
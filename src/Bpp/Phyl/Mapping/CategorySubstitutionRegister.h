@@ -108,6 +108,7 @@ namespace bpp
     template<class T>
     void setModelCategories(const std::map<size_t, T>& categories)
     {
+      resetTypeTable_();
       // First index categories:
       nbCategories_ = 0;
       std::map<T, size_t> cats;
@@ -0,0 +1,199 @@
+//
+// File: CompactProbabilisticSubstitutionMapping.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "CompactProbabilisticSubstitutionMapping.h"
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+CompactProbabilisticSubstitutionMapping::CompactProbabilisticSubstitutionMapping(
+  const Tree& tree,
+  const SubstitutionCount* sc,
+  size_t numberOfSites,
+  double threshold) throw (Exception) :
+  AbstractMapping(tree), AbstractSubstitutionMapping(tree),
+  substitutionCount_(sc),
+  threshold_(threshold),
+  values_(),
+  sparsePositions_(),
+  sparseValues_()
+{
+  setNumberOfSites(numberOfSites);
+}
+
+void CompactProbabilisticSubstitutionMapping::resetValues_()
+{
+  size_t nbBranches = getNumberOfBranches();
+  size_t nbSites = getNumberOfSites();
+  size_t nbTypes = getNumberOfSubstitutionTypes();
+  if (isSparse())
+  {
+    if (nbSites * nbTypes > static_cast<size_t>(numeric_limits<uint32_t>::max()))
+      throw Exception("CompactProbabilisticSubstitutionMapping. Too many sites and types for the sparse mode.");
+    values_.clear();
+    sparsePositions_.assign(nbBranches, vector<uint32_t>());
+    sparseValues_.assign(nbBranches, vector<float>());
+  }
+  else
+  {
+    values_.assign(nbBranches * nbSites * nbTypes, 0.f);
+    sparsePositions_.clear();
+    sparseValues_.clear();
+  }
+}
+
+void CompactProbabilisticSubstitutionMapping::setTree(const Tree& tree)
+{
+  AbstractSubstitutionMapping::setTree(tree);
+  resetValues_();
+}
+
+void CompactProbabilisticSubstitutionMapping::setNumberOfSites(size_t numberOfSites)
+{
+  AbstractSubstitutionMapping::setNumberOfSites(numberOfSites);
+  resetValues_();
+}
+
+size_t CompactProbabilisticSubstitutionMapping::getNumberOfStoredValues() const
+{
+  if (!isSparse())
+    return values_.size();
+  size_t n = 0;
+  for (size_t j = 0; j < sparseValues_.size(); ++j)
+  {
+    n += sparseValues_[j].size();
+  }
+  return n;
+}
+
+double CompactProbabilisticSubstitutionMapping::getCount(size_t nodeIndex, size_t siteIndex, size_t type) const
+{
+  size_t nbTypes = getNumberOfSubstitutionTypes();
+  if (!isSparse())
+    return values_[(nodeIndex * getNumberOfSites() + siteIndex) * nbTypes + type];
+  const vector<uint32_t>& positions = sparsePositions_[nodeIndex];
+  uint32_t pos = static_cast<uint32_t>(siteIndex * nbTypes + type);
+  vector<uint32_t>::const_iterator it = lower_bound(positions.begin(), positions.end(), pos);
+  if (it == positions.end() || *it != pos)
+    return 0.;
+  return sparseValues_[nodeIndex][static_cast<size_t>(it - positions.begin())];
+}
+
+void CompactProbabilisticSubstitutionMapping::setCount(size_t nodeIndex, size_t siteIndex, size_t type, double value)
+{
+  size_t nbTypes = getNumberOfSubstitutionTypes();
+  if (!isSparse())
+  {
+    values_[(nodeIndex * getNumberOfSites() + siteIndex) * nbTypes + type] = static_cast<float>(value);
+    return;
+  }
+  vector<uint32_t>& positions = sparsePositions_[nodeIndex];
+  vector<float>& values = sparseValues_[nodeIndex];
+  uint32_t pos = static_cast<uint32_t>(siteIndex * nbTypes + type);
+  vector<uint32_t>::iterator it = lower_bound(positions.begin(), positions.end(), pos);
+  vector<float>::iterator vit = values.begin() + (it - positions.begin());
+  bool stored = (it != positions.end() && *it == pos);
+  if (abs(value) > threshold_)
+  {
+    if (stored)
+      *vit = static_cast<float>(value);
+    else
+    {
+      positions.insert(it, pos);
+      values.insert(vit, static_cast<float>(value));
+    }
+  }
+  else if (stored)
+  {
+    positions.erase(it);
+    values.erase(vit);
+  }
+}
+
+void CompactProbabilisticSubstitutionMapping::setBranch(size_t nodeIndex, const VVdouble& counts) throw (DimensionException)
+{
+  size_t nbSites = getNumberOfSites();
+  size_t nbTypes = getNumberOfSubstitutionTypes();
+  if (counts.size() != nbSites)
+    throw DimensionException("CompactProbabilisticSubstitutionMapping::setBranch. Bad number of sites.", counts.size(), nbSites);
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    if (counts[i].size() != nbTypes)
+      throw DimensionException("CompactProbabilisticSubstitutionMapping::setBranch. Bad number of types.", counts[i].size(), nbTypes);
+  }
+
+  if (!isSparse())
+  {
+    float* values = &values_[nodeIndex * nbSites * nbTypes];
+    for (size_t i = 0; i < nbSites; ++i)
+    {
+      for (size_t t = 0; t < nbTypes; ++t)
+      {
+        values[i * nbTypes + t] = static_cast<float>(counts[i][t]);
+      }
+    }
+    return;
+  }
+
+  vector<uint32_t>& positions = sparsePositions_[nodeIndex];
+  vector<float>& values = sparseValues_[nodeIndex];
+  positions.clear();
+  values.clear();
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    for (size_t t = 0; t < nbTypes; ++t)
+    {
+      if (abs(counts[i][t]) > threshold_)
+      {
+        positions.push_back(static_cast<uint32_t>(i * nbTypes + t));
+        values.push_back(static_cast<float>(counts[i][t]));
+      }
+    }
+  }
+  // Release the memory of the previous content, if any:
+  positions.shrink_to_fit();
+  values.shrink_to_fit();
+}
+
@@ -0,0 +1,189 @@
+//
+// File: CompactProbabilisticSubstitutionMapping.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef _COMPACTPROBABILISTICSUBSTITUTIONMAPPING_H_
+#define _COMPACTPROBABILISTICSUBSTITUTIONMAPPING_H_
+
+#include "SubstitutionMapping.h"
+#include "SubstitutionCount.h"
+
+#include <Bpp/Numeric/VectorTools.h>
+
+// From the STL:
+#include <vector>
+#include <cstdint>
+
+namespace bpp
+{
+
+/**
+ * @brief Memory-efficient storage for probabilistic substitution mappings.
+ *
+ * This class stores the same data as ProbabilisticSubstitutionMapping,
+ * in single precision. Two storage modes are available:
+ * - dense, where all values are stored in one contiguous array of floats,
+ *   by branch, then site, then type;
+ * - sparse, where only values above a given threshold (in absolute value)
+ *   are stored, branch by branch, together with their site and type. Other
+ *   values are read as 0.
+ *
+ * The sparse mode is chosen by giving a non-negative threshold. It is useful
+ * when most counts are close to 0, as for instance nonsynonymous counts on
+ * conserved sites. Setting single values in sparse mode costs a linear time
+ * in the number of values stored for the branch, so mappings are better
+ * filled branch by branch, with setBranch.
+ *
+ * Values are accessed with getCount and setCount, so that all tools working
+ * on SubstitutionMapping objects can use this storage.
+ */
+class CompactProbabilisticSubstitutionMapping:
+  public AbstractSubstitutionMapping
+{
+  private:
+    const SubstitutionCount* substitutionCount_;
+    double threshold_;
+
+    /**
+     * @brief Dense storage, by branch, site and type.
+     */
+    std::vector<float> values_;
+
+    /**
+     * @brief Sparse storage: for each branch, the sorted positions
+     * (site * number of types + type) of the values stored, and the values.
+     */
+    std::vector< std::vector<uint32_t> > sparsePositions_;
+    std::vector< std::vector<float> > sparseValues_;
+
+  public:
+    /**
+     * @brief Build a new CompactProbabilisticSubstitutionMapping object.
+     *
+     * @param tree The tree object to use. It will be cloned for internal use.
+     * @param sc A pointer toward the substitution count object that has been used for the mapping, if any.
+     * @param numberOfSites The number of sites to map.
+     * @param threshold If negative, values are stored densely. Otherwise, only values
+     * whose absolute value is greater than the threshold are stored.
+     * @throw Exception If the sparse mode is used with too many sites and types.
+     */
+    CompactProbabilisticSubstitutionMapping(const Tree& tree, const SubstitutionCount* sc, size_t numberOfSites, double threshold = -1) throw (Exception);
+
+    CompactProbabilisticSubstitutionMapping* clone() const { return new CompactProbabilisticSubstitutionMapping(*this); }
+
+    CompactProbabilisticSubstitutionMapping(const CompactProbabilisticSubstitutionMapping& cpsm):
+      AbstractMapping(cpsm), AbstractSubstitutionMapping(cpsm),
+      substitutionCount_(cpsm.substitutionCount_),
+      threshold_(cpsm.threshold_),
+      values_(cpsm.values_),
+      sparsePositions_(cpsm.sparsePositions_),
+      sparseValues_(cpsm.sparseValues_)
+    {}
+
+    CompactProbabilisticSubstitutionMapping& operator=(const CompactProbabilisticSubstitutionMapping& cpsm)
+    {
+      AbstractSubstitutionMapping::operator=(cpsm);
+      substitutionCount_ = cpsm.substitutionCount_;
+      threshold_         = cpsm.threshold_;
+      values_            = cpsm.values_;
+      sparsePositions_   = cpsm.sparsePositions_;
+      sparseValues_      = cpsm.sparseValues_;
+      return *this;
+    }
+
+    virtual ~CompactProbabilisticSubstitutionMapping() {}
+
+  public:
+    size_t getNumberOfSubstitutionTypes() const
+    {
+      if (!substitutionCount_) return 1;
+      return substitutionCount_->getNumberOfSubstitutionTypes();
+    }
+
+    /**
+     * @return True if values are stored sparsely.
+     */
+    bool isSparse() const { return threshold_ >= 0; }
+
+    /**
+     * @return The threshold used in sparse mode (negative in dense mode).
+     */
+    double getThreshold() const { return threshold_; }
+
+    /**
+     * @return The number of values actually stored.
+     */
+    size_t getNumberOfStoredValues() const;
+
+    double getCount(size_t nodeIndex, size_t siteIndex, size_t type) const;
+
+    void setCount(size_t nodeIndex, size_t siteIndex, size_t type, double value);
+
+    /**
+     * @brief Set all values of a branch at once.
+     *
+     * Distinct branches can be set concurrently from several threads.
+     *
+     * @param nodeIndex The index of the branch.
+     * @param counts The counts for this branch, indexed by site then by type.
+     * @throw DimensionException If counts does not have the expected dimensions.
+     */
+    void setBranch(size_t nodeIndex, const VVdouble& counts) throw (DimensionException);
+
+    /**
+     * @brief (Re)-set the phylogenetic tree associated to this mapping.
+     *
+     * All values are reset to 0.
+     *
+     * @param tree The new tree.
+     */
+    virtual void setTree(const Tree& tree);
+
+    /**
+     * @brief Set the number of sites. All values are reset to 0.
+     */
+    virtual void setNumberOfSites(size_t numberOfSites);
+
+  private:
+    void resetValues_();
+};
+
+} //end of namespace bpp.
+
+#endif //_COMPACTPROBABILISTICSUBSTITUTIONMAPPING_H_
+
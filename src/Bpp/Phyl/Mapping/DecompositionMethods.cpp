@@ -42,6 +42,8 @@
 #include <Bpp/Numeric/Matrix/MatrixTools.h>
 
 #include <vector>
+#include <map>
+#include <cmath>
 #include <typeinfo>
 
 using namespace std;
@@ -212,6 +214,99 @@ void DecompositionMethods::computeExpectations(std::vector< RowMatrix<double> >&
 } 
 
 
+void DecompositionMethods::computeExpectations(const std::vector<double>& lengths, std::vector< std::vector< RowMatrix<double> > >& mappings) const
+{
+  bool diagonalizable = model_->isDiagonalizable();
+  if (!diagonalizable && !model_->isNonSingular())
+    throw Exception("void DecompositionMethods::computeExpectations : substitution mapping is not implemented for singular generators.");
+
+  const vector<double>& lambda = model_->getEigenValues();
+  vector<double> ilambda(nbStates_, 0.);
+  if (!diagonalizable)
+    ilambda = model_->getIEigenValues();
+
+  // The J-functions only depend on the length through the exponentials
+  // of the eigenvalues. With d = lambda_i - lambda_j (complex), we have
+  // J(i, j) = (exp(lambda_i t) - exp(lambda_j t)) / d, and 1 / d is
+  // computed here once for all lengths:
+  RowMatrix<double> invDiff(nbStates_, nbStates_), iInvDiff(nbStates_, nbStates_);
+  vector<bool> sameValues(nbStates_ * nbStates_);
+  for (size_t i = 0; i < nbStates_; ++i) {
+    for (size_t j = 0; j < nbStates_; ++j) {
+      double dd = lambda[i] - lambda[j];
+      double idd = ilambda[i] - ilambda[j];
+      sameValues[i * nbStates_ + j] = (dd == 0 && idd == 0);
+      if (idd == 0) {
+        invDiff(i, j) = (dd == 0 ? 0. : 1. / dd);
+        iInvDiff(i, j) = 0.;
+      } else {
+        double num = dd * dd + idd * idd;
+        invDiff(i, j) = dd / num;
+        iInvDiff(i, j) = idd / num;
+      }
+    }
+  }
+
+  RowMatrix<double> jMat(nbStates_, nbStates_), jIMat(nbStates_, nbStates_);
+  RowMatrix<double> tmp1(nbStates_, nbStates_), tmp2(nbStates_, nbStates_);
+  RowMatrix<double> itmp1(nbStates_, nbStates_), itmp2(nbStates_, nbStates_);
+  RowMatrix<double> imat(nbStates_, nbStates_);
+  vector<double> cosLam(nbStates_), sinLam(nbStates_, 0.);
+  map<double, size_t> computed;
+
+  mappings.resize(lengths.size());
+  for (size_t l = 0; l < lengths.size(); ++l) {
+    double t = lengths[l];
+    mappings[l].resize(nbTypes_);
+
+    map<double, size_t>::const_iterator it = computed.find(t);
+    if (it != computed.end()) {
+      for (size_t i = 0; i < nbTypes_; ++i)
+        mappings[l][i] = mappings[it->second][i];
+      continue;
+    }
+    computed[t] = l;
+
+    for (size_t i = 0; i < nbStates_; ++i) {
+      double e = exp(lambda[i] * t);
+      if (diagonalizable)
+        cosLam[i] = e;
+      else {
+        cosLam[i] = e * cos(ilambda[i] * t);
+        sinLam[i] = e * sin(ilambda[i] * t);
+      }
+    }
+
+    for (size_t i = 0; i < nbStates_; ++i) {
+      for (size_t j = 0; j < nbStates_; ++j) {
+        if (sameValues[i * nbStates_ + j]) {
+          jMat(i, j) = t * cosLam[i];
+          jIMat(i, j) = t * sinLam[i];
+        } else {
+          double ec = cosLam[i] - cosLam[j];
+          double es = sinLam[i] - sinLam[j];
+          jMat(i, j) = invDiff(i, j) * ec + iInvDiff(i, j) * es;
+          jIMat(i, j) = invDiff(i, j) * es - iInvDiff(i, j) * ec;
+        }
+      }
+    }
+
+    for (size_t i = 0; i < nbTypes_; ++i) {
+      mappings[l][i].resize(nbStates_, nbStates_);
+      if (diagonalizable) {
+        MatrixTools::hadamardMult(jMat, insideProducts_[i], tmp1);
+        MatrixTools::mult(model_->getColumnRightEigenVectors(), tmp1, tmp2);
+        MatrixTools::mult(tmp2, model_->getRowLeftEigenVectors(), mappings[l][i]);
+      } else {
+        MatrixTools::hadamardMult(jMat, jIMat, insideProducts_[i], insideIProducts_[i], tmp1, itmp1);
+        MatrixTools::mult(rightEigenVectors_, rightIEigenVectors_, tmp1, itmp1, tmp2, itmp2);
+        MatrixTools::mult(tmp2, itmp2, leftEigenVectors_, leftIEigenVectors_, mappings[l][i], imat);
+      }
+    }
+  }
+}
+
+
 void DecompositionMethods::initStates_()
 {
   jMat_.resize(nbStates_, nbStates_);
@@ -152,6 +152,20 @@ namespace bpp
 
     void computeExpectations(std::vector< RowMatrix<double> >& mappings, double leangth) const;
 
+    /**
+     * @brief Perform the computation of the conditional expectations
+     * for several lengths at once, for all types.
+     *
+     * The differences of eigenvalues used by the J-functions and the
+     * products computed by computeProducts_ are shared by all lengths,
+     * and identical lengths are only computed once.
+     *
+     * @param lengths  The lengths of the branches.
+     * @param mappings [out] For each length and each type (starting
+     * from 0), the matrix of conditional expectations.
+     */
+    void computeExpectations(const std::vector<double>& lengths, std::vector< std::vector< RowMatrix<double> > >& mappings) const;
+
     /**
      * @brief Compute the integral part of the computation
      *
@@ -89,14 +89,20 @@ void DecompositionReward::fillBMatrice_()
 void DecompositionReward::computeRewards_(double length) const
 {
   computeExpectations(rewards_, length);
+  normalizeRewards_(length, rewards_);
+}
+
+/******************************************************************************/
 
+void DecompositionReward::normalizeRewards_(double length, RowMatrix<double>& rewards) const
+{
   // Now we must divide by pijt:
   RowMatrix<double> P = model_->getPij_t(length);
   for (size_t j = 0; j < nbStates_; j++) {
     for (size_t k = 0; k < nbStates_; k++) {
-      rewards_(j, k) /= P(j, k);
-      if (std::isnan(rewards_(j, k)) || std::isnan(-rewards_(j, k)) || std::isinf(rewards_(j, k)))
-        rewards_(j, k) = 0.;
+      rewards(j, k) /= P(j, k);
+      if (std::isnan(rewards(j, k)) || std::isnan(-rewards(j, k)) || std::isinf(rewards(j, k)))
+        rewards(j, k) = 0.;
     }
   }
 }
@@ -131,6 +137,23 @@ double DecompositionReward::getReward(size_t initialState, size_t finalState, do
 
 /******************************************************************************/
 
+void DecompositionReward::getAllRewardsForEachLength(const std::vector<double>& lengths, std::vector< RowMatrix<double> >& rewards) const
+{
+  for (size_t l = 0; l < lengths.size(); ++l) {
+    if (lengths[l] < 0)
+      throw Exception("DecompositionReward::getAllRewardsForEachLength. Negative branch length: " + TextTools::toString(lengths[l]) + ".");
+  }
+  vector< vector< RowMatrix<double> > > expectations;
+  computeExpectations(lengths, expectations);
+  rewards.resize(lengths.size());
+  for (size_t l = 0; l < lengths.size(); ++l) {
+    rewards[l] = expectations[l][0];
+    normalizeRewards_(lengths[l], rewards[l]);
+  }
+}
+
+/******************************************************************************/
+
 void DecompositionReward::setSubstitutionModel(const SubstitutionModel* model)
 {
   //Check compatiblity between model and substitution register:
@@ -98,6 +98,8 @@ namespace bpp
     double getReward(size_t initialState, size_t finalState, double length) const;
 
     Matrix<double>* getAllRewards(double length) const;
+
+    void getAllRewardsForEachLength(const std::vector<double>& lengths, std::vector< RowMatrix<double> >& rewards) const;
     
     /**
      * @brief Set the substitution model.
@@ -114,6 +116,12 @@ namespace bpp
     
     void computeRewards_(double length) const;
 
+    /**
+     * @brief Divide the conditional expectations for a branch length by
+     * the transition probabilities.
+     */
+    void normalizeRewards_(double length, RowMatrix<double>& rewards) const;
+
     void alphabetIndexHasChanged();
 
   private:
@@ -80,9 +80,11 @@ void DecompositionSubstitutionCount::initCounts_()
 void DecompositionSubstitutionCount::fillBMatrices_()
 {
   vector<int> supportedStates = model_->getAlphabetStates();
+  const vector<size_t>& types = register_->getTypeTable();
+  size_t n = register_->getSubstitutionModel()->getNumberOfStates();
   for (size_t j = 0; j < nbStates_; ++j) {
     for (size_t k = 0; k < nbStates_; ++k) {
-      size_t i = register_->getType(j, k);
+      size_t i = types[j * n + k];
       if (i > 0 && k != j) {
         bMatrices_[i - 1](j, k) = model_->Qij(j, k);
       }
@@ -96,19 +98,25 @@ void DecompositionSubstitutionCount::fillBMatrices_()
 void DecompositionSubstitutionCount::computeCounts_(double length) const
 {
   computeExpectations(counts_, length);
+  normalizeCounts_(length, counts_);
+}
+
+/******************************************************************************/
 
+void DecompositionSubstitutionCount::normalizeCounts_(double length, std::vector< RowMatrix<double> >& counts) const
+{
   // Now we must divide by pijt and account for putative weights:
   vector<int> supportedStates = model_->getAlphabetStates();
   RowMatrix<double> P = model_->getPij_t(length);
   for (size_t i = 0; i < nbTypes_; i++) {
     for (size_t j = 0; j < nbStates_; j++) {
       for (size_t k = 0; k < nbStates_; k++) {
-        counts_[i](j, k) /= P(j, k);
-        if (std::isinf(counts_[i](j, k)) || std::isnan(counts_[i](j, k)) || counts_[i](j, k) < 0.) {
-          counts_[i](j, k) = 0.;
+        counts[i](j, k) /= P(j, k);
+        if (std::isinf(counts[i](j, k)) || std::isnan(counts[i](j, k)) || counts[i](j, k) < 0.) {
+          counts[i](j, k) = 0.;
           //Weights:
           if (weights_)
-            counts_[i](j, k) *= weights_->getIndex(supportedStates[j], supportedStates[k]);
+            counts[i](j, k) *= weights_->getIndex(supportedStates[j], supportedStates[k]);
         }
       }
     }
@@ -163,6 +171,19 @@ std::vector<double> DecompositionSubstitutionCount::getNumberOfSubstitutionsForE
     
 /******************************************************************************/
 
+void DecompositionSubstitutionCount::getAllNumbersOfSubstitutionsForEachLength(const std::vector<double>& lengths, std::vector< std::vector< RowMatrix<double> > >& counts) const
+{
+  for (size_t l = 0; l < lengths.size(); ++l) {
+    if (lengths[l] < 0)
+      throw Exception("DecompositionSubstitutionCount::getAllNumbersOfSubstitutionsForEachLength. Negative branch length: " + TextTools::toString(lengths[l]) + ".");
+  }
+  computeExpectations(lengths, counts);
+  for (size_t l = 0; l < lengths.size(); ++l)
+    normalizeCounts_(lengths[l], counts[l]);
+}
+
+/******************************************************************************/
+
 void DecompositionSubstitutionCount::setSubstitutionModel(const SubstitutionModel* model)
 {
   //Check compatiblity between model and substitution register:
@@ -95,6 +95,8 @@ namespace bpp
     Matrix<double>* getAllNumbersOfSubstitutions(double length, size_t type = 1) const;
     
     std::vector<double> getNumberOfSubstitutionsForEachType(size_t initialState, size_t finalState, double length) const;
+
+    void getAllNumbersOfSubstitutionsForEachLength(const std::vector<double>& lengths, std::vector< std::vector< RowMatrix<double> > >& counts) const;
    
     /**
      * @brief Set the substitution model.
@@ -110,6 +112,12 @@ namespace bpp
 
     void computeCounts_(double length) const;
 
+    /**
+     * @brief Turn the conditional expectations for a branch length into
+     * numbers of substitutions, dividing them by the transition probabilities.
+     */
+    void normalizeCounts_(double length, std::vector< RowMatrix<double> >& counts) const;
+
     void substitutionRegisterHasChanged() throw (Exception);
 
     void weightsHaveChanged() throw (Exception);
@@ -0,0 +1,159 @@
+//
+// File: MappingBlock.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#ifndef _MAPPINGBLOCK_H_
+#define _MAPPINGBLOCK_H_
+
+#include "../Model/SubstitutionModel.h"
+#include "../ParallelTools.h"
+
+#include <Bpp/App/ApplicationTools.h>
+
+// From the STL:
+#include <functional>
+#include <map>
+#include <memory>
+
+namespace bpp
+{
+/**
+ * @brief The counting object used on a block of branches by the
+ * mapping procedures.
+ *
+ * It is either the given object (serial computation), or a private
+ * copy working on private copies of the models, as substitution
+ * counts, rewards and models all keep mutable buffers and may not be
+ * shared between threads.
+ *
+ * T may be any class with clone() and setSubstitutionModel(const
+ * SubstitutionModel*) methods, typically SubstitutionCount or Reward.
+ */
+template<class T>
+class MappingBlock
+{
+private:
+  std::unique_ptr<T> copy_;
+  T& object_;
+  std::map<const SubstitutionModel*, std::shared_ptr<SubstitutionModel> > models_;
+
+public:
+  MappingBlock(T& object, bool copy) :
+    copy_(copy ? object.clone() : 0),
+    object_(copy ? *copy_ : object),
+    models_()
+  {}
+
+private:
+  MappingBlock(const MappingBlock&);
+  MappingBlock& operator=(const MappingBlock&);
+
+public:
+  T& get() { return object_; }
+
+  void setSubstitutionModel(const SubstitutionModel* model)
+  {
+    if (copy_.get() && model)
+    {
+      std::shared_ptr<SubstitutionModel>& m = models_[model];
+      if (!m)
+        m.reset(model->clone());
+      model = m.get();
+    }
+    object_.setSubstitutionModel(model);
+  }
+
+  /**
+   * @brief Call f(l, block) for all branches l in [0, nbNodes).
+   *
+   * Branches are independent, so that they can be split in blocks run
+   * on distinct threads, each with its own copy of the object. Every
+   * branch is computed with the same operations whatever the number
+   * of threads, hence the results do not depend on it.
+   *
+   * On several threads, f may only read shared objects through
+   * methods that never modify them. This holds for the const
+   * accessors of DRTreeLikelihood and of its likelihood data, such as
+   * getLikelihoodArray() and getTransitionProbabilitiesPerRateClass(),
+   * but not for getData() if the full data set has not been built
+   * yet, nor for models with a pending update (see
+   * AbstractSubstitutionModel::computePendingUpdate()): these must be
+   * queried before calling this method.
+   *
+   * @param nbNodes The number of branches.
+   * @param nbThreads Maximum number of threads to use (see ParallelTools).
+   * @param object The counting object, used directly on a single thread.
+   * @param f The function computing one branch.
+   * @param verbose Display a progress gauge (serial computation only).
+   */
+  static void forEachBranch(
+    size_t nbNodes,
+    unsigned int nbThreads,
+    T& object,
+    const std::function<void (size_t, MappingBlock<T>&)>& f,
+    bool verbose)
+  {
+    if (ParallelTools::getNumberOfBlocks(nbNodes, nbThreads) <= 1)
+    {
+      MappingBlock<T> block(object, false);
+      for (size_t l = 0; l < nbNodes; ++l)
+      {
+        if (verbose)
+          ApplicationTools::displayGauge(l, nbNodes - 1);
+        f(l, block);
+      }
+    }
+    else
+    {
+      ParallelTools::forEachBlock(nbNodes, nbThreads,
+        [&](size_t begin, size_t end, unsigned int)
+        {
+          MappingBlock<T> block(object, true);
+          for (size_t l = begin; l < end; ++l)
+          {
+            f(l, block);
+          }
+        });
+    }
+  }
+};
+} // end of namespace bpp.
+
+#endif // _MAPPINGBLOCK_H_
+
@@ -141,6 +141,16 @@ class ProbabilisticSubstitutionMapping:
     virtual void setTree(const Tree& tree);
 
     virtual void setNumberOfSites(size_t numberOfSites);
+
+    double getCount(size_t nodeIndex, size_t siteIndex, size_t type) const
+    {
+      return mapping_[siteIndex][nodeIndex][type];
+    }
+
+    void setCount(size_t nodeIndex, size_t siteIndex, size_t type, double value)
+    {
+      mapping_[siteIndex][nodeIndex][type] = value;
+    }
     
     /**
      * @brief Direct access to substitution numbers.
@@ -47,6 +47,7 @@
 
 //From the STL:
 #include <vector>
+#include <memory>
 
 namespace bpp
 {
@@ -135,6 +136,25 @@ namespace bpp
      */
     virtual Matrix<double>* getAllRewards(double length) const = 0;
 
+    /**
+     * @brief Get the rewards for several branch lengths at once.
+     *
+     * Implementations may share computations between lengths, the default one
+     * calls getAllRewards() for each length.
+     *
+     * @param lengths The lengths of the branches (for instance of all branches and rate classes of a tree).
+     * @param rewards [out] For each length, the matrix of all rewards for each initial and final states.
+     */
+    virtual void getAllRewardsForEachLength(const std::vector<double>& lengths, std::vector< RowMatrix<double> >& rewards) const
+    {
+      rewards.resize(lengths.size());
+      for (size_t l = 0; l < lengths.size(); ++l)
+      {
+        std::unique_ptr< Matrix<double> > rij(getAllRewards(lengths[l]));
+        rewards[l] = RowMatrix<double>(*rij);
+      }
+    }
+
     /**
      * @brief Set the substitution model associated with this reward, if relevant.
      *
@@ -38,8 +38,10 @@
  */
 
 #include "RewardMappingTools.h"
+#include "BinarySubstitutionMappingIO.h"
 #include "../Likelihood/DRTreeLikelihoodTools.h"
 #include "../Likelihood/MarginalAncestralStateReconstruction.h"
+#include "MappingBlock.h"
 
 #include <Bpp/Text/TextTools.h>
 #include <Bpp/App/ApplicationTools.h>
@@ -50,16 +52,27 @@ using namespace bpp;
 
 // From the STL:
 #include <iomanip>
+#include <map>
+#include <memory>
 
 using namespace std;
 
 /******************************************************************************/
 
-ProbabilisticRewardMapping* RewardMappingTools::computeRewardVectors(
+namespace
+{
+  typedef MappingBlock<Reward> BlockReward;
+}
+
+/******************************************************************************/
+
+void RewardMappingTools::computeJointRewardVectors_(
   const DRTreeLikelihood& drtl,
   const vector<int>& nodeIds,
   Reward& reward,
-  bool verbose) throw (Exception)
+  const std::function<void (size_t, const Node*, Vdouble&)>& store,
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
 {
   // Preamble:
   if (!drtl.isInitialized())
@@ -71,19 +84,13 @@ ProbabilisticRewardMapping* RewardMappingTools::computeRewardVectors(
   const SiteContainer*    sequences = drtl.getData();
   const DiscreteDistribution* rDist = drtl.getRateDistribution();
 
-  size_t nbSites         = sequences->getNumberOfSites();
   size_t nbDistinctSites = drtl.getLikelihoodData()->getNumberOfDistinctSites();
   size_t nbStates        = sequences->getAlphabet()->getSize();
   size_t nbClasses       = rDist->getNumberOfCategories();
   vector<const Node*> nodes    = tree.getNodes();
-  const vector<size_t>* rootPatternLinks
-    = &drtl.getLikelihoodData()->getRootArrayPositions();
   nodes.pop_back(); // Remove root node.
   size_t nbNodes         = nodes.size();
 
-  // We create a new ProbabilisticRewardMapping object:
-  ProbabilisticRewardMapping* rewards = new ProbabilisticRewardMapping(tree, &reward, nbSites);
-
   // Store likelihood for each rate for each site:
   VVVdouble lik;
   drtl.computeLikelihoodAtNode(tree.getRootId(), lik);
@@ -108,19 +115,17 @@ ProbabilisticRewardMapping* RewardMappingTools::computeRewardVectors(
   if (verbose)
     ApplicationTools::displayTask("Compute joint node-pairs likelihood", true);
 
-  for (size_t l = 0; l < nbNodes; ++l)
+  auto computeBranch = [&](size_t l, BlockReward& block)
   {
     // For each node,
     const Node* currentNode = nodes[l];
     if (nodeIds.size() > 0 && !VectorTools::contains(nodeIds, currentNode->getId()))
-      continue;
+      return;
 
     const Node* father = currentNode->getFather();
 
     double d = currentNode->getDistanceToFather();
 
-    if (verbose)
-      ApplicationTools::displayGauge(l, nbNodes - 1);
     Vdouble rewardsForCurrentNode(nbDistinctSites);
 
     // Now we've got to compute likelihoods in a smart manner... ;)
@@ -265,14 +270,15 @@ ProbabilisticRewardMapping* RewardMappingTools::computeRewardVectors(
     while (mit->hasNext())
     {
       TreeLikelihood::ConstBranchModelDescription* bmd = mit->next();
-      reward.setSubstitutionModel(bmd->getSubstitutionModel());
-      // compute all nxy first:
+      block.setSubstitutionModel(bmd->getSubstitutionModel());
+      // compute all nxy first, for all rate classes at once:
+      vector< RowMatrix<double> > nij;
+      block.get().getAllRewardsForEachLength(rcRates * d, nij);
       VVVdouble nxy(nbClasses);
       for (size_t c = 0; c < nbClasses; ++c)
       {
         VVdouble* nxy_c = &nxy[c];
-        double rc = rcRates[c];
-        Matrix<double>* nij = reward.getAllRewards(d * rc);
+        const RowMatrix<double>& nij_c = nij[c];
         nxy_c->resize(nbStates);
         for (size_t x = 0; x < nbStates; ++x)
         {
@@ -280,10 +286,9 @@ ProbabilisticRewardMapping* RewardMappingTools::computeRewardVectors(
           nxy_c_x->resize(nbStates);
           for (size_t y = 0; y < nbStates; ++y)
           {
-            (*nxy_c_x)[y] = (*nij)(x, y);
+            (*nxy_c_x)[y] = nij_c(x, y);
           }
         }
-        delete nij;
       }
 
       // Now loop over sites:
@@ -330,20 +335,102 @@ ProbabilisticRewardMapping* RewardMappingTools::computeRewardVectors(
       }
     }
 
-    // Now we just have to copy the substitutions into the result vector:
-    for (size_t i = 0; i < nbSites; ++i)
-      (*rewards)(l, i) = rewardsForCurrentNode[(*rootPatternLinks)[i]] / Lr[(*rootPatternLinks)[i]];
+    // Now we just have to normalize by the site likelihoods:
+    for (size_t i = 0; i < nbDistinctSites; ++i)
+      rewardsForCurrentNode[i] /= Lr[i];
+    store(l, currentNode, rewardsForCurrentNode);
+  };
+
+  BlockReward::forEachBranch(nbNodes, nbThreads, reward, computeBranch, verbose);
 
-  }
   if (verbose)
   {
     if (ApplicationTools::message)
       *ApplicationTools::message << " ";
     ApplicationTools::displayTaskDone();
   }
+}
+
+/******************************************************************************/
+
+ProbabilisticRewardMapping* RewardMappingTools::computeRewardVectors(
+  const DRTreeLikelihood& drtl,
+  const vector<int>& nodeIds,
+  Reward& reward,
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
+{
+  // Preamble:
+  if (!drtl.isInitialized())
+    throw Exception("RewardMappingTools::computeRewardVectors(). Likelihood object is not initialized.");
+
+  size_t nbSites         = drtl.getData()->getNumberOfSites();
+  const vector<size_t>* rootPatternLinks
+    = &drtl.getLikelihoodData()->getRootArrayPositions();
+
+  // We create a new ProbabilisticRewardMapping object:
+  ProbabilisticRewardMapping* rewards = new ProbabilisticRewardMapping(drtl.getTree(), &reward, nbSites);
+
+  computeJointRewardVectors_(drtl, nodeIds, reward,
+    [&](size_t l, const Node*, Vdouble& rewardsForCurrentNode)
+    {
+      // Now we just have to copy the rewards into the result vector:
+      for (size_t i = 0; i < nbSites; ++i)
+        (*rewards)(l, i) = rewardsForCurrentNode[(*rootPatternLinks)[i]];
+    }, verbose, nbThreads);
+
   return rewards;
 }
 
+/******************************************************************************/
+
+void RewardMappingTools::computeRewardVectorsToStream(
+  const DRTreeLikelihood& drtl,
+  const vector<int>& nodeIds,
+  Reward& reward,
+  ostream& out,
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
+{
+  // Preamble:
+  if (!drtl.isInitialized())
+    throw Exception("RewardMappingTools::computeRewardVectorsToStream(). Likelihood object is not initialized.");
+
+  const SiteContainer* sequences = drtl.getData();
+  size_t nbSites         = sequences->getNumberOfSites();
+  const vector<size_t>* rootPatternLinks
+    = &drtl.getLikelihoodData()->getRootArrayPositions();
+
+  // Branches are written in the order of the tree nodes:
+  const TreeTemplate<Node> tree(drtl.getTree());
+  vector<const Node*> nodes = tree.getNodes();
+  nodes.pop_back(); // Remove root node.
+  vector<int> branchIds;
+  for (size_t l = 0; l < nodes.size(); ++l)
+  {
+    if (nodeIds.size() == 0 || VectorTools::contains(nodeIds, nodes[l]->getId()))
+      branchIds.push_back(nodes[l]->getId());
+  }
+  vector<int> sitePositions(nbSites);
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    sitePositions[i] = sequences->getSite(i).getPosition();
+  }
+
+  // Rewards are stored as a mapping with a single type:
+  BinarySubstitutionMappingWriter writer(out, branchIds, sitePositions, 1);
+  computeJointRewardVectors_(drtl, nodeIds, reward,
+    [&](size_t, const Node* node, Vdouble& rewardsForCurrentNode)
+    {
+      VVdouble values(1, Vdouble(nbSites));
+      for (size_t i = 0; i < nbSites; ++i)
+      {
+        values[0][i] = rewardsForCurrentNode[(*rootPatternLinks)[i]];
+      }
+      writer.writeBranch(writer.getBranchIndex(node->getId()), values);
+    }, verbose, nbThreads);
+}
+
 /**************************************************************************************************/
 
 void RewardMappingTools::writeToStream(
@@ -45,6 +45,9 @@
 
 #include "../Likelihood/DRTreeLikelihood.h"
 
+// From the STL:
+#include <functional>
+
 namespace bpp
 {
 /**
@@ -75,6 +78,10 @@ public:
    *                          are computed on.
    * @param reward            The Reward to use.
    * @param verbose           Print info to screen.
+   * @param nbThreads         Number of threads the branches are shared
+   *                          between (0 for all cores). Each thread works
+   *                          on copies of the reward and of the models, and
+   *                          results do not depend on the number of threads.
    * @return A vector of reward vectors (one for each site).
    * @throw Exception If the likelihood object is not initialized.
    */
@@ -82,7 +89,35 @@ public:
     const DRTreeLikelihood& drtl,
     const std::vector<int>& nodeIds,
     Reward& reward,
-    bool verbose = true) throw (Exception);
+    bool verbose = true,
+    unsigned int nbThreads = 1) throw (Exception);
+
+  /**
+   * @brief Compute the reward vectors like computeRewardVectors, but write
+   * them to a stream branch by branch instead of keeping them in memory.
+   *
+   * The binary columnar format of substitution mappings is used, with a
+   * single type, so that rewards can be read back with a
+   * BinarySubstitutionMappingReader.
+   *
+   * @param drtl              A DRTreeLikelihood object.
+   * @param nodeIds           The Ids of the nodes the reward vectors
+   *                          are computed on. If empty, use all nodes.
+   * @param reward            The Reward to use.
+   * @param out               The output stream. It must allow to seek, as
+   *                          branches may not be written in order.
+   * @param verbose           Print info to screen.
+   * @param nbThreads         Number of threads to use (see computeRewardVectors).
+   * @throw Exception If the likelihood object is not initialized, or if writing failed.
+   * @see BinarySubstitutionMappingFormat
+   */
+  static void computeRewardVectorsToStream(
+    const DRTreeLikelihood& drtl,
+    const std::vector<int>& nodeIds,
+    Reward& reward,
+    std::ostream& out,
+    bool verbose = true,
+    unsigned int nbThreads = 1) throw (Exception);
 
 
   /**
@@ -130,6 +165,22 @@ public:
    * @return A vector will all counts summed for each types of substitutions.
    */
   static double computeSumForSite(const RewardMapping& smap, size_t siteIndex);
+
+private:
+  /**
+   * @brief Compute the reward vectors and give the ones of each branch to
+   * store(l, node, rewards), with l the index of the branch and rewards[i]
+   * the reward for distinct site i.
+   *
+   * With several threads, store is called concurrently for distinct branches.
+   */
+  static void computeJointRewardVectors_(
+    const DRTreeLikelihood& drtl,
+    const std::vector<int>& nodeIds,
+    Reward& reward,
+    const std::function<void (size_t, const Node*, Vdouble&)>& store,
+    bool verbose,
+    unsigned int nbThreads) throw (Exception);
 };
 } // end of namespace bpp.
 
@@ -0,0 +1,427 @@
+//
+// File: StochasticMapping.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "StochasticMapping.h"
+#include "../ParallelTools.h"
+#include "../TreeTemplate.h"
+
+#include <Bpp/Numeric/VectorTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <cmath>
+#include <algorithm>
+#include <memory>
+
+using namespace std;
+
+/******************************************************************************/
+
+StochasticMapping::StochasticMapping(const DRTreeLikelihood& drtl, unsigned int seed) throw (Exception) :
+  alphabet_(drtl.getAlphabet()),
+  nbStates_(drtl.getNumberOfStates()),
+  nbClasses_(0),
+  nbSites_(0),
+  nbDistinctSites_(0),
+  seed_(seed),
+  rates_(),
+  nodeIds_(),
+  fathers_(),
+  lengths_(),
+  likelihoods_(),
+  siteModels_(),
+  models_(),
+  rootPatternLinks_(),
+  rootProbabilities_(),
+  acceptanceThreshold_(0.1),
+  maxNumberOfTrials_(1000)
+{
+  if (!drtl.isInitialized())
+    throw Exception("StochasticMapping (constructor). Likelihood object is not initialized.");
+
+  const DiscreteDistribution* rDist = drtl.getRateDistribution();
+  nbClasses_ = rDist->getNumberOfCategories();
+  rates_ = rDist->getCategories();
+  Vdouble rcProbs = rDist->getProbabilities();
+  nbDistinctSites_ = drtl.getLikelihoodData()->getNumberOfDistinctSites();
+  rootPatternLinks_ = drtl.getLikelihoodData()->getRootArrayPositions();
+  nbSites_ = rootPatternLinks_.size();
+
+  // Sort nodes so that fathers come first:
+  const TreeTemplate<Node> tree(drtl.getTree());
+  vector<const Node*> nodes(1, tree.getRootNode());
+  fathers_.push_back(0);
+  for (size_t k = 0; k < nodes.size(); ++k)
+  {
+    for (size_t s = 0; s < nodes[k]->getNumberOfSons(); ++s)
+    {
+      nodes.push_back(nodes[k]->getSon(s));
+      fathers_.push_back(k);
+    }
+  }
+
+  size_t nbNodes = nodes.size();
+  nodeIds_.resize(nbNodes);
+  lengths_.resize(nbNodes);
+  likelihoods_.resize(nbNodes);
+  siteModels_.resize(nbNodes);
+  models_.resize(nbNodes);
+  nodeIds_[0] = nodes[0]->getId();
+  for (size_t k = 1; k < nbNodes; ++k)
+  {
+    int nodeId = nodes[k]->getId();
+    nodeIds_[k] = nodeId;
+    lengths_[k] = nodes[k]->getDistanceToFather();
+    likelihoods_[k] = &drtl.getLikelihoodData()->getLikelihoodArray(nodeIds_[fathers_[k]], nodeId);
+
+    // One generator per group of sites sharing a model on this branch:
+    siteModels_[k].resize(nbDistinctSites_);
+    unique_ptr<TreeLikelihood::ConstBranchModelIterator> mit(drtl.getNewBranchModelIterator(nodeId));
+    while (mit->hasNext())
+    {
+      TreeLikelihood::ConstBranchModelDescription* bmd = mit->next();
+      const SubstitutionModel* model = bmd->getSubstitutionModel();
+      BranchModel_ bm;
+      bm.generator.resize(nbStates_, nbStates_);
+      // The transition probabilities account for the rate of the model, so must the generator:
+      double modelRate = model->getRate();
+      for (size_t x = 0; x < nbStates_; ++x)
+      {
+        for (size_t y = 0; y < nbStates_; ++y)
+        {
+          bm.generator(x, y) = modelRate * model->Qij(x, y);
+        }
+        bm.maxRate = max(bm.maxRate, -bm.generator(x, x));
+      }
+      // R = I + Q / mu:
+      bm.uniformized.resize(nbStates_, nbStates_);
+      for (size_t x = 0; x < nbStates_; ++x)
+      {
+        for (size_t y = 0; y < nbStates_; ++y)
+        {
+          bm.uniformized(x, y) = (x == y ? 1. : 0.) + (bm.maxRate > 0 ? bm.generator(x, y) / bm.maxRate : 0.);
+        }
+      }
+
+      unique_ptr<TreeLikelihood::SiteIterator> sit(bmd->getNewSiteIterator());
+      bool first = true;
+      while (sit->hasNext())
+      {
+        size_t i = sit->next();
+        if (first)
+        {
+          bm.pxy = drtl.getTransitionProbabilitiesPerRateClass(nodeId, i);
+          first = false;
+        }
+        siteModels_[k][i] = models_[k].size();
+      }
+      models_[k].push_back(bm);
+    }
+  }
+
+  // Joint probabilities of the rate class and the root state:
+  rootProbabilities_.resize(nbDistinctSites_);
+  for (size_t i = 0; i < nbDistinctSites_; ++i)
+  {
+    const vector<double>& freqs = drtl.getRootFrequencies(i);
+    Vdouble* rootProbabilities_i = &rootProbabilities_[i];
+    rootProbabilities_i->resize(nbClasses_ * nbStates_);
+    for (size_t c = 0; c < nbClasses_; ++c)
+    {
+      for (size_t x = 0; x < nbStates_; ++x)
+      {
+        (*rootProbabilities_i)[c * nbStates_ + x] = rcProbs[c] * freqs[x];
+      }
+    }
+    for (size_t k = 1; k < nbNodes && fathers_[k] == 0; ++k)
+    {
+      const VVVdouble& pxy = models_[k][siteModels_[k][i]].pxy;
+      const VVdouble& likelihoods_k_i = (*likelihoods_[k])[i];
+      for (size_t c = 0; c < nbClasses_; ++c)
+      {
+        for (size_t x = 0; x < nbStates_; ++x)
+        {
+          double likelihood = 0.;
+          for (size_t y = 0; y < nbStates_; ++y)
+          {
+            likelihood += pxy[c][x][y] * likelihoods_k_i[c][y];
+          }
+          (*rootProbabilities_i)[c * nbStates_ + x] *= likelihood;
+        }
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+size_t StochasticMapping::sampleIndex_(const double* probabilities, size_t n, RandomEngine& engine) const
+{
+  double total = 0.;
+  for (size_t k = 0; k < n; ++k)
+    total += probabilities[k];
+  if (!(total > 0.))
+    throw Exception("StochasticMapping::sampleIndex_. All probabilities are null.");
+  double u = uniform_real_distribution<double>(0., total)(engine);
+  size_t last = 0;
+  double cumProb = 0.;
+  for (size_t k = 0; k < n; ++k)
+  {
+    if (probabilities[k] > 0.)
+    {
+      cumProb += probabilities[k];
+      last = k;
+      if (u < cumProb)
+        return k;
+    }
+  }
+  // Rounding errors:
+  return last;
+}
+
+/******************************************************************************/
+
+size_t StochasticMapping::jump_(const BranchModel_& model, size_t state, double u) const
+{
+  double r = u * -model.generator(state, state);
+  size_t last = state;
+  double cumRate = 0.;
+  for (size_t k = 0; k < nbStates_; ++k)
+  {
+    if (k != state && model.generator(state, k) > 0.)
+    {
+      cumRate += model.generator(state, k);
+      last = k;
+      if (r < cumRate)
+        return k;
+    }
+  }
+  return last;
+}
+
+/******************************************************************************/
+
+void StochasticMapping::sampleHistory(size_t site, size_t sample, std::vector<MutationPath>& paths) const throw (IndexOutOfBoundsException)
+{
+  if (site >= nbSites_)
+    throw IndexOutOfBoundsException("StochasticMapping::sampleHistory.", site, 0, nbSites_ - 1);
+
+  // Each sample of each site has its own stream:
+  seed_seq seq = {
+    seed_,
+    static_cast<unsigned int>(site & 0xFFFFFFFF), static_cast<unsigned int>(static_cast<unsigned long long>(site) >> 32),
+    static_cast<unsigned int>(sample & 0xFFFFFFFF), static_cast<unsigned int>(static_cast<unsigned long long>(sample) >> 32)
+  };
+  RandomEngine engine(seq);
+
+  size_t i = rootPatternLinks_[site];
+  size_t rootClassAndState = sampleIndex_(&rootProbabilities_[i][0], nbClasses_ * nbStates_, engine);
+  size_t c = rootClassAndState / nbStates_;
+
+  vector<size_t> states(nodeIds_.size());
+  states[0] = rootClassAndState % nbStates_;
+  paths.clear();
+  paths.reserve(nodeIds_.size() - 1);
+  Vdouble probs(nbStates_);
+  for (size_t k = 1; k < nodeIds_.size(); ++k)
+  {
+    const BranchModel_& model = models_[k][siteModels_[k][i]];
+    size_t x = states[fathers_[k]];
+    const Vdouble& pxy_c_x = model.pxy[c][x];
+    const Vdouble& likelihoods_k_i_c = (*likelihoods_[k])[i][c];
+    for (size_t y = 0; y < nbStates_; ++y)
+      probs[y] = pxy_c_x[y] * likelihoods_k_i_c[y];
+    size_t y = sampleIndex_(&probs[0], nbStates_, engine);
+    states[k] = y;
+
+    paths.push_back(MutationPath(alphabet_, x, lengths_[k]));
+    samplePath_(model, x, y, lengths_[k], rates_[c], pxy_c_x[y], paths.back(), engine);
+  }
+}
+
+/******************************************************************************/
+
+void StochasticMapping::sampleHistories(
+  size_t nbSamples,
+  const std::function<void (size_t, size_t, const std::vector<MutationPath>&)>& f,
+  unsigned int nbThreads) const
+{
+  ParallelTools::forEachBlock(nbSites_, nbThreads,
+    [&](size_t begin, size_t end, unsigned int)
+    {
+      vector<MutationPath> paths;
+      for (size_t site = begin; site < end; ++site)
+      {
+        for (size_t s = 0; s < nbSamples; ++s)
+        {
+          sampleHistory(site, s, paths);
+          f(site, s, paths);
+        }
+      }
+    });
+}
+
+/******************************************************************************/
+
+void StochasticMapping::samplePath_(const BranchModel_& model, size_t x, size_t y, double d, double rate, double pxy, MutationPath& path, RandomEngine& engine) const
+{
+  double t = d * rate;
+  if (!(t > 0.))
+    return;
+
+  // Probability that a forward simulation ends in y, when conditioned on
+  // at least one jump if x != y:
+  double qx = -model.generator(x, x);
+  double acceptance = pxy;
+  if (x != y)
+    acceptance = (qx > 0. ? pxy / (1. - exp(-qx * t)) : 0.);
+
+  if (acceptance > 0. && acceptance >= acceptanceThreshold_)
+  {
+    for (unsigned int trial = 0; trial < maxNumberOfTrials_; ++trial)
+    {
+      if (samplePathByRejection_(model, x, y, t, rate, path, engine))
+        return;
+    }
+  }
+  samplePathByUniformization_(model, x, y, t, rate, pxy, path, engine);
+}
+
+/******************************************************************************/
+
+bool StochasticMapping::samplePathByRejection_(const BranchModel_& model, size_t x, size_t y, double t, double rate, MutationPath& path, RandomEngine& engine) const
+{
+  uniform_real_distribution<double> unif(0., 1.);
+  MutationPath candidate(alphabet_, x, path.getTotalTime());
+  size_t state = x;
+  double time = 0.;
+  if (x != y)
+  {
+    // The first jump is conditioned to occur before t:
+    double qx = -model.generator(x, x);
+    if (!(qx > 0.))
+      return false;
+    double tau = -log(1. - unif(engine) * (1. - exp(-qx * t))) / qx;
+    state = jump_(model, state, unif(engine));
+    candidate.addEvent(state, tau / rate);
+    time = tau;
+  }
+  while (true)
+  {
+    double q = -model.generator(state, state);
+    if (!(q > 0.))
+      break;
+    double tau = -log(1. - unif(engine)) / q;
+    if (time + tau > t)
+      break;
+    time += tau;
+    state = jump_(model, state, unif(engine));
+    candidate.addEvent(state, tau / rate);
+  }
+  if (state != y)
+    return false;
+  path = candidate;
+  return true;
+}
+
+/******************************************************************************/
+
+void StochasticMapping::samplePathByUniformization_(const BranchModel_& model, size_t x, size_t y, double t, double rate, double pxy, MutationPath& path, RandomEngine& engine) const
+{
+  double mut = model.maxRate * t;
+  if (!(mut > 0.))
+    return;
+  const RowMatrix<double>& r = model.uniformized;
+  uniform_real_distribution<double> unif(0., 1.);
+
+  // Number of jumps, virtual ones included:
+  // P(n) = Poisson(mu t)(n) R^n(x, y) / P(x, y),
+  // with powers[m][k] = R^m(k, y).
+  vector<Vdouble> powers(1, Vdouble(nbStates_, 0.));
+  powers[0][y] = 1.;
+  double u = unif(engine) * pxy;
+  double poisson = exp(-mut);
+  double cumProb = (x == y ? poisson : 0.);
+  size_t maxNbJumps = static_cast<size_t>(mut + 10. * sqrt(mut) + 50.);
+  size_t n = 0;
+  while (cumProb <= u && n < maxNbJumps)
+  {
+    ++n;
+    powers.push_back(Vdouble(nbStates_, 0.));
+    const Vdouble& previous = powers[n - 1];
+    Vdouble& current = powers[n];
+    for (size_t k = 0; k < nbStates_; ++k)
+    {
+      for (size_t j = 0; j < nbStates_; ++j)
+      {
+        current[k] += r(k, j) * previous[j];
+      }
+    }
+    poisson *= mut / static_cast<double>(n);
+    cumProb += poisson * current[x];
+  }
+
+  // Jump times are uniformly distributed, and states are drawn
+  // conditionally on reaching y after the remaining jumps:
+  vector<double> times(n);
+  for (size_t j = 0; j < n; ++j)
+    times[j] = unif(engine) * t;
+  sort(times.begin(), times.end());
+
+  size_t state = x;
+  double last = 0.;
+  Vdouble probs(nbStates_);
+  for (size_t j = 0; j < n; ++j)
+  {
+    const Vdouble& next = powers[n - j - 1];
+    for (size_t k = 0; k < nbStates_; ++k)
+      probs[k] = r(state, k) * next[k];
+    size_t k = sampleIndex_(&probs[0], nbStates_, engine);
+    if (k != state)
+    {
+      path.addEvent(k, (times[j] - last) / rate);
+      last = times[j];
+      state = k;
+    }
+  }
+}
+
+/******************************************************************************/
+
@@ -0,0 +1,221 @@
+//
+// File: StochasticMapping.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef _STOCHASTICMAPPING_H_
+#define _STOCHASTICMAPPING_H_
+
+#include "../Likelihood/DRTreeLikelihood.h"
+#include "../Simulation/MutationProcess.h"
+
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+
+// From the STL:
+#include <vector>
+#include <random>
+#include <functional>
+
+namespace bpp
+{
+
+/**
+ * @brief Sample substitution histories conditioned on the data.
+ *
+ * Where SubstitutionMappingTools computes expected numbers of substitutions,
+ * this class draws complete histories, from which the timing of changes or
+ * co-occurrences between sites can be studied. For a given site, a rate class
+ * and the states at all nodes are first sampled top-down from the conditional
+ * likelihood arrays of a DRTreeLikelihood object. A path is then sampled on
+ * each branch, conditioned on the states at both ends, either by rejection
+ * of forward simulations (Nielsen 2002) or by uniformization (Hobolth and
+ * Stone 2009). Rejection is used when the probability of accepting a
+ * simulation is high enough, uniformization otherwise.
+ *
+ * Each sample of each site has its own random generator, seeded from a
+ * global seed, the site index and the sample index. Samples are
+ * therefore reproducible and do not depend on the number of threads used,
+ * nor on the order in which they are drawn.
+ *
+ * All required quantities are copied or pointed to at construction: the
+ * likelihood object must be kept alive and left unchanged while the sampler
+ * is in use.
+ *
+ * See:
+ * - Nielsen, R., Mapping mutations on phylogenies, Syst. Biol. 2002 51:729-39.
+ * - Hobolth, A. and Stone, E.A., Simulation from endpoint-conditioned,
+ * continuous-time Markov chains on a finite state space, with applications
+ * to molecular evolution, Ann. Appl. Stat. 2009 3:1204-31.
+ *
+ * @author agent
+ */
+  class StochasticMapping
+  {
+  public:
+    /**
+     * @brief The random generator used for each sample.
+     */
+    typedef std::mt19937 RandomEngine;
+
+  private:
+    /*
+     * The generator of the model of a branch, for a group of sites, with the
+     * corresponding transition probabilities for each rate class.
+     */
+    struct BranchModel_
+    {
+      RowMatrix<double> generator;
+      RowMatrix<double> uniformized;
+      double maxRate;
+      VVVdouble pxy;
+
+      BranchModel_() : generator(), uniformized(), maxRate(0), pxy() {}
+    };
+
+    const Alphabet* alphabet_;
+    size_t nbStates_;
+    size_t nbClasses_;
+    size_t nbSites_;
+    size_t nbDistinctSites_;
+    unsigned int seed_;
+    Vdouble rates_;
+
+    /*
+     * Nodes are sorted so that fathers come before their sons, the root
+     * being the first one. Branches are indexed by their child node,
+     * starting at 1.
+     */
+    std::vector<int> nodeIds_;
+    std::vector<size_t> fathers_;
+    std::vector<double> lengths_;
+    std::vector<const VVVdouble*> likelihoods_;
+    std::vector< std::vector<size_t> > siteModels_;
+    std::vector< std::vector<BranchModel_> > models_;
+    std::vector<size_t> rootPatternLinks_;
+
+    /*
+     * For each distinct site, the joint probability of each rate class
+     * and root state, as a flat array indexed by class * nbStates + state.
+     */
+    VVdouble rootProbabilities_;
+
+    double acceptanceThreshold_;
+    unsigned int maxNumberOfTrials_;
+
+  public:
+    /**
+     * @param drtl A DRTreeLikelihood object, initialized and with up-to-date likelihood arrays.
+     * @param seed The global seed used to derive the random generator of each sample.
+     */
+    StochasticMapping(const DRTreeLikelihood& drtl, unsigned int seed = 0) throw (Exception);
+
+    virtual ~StochasticMapping() {}
+
+  public:
+    /**
+     * @return The ids of the nodes defining the branches, in the order used for the paths.
+     */
+    std::vector<int> getBranchIds() const { return std::vector<int>(nodeIds_.begin() + 1, nodeIds_.end()); }
+
+    /**
+     * @return The number of sites in the alignment.
+     */
+    size_t getNumberOfSites() const { return nbSites_; }
+
+    unsigned int getSeed() const { return seed_; }
+
+    /**
+     * @brief Set the minimum estimated acceptance probability for which
+     * paths are sampled by rejection rather than by uniformization.
+     *
+     * @param threshold A probability. 0 means always using rejection, and
+     * any value above 1 always using uniformization.
+     */
+    void setAcceptanceThreshold(double threshold) { acceptanceThreshold_ = threshold; }
+
+    double getAcceptanceThreshold() const { return acceptanceThreshold_; }
+
+    /**
+     * @brief Sample a substitution history for a given site.
+     *
+     * @param site   The index of the site in the alignment.
+     * @param sample The index of the sample, which determines the random generator.
+     * @param paths  [out] The path on each branch, in the order of getBranchIds().
+     * The initial state of a path is the state at the father node, and its final
+     * state the state at the child node. States are model states.
+     * @throw IndexOutOfBoundsException If the site index is not valid.
+     */
+    void sampleHistory(size_t site, size_t sample, std::vector<MutationPath>& paths) const throw (IndexOutOfBoundsException);
+
+    /**
+     * @brief Sample several histories for each site.
+     *
+     * Sites are split in blocks processed on distinct threads. f(site, sample, paths)
+     * is called for each site and sample, and may therefore be called concurrently for
+     * distinct sites. Results do not depend on the number of threads.
+     *
+     * @param nbSamples The number of histories to sample per site.
+     * @param f         The function receiving each sampled history.
+     * @param nbThreads The number of threads to use (0 means all cores).
+     */
+    void sampleHistories(
+      size_t nbSamples,
+      const std::function<void (size_t, size_t, const std::vector<MutationPath>&)>& f,
+      unsigned int nbThreads = 1) const;
+
+  private:
+    size_t sampleIndex_(const double* probabilities, size_t n, RandomEngine& engine) const;
+
+    size_t jump_(const BranchModel_& model, size_t state, double u) const;
+
+    /*
+     * Sample a path from x to y on a branch of length d and relative rate
+     * rate, pxy being the probability of this transition. Times in the path
+     * are expressed in branch length units.
+     */
+    void samplePath_(const BranchModel_& model, size_t x, size_t y, double d, double rate, double pxy, MutationPath& path, RandomEngine& engine) const;
+
+    bool samplePathByRejection_(const BranchModel_& model, size_t x, size_t y, double t, double rate, MutationPath& path, RandomEngine& engine) const;
+
+    void samplePathByUniformization_(const BranchModel_& model, size_t x, size_t y, double t, double rate, double pxy, MutationPath& path, RandomEngine& engine) const;
+  };
+
+} //end of namespace bpp.
+
+#endif //_STOCHASTICMAPPING_H_
+
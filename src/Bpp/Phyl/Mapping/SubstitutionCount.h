@@ -48,6 +48,7 @@
 
 //From the STL:
 #include <vector>
+#include <memory>
 
 namespace bpp
 {
@@ -151,6 +152,30 @@ namespace bpp
      */
     virtual std::vector<double> getNumberOfSubstitutionsForEachType(size_t initialState, size_t finalState, double length) const = 0;
 
+    /**
+     * @brief Get the numbers of susbstitutions for several branch lengths at once, for all types.
+     *
+     * Implementations may share computations between lengths, the default one
+     * calls getAllNumbersOfSubstitutions() for each length and type.
+     *
+     * @param lengths The lengths of the branches (for instance of all branches and rate classes of a tree).
+     * @param counts  [out] For each length and each type (starting from 0), the matrix of all numbers of substitutions.
+     */
+    virtual void getAllNumbersOfSubstitutionsForEachLength(const std::vector<double>& lengths, std::vector< std::vector< RowMatrix<double> > >& counts) const
+    {
+      size_t nbTypes = getNumberOfSubstitutionTypes();
+      counts.resize(lengths.size());
+      for (size_t l = 0; l < lengths.size(); ++l)
+      {
+        counts[l].resize(nbTypes);
+        for (size_t t = 0; t < nbTypes; ++t)
+        {
+          std::unique_ptr< Matrix<double> > nijt(getAllNumbersOfSubstitutions(lengths[l], t + 1));
+          counts[l][t] = RowMatrix<double>(*nijt);
+        }
+      }
+    }
+
     /**
      * @brief Set the substitution model associated with this count, if relevent.
      *
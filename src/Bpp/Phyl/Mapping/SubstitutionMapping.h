@@ -77,9 +77,38 @@ namespace bpp
      * @return The number of distinct types of substitutions mapped.
      */
     virtual size_t getNumberOfSubstitutionTypes() const = 0;
-    
-    virtual double& operator()(size_t nodeIndex, size_t siteIndex, size_t type) = 0;
-    virtual const double& operator()(size_t nodeIndex, size_t siteIndex, size_t type) const = 0;
+
+    /**
+     * @return The number of substitutions of a given type, for a branch and a site.
+     *
+     * @param nodeIndex The index of the branch.
+     * @param siteIndex The index of the site.
+     * @param type      The substitution type (starting from 0).
+     * @warning No index checking is performed, use with care!
+     */
+    virtual double getCount(size_t nodeIndex, size_t siteIndex, size_t type) const = 0;
+
+    /**
+     * @brief Set the number of substitutions of a given type, for a branch and a site.
+     *
+     * Depending on the storage, the value may be stored with a lower precision.
+     *
+     * @warning No index checking is performed, use with care!
+     */
+    virtual void setCount(size_t nodeIndex, size_t siteIndex, size_t type, double value) = 0;
+
+    /**
+     * @brief Same as getCount().
+     *
+     * Values are returned by copy, since some storages do not hold
+     * them as doubles: use setCount() to modify them.
+     *
+     * @warning No index checking is performed, use with care!
+     */
+    double operator()(size_t nodeIndex, size_t siteIndex, size_t type) const
+    {
+      return getCount(nodeIndex, siteIndex, type);
+    }
 };
 
 
@@ -38,12 +38,14 @@
  */
 
 #include "SubstitutionMappingTools.h"
+#include "BinarySubstitutionMappingIO.h"
 #include "UniformizationSubstitutionCount.h"
 #include "DecompositionReward.h"
 #include "ProbabilisticRewardMapping.h"
 #include "RewardMappingTools.h"
 #include "../Likelihood/DRTreeLikelihoodTools.h"
 #include "../Likelihood/MarginalAncestralStateReconstruction.h"
+#include "MappingBlock.h"
 
 #include <Bpp/Text/TextTools.h>
 #include <Bpp/App/ApplicationTools.h>
@@ -55,16 +57,58 @@ using namespace bpp;
 
 // From the STL:
 #include <iomanip>
+#include <map>
+#include <memory>
 
 using namespace std;
 
 /******************************************************************************/
 
-ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionVectors(
+namespace
+{
+  /*
+   * Fill nxy[c][t][x][y] with the numbers of substitutions of each type t (starting from 0),
+   * for a branch of length d and each rate class c, using a single batched call.
+   */
+  void computeCountsForAllClasses_(const SubstitutionCount& substitutionCount, double d, const Vdouble& rcRates, VVVVdouble& nxy)
+  {
+    vector< vector< RowMatrix<double> > > nijt;
+    substitutionCount.getAllNumbersOfSubstitutionsForEachLength(rcRates * d, nijt);
+    nxy.resize(nijt.size());
+    for (size_t c = 0; c < nijt.size(); ++c)
+    {
+      VVVdouble* nxy_c = &nxy[c];
+      nxy_c->resize(nijt[c].size());
+      for (size_t t = 0; t < nijt[c].size(); ++t)
+      {
+        const RowMatrix<double>& nijt_c_t = nijt[c][t];
+        VVdouble* nxy_c_t = &(*nxy_c)[t];
+        nxy_c_t->resize(nijt_c_t.getNumberOfRows());
+        for (size_t x = 0; x < nxy_c_t->size(); ++x)
+        {
+          Vdouble* nxy_c_t_x = &(*nxy_c_t)[x];
+          nxy_c_t_x->resize(nijt_c_t.getNumberOfColumns());
+          for (size_t y = 0; y < nxy_c_t_x->size(); ++y)
+          {
+            (*nxy_c_t_x)[y] = nijt_c_t(x, y);
+          }
+        }
+      }
+    }
+  }
+
+  typedef MappingBlock<SubstitutionCount> BlockSubstitutionCount;
+}
+
+/******************************************************************************/
+
+void SubstitutionMappingTools::computeJointSubstitutionVectors_(
   const DRTreeLikelihood& drtl,
   const vector<int>& nodeIds,
   SubstitutionCount& substitutionCount,
-  bool verbose) throw (Exception)
+  const std::function<void (size_t, const Node*, VVdouble&)>& store,
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
 {
   // Preamble:
   if (!drtl.isInitialized())
@@ -76,20 +120,14 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
   const SiteContainer*    sequences = drtl.getData();
   const DiscreteDistribution* rDist = drtl.getRateDistribution();
 
-  size_t nbSites         = sequences->getNumberOfSites();
   size_t nbDistinctSites = drtl.getLikelihoodData()->getNumberOfDistinctSites();
   size_t nbStates        = sequences->getAlphabet()->getSize();
   size_t nbClasses       = rDist->getNumberOfCategories();
   size_t nbTypes         = substitutionCount.getNumberOfSubstitutionTypes();
   vector<const Node*> nodes    = tree.getNodes();
-  const vector<size_t>* rootPatternLinks
-    = &drtl.getLikelihoodData()->getRootArrayPositions();
   nodes.pop_back(); // Remove root node.
   size_t nbNodes         = nodes.size();
 
-  // We create a new ProbabilisticSubstitutionMapping object:
-  ProbabilisticSubstitutionMapping* substitutions = new ProbabilisticSubstitutionMapping(tree, &substitutionCount, nbSites);
-
   // Store likelihood for each rate for each site:
   VVVdouble lik;
   drtl.computeLikelihoodAtNode(tree.getRootId(), lik);
@@ -114,19 +152,17 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
   if (verbose)
     ApplicationTools::displayTask("Compute joint node-pairs likelihood", true);
 
-  for (size_t l = 0; l < nbNodes; ++l)
+  auto computeBranch = [&](size_t l, BlockSubstitutionCount& count)
   {
     // For each node,
     const Node* currentNode = nodes[l];
     if (nodeIds.size() > 0 && !VectorTools::contains(nodeIds, currentNode->getId()))
-      continue;
+      return;
 
     const Node* father = currentNode->getFather();
 
     double d = currentNode->getDistanceToFather();
 
-    if (verbose)
-      ApplicationTools::displayGauge(l, nbNodes - 1);
     VVdouble substitutionsForCurrentNode(nbDistinctSites);
     for (size_t i = 0; i < nbDistinctSites; ++i)
     {
@@ -276,32 +312,10 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
     while (mit->hasNext())
     {
       TreeLikelihood::ConstBranchModelDescription* bmd = mit->next();
-      substitutionCount.setSubstitutionModel(bmd->getSubstitutionModel());
-      // compute all nxy first:
-      VVVVdouble nxy(nbClasses);
-      for (size_t c = 0; c < nbClasses; ++c)
-      {
-        VVVdouble* nxy_c = &nxy[c];
-        double rc = rcRates[c];
-        nxy_c->resize(nbTypes);
-        for (size_t t = 0; t < nbTypes; ++t)
-        {
-          VVdouble* nxy_c_t = &(*nxy_c)[t];
-          Matrix<double>* nijt = substitutionCount.getAllNumbersOfSubstitutions(d * rc, t + 1);
-           
-          nxy_c_t->resize(nbStates);
-          for (size_t x = 0; x < nbStates; ++x)
-          {
-            Vdouble* nxy_c_t_x = &(*nxy_c_t)[x];
-            nxy_c_t_x->resize(nbStates);
-            for (size_t y = 0; y < nbStates; ++y)
-            {
-              (*nxy_c_t_x)[y] = (*nijt)(x, y);
-            }
-          }
-          delete nijt;
-        }
-      }
+      count.setSubstitutionModel(bmd->getSubstitutionModel());
+      // compute all nxy first, for all rate classes at once:
+      VVVVdouble nxy;
+      computeCountsForAllClasses_(count.get(), d, rcRates, nxy);
 
       // Now loop over sites:
       unique_ptr<TreeLikelihood::SiteIterator> sit(bmd->getNewSiteIterator());
@@ -351,33 +365,158 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
       }
     }
 
-    // Now we just have to copy the substitutions into the result vector:
-    for (size_t i = 0; i < nbSites; ++i)
+    // Now we just have to normalize by the site likelihoods:
+    for (size_t i = 0; i < nbDistinctSites; ++i)
     {
       for (size_t t = 0; t < nbTypes; ++t)
       {
-        (*substitutions)(l, i, t) = substitutionsForCurrentNode[(*rootPatternLinks)[i]][t] / Lr[(*rootPatternLinks)[i]];
+        substitutionsForCurrentNode[i][t] /= Lr[i];
       }
     }
-  }
+    store(l, currentNode, substitutionsForCurrentNode);
+  };
+  BlockSubstitutionCount::forEachBranch(nbNodes, nbThreads, substitutionCount, computeBranch, verbose);
+
   if (verbose)
   {
     if (ApplicationTools::message)
       *ApplicationTools::message << " ";
     ApplicationTools::displayTaskDone();
   }
+}
+
+/******************************************************************************/
+
+ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionVectors(
+  const DRTreeLikelihood& drtl,
+  const vector<int>& nodeIds,
+  SubstitutionCount& substitutionCount,
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
+{
+  // Preamble:
+  if (!drtl.isInitialized())
+    throw Exception("SubstitutionMappingTools::computeSubstitutionVectors(). Likelihood object is not initialized.");
+
+  size_t nbSites         = drtl.getData()->getNumberOfSites();
+  size_t nbTypes         = substitutionCount.getNumberOfSubstitutionTypes();
+  const vector<size_t>* rootPatternLinks
+    = &drtl.getLikelihoodData()->getRootArrayPositions();
+
+  // We create a new ProbabilisticSubstitutionMapping object:
+  ProbabilisticSubstitutionMapping* substitutions = new ProbabilisticSubstitutionMapping(drtl.getTree(), &substitutionCount, nbSites);
+
+  computeJointSubstitutionVectors_(drtl, nodeIds, substitutionCount,
+    [&](size_t l, const Node*, VVdouble& substitutionsForCurrentNode)
+    {
+      // Now we just have to copy the substitutions into the result vector:
+      for (size_t i = 0; i < nbSites; ++i)
+      {
+        for (size_t t = 0; t < nbTypes; ++t)
+        {
+          (*substitutions)(l, i, t) = substitutionsForCurrentNode[(*rootPatternLinks)[i]][t];
+        }
+      }
+    }, verbose, nbThreads);
 
   return substitutions;
 }
 
 /******************************************************************************/
 
+CompactProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeCompactSubstitutionVectors(
+  const DRTreeLikelihood& drtl,
+  const vector<int>& nodeIds,
+  SubstitutionCount& substitutionCount,
+  double threshold,
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
+{
+  // Preamble:
+  if (!drtl.isInitialized())
+    throw Exception("SubstitutionMappingTools::computeCompactSubstitutionVectors(). Likelihood object is not initialized.");
+
+  size_t nbSites         = drtl.getData()->getNumberOfSites();
+  const vector<size_t>* rootPatternLinks
+    = &drtl.getLikelihoodData()->getRootArrayPositions();
+
+  CompactProbabilisticSubstitutionMapping* substitutions = new CompactProbabilisticSubstitutionMapping(drtl.getTree(), &substitutionCount, nbSites, threshold);
+
+  computeJointSubstitutionVectors_(drtl, nodeIds, substitutionCount,
+    [&](size_t l, const Node*, VVdouble& substitutionsForCurrentNode)
+    {
+      VVdouble counts(nbSites);
+      for (size_t i = 0; i < nbSites; ++i)
+      {
+        counts[i] = substitutionsForCurrentNode[(*rootPatternLinks)[i]];
+      }
+      substitutions->setBranch(l, counts);
+    }, verbose, nbThreads);
+
+  return substitutions;
+}
+
+/******************************************************************************/
+
+void SubstitutionMappingTools::computeSubstitutionVectorsToStream(
+  const DRTreeLikelihood& drtl,
+  const vector<int>& nodeIds,
+  SubstitutionCount& substitutionCount,
+  ostream& out,
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
+{
+  // Preamble:
+  if (!drtl.isInitialized())
+    throw Exception("SubstitutionMappingTools::computeSubstitutionVectorsToStream(). Likelihood object is not initialized.");
+
+  const SiteContainer* sequences = drtl.getData();
+  size_t nbSites         = sequences->getNumberOfSites();
+  size_t nbTypes         = substitutionCount.getNumberOfSubstitutionTypes();
+  const vector<size_t>* rootPatternLinks
+    = &drtl.getLikelihoodData()->getRootArrayPositions();
+
+  // Branches are written in the order of the tree nodes:
+  const TreeTemplate<Node> tree(drtl.getTree());
+  vector<const Node*> nodes = tree.getNodes();
+  nodes.pop_back(); // Remove root node.
+  vector<int> branchIds;
+  for (size_t l = 0; l < nodes.size(); ++l)
+  {
+    if (nodeIds.size() == 0 || VectorTools::contains(nodeIds, nodes[l]->getId()))
+      branchIds.push_back(nodes[l]->getId());
+  }
+  vector<int> sitePositions(nbSites);
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    sitePositions[i] = sequences->getSite(i).getPosition();
+  }
+
+  BinarySubstitutionMappingWriter writer(out, branchIds, sitePositions, nbTypes);
+  computeJointSubstitutionVectors_(drtl, nodeIds, substitutionCount,
+    [&](size_t, const Node* node, VVdouble& substitutionsForCurrentNode)
+    {
+      VVdouble counts(nbTypes, Vdouble(nbSites));
+      for (size_t t = 0; t < nbTypes; ++t)
+      {
+        for (size_t i = 0; i < nbSites; ++i)
+        {
+          counts[t][i] = substitutionsForCurrentNode[(*rootPatternLinks)[i]][t];
+        }
+      }
+      writer.writeBranch(writer.getBranchIndex(node->getId()), counts);
+    }, verbose, nbThreads);
+}
+
+/******************************************************************************/
+
 ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionVectors(
   const DRTreeLikelihood& drtl,
   const SubstitutionModelSet& modelSet,
   const vector<int>& nodeIds,
   SubstitutionCount& substitutionCount,
-  bool verbose) throw (Exception)
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
 {
   // Preamble:
   if (!drtl.isInitialized())
@@ -427,19 +566,17 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
   if (verbose)
     ApplicationTools::displayTask("Compute joint node-pairs likelihood", true);
 
-  for (size_t l = 0; l < nbNodes; ++l)
+  auto computeBranch = [&](size_t l, BlockSubstitutionCount& count)
   {
     // For each node,
     const Node* currentNode = nodes[l];
     if (nodeIds.size() > 0 && !VectorTools::contains(nodeIds, currentNode->getId()))
-      continue;
+      return;
 
     const Node* father = currentNode->getFather();
 
     double d = currentNode->getDistanceToFather();
 
-    if (verbose)
-      ApplicationTools::displayGauge(l, nbNodes - 1);
     VVdouble substitutionsForCurrentNode(nbDistinctSites);
     for (size_t i = 0; i < nbDistinctSites; ++i)
     {
@@ -589,32 +726,11 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
     while (mit->hasNext())
     {
       TreeLikelihood::ConstBranchModelDescription* bmd = mit->next();
-      substitutionCount.setSubstitutionModel(modelSet.getSubstitutionModelForNode(currentNode->getId()));
+      count.setSubstitutionModel(modelSet.getSubstitutionModelForNode(currentNode->getId()));
 
-      // compute all nxy first:
-      VVVVdouble nxy(nbClasses);
-      for (size_t c = 0; c < nbClasses; ++c)
-      {
-        VVVdouble* nxy_c = &nxy[c];
-        double rc = rcRates[c];
-        nxy_c->resize(nbTypes);
-        for (size_t t = 0; t < nbTypes; ++t)
-        {
-          VVdouble* nxy_c_t = &(*nxy_c)[t];
-          Matrix<double>* nijt = substitutionCount.getAllNumbersOfSubstitutions(d * rc, t + 1);
-          nxy_c_t->resize(nbStates);
-          for (size_t x = 0; x < nbStates; ++x)
-          {
-            Vdouble* nxy_c_t_x = &(*nxy_c_t)[x];
-            nxy_c_t_x->resize(nbStates);
-            for (size_t y = 0; y < nbStates; ++y)
-            {
-              (*nxy_c_t_x)[y] = (*nijt)(x, y);
-            }
-          }
-          delete nijt;
-        }
-      }
+      // compute all nxy first, for all rate classes at once:
+      VVVVdouble nxy;
+      computeCountsForAllClasses_(count.get(), d, rcRates, nxy);
 
       // Now loop over sites:
       unique_ptr<TreeLikelihood::SiteIterator> sit(bmd->getNewSiteIterator());
@@ -671,7 +787,9 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
         (*substitutions)(l, i, t) = substitutionsForCurrentNode[(*rootPatternLinks)[i]][t] / Lr[(*rootPatternLinks)[i]];
       }
     }
-  }
+  };
+  BlockSubstitutionCount::forEachBranch(nbNodes, nbThreads, substitutionCount, computeBranch, verbose);
+
   if (verbose)
   {
     if (ApplicationTools::message)
@@ -687,7 +805,8 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
 ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionVectorsNoAveraging(
   const DRTreeLikelihood& drtl,
   SubstitutionCount& substitutionCount,
-  bool verbose) throw (Exception)
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
 {
   // Preamble:
   if (!drtl.isInitialized())
@@ -718,7 +837,7 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
   if (verbose)
     ApplicationTools::displayTask("Compute joint node-pairs likelihood", true);
 
-  for (size_t l = 0; l < nbNodes; ++l)
+  auto computeBranch = [&](size_t l, BlockSubstitutionCount& count)
   {
     // For each node,
     const Node* currentNode = nodes[l];
@@ -727,8 +846,6 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
 
     double d = currentNode->getDistanceToFather();
 
-    if (verbose)
-      ApplicationTools::displayGauge(l, nbNodes - 1);
     VVdouble substitutionsForCurrentNode(nbDistinctSites);
     for (size_t i = 0; i < nbDistinctSites; ++i)
     {
@@ -877,31 +994,10 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
     while (mit->hasNext())
     {
       TreeLikelihood::ConstBranchModelDescription* bmd = mit->next();
-      substitutionCount.setSubstitutionModel(bmd->getSubstitutionModel());
-      // compute all nxy first:
-      VVVVdouble nxy(nbClasses);
-      for (size_t c = 0; c < nbClasses; ++c)
-      {
-        double rc = rcRates[c];
-        VVVdouble* nxy_c = &nxy[c];
-        nxy_c->resize(nbTypes);
-        for (size_t t = 0; t < nbTypes; ++t)
-        {
-          VVdouble* nxy_c_t = &(*nxy_c)[t];
-          nxy_c_t->resize(nbStates);
-          Matrix<double>* nijt = substitutionCount.getAllNumbersOfSubstitutions(d * rc, t + 1);
-          for (size_t x = 0; x < nbStates; ++x)
-          {
-            Vdouble* nxy_c_t_x = &(*nxy_c_t)[x];
-            nxy_c_t_x->resize(nbStates);
-            for (size_t y = 0; y < nbStates; ++y)
-            {
-              (*nxy_c_t_x)[y] = (*nijt)(x, y);
-            }
-          }
-          delete nijt;
-        }
-      }
+      count.setSubstitutionModel(bmd->getSubstitutionModel());
+      // compute all nxy first, for all rate classes at once:
+      VVVVdouble nxy;
+      computeCountsForAllClasses_(count.get(), d, rcRates, nxy);
 
       // Now loop over sites:
       unique_ptr<TreeLikelihood::SiteIterator> sit(bmd->getNewSiteIterator());
@@ -969,7 +1065,9 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
         (*substitutions)(l, i, t) = substitutionsForCurrentNode[(*rootPatternLinks)[i]][t];
       }
     }
-  }
+  };
+  BlockSubstitutionCount::forEachBranch(nbNodes, nbThreads, substitutionCount, computeBranch, verbose);
+
   if (verbose)
   {
     if (ApplicationTools::message)
@@ -984,7 +1082,8 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
 ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionVectorsNoAveragingMarginal(
   const DRTreeLikelihood& drtl,
   SubstitutionCount& substitutionCount,
-  bool verbose) throw (Exception)
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
 {
   // Preamble:
   if (!drtl.isInitialized())
@@ -1026,7 +1125,7 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
   if (verbose)
     ApplicationTools::displayTask("Compute substitution vectors", true);
 
-  for (size_t l = 0; l < nbNodes; l++)
+  auto computeBranch = [&](size_t l, BlockSubstitutionCount& count)
   {
     const Node* currentNode = nodes[l];
 
@@ -1034,12 +1133,10 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
 
     double d = currentNode->getDistanceToFather();
 
-    vector<size_t> nodeStates = ancestors[currentNode->getId()]; // These are not 'true' ancestors ;)
-    vector<size_t> fatherStates = ancestors[father->getId()];
+    vector<size_t> nodeStates = ancestors.at(currentNode->getId()); // These are not 'true' ancestors ;)
+    vector<size_t> fatherStates = ancestors.at(father->getId());
 
     // For each node,
-    if (verbose)
-      ApplicationTools::displayGauge(l, nbNodes - 1);
     VVdouble substitutionsForCurrentNode(nbDistinctSites);
     for (size_t i = 0; i < nbDistinctSites; ++i)
     {
@@ -1055,13 +1152,13 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
     while (mit->hasNext())
     {
       TreeLikelihood::ConstBranchModelDescription* bmd = mit->next();
-      substitutionCount.setSubstitutionModel(bmd->getSubstitutionModel());
+      count.setSubstitutionModel(bmd->getSubstitutionModel());
       // compute all nxy first:
       VVVdouble nxyt(nbTypes);
       for (size_t t = 0; t < nbTypes; ++t)
       {
         nxyt[t].resize(nbStates);
-        Matrix<double>* nxy = substitutionCount.getAllNumbersOfSubstitutions(d, t + 1);
+        Matrix<double>* nxy = count.get().getAllNumbersOfSubstitutions(d, t + 1);
         for (size_t x = 0; x < nbStates; ++x)
         {
           nxyt[t][x].resize(nbStates);
@@ -1100,7 +1197,9 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
         (*substitutions)(l, i, t) = substitutionsForCurrentNode[(*rootPatternLinks)[i]][t];
       }
     }
-  }
+  };
+  BlockSubstitutionCount::forEachBranch(nbNodes, nbThreads, substitutionCount, computeBranch, verbose);
+
   if (verbose)
   {
     if (ApplicationTools::message)
@@ -1115,7 +1214,8 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
 ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionVectorsMarginal(
   const DRTreeLikelihood& drtl,
   SubstitutionCount& substitutionCount,
-  bool verbose) throw (Exception)
+  bool verbose,
+  unsigned int nbThreads) throw (Exception)
 {
   // Preamble:
   if (!drtl.isInitialized())
@@ -1150,7 +1250,7 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
   if (verbose)
     ApplicationTools::displayTask("Compute marginal node-pairs likelihoods", true);
 
-  for (size_t l = 0; l < nbNodes; l++)
+  auto computeBranch = [&](size_t l, BlockSubstitutionCount& count)
   {
     const Node* currentNode = nodes[l];
 
@@ -1159,8 +1259,6 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
     double d = currentNode->getDistanceToFather();
 
     // For each node,
-    if (verbose)
-      ApplicationTools::displayGauge(l, nbNodes - 1);
     VVdouble substitutionsForCurrentNode(nbDistinctSites);
     for (size_t i = 0; i < nbDistinctSites; ++i)
     {
@@ -1177,31 +1275,10 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
     while (mit->hasNext())
     {
       TreeLikelihood::ConstBranchModelDescription* bmd = mit->next();
-      substitutionCount.setSubstitutionModel(bmd->getSubstitutionModel());
-      // compute all nxy first:
-      VVVVdouble nxy(nbClasses);
-      for (size_t c = 0; c < nbClasses; ++c)
-      {
-        VVVdouble* nxy_c = &nxy[c];
-        double rc = rcRates[c];
-        nxy_c->resize(nbTypes);
-        for (size_t t = 0; t < nbTypes; ++t)
-        {
-          VVdouble* nxy_c_t = &(*nxy_c)[t];
-          Matrix<double>* nijt = substitutionCount.getAllNumbersOfSubstitutions(d * rc, t + 1);
-          nxy_c_t->resize(nbStates);
-          for (size_t x = 0; x < nbStates; ++x)
-          {
-            Vdouble* nxy_c_t_x = &(*nxy_c_t)[x];
-            nxy_c_t_x->resize(nbStates);
-            for (size_t y = 0; y < nbStates; ++y)
-            {
-              (*nxy_c_t_x)[y] = (*nijt)(x, y);
-            }
-          }
-          delete nijt;
-        }
-      }
+      count.setSubstitutionModel(bmd->getSubstitutionModel());
+      // compute all nxy first, for all rate classes at once:
+      VVVVdouble nxy;
+      computeCountsForAllClasses_(count.get(), d, rcRates, nxy);
 
       // Now loop over sites:
       unique_ptr<TreeLikelihood::SiteIterator> sit(bmd->getNewSiteIterator());
@@ -1245,7 +1322,9 @@ ProbabilisticSubstitutionMapping* SubstitutionMappingTools::computeSubstitutionV
         (*substitutions)(l, i, t) = substitutionsForCurrentNode[(*rootPatternLinks)[i]][t];
       }
     }
-  }
+  };
+  BlockSubstitutionCount::forEachBranch(nbNodes, nbThreads, substitutionCount, computeBranch, verbose);
+
   if (verbose)
   {
     if (ApplicationTools::message)
@@ -1331,6 +1410,50 @@ throw (IOException)
 
 /**************************************************************************************************/
 
+void SubstitutionMappingTools::writeToBinaryStream(
+  const ProbabilisticSubstitutionMapping& substitutions,
+  const SiteContainer& sites,
+  ostream& out)
+throw (Exception)
+{
+  size_t nbBranches = substitutions.getNumberOfBranches();
+  size_t nbSites = substitutions.getNumberOfSites();
+  size_t nbTypes = substitutions.getNumberOfSubstitutionTypes();
+  vector<int> nodeIds(nbBranches);
+  for (size_t j = 0; j < nbBranches; ++j)
+  {
+    nodeIds[j] = substitutions.getNode(j)->getId();
+  }
+  vector<int> sitePositions(nbSites);
+  for (size_t i = 0; i < nbSites; ++i)
+  {
+    sitePositions[i] = sites.getSite(i).getPosition();
+  }
+
+  BinarySubstitutionMappingWriter writer(out, nodeIds, sitePositions, nbTypes);
+  VVdouble counts(nbTypes, Vdouble(nbSites));
+  for (size_t j = 0; j < nbBranches; ++j)
+  {
+    for (size_t t = 0; t < nbTypes; ++t)
+    {
+      for (size_t i = 0; i < nbSites; ++i)
+      {
+        counts[t][i] = substitutions(j, i, t);
+      }
+    }
+    writer.writeBranch(j, counts);
+  }
+}
+
+/**************************************************************************************************/
+
+void SubstitutionMappingTools::readFromBinaryStream(istream& in, ProbabilisticSubstitutionMapping& substitutions)
+throw (Exception)
+{
+  BinarySubstitutionMappingReader reader(in);
+  reader.readMapping(substitutions);
+}
+
 vector<double> SubstitutionMappingTools::computeTotalSubstitutionVectorForSitePerBranch(const SubstitutionMapping& smap, size_t siteIndex)
 {
   size_t nbBranches = smap.getNumberOfBranches();
@@ -1341,7 +1464,7 @@ vector<double> SubstitutionMappingTools::computeTotalSubstitutionVectorForSitePe
     v[l] = 0;
     for (size_t t = 0; t < nbTypes; ++t)
     {
-      v[l] += smap(l, siteIndex, t);
+      v[l] += smap.getCount(l, siteIndex, t);
     }
   }
   return v;
@@ -1358,7 +1481,7 @@ vector<double> SubstitutionMappingTools::computeTotalSubstitutionVectorForSitePe
   {
     v[t] = 0;
     for (size_t l = 0; l < nbBranches; ++l)
-      v[t] += smap(l, siteIndex, t);
+      v[t] += smap.getCount(l, siteIndex, t);
 
   }
   return v;
@@ -1374,7 +1497,7 @@ double SubstitutionMappingTools::computeNormForSite(const SubstitutionMapping& s
     double sum = 0;
     for (size_t t = 0; t < smap.getNumberOfSubstitutionTypes(); ++t)
     {
-      sum += smap(l, siteIndex, t);
+      sum += smap.getCount(l, siteIndex, t);
     }
     sumSquare += sum * sum;
   }
@@ -1392,7 +1515,7 @@ vector<double> SubstitutionMappingTools::computeSumForBranch(const SubstitutionM
   {
     for (size_t t = 0; t < nbTypes; ++t)
     {
-      v[t] += smap(branchIndex, i, t);
+      v[t] += smap.getCount(branchIndex, i, t);
     }
   }
   return v;
@@ -1409,7 +1532,7 @@ vector<double> SubstitutionMappingTools::computeSumForSite(const SubstitutionMap
   {
     for (size_t t = 0; t < nbTypes; ++t)
     {
-      v[t] += smap(i, siteIndex, t);
+      v[t] += smap.getCount(i, siteIndex, t);
     }
   }
   return v;
@@ -1600,13 +1723,15 @@ vector< vector<double> > SubstitutionMappingTools::getNormalizationsPerBranch(
     for (size_t i = 0; i < nbStates; i++)
       usai[nbt].setIndex(supportedStates[i], 0);
 
+  const vector<size_t>& types = reg.getTypeTable();
+  size_t nbRegStates = reg.getSubstitutionModel()->getNumberOfStates();
   for (size_t i = 0; i < nbStates; i++)
   {
     for (size_t j = 0; j < nbStates; j++)
     {
       if (i != j)
       {
-        size_t nbt = reg.getType(i, j);
+        size_t nbt = types[i * nbRegStates + j];
         if (nbt != 0)
           usai[nbt - 1].setIndex(supportedStates[i], usai[nbt - 1].getIndex(supportedStates[i]) + nullModel->Qij(i, j));
       }
@@ -1688,13 +1813,15 @@ vector< vector<double> > SubstitutionMappingTools::getNormalizationsPerBranch(
         for (size_t i = 0; i < nbStates; i++)
           usai[nbt].setIndex(supportedStates[i], 0);
 
+      const vector<size_t>& types = reg.getTypeTable();
+      size_t nbRegStates = reg.getSubstitutionModel()->getNumberOfStates();
       for (size_t i = 0; i < nbStates; i++)
       {
         for (size_t j = 0; j < nbStates; j++)
         {
           if (i != j)
           {
-            size_t nbt = reg.getType(i, j);
+            size_t nbt = types[i * nbRegStates + j];
             if (nbt != 0)
               usai[nbt - 1].setIndex(supportedStates[i], usai[nbt - 1].getIndex(supportedStates[i]) + modn->Qij(i, j));
           }
@@ -1900,7 +2027,17 @@ void SubstitutionMappingTools::computeCountsPerSitePerBranch(
   unique_ptr<SubstitutionCount> count(new UniformizationSubstitutionCount(model, reg.clone()));
   unique_ptr<ProbabilisticSubstitutionMapping> smap(SubstitutionMappingTools::computeSubstitutionVectors(drtl, ids, *count, false));
 
-  size_t nbSites = smap->getNumberOfSites();
+  computeCountsPerSitePerBranch(*smap, ids, result);
+}
+
+/**************************************************************************************************/
+
+void SubstitutionMappingTools::computeCountsPerSitePerBranch(
+  const SubstitutionMapping& smap,
+  const vector<int>& ids,
+  VVdouble& result)
+{
+  size_t nbSites = smap.getNumberOfSites();
   size_t nbBr = ids.size();
 
   VectorTools::resize2(result, nbSites, nbBr);
@@ -1908,12 +2045,12 @@ void SubstitutionMappingTools::computeCountsPerSitePerBranch(
   vector<size_t> sdi(nbBr);  // reverse of ids
   for (size_t i = 0; i < nbBr; ++i)
   {
-    sdi[i] = smap->getNodeIndex(ids[i]);
+    sdi[i] = smap.getNodeIndex(ids[i]);
   }
 
   for (size_t k = 0; k < nbSites; ++k)
   {
-    vector<double> countsf = SubstitutionMappingTools::computeTotalSubstitutionVectorForSitePerBranch(*smap, k);
+    vector<double> countsf = SubstitutionMappingTools::computeTotalSubstitutionVectorForSitePerBranch(smap, k);
     Vdouble* resS=&result[k];
     
     for (size_t i = 0; i < nbBr; ++i)
@@ -1934,16 +2071,23 @@ void SubstitutionMappingTools::computeCountsPerSitePerType(
   unique_ptr<SubstitutionCount> count(new UniformizationSubstitutionCount(model, reg.clone()));
   unique_ptr<ProbabilisticSubstitutionMapping> smap(SubstitutionMappingTools::computeSubstitutionVectors(drtl, ids, *count, false));
 
-  size_t nbSites = smap->getNumberOfSites();
-  size_t nbTypes = smap->getNumberOfSubstitutionTypes();
+  computeCountsPerSitePerType(*smap, result);
+}
+
+/**************************************************************************************************/
+
+void SubstitutionMappingTools::computeCountsPerSitePerType(
+  const SubstitutionMapping& smap,
+  VVdouble& result)
+{
+  size_t nbSites = smap.getNumberOfSites();
+  size_t nbTypes = smap.getNumberOfSubstitutionTypes();
 
   VectorTools::resize2(result, nbSites, nbTypes);
 
-  vector<unique_ptr<ProbabilisticRewardMapping> > rmap;
-  
   for (size_t k = 0; k < nbSites; ++k)
   {
-    vector<double> countsf = SubstitutionMappingTools::computeTotalSubstitutionVectorForSitePerType(*smap, k);
+    vector<double> countsf = SubstitutionMappingTools::computeTotalSubstitutionVectorForSitePerType(smap, k);
 
     Vdouble* resS=&result[k];
     
@@ -1984,13 +2128,15 @@ void SubstitutionMappingTools::computeCountsPerSitePerType(
     for (size_t i = 0; i < nbStates; i++)
       usai[nbt].setIndex(supportedStates[i], 0);
 
+  const vector<size_t>& types = reg.getTypeTable();
+  size_t nbRegStates = reg.getSubstitutionModel()->getNumberOfStates();
   for (size_t i = 0; i < nbStates; i++)
   {
     for (size_t j = 0; j < nbStates; j++)
     {
       if (i != j)
       {
-        size_t nbt = reg.getType(i, j);
+        size_t nbt = types[i * nbRegStates + j];
         if (nbt != 0)
           usai[nbt - 1].setIndex(supportedStates[i], usai[nbt - 1].getIndex(supportedStates[i]) + nullModel->Qij(i, j));
       }
@@ -2111,13 +2257,15 @@ void SubstitutionMappingTools::computeCountsPerSitePerType(
         for (size_t i = 0; i < nbStates; i++)
           usai[nbt].setIndex(supportedStates[i], 0);
       
+      const vector<size_t>& types = reg.getTypeTable();
+      size_t nbRegStates = reg.getSubstitutionModel()->getNumberOfStates();
       for (size_t i = 0; i < nbStates; i++)
       {
         for (size_t j = 0; j < nbStates; j++)
         {
           if (i != j)
           {
-            size_t nbt = reg.getType(i, j);
+            size_t nbt = types[i * nbRegStates + j];
             if (nbt != 0)
               usai[nbt - 1].setIndex(supportedStates[i], usai[nbt - 1].getIndex(supportedStates[i]) + modn->Qij(i, j));
           }
@@ -2202,12 +2350,28 @@ void SubstitutionMappingTools::computeCountsPerSitePerBranchPerType(
   unique_ptr<SubstitutionCount> count(new UniformizationSubstitutionCount(model, reg.clone()));
   unique_ptr<ProbabilisticSubstitutionMapping> smap(SubstitutionMappingTools::computeSubstitutionVectors(drtl, ids, *count, false));
 
-  size_t nbSites = smap->getNumberOfSites();
+  computeCountsPerSitePerBranchPerType(*smap, ids, result);
+}
+
+/**************************************************************************************************/
+
+void SubstitutionMappingTools::computeCountsPerSitePerBranchPerType(
+  const SubstitutionMapping& smap,
+  const vector<int>& ids,
+  VVVdouble& result)
+{
+  size_t nbSites = smap.getNumberOfSites();
   size_t nbBr = ids.size();
-  size_t nbTypes= reg.getNumberOfSubstitutionTypes();
+  size_t nbTypes= smap.getNumberOfSubstitutionTypes();
 
   VectorTools::resize3(result, nbSites, nbBr, nbTypes);
   
+  vector<size_t> sdi(nbBr);  // reverse of ids
+  for (size_t k = 0; k < nbBr; ++k)
+  {
+    sdi[k] = smap.getNodeIndex(ids[k]);
+  }
+
   for (size_t i = 0; i < nbTypes; ++i)
   {
     for (size_t j = 0; j < nbSites; ++j)
@@ -2216,7 +2380,7 @@ void SubstitutionMappingTools::computeCountsPerSitePerBranchPerType(
       
       for (size_t k = 0; k < nbBr; ++k)
       {
-        resS[k][i] = (*smap)(smap->getNodeIndex(ids[k]), j, i);
+        resS[k][i] = smap.getCount(sdi[k], j, i);
       }
     }
   }
@@ -2260,13 +2424,15 @@ void SubstitutionMappingTools::computeCountsPerSitePerBranchPerType(
     for (size_t i = 0; i < nbStates; i++)
       usai[nbt].setIndex(supportedStates[i], 0);
 
+  const vector<size_t>& types = reg.getTypeTable();
+  size_t nbRegStates = reg.getSubstitutionModel()->getNumberOfStates();
   for (size_t i = 0; i < nbStates; i++)
   {
     for (size_t j = 0; j < nbStates; j++)
     {
       if (i != j)
       {
-        size_t nbt = reg.getType(i, j);
+        size_t nbt = types[i * nbRegStates + j];
         if (nbt != 0)
           usai[nbt - 1].setIndex(supportedStates[i], usai[nbt - 1].getIndex(supportedStates[i]) + nullModel->Qij(i, j));
       }
@@ -2365,13 +2531,15 @@ void SubstitutionMappingTools::computeCountsPerSitePerBranchPerType(
         for (size_t i = 0; i < nbStates; i++)
           usai[nbt].setIndex(supportedStates[i], 0);
       
+      const vector<size_t>& types = reg.getTypeTable();
+      size_t nbRegStates = reg.getSubstitutionModel()->getNumberOfStates();
       for (size_t i = 0; i < nbStates; i++)
       {
         for (size_t j = 0; j < nbStates; j++)
         {
           if (i != j)
           {
-            size_t nbt = reg.getType(i, j);
+            size_t nbt = types[i * nbRegStates + j];
             if (nbt != 0)
               usai[nbt - 1].setIndex(supportedStates[i], usai[nbt - 1].getIndex(supportedStates[i]) + modn->Qij(i, j));
           }
@@ -41,10 +41,14 @@
 #define _SUBSTITUTIONMAPPINGTOOLS_H_
 
 #include "ProbabilisticSubstitutionMapping.h"
+#include "CompactProbabilisticSubstitutionMapping.h"
 #include "SubstitutionCount.h"
 #include "OneJumpSubstitutionCount.h"
 #include "../Likelihood/DRTreeLikelihood.h"
 
+// From the STL:
+#include <functional>
+
 namespace bpp
 {
 /**
@@ -74,16 +78,21 @@ namespace bpp
      * @param drtl              A DRTreeLikelihood object.
      * @param substitutionCount The SubstitutionCount to use.
      * @param verbose           Print info to screen.
+     * @param nbThreads         Number of threads the branches are shared
+     *                          between (0 for all cores). Each thread works
+     *                          on copies of the count and of the models, and
+     *                          results do not depend on the number of threads.
      * @return A vector of substitutions vectors (one for each site).
      * @throw Exception If the likelihood object is not initialized.
      */
     static ProbabilisticSubstitutionMapping* computeSubstitutionVectors(
       const DRTreeLikelihood& drtl,
       SubstitutionCount& substitutionCount,
-      bool verbose = true) throw (Exception)
+      bool verbose = true,
+      unsigned int nbThreads = 1) throw (Exception)
     {
       std::vector<int> nodeIds;
-      return computeSubstitutionVectors(drtl, nodeIds, substitutionCount, verbose);
+      return computeSubstitutionVectors(drtl, nodeIds, substitutionCount, verbose, nbThreads);
     }
 
     /**
@@ -96,6 +105,7 @@ namespace bpp
      *                          on all nodes.
      * @param substitutionCount The SubstitutionCount to use.
      * @param verbose           Print info to screen.
+     * @param nbThreads         Number of threads to use (see computeSubstitutionVectors).
      * @return A vector of substitutions vectors (one for each site).
      * @throw Exception If the likelihood object is not initialized.
      */
@@ -103,14 +113,65 @@ namespace bpp
       const DRTreeLikelihood& drtl,
       const std::vector<int>& nodeIds,
       SubstitutionCount& substitutionCount,
-      bool verbose = true) throw (Exception);
+      bool verbose = true,
+      unsigned int nbThreads = 1) throw (Exception);
+
+    /**
+     * @brief Compute the substitutions vectors like computeSubstitutionVectors,
+     * but store them in single precision, optionally sparsely.
+     *
+     * @param drtl              A DRTreeLikelihood object.
+     * @param nodeIds           The Ids of the nodes the substitutions
+     *                          are counted on. If empty, count substitutions
+     *                          on all nodes.
+     * @param substitutionCount The SubstitutionCount to use.
+     * @param threshold         If non-negative, only counts above this value are stored
+     *                          (see CompactProbabilisticSubstitutionMapping).
+     * @param verbose           Print info to screen.
+     * @param nbThreads         Number of threads to use (see computeSubstitutionVectors).
+     * @return A vector of substitutions vectors (one for each site).
+     * @throw Exception If the likelihood object is not initialized.
+     */
+    static CompactProbabilisticSubstitutionMapping* computeCompactSubstitutionVectors(
+      const DRTreeLikelihood& drtl,
+      const std::vector<int>& nodeIds,
+      SubstitutionCount& substitutionCount,
+      double threshold = -1,
+      bool verbose = true,
+      unsigned int nbThreads = 1) throw (Exception);
+
+    /**
+     * @brief Compute the substitutions vectors like computeSubstitutionVectors,
+     * but write them to a stream in the binary columnar format, branch by branch,
+     * instead of keeping them in memory.
+     *
+     * @param drtl              A DRTreeLikelihood object.
+     * @param nodeIds           The Ids of the nodes the substitutions
+     *                          are counted on. If empty, count substitutions
+     *                          on all nodes.
+     * @param substitutionCount The SubstitutionCount to use.
+     * @param out               The output stream. It must allow to seek, as
+     *                          branches may not be written in order.
+     * @param verbose           Print info to screen.
+     * @param nbThreads         Number of threads to use (see computeSubstitutionVectors).
+     * @throw Exception If the likelihood object is not initialized, or if writing failed.
+     * @see BinarySubstitutionMappingFormat
+     */
+    static void computeSubstitutionVectorsToStream(
+      const DRTreeLikelihood& drtl,
+      const std::vector<int>& nodeIds,
+      SubstitutionCount& substitutionCount,
+      std::ostream& out,
+      bool verbose = true,
+      unsigned int nbThreads = 1) throw (Exception);
 
     static ProbabilisticSubstitutionMapping* computeSubstitutionVectors(
       const DRTreeLikelihood& drtl,
       const SubstitutionModelSet& modelSet,
       const std::vector<int>& nodeIds,
       SubstitutionCount& substitutionCount,
-      bool verbose = true) throw (Exception);
+      bool verbose = true,
+      unsigned int nbThreads = 1) throw (Exception);
 
     /**
      * @brief Compute the substitutions vectors for a particular dataset using the
@@ -129,13 +190,15 @@ namespace bpp
      * @param drtl              A DRTreeLikelihood object.
      * @param substitutionCount The substitutionsCount to use.
      * @param verbose           Print info to screen.
+     * @param nbThreads         Number of threads to use (see computeSubstitutionVectors).
      * @return A vector of substitutions vectors (one for each site).
      * @throw Exception If the likelihood object is not initialized.
      */
     static ProbabilisticSubstitutionMapping* computeSubstitutionVectorsNoAveraging(
       const DRTreeLikelihood& drtl,
       SubstitutionCount& substitutionCount,
-      bool verbose = true) throw (Exception);
+      bool verbose = true,
+      unsigned int nbThreads = 1) throw (Exception);
 
 
     /**
@@ -153,13 +216,15 @@ namespace bpp
      * @param drtl              A DRTreeLikelihood object.
      * @param substitutionCount The substitutionsCount to use.
      * @param verbose           Print info to screen.
+     * @param nbThreads         Number of threads to use (see computeSubstitutionVectors).
      * @return A vector of substitutions vectors (one for each site).
      * @throw Exception If the likelihood object is not initialized.
      */
     static ProbabilisticSubstitutionMapping* computeSubstitutionVectorsNoAveragingMarginal(
       const DRTreeLikelihood& drtl,
       SubstitutionCount& substitutionCount,
-      bool verbose = true) throw (Exception);
+      bool verbose = true,
+      unsigned int nbThreads = 1) throw (Exception);
 
 
     /**
@@ -174,13 +239,15 @@ namespace bpp
      * @param drtl              A DRTreeLikelihood object.
      * @param substitutionCount The substitutionsCount to use.
      * @param verbose           Print info to screen.
+     * @param nbThreads         Number of threads to use (see computeSubstitutionVectors).
      * @return A vector of substitutions vectors (one for each site).
      * @throw Exception If the likelihood object is not initialized.
      */
     static ProbabilisticSubstitutionMapping* computeSubstitutionVectorsMarginal(
       const DRTreeLikelihood& drtl,
       SubstitutionCount& substitutionCount,
-      bool verbose = true) throw (Exception);
+      bool verbose = true,
+      unsigned int nbThreads = 1) throw (Exception);
 
 
     /**
@@ -230,6 +297,36 @@ namespace bpp
       throw (IOException);
 
 
+    /**
+     * @brief Write all types of the substitutions vectors to a stream, in the
+     * binary columnar format.
+     *
+     * @param substitutions The substitutions vectors to write.
+     * @param sites         The dataset associated to the vectors
+     * (needed to know the position of each site in the dataset).
+     * @param out           The output stream where to write the vectors.
+     * @throw Exception If an output error happens.
+     * @see BinarySubstitutionMappingFormat
+     */
+    static void writeToBinaryStream(
+      const ProbabilisticSubstitutionMapping& substitutions,
+      const SiteContainer& sites,
+      std::ostream& out)
+      throw (Exception);
+
+    /**
+     * @brief Read substitutions vectors written by writeToBinaryStream.
+     *
+     * Use BinarySubstitutionMappingReader to read only some branches, types or sites.
+     *
+     * @param in            The input stream where to read the vectors.
+     * @param substitutions The mapping object to fill, with the same tree and number of types.
+     * @throw Exception If an input error happens.
+     */
+    static void readFromBinaryStream(std::istream& in, ProbabilisticSubstitutionMapping& substitutions)
+      throw (Exception);
+
+
     /**
      * @brief Sum all type of substitutions for each branch of a given
      * position (specified by its index). 
@@ -483,6 +580,20 @@ namespace bpp
       const SubstitutionRegister& reg,
       VVdouble& array);
 
+    /**
+     * @brief Compute the sum over all types of the counts per site
+     * per branch, from an existing mapping.
+     *
+     * @param smap              The substitution mapping, with any storage.
+     * @param ids               The numbers of the nodes of the tree
+     * @param result            the resulted counts as an tabular
+     *                          site X branchid
+     */
+    static void computeCountsPerSitePerBranch(
+      const SubstitutionMapping& smap,
+      const std::vector<int>& ids,
+      VVdouble& result);
+
 
     /**
      *@}
@@ -617,6 +728,18 @@ namespace bpp
       const SubstitutionRegister& reg,
       VVdouble& result);
 
+    /**
+     * @brief Compute the sum over all branches of the counts per type per site,
+     * from an existing mapping.
+     *
+     * @param smap              The substitution mapping, with any storage.
+     * @param result            the resulted counts as an tabular
+     *                          site X TypeId
+     */
+    static void computeCountsPerSitePerType(
+      const SubstitutionMapping& smap,
+      VVdouble& result);
+
     /**
      * @brief Compute the sum over all branches of the normalized
      * counts per site per type.
@@ -709,6 +832,19 @@ namespace bpp
       const SubstitutionRegister& reg,
       VVVdouble& result);
 
+    /**
+     * @brief Compute counts per site per branch per type, from an existing mapping.
+     *
+     * @param smap              The substitution mapping, with any storage.
+     * @param ids               The numbers of the nodes of the tree
+     * @param result            the resulted counts as an tabular
+     *                          site X branchid X typeId
+     */
+    static void computeCountsPerSitePerBranchPerType(
+      const SubstitutionMapping& smap,
+      const std::vector<int>& ids,
+      VVVdouble& result);
+
     /** 
      * @brief Compute normalized counts per site per branch per type.
      *
@@ -814,6 +950,22 @@ namespace bpp
      *
      */
 
+  private:
+    /**
+     * @brief Compute the substitutions vectors averaged over all pairs of states,
+     * and give the ones of each branch to store(l, node, counts), with l the index
+     * of the branch and counts[i][t] the number of substitutions of type t for
+     * distinct site i.
+     *
+     * With several threads, store is called concurrently for distinct branches.
+     */
+    static void computeJointSubstitutionVectors_(
+      const DRTreeLikelihood& drtl,
+      const std::vector<int>& nodeIds,
+      SubstitutionCount& substitutionCount,
+      const std::function<void (size_t, const Node*, VVdouble&)>& store,
+      bool verbose,
+      unsigned int nbThreads) throw (Exception);
   };
 } // end of namespace bpp.
 
@@ -44,6 +44,7 @@ using namespace std;
 
 void GeneralSubstitutionRegister::updateTypes_()
 {
+  resetTypeTable_();
   types_.clear();
   for (size_t i = 0; i < size_; i++)
   {
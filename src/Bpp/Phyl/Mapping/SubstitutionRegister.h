@@ -60,6 +60,7 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <mutex>
 
 namespace bpp
 {
@@ -114,6 +115,18 @@ namespace bpp
      */
     virtual size_t getType(size_t fromState, size_t toState) const = 0;
 
+    /**
+     * @brief Get the substitution types of all pairs of model states at once.
+     *
+     * The table is stored as a flat array of size n * n, where n is the number of states
+     * of the substitution model: the type of the substitution from state i to state j is
+     * found at index i * n + j. Counting procedures should prefer it to repeated calls of
+     * getType in their inner loops.
+     *
+     * @return A reference toward the table of substitution types.
+     */
+    virtual const std::vector<size_t>& getTypeTable() const = 0;
+
     /**
      * @brief Get the name of a given substitution type.
      *
@@ -132,20 +145,33 @@ namespace bpp
   protected:
     const SubstitutionModel* model_;
     std::string name_;
+
+  private:
+    /**
+     * @brief The table of substitution types, built on first request.
+     *
+     * Counting procedures may request it concurrently from several
+     * threads, hence the mutex guarding its construction.
+     */
+    mutable std::vector<size_t> typeTable_;
+    mutable std::mutex typeTableMutex_;
     
   public:
     AbstractSubstitutionRegister(const SubstitutionModel* model, const std::string& name) :
-      model_(model), name_(name)
+      model_(model), name_(name), typeTable_(), typeTableMutex_()
     {}
 
     AbstractSubstitutionRegister(const AbstractSubstitutionRegister& asr) :
-      model_(asr.model_), name_(asr.name_)
+      model_(asr.model_), name_(asr.name_), typeTable_(asr.copyTypeTable_()), typeTableMutex_()
     {}
 
     AbstractSubstitutionRegister& operator=(const AbstractSubstitutionRegister& asr)
     {
       model_ = asr.model_;
       name_ = asr.name_;
+      std::vector<size_t> table = asr.copyTypeTable_();
+      std::lock_guard<std::mutex> lock(typeTableMutex_);
+      typeTable_.swap(table);
       return *this;
     }
 
@@ -160,6 +186,43 @@ namespace bpp
     {
       return name_;
     }
+
+    const std::vector<size_t>& getTypeTable() const
+    {
+      std::lock_guard<std::mutex> lock(typeTableMutex_);
+      if (typeTable_.empty())
+      {
+        size_t n = model_->getNumberOfStates();
+        typeTable_.resize(n * n);
+        for (size_t i = 0; i < n; ++i)
+        {
+          for (size_t j = 0; j < n; ++j)
+          {
+            typeTable_[i * n + j] = getType(i, j);
+          }
+        }
+      }
+      return typeTable_;
+    }
+
+  protected:
+    /**
+     * @brief Discard the table of substitution types.
+     *
+     * Must be called by derived classes each time the types they return change.
+     */
+    void resetTypeTable_()
+    {
+      std::lock_guard<std::mutex> lock(typeTableMutex_);
+      typeTable_.clear();
+    }
+
+  private:
+    std::vector<size_t> copyTypeTable_() const
+    {
+      std::lock_guard<std::mutex> lock(typeTableMutex_);
+      return typeTable_;
+    }
     
   };
 
@@ -369,6 +432,7 @@ namespace bpp
           throw Exception("VectorOfSubstitionRegisters::addRegister : mismatch between models");
       
         vSubReg_.push_back(reg);
+        resetTypeTable_();
       }
     }
     
@@ -54,11 +54,13 @@ UniformizationSubstitutionCount::UniformizationSubstitutionCount(const Substitut
   model_(model),
   nbStates_(model->getNumberOfStates()),
   bMatrices_(reg->getNumberOfSubstitutionTypes()),
+  generator_(),
+  uniformized_(),
   power_(),
   s_(reg->getNumberOfSubstitutionTypes()),
   miu_(0),
   counts_(reg->getNumberOfSubstitutionTypes()),
-  currentLength_(1.)
+  currentLength_(-1.)
 {
   //Check compatiblity between model and substitution register:
   if (model->getAlphabet()->getAlphabetType() != reg->getAlphabet()->getAlphabetType())
@@ -67,17 +69,7 @@ UniformizationSubstitutionCount::UniformizationSubstitutionCount(const Substitut
   //Initialize all B matrices according to substitution register. This is done once for all,
   //unless the number of states changes:
   initBMatrices_();
-  fillBMatrices_();
-
-  for (unsigned int i = 0; i < nbStates_; ++i) {
-    double diagQ = abs(model_->Qij(i, i));
-    if (diagQ > miu_)
-      miu_ = diagQ;
-  }
-  
-  if (miu_>10000)
-    throw Exception("UniformizationSubstitutionCount::UniformizationSubstitutionCount The maximum diagonal values of generator is above 10000. Abort, chose another mapping method");
-      
+  updateUniformization_();
 }        
 
 /******************************************************************************/
@@ -96,15 +88,20 @@ void UniformizationSubstitutionCount::initBMatrices_()
   //Re-initialize all B matrices according to substitution register.
   for (size_t i = 0; i < register_->getNumberOfSubstitutionTypes(); ++i) {
     bMatrices_[i].resize(nbStates_, nbStates_);
+    MatrixTools::fill(bMatrices_[i], 0.);
     counts_[i].resize(nbStates_, nbStates_);
   }
+  //Force the update of the cached sequences:
+  generator_.resize(0, 0);
 }
 
-void UniformizationSubstitutionCount::fillBMatrices_()
+void UniformizationSubstitutionCount::fillBMatrices_() const
 {
+  const vector<size_t>& types = register_->getTypeTable();
+  size_t n = register_->getSubstitutionModel()->getNumberOfStates();
   for (size_t j = 0; j < nbStates_; ++j) {
     for (size_t k = 0; k < nbStates_; ++k) {
-      size_t i = register_->getType(j, k);
+      size_t i = types[j * n + k];
       if (i > 0 && k != j) {
         //jdutheil on 25/07/14: I think this is incorrect, weights should only come at the end.
         //bMatrices_[i - 1](j, k) = model_->Qij(j, k) * (weights_ ? weights_->getIndex(fromState, toState) : 1);
@@ -114,60 +111,113 @@ void UniformizationSubstitutionCount::fillBMatrices_()
   }
 }
 
-
 /******************************************************************************/
 
-void UniformizationSubstitutionCount::computeCounts_(double length) const
+void UniformizationSubstitutionCount::updateUniformization_() const
 {
-  double lam = miu_ * length;
+  const Matrix<double>& gen = model_->getGenerator();
+  bool upToDate = (generator_.getNumberOfRows() == nbStates_);
+  for (size_t i = 0; upToDate && i < nbStates_; ++i) {
+    for (size_t j = 0; upToDate && j < nbStates_; ++j) {
+      upToDate = (generator_(i, j) == gen(i, j));
+    }
+  }
+  if (upToDate)
+    return;
+
+  fillBMatrices_();
+
+  double miu = 0;
+  for (size_t i = 0; i < nbStates_; ++i) {
+    double diagQ = abs(gen(i, i));
+    if (diagQ > miu)
+      miu = diagQ;
+  }
+  if (miu > 10000)
+    throw Exception("UniformizationSubstitutionCount. The maximum diagonal values of generator is above 10000. Abort, chose another mapping method.");
+  miu_ = miu;
+
+  generator_ = RowMatrix<double>(gen);
   RowMatrix<double> I;
   MatrixTools::getId(nbStates_, I);
-  RowMatrix<double> R(model_->getGenerator());
-  MatrixTools::scale(R, 1. / miu_);
-  MatrixTools::add(R, I);
-  
-  //compute the stopping point
-  //use the tail of Poisson distribution
-  //can be approximated by 4 + 6 * sqrt(lam) + lam
-  size_t nMax = static_cast<size_t>(ceil(4 + 6 * sqrt(lam) + lam));
+  uniformized_ = generator_;
+  MatrixTools::scale(uniformized_, 1. / miu_);
+  MatrixTools::add(uniformized_, I);
+
+  power_.assign(1, I);
+  for (size_t i = 0; i < s_.size(); ++i)
+    s_[i].assign(1, bMatrices_[i]);
+  currentLength_ = -1.;
+}
+
+void UniformizationSubstitutionCount::extendSequences_(size_t nMax) const
+{
+  size_t n0 = power_.size();
+  if (n0 > nMax)
+    return;
 
   //compute the powers of R
   power_.resize(nMax + 1);
-  power_[0] = I;
-  for (size_t i = 1; i < nMax + 1; ++i)
-    MatrixTools::mult(power_[i - 1], R, power_[i]);
+  for (size_t l = n0; l < nMax + 1; ++l)
+    MatrixTools::mult(power_[l - 1], uniformized_, power_[l]);
 
-  for (size_t i = 0; i < register_->getNumberOfSubstitutionTypes(); ++i) {
+  RowMatrix<double> tmp(nbStates_, nbStates_);
+  for (size_t i = 0; i < s_.size(); ++i) {
     s_[i].resize(nMax + 1);
-    MatrixTools::mult(bMatrices_[i], power_[0], s_[i][0]);
-    RowMatrix<double> tmp(nbStates_, nbStates_);
-    for (size_t l = 1; l < nMax + 1; ++l) {
-      MatrixTools::mult(R, s_[i][l - 1], s_[i][l]);
+    for (size_t l = n0; l < nMax + 1; ++l) {
+      MatrixTools::mult(uniformized_, s_[i][l - 1], s_[i][l]);
       MatrixTools::mult(bMatrices_[i], power_[l], tmp);
       MatrixTools::add(s_[i][l], tmp);
     }
-    MatrixTools::fill(counts_[i], 0);
+  }
+}
+
+/******************************************************************************/
+
+void UniformizationSubstitutionCount::computeCounts_(double length) const
+{
+  computeCounts_(length, counts_);
+  currentLength_ = length;
+}
+
+void UniformizationSubstitutionCount::computeCounts_(double length, vector< RowMatrix<double> >& counts) const
+{
+  updateUniformization_();
+  double lam = miu_ * length;
+  size_t nMax = getNumberOfTerms_(length);
+  extendSequences_(nMax);
+
+  size_t nbTypes = register_->getNumberOfSubstitutionTypes();
+  counts.resize(nbTypes);
+  for (size_t i = 0; i < nbTypes; ++i) {
+    RowMatrix<double>& counts_i = counts[i];
+    counts_i.resize(nbStates_, nbStates_);
+    MatrixTools::fill(counts_i, 0);
     for (size_t l = 0; l < nMax + 1; ++l) {
-      tmp = s_[i][l];
       //double f = (pow(lam, static_cast<double>(l + 1)) * exp(-lam) / static_cast<double>(NumTools::fact(l + 1))) / miu_;
       double logF = static_cast<double>(l + 1) * log(lam) - lam - log(miu_) - NumTools::logFact(static_cast<double>(l + 1));
-      MatrixTools::scale(tmp, exp(logF));
-      MatrixTools::add(counts_[i], tmp);
+      double f = exp(logF);
+      const RowMatrix<double>& s_i_l = s_[i][l];
+      for (size_t j = 0; j < nbStates_; ++j) {
+        for (size_t k = 0; k < nbStates_; ++k) {
+          counts_i(j, k) += f * s_i_l(j, k);
+        }
+      }
     }
   }
 
   // Now we must divide by pijt and account for putative weights:
   vector<int> supportedStates = model_->getAlphabetStates();
-  RowMatrix<double> P = model_->getPij_t(length);
-  for (size_t i = 0; i < register_->getNumberOfSubstitutionTypes(); i++) {
+  const Matrix<double>& P = model_->getPij_t(length);
+  for (size_t i = 0; i < nbTypes; i++) {
     for (size_t j = 0; j < nbStates_; j++) {
       for(size_t k = 0; k < nbStates_; k++) {
-        counts_[i](j, k) /= P(j, k);
-        if (std::isinf(counts_[i](j, k)) || std::isnan(counts_[i](j, k)) || counts_[i](j, k) < 0.)
-          counts_[i](j, k) = 0;
+        counts[i](j, k) /= P(j, k);
+        if (std::isinf(counts[i](j, k)) || std::isnan(counts[i](j, k)) || counts[i](j, k) < 0.)
+          counts[i](j, k) = 0;
         //Weights:
         if (weights_)
-          counts_[i](j, k) *= weights_->getIndex(supportedStates[j], supportedStates[k]);
+          counts[i](j, k) *= weights_->getIndex(supportedStates[j], supportedStates[k]);
       }
     }
   }
@@ -221,6 +271,26 @@ std::vector<double> UniformizationSubstitutionCount::getNumberOfSubstitutionsFor
     
 /******************************************************************************/
 
+void UniformizationSubstitutionCount::getAllNumbersOfSubstitutionsForEachLength(const std::vector<double>& lengths, std::vector< std::vector< RowMatrix<double> > >& counts) const
+{
+  double maxLength = 0;
+  for (size_t l = 0; l < lengths.size(); ++l) {
+    if (lengths[l] < 0)
+      throw Exception("UniformizationSubstitutionCount::getAllNumbersOfSubstitutionsForEachLength. Negative branch length: " + TextTools::toString(lengths[l]) + ".");
+    if (lengths[l] > maxLength)
+      maxLength = lengths[l];
+  }
+  //Extend the cached sequences once for all:
+  updateUniformization_();
+  extendSequences_(getNumberOfTerms_(maxLength));
+
+  counts.resize(lengths.size());
+  for (size_t l = 0; l < lengths.size(); ++l)
+    computeCounts_(lengths[l], counts[l]);
+}
+
+/******************************************************************************/
+
 void UniformizationSubstitutionCount::setSubstitutionModel(const SubstitutionModel* model)
 {
   //Check compatiblity between model and substitution register:
@@ -234,20 +304,11 @@ void UniformizationSubstitutionCount::setSubstitutionModel(const SubstitutionMod
     //Re-initialize all B matrices according to substitution register.
     initBMatrices_();
   }
-  fillBMatrices_();
-  
-  miu_ = 0;
-  for (size_t i = 0; i < nbStates_; ++i) {
-    double diagQ = abs(model_->Qij(i, i));
-    if (diagQ > miu_)
-      miu_ = diagQ;
-  }
 
-  if (miu_ > 10000)
-    throw Exception("UniformizationSubstitutionCount::setSubstitutionModel(). The maximum diagonal values of generator is above 10000. Abort, chose another mapping method.");
-
-  //Recompute counts:
-  computeCounts_(currentLength_);
+  //The cached sequences are kept if the generator did not change,
+  //counts will be recomputed when needed:
+  updateUniformization_();
+  currentLength_ = -1.;
 }
 
 /******************************************************************************/
@@ -260,11 +321,7 @@ void UniformizationSubstitutionCount::substitutionRegisterHasChanged() throw (Ex
 
   resetBMatrices_();
   initBMatrices_();
-  fillBMatrices_();
-  
-  //Recompute counts:
-  if (currentLength_ > 0)
-    computeCounts_(currentLength_);
+  updateUniformization_();
 }
 
 /******************************************************************************/
@@ -277,9 +334,8 @@ void UniformizationSubstitutionCount::weightsHaveChanged() throw (Exception)
   //jdutheil on 25/07/14: not necessary if weights are only accounted for in the end.
   //fillBMatrices_();
   
-  //Recompute counts:
-  if (currentLength_ > 0)
-    computeCounts_(currentLength_);
+  //Counts will be recomputed when needed:
+  currentLength_ = -1.;
 }
 
 /******************************************************************************/
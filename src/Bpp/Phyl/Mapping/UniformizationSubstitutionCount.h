@@ -44,6 +44,8 @@ knowledge of the CeCILL license and that you accept its terms.
 
 #include <Bpp/Numeric/Matrix/Matrix.h>
 
+#include <cmath>
+
 namespace bpp
 {
 
@@ -52,6 +54,13 @@ namespace bpp
  *
  * The code is adapted from the original R code by Paula Tataru and Asger Hobolth.
  *
+ * The powers @f$R^k@f$ of the uniformized matrix @f$R = I + Q/\mu@f$, and the
+ * sequences @f$S_l = R S_{l-1} + B R^l@f$ for each substitution type, do not depend
+ * on the branch length, which only determines how many terms are needed. They are
+ * therefore cached and extended on demand, and only recomputed when the generator
+ * of the model changes. Counts for a given length are then a Poisson-weighted sum of
+ * the cached @f$S_l@f$, with no matrix product.
+ *
  * @author Julien Dutheil
  */
 class UniformizationSubstitutionCount:
@@ -61,10 +70,12 @@ class UniformizationSubstitutionCount:
   private:
     const SubstitutionModel* model_;
     size_t nbStates_;
-    std::vector< RowMatrix<double> > bMatrices_;
+    mutable std::vector< RowMatrix<double> > bMatrices_;
+    mutable RowMatrix<double> generator_; // The generator the cache was computed for.
+    mutable RowMatrix<double> uniformized_;
     mutable std::vector< RowMatrix<double> > power_;
     mutable std::vector < std::vector< RowMatrix<double> > > s_;
-    double miu_;
+    mutable double miu_;
     mutable std::vector< RowMatrix<double> > counts_;
     mutable double currentLength_;
   
@@ -77,6 +88,8 @@ class UniformizationSubstitutionCount:
       model_(usc.model_),
       nbStates_(usc.nbStates_),
       bMatrices_(usc.bMatrices_),
+      generator_(usc.generator_),
+      uniformized_(usc.uniformized_),
       power_(usc.power_),
       s_(usc.s_),
       miu_(usc.miu_),
@@ -91,6 +104,8 @@ class UniformizationSubstitutionCount:
       model_          = usc.model_;
       nbStates_       = usc.nbStates_;
       bMatrices_      = usc.bMatrices_;
+      generator_      = usc.generator_;
+      uniformized_    = usc.uniformized_;
       power_          = usc.power_;
       s_              = usc.s_;
       miu_            = usc.miu_;
@@ -109,6 +124,14 @@ public:
     Matrix<double>* getAllNumbersOfSubstitutions(double length, size_t type = 1) const;
     
     std::vector<double> getNumberOfSubstitutionsForEachType(size_t initialState, size_t finalState, double length) const;
+
+    /**
+     * @brief Get the counts for all lengths in one sweep.
+     *
+     * The cached sequences are extended once, up to the number of terms needed
+     * by the longest branch.
+     */
+    void getAllNumbersOfSubstitutionsForEachLength(const std::vector<double>& lengths, std::vector< std::vector< RowMatrix<double> > >& counts) const;
    
     void setSubstitutionModel(const SubstitutionModel* model);
 
@@ -120,7 +143,34 @@ public:
   private:
     void resetBMatrices_();
     void initBMatrices_();
-    void fillBMatrices_();
+    void fillBMatrices_() const;
+
+    /**
+     * @brief Compute the counts for a given length into the given matrices, one per type.
+     */
+    void computeCounts_(double length, std::vector< RowMatrix<double> >& counts) const;
+
+    /**
+     * @brief Recompute the uniformized matrix and reset the cached sequences,
+     * if the generator of the model changed since they were computed.
+     */
+    void updateUniformization_() const;
+
+    /**
+     * @brief Extend the cached powers of R and sequences S_l up to index nMax.
+     */
+    void extendSequences_(size_t nMax) const;
+
+    /**
+     * @return The number of terms needed for a given length.
+     */
+    size_t getNumberOfTerms_(double length) const
+    {
+      //use the tail of Poisson distribution
+      //can be approximated by 4 + 6 * sqrt(lam) + lam
+      double lam = miu_ * length;
+      return static_cast<size_t>(ceil(4 + 6 * sqrt(lam) + lam));
+    }
 
 };
 
@@ -42,6 +42,7 @@
 
 #include "AbstractBiblioSubstitutionModel.h"
 #include "MixedSubstitutionModel.h"
+#include "AbstractMixedSubstitutionModel.h"
 
 namespace bpp
 {
@@ -179,6 +180,17 @@ namespace bpp
      */
     Vint getSubmodelNumbers(const std::string& desc) const;
 
+    /**
+     * @brief Set the number of threads used to update the submodels
+     * (0 means all available cores), if the mixture supports it.
+     */
+    void setNumberOfThreads(unsigned int nbThreads)
+    {
+      AbstractMixedSubstitutionModel* pm = dynamic_cast<AbstractMixedSubstitutionModel*>(pmixmodel_.get());
+      if (pm)
+        pm->setNumberOfThreads(nbThreads);
+    }
+
     const SubstitutionModel& getSubstitutionModel() const { return *pmixmodel_.get(); }
 
     const MixedSubstitutionModel& getMixedModel() const { return *pmixmodel_.get(); }
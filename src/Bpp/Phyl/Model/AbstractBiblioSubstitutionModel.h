@@ -142,6 +142,8 @@ namespace bpp
     /*
      * @}
      */
+
+    friend class SubstitutionModelBatchUpdate;
   };
 } // end of namespace bpp.
 
@@ -130,6 +130,19 @@ namespace bpp
       getModel().setNamespace(name);
     }
 
+    /*
+     * @brief The transition probabilities are derived from the ones
+     * of the substitution model, so they are computed matrix by
+     * matrix instead of being forwarded.
+     */
+    bool hasClosedFormPij_t() const { return false; }
+
+    void fillPij_t(const Vdouble& times, VVVdouble& pijt) const { TransitionModel::fillPij_t(times, pijt); }
+
+    void filldPij_dt(const Vdouble& times, VVVdouble& dpijt) const { TransitionModel::filldPij_dt(times, dpijt); }
+
+    void filld2Pij_dt2(const Vdouble& times, VVVdouble& d2pijt) const { TransitionModel::filld2Pij_dt2(times, d2pijt); }
+
   };
 } // end of namespace bpp.
 
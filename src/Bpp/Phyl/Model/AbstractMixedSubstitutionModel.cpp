@@ -38,6 +38,8 @@
  */
 
 #include "AbstractMixedSubstitutionModel.h"
+#include "WrappedModel.h"
+#include "../ParallelTools.h"
 
 #include <string>
 
@@ -51,7 +53,8 @@ AbstractMixedSubstitutionModel::AbstractMixedSubstitutionModel(
   AbstractSubstitutionModel(alpha, stateMap, prefix),
   modelsContainer_(),
   vProbas_(),
-  vRates_()
+  vRates_(),
+  nbThreads_(1)
 {
   for (unsigned int i = 0; i < size_; i++)
   {
@@ -72,7 +75,8 @@ AbstractMixedSubstitutionModel::AbstractMixedSubstitutionModel(const AbstractMix
   AbstractSubstitutionModel(msm),
   modelsContainer_(),
   vProbas_(),
-  vRates_()
+  vRates_(),
+  nbThreads_(msm.nbThreads_)
 {
   for (unsigned int i = 0; i < msm.modelsContainer_.size(); i++)
   {
@@ -87,6 +91,8 @@ AbstractMixedSubstitutionModel& AbstractMixedSubstitutionModel::operator=(const
   AbstractParameterAliasable::operator=(model);
   AbstractSubstitutionModel::operator=(model);
 
+  nbThreads_ = model.nbThreads_;
+
   // Clear existing containers:
   modelsContainer_.clear();
   vProbas_.clear();
@@ -110,6 +116,126 @@ AbstractMixedSubstitutionModel::~AbstractMixedSubstitutionModel()
   }
 }
 
+/******************************************************************************/
+
+namespace
+{
+  /**
+   * @return The object that computes the matrices of a model: the
+   * model itself, or the model wrapped in it, or 0 if this is not an
+   * AbstractSubstitutionModel.
+   */
+  AbstractSubstitutionModel* getUpdatableModel(TransitionModel* model)
+  {
+    AbstractSubstitutionModel* asm_ = dynamic_cast<AbstractSubstitutionModel*>(model);
+    if (asm_)
+      return asm_;
+    WrappedModel* wm = dynamic_cast<WrappedModel*>(model);
+    if (wm)
+      return getUpdatableModel(const_cast<TransitionModel*>(&wm->getModel()));
+    return 0;
+  }
+}
+
+void AbstractMixedSubstitutionModel::updateSubModels_(
+  const std::function<void (size_t)>& setSubModel,
+  bool shareIdentical)
+{
+  vector<AbstractSubstitutionModel*> vUpdatable;
+  for (size_t i = 0; i < modelsContainer_.size(); i++)
+  {
+    AbstractSubstitutionModel* pm = getUpdatableModel(modelsContainer_[i]);
+    if (pm)
+    {
+      pm->beginParameterBatch();
+      vUpdatable.push_back(pm);
+    }
+  }
+
+  try
+  {
+    for (size_t i = 0; i < modelsContainer_.size(); i++)
+    {
+      setSubModel(i);
+    }
+
+    vector<AbstractSubstitutionModel*> vPending;
+    vector<AbstractSubstitutionModel*> vShared;  // submodels to be copied
+    vector<AbstractSubstitutionModel*> vSource;  // from these ones
+    vector<Vdouble> vValues;
+
+    for (size_t i = 0; i < vUpdatable.size(); i++)
+    {
+      AbstractSubstitutionModel* pm = vUpdatable[i];
+      if (!pm->hasPendingUpdate())
+        continue;
+
+      if (shareIdentical)
+      {
+        const ParameterList& pl = pm->getParameters();
+        Vdouble values(pl.size());
+        for (size_t k = 0; k < pl.size(); k++)
+        {
+          values[k] = pl[k].getValue();
+        }
+
+        size_t j;
+        for (j = 0; j < vPending.size(); j++)
+        {
+          if (vValues[j] == values)
+            break;
+        }
+        if (j < vPending.size())
+        {
+          vShared.push_back(pm);
+          vSource.push_back(vPending[j]);
+          continue;
+        }
+        vValues.push_back(values);
+      }
+      vPending.push_back(pm);
+    }
+
+    // Each thread only writes into its own submodels.
+    ParallelTools::forEachBlock(vPending.size(), nbThreads_,
+      [&vPending](size_t begin, size_t end, unsigned int) {
+        for (size_t i = begin; i < end; i++)
+        {
+          vPending[i]->computePendingUpdate();
+        }
+      });
+
+    for (size_t i = 0; i < vShared.size(); i++)
+    {
+      if (!vShared[i]->copyMatricesFrom(*vSource[i]))
+        vShared[i]->computePendingUpdate();
+    }
+  }
+  catch (...)
+  {
+    // Close the batches anyway, the failing update being reported
+    // by the rethrown exception.
+    for (size_t i = 0; i < vUpdatable.size(); i++)
+    {
+      try
+      {
+        vUpdatable[i]->endParameterBatch();
+      }
+      catch (...)
+      {}
+    }
+    throw;
+  }
+
+  // Nothing is pending any more, so this does not compute anything.
+  for (size_t i = 0; i < vUpdatable.size(); i++)
+  {
+    vUpdatable[i]->endParameterBatch();
+  }
+}
+
+/******************************************************************************/
+
 size_t AbstractMixedSubstitutionModel::getNumberOfStates() const
 {
   return modelsContainer_[0]->getNumberOfStates();
@@ -117,6 +243,7 @@ size_t AbstractMixedSubstitutionModel::getNumberOfStates() const
 
 const Matrix<double>& AbstractMixedSubstitutionModel::getPij_t(double t) const
 {
+  updatePendingMatrices_();
   vector<const Matrix<double>* > vM;
   double sP = 0;
   for (unsigned int n = 0; n < modelsContainer_.size(); n++)
@@ -143,6 +270,7 @@ const Matrix<double>& AbstractMixedSubstitutionModel::getPij_t(double t) const
 
 const Matrix<double>& AbstractMixedSubstitutionModel::getdPij_dt(double t) const
 {
+  updatePendingMatrices_();
   vector<const Matrix<double>* > vM;
   double sP = 0;
   for (unsigned int n = 0; n < modelsContainer_.size(); n++)
@@ -169,6 +297,7 @@ const Matrix<double>& AbstractMixedSubstitutionModel::getdPij_dt(double t) const
 
 const Matrix<double>& AbstractMixedSubstitutionModel::getd2Pij_dt2(double t) const
 {
+  updatePendingMatrices_();
   vector<const Matrix<double>* > vM;
   double sP = 0;
   for (unsigned int n = 0; n < modelsContainer_.size(); n++)
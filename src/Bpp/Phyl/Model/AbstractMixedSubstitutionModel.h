@@ -45,6 +45,7 @@
 // #include <Bpp/Seq/Alphabet.all>
 
 #include <vector>
+#include <functional>
 #include <string>
 #include <map>
 #include <cstring> // C lib for string copy
@@ -96,6 +97,12 @@ protected:
    */
   std::vector<double> vRates_;
 
+  /**
+   * @brief Number of threads used to update the submodels (default:
+   * 1, 0 means all available cores).
+   */
+  unsigned int nbThreads_;
+
 public:
   AbstractMixedSubstitutionModel(const Alphabet*, StateMap* stateMap, const std::string& prefix);
 
@@ -216,6 +223,35 @@ public:
   virtual const Matrix<double>& getPij_t(double t) const;
   virtual const Matrix<double>& getdPij_dt(double t) const;
   virtual const Matrix<double>& getd2Pij_dt2(double t) const;
+
+  /**
+   * @brief Set the number of threads used to compute the
+   * eigen decompositions of the submodels (0 means all available
+   * cores).
+   */
+  void setNumberOfThreads(unsigned int nbThreads) { nbThreads_ = nbThreads; }
+
+  unsigned int getNumberOfThreads() const { return nbThreads_; }
+
+protected:
+  /**
+   * @brief Set the parameters of the submodels, and compute their
+   * matrices together.
+   *
+   * The submodels are put in a parameter batch while
+   * setSubModel(i) is called for each of them, then those whose
+   * parameters have changed are computed, on nbThreads_ threads. On
+   * return, no submodel has a pending update, so that they can then
+   * be read concurrently.
+   *
+   * @param setSubModel sets the parameters of the i-th submodel.
+   * @param shareIdentical if true, submodels with the same parameter
+   * values as a previous one take its matrices instead of computing
+   * them (see AbstractSubstitutionModel::copyMatricesFrom). This is
+   * only valid if all the submodels have been built the same way,
+   * such as in MixtureOfASubstitutionModel.
+   */
+  void updateSubModels_(const std::function<void (size_t)>& setSubModel, bool shareIdentical);
 };
 } // end of namespace bpp.
 
@@ -38,6 +38,7 @@
  */
 
 #include "AbstractSubstitutionModel.h"
+#include "AbstractBiblioSubstitutionModel.h"
 
 #include <Bpp/Text/TextTools.h>
 #include <Bpp/Numeric/VectorTools.h>
@@ -74,7 +75,10 @@ AbstractSubstitutionModel::AbstractSubstitutionModel(const Alphabet* alpha, cons
   isNonSingular_(false),
   leftEigenVectors_(size_, size_),
   vPowGen_(),
-  tmpMat_(size_, size_)
+  tmpMat_(size_, size_),
+  lazyUpdates_(false),
+  nbOpenedBatches_(0),
+  updatePending_(false)
 {
   for (size_t i = 0; i < size_; i++)
   {
@@ -131,10 +135,31 @@ void AbstractSubstitutionModel::updateMatrices()
 }
 
 
+/******************************************************************************/
+
+void AbstractSubstitutionModel::copyBaseMatrices_(const AbstractSubstitutionModel& model)
+{
+  model.updatePendingMatrices_();
+
+  generator_         = model.generator_;
+  freq_              = model.freq_;
+  exchangeability_   = model.exchangeability_;
+  eigenValues_       = model.eigenValues_;
+  iEigenValues_      = model.iEigenValues_;
+  isDiagonalizable_  = model.isDiagonalizable_;
+  rightEigenVectors_ = model.rightEigenVectors_;
+  isNonSingular_     = model.isNonSingular_;
+  leftEigenVectors_  = model.leftEigenVectors_;
+  vPowGen_           = model.vPowGen_;
+  updatePending_     = false;
+}
+
 /******************************************************************************/
 
 const Matrix<double>& AbstractSubstitutionModel::getPij_t(double t) const
 {
+  updatePendingMatrices_();
+
   if (t == 0)
   {
     MatrixTools::getId(size_, pijt_);
@@ -208,6 +233,8 @@ const Matrix<double>& AbstractSubstitutionModel::getPij_t(double t) const
 
 const Matrix<double>& AbstractSubstitutionModel::getdPij_dt(double t) const
 {
+  updatePendingMatrices_();
+
   if (isNonSingular_)
   {
     if (isDiagonalizable_)
@@ -279,6 +306,8 @@ const Matrix<double>& AbstractSubstitutionModel::getdPij_dt(double t) const
 
 const Matrix<double>& AbstractSubstitutionModel::getd2Pij_dt2(double t) const
 {
+  updatePendingMatrices_();
+
   if (isNonSingular_)
   {
     if (isDiagonalizable_)
@@ -399,13 +428,15 @@ void AbstractSubstitutionModel::setFreq(map<int, double>& freqs)
     freq_[i] = freqs[static_cast<int>(i)];
   }
   // Re-compute generator and eigen values:
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
 
 double AbstractSubstitutionModel::getScale() const
 {
+  updatePendingMatrices_();
+
   vector<double> v;
   MatrixTools::diag(generator_, v);
   return -VectorTools::scalar<double, double>(v, freq_);
@@ -415,6 +446,8 @@ double AbstractSubstitutionModel::getScale() const
 
 void AbstractSubstitutionModel::setScale(double scale)
 {
+  updatePendingMatrices_();
+
   if (isScalable_)
   {
     MatrixTools::scale(generator_, scale);
@@ -492,3 +525,16 @@ void AbstractReversibleSubstitutionModel::updateMatrices()
 
 /******************************************************************************/
 
+
+AbstractSubstitutionModel* SubstitutionModelBatchUpdate::getBatchedModel_(TransitionModel* model)
+{
+  // A bibliographic model forwards its parameters to the model it
+  // wraps, which computes the matrices right away unless a batch is
+  // opened on it:
+  AbstractBiblioSubstitutionModel* biblio;
+  while ((biblio = dynamic_cast<AbstractBiblioSubstitutionModel*>(model)))
+    model = &biblio->getModel();
+  return dynamic_cast<AbstractSubstitutionModel*>(model);
+}
+
+/******************************************************************************/
@@ -180,7 +180,24 @@ protected:
    * @brief For computational issues
    */
   mutable RowMatrix<double> tmpMat_;
-  
+
+  /**
+   * @brief Tell if updateMatrices() is deferred until the matrices
+   * are queried (see enableLazyUpdates()).
+   */
+  bool lazyUpdates_;
+
+  /**
+   * @brief Number of opened parameter batches (see
+   * beginParameterBatch()).
+   */
+  unsigned int nbOpenedBatches_;
+
+  /**
+   * @brief Tell if an updateMatrices() has been deferred.
+   */
+  mutable bool updatePending_;
+
 public:
   AbstractSubstitutionModel(const Alphabet* alpha, const StateMap* stateMap, const std::string& prefix);
 
@@ -205,7 +222,10 @@ public:
     isNonSingular_(model.isNonSingular_),
     leftEigenVectors_(model.leftEigenVectors_),
     vPowGen_(model.vPowGen_),
-    tmpMat_(model.tmpMat_)
+    tmpMat_(model.tmpMat_),
+    lazyUpdates_(model.lazyUpdates_),
+    nbOpenedBatches_(0),
+    updatePending_(model.updatePending_)
   {}
 
   AbstractSubstitutionModel& operator=(const AbstractSubstitutionModel& model)
@@ -231,6 +251,9 @@ public:
     leftEigenVectors_  = model.leftEigenVectors_;
     vPowGen_           = model.vPowGen_;
     tmpMat_            = model.tmpMat_;
+    lazyUpdates_       = model.lazyUpdates_;
+    nbOpenedBatches_   = 0;
+    updatePending_     = model.updatePending_;
     return *this;
   }
   
@@ -253,33 +276,33 @@ public:
   
   std::vector<size_t> getModelStates(const std::string& code) const { return stateMap_->getModelStates(code); }
 
-  virtual const Vdouble& getFrequencies() const { return freq_; }
+  virtual const Vdouble& getFrequencies() const { updatePendingMatrices_(); return freq_; }
 
-  const Matrix<double>& getGenerator() const { return generator_; }
+  const Matrix<double>& getGenerator() const { updatePendingMatrices_(); return generator_; }
 
-  const Matrix<double>& getExchangeabilityMatrix() const { return exchangeability_; }
+  const Matrix<double>& getExchangeabilityMatrix() const { updatePendingMatrices_(); return exchangeability_; }
 
-  double Sij(size_t i, size_t j) const { return exchangeability_(i, j); }
+  double Sij(size_t i, size_t j) const { updatePendingMatrices_(); return exchangeability_(i, j); }
 
   virtual const Matrix<double>& getPij_t(double t) const;
   virtual const Matrix<double>& getdPij_dt(double t) const;
   virtual const Matrix<double>& getd2Pij_dt2(double t) const;
 
-  const Vdouble& getEigenValues() const { return eigenValues_; }
+  const Vdouble& getEigenValues() const { updatePendingMatrices_(); return eigenValues_; }
 
-  const Vdouble& getIEigenValues() const { return iEigenValues_; }
+  const Vdouble& getIEigenValues() const { updatePendingMatrices_(); return iEigenValues_; }
 
-  bool isDiagonalizable() const { return isDiagonalizable_; }
+  bool isDiagonalizable() const { updatePendingMatrices_(); return isDiagonalizable_; }
   
-  bool isNonSingular() const { return isNonSingular_; }
+  bool isNonSingular() const { updatePendingMatrices_(); return isNonSingular_; }
 
-  const Matrix<double>& getRowLeftEigenVectors() const { return leftEigenVectors_; }
+  const Matrix<double>& getRowLeftEigenVectors() const { updatePendingMatrices_(); return leftEigenVectors_; }
 
-  const Matrix<double>& getColumnRightEigenVectors() const { return rightEigenVectors_; }
+  const Matrix<double>& getColumnRightEigenVectors() const { updatePendingMatrices_(); return rightEigenVectors_; }
 
-  virtual double freq(size_t i) const { return freq_[i]; }
+  virtual double freq(size_t i) const { updatePendingMatrices_(); return freq_[i]; }
 
-  virtual double Qij(size_t i, size_t j) const { return generator_(i, j); }
+  virtual double Qij(size_t i, size_t j) const { updatePendingMatrices_(); return generator_(i, j); }
 
   virtual double Pij_t    (size_t i, size_t j, double t) const { return getPij_t(t) (i, j); }
   virtual double dPij_dt  (size_t i, size_t j, double t) const { return getdPij_dt(t) (i, j); }
@@ -298,7 +321,9 @@ public:
   /**
    * @brief Tells the model that a parameter value has changed.
    *
-   * This updates the matrices consequently.
+   * This updates the matrices consequently, or only records that
+   * they must be updated if updates are deferred (see
+   * enableLazyUpdates() and beginParameterBatch()).
    */
   virtual void fireParameterChanged(const ParameterList& parameters)
   {
@@ -309,12 +334,93 @@ public:
       rate_=parameters.getParameterValue(getNamespace()+"rate");
       
       if (parameters.size()!=1)
-        updateMatrices();
+        requestUpdateMatrices_();
     }
     else
-      updateMatrices();      
+      requestUpdateMatrices_();
+  }
+
+  /**
+   * @name Deferred computation of the matrices.
+   *
+   * By default, each parameter change triggers updateMatrices(), ie
+   * a new computation of the generator and its eigen
+   * decomposition. When several parameters are set one after the
+   * other, this computation can be deferred:
+   *
+   * - in lazy mode, the matrices are only computed when they are
+   *   next queried (getPij_t(), getGenerator(), getFrequencies(),
+   *   etc.);
+   * - between beginParameterBatch() and endParameterBatch(), the
+   *   matrices are computed once, when the last opened batch is
+   *   closed (or before, if they are queried).
+   *
+   * A query on a model with a pending update modifies it, so such a
+   * model must not be shared between threads: call
+   * computePendingUpdate() or close the batches first.
+   *
+   * @{
+   */
+
+  /**
+   * @brief Defer (or not) the computation of the matrices until
+   * they are queried.
+   */
+  void enableLazyUpdates(bool yn)
+  {
+    lazyUpdates_ = yn;
+    if (!yn)
+      updatePendingMatrices_();
   }
 
+  bool lazyUpdates() const { return lazyUpdates_; }
+
+  /**
+   * @return true if an updateMatrices() has been deferred and not
+   * performed yet.
+   */
+  bool hasPendingUpdate() const { return updatePending_; }
+
+  /**
+   * @brief Perform the deferred updateMatrices(), if any.
+   */
+  void computePendingUpdate() { updatePendingMatrices_(); }
+
+  /**
+   * @brief Take the matrices computed by another model, instead of
+   * computing them.
+   *
+   * This is only valid if both models compute the same matrices,
+   * ie are of the same class, with the same parameter values and
+   * the same set-up. A pending update of this model is then
+   * cancelled.
+   *
+   * @return true if the matrices have been copied. The default
+   * implementation returns false, since inheriting classes may hold
+   * their own state derived from the parameters.
+   */
+  virtual bool copyMatricesFrom(const AbstractSubstitutionModel& model) { return false; }
+
+  /**
+   * @brief Open a batch of parameter changes. Batches can be nested.
+   */
+  void beginParameterBatch() { nbOpenedBatches_++; }
+
+  /**
+   * @brief Close a batch of parameter changes, and compute the
+   * matrices if this was the last opened batch and the model is not
+   * in lazy mode.
+   */
+  void endParameterBatch()
+  {
+    if (nbOpenedBatches_ > 0)
+      nbOpenedBatches_--;
+    if (nbOpenedBatches_ == 0 && !lazyUpdates_)
+      updatePendingMatrices_();
+  }
+
+  /** @} */
+
   /**
    * @brief add a "rate" parameter to the model, that handles the
    * overall rate of the process.
@@ -340,6 +446,50 @@ protected:
    */
   virtual void updateMatrices();
 
+  /**
+   * @brief Copy the fields computed by updateMatrices() in this
+   * class from another model, and cancel any pending update.
+   */
+  void copyBaseMatrices_(const AbstractSubstitutionModel& model);
+
+  /**
+   * @brief Call updateMatrices(), or defer it if the model is in
+   * lazy mode or if a parameter batch is opened.
+   */
+  void requestUpdateMatrices_()
+  {
+    if (lazyUpdates_ || nbOpenedBatches_ > 0)
+      updatePending_ = true;
+    else
+    {
+      updatePending_ = false;
+      updateMatrices();
+    }
+  }
+
+  /**
+   * @brief Perform a deferred updateMatrices(), if any.
+   *
+   * This must be called by all the methods that read the matrices,
+   * including the closed-form Pij_t of inheriting classes.
+   */
+  void updatePendingMatrices_() const
+  {
+    if (updatePending_)
+    {
+      updatePending_ = false;
+      try
+      {
+        const_cast<AbstractSubstitutionModel*>(this)->updateMatrices();
+      }
+      catch (...)
+      {
+        updatePending_ = true;
+        throw;
+      }
+    }
+  }
+
 public:
 
   /**
@@ -399,6 +549,85 @@ public:
 };
 
 
+/**
+ * @brief Scope of a batch of parameter changes on a substitution
+ * model.
+ *
+ * The matrices of the model are computed once, when the scope is
+ * left, instead of after each parameter change:
+ * @code
+ * {
+ *   SubstitutionModelBatchUpdate batch(model);
+ *   model->setParameterValue("kappa", 2.);
+ *   model->setParameterValue("theta", 0.4);
+ *   batch.commit(); // one eigen decomposition here
+ * }
+ * @endcode
+ *
+ * If commit() is not called, the matrices are computed when the scope
+ * is left, but a failing update is then only reported when the
+ * matrices are queried.
+ *
+ * The batch of a bibliographic model (see
+ * AbstractBiblioSubstitutionModel) is opened on the model it wraps,
+ * which is the one computing the matrices. Other models that do not
+ * inherit from AbstractSubstitutionModel are updated as usual.
+ */
+class SubstitutionModelBatchUpdate
+{
+private:
+  AbstractSubstitutionModel* model_;
+
+public:
+  SubstitutionModelBatchUpdate(TransitionModel* model) :
+    model_(getBatchedModel_(model))
+  {
+    if (model_)
+      model_->beginParameterBatch();
+  }
+
+  ~SubstitutionModelBatchUpdate()
+  {
+    // A failing update is kept pending, and will be reported when the
+    // matrices are queried.
+    try
+    {
+      if (model_)
+        model_->endParameterBatch();
+    }
+    catch (...)
+    {}
+  }
+
+  /**
+   * @brief Close the batch now, and compute the matrices of the model
+   * unless it is in lazy mode.
+   *
+   * Contrary to the destructor, this method lets the exceptions
+   * raised by the update propagate. Calling it several times has no
+   * further effect.
+   */
+  void commit()
+  {
+    if (!model_)
+      return;
+    AbstractSubstitutionModel* model = model_;
+    model_ = 0;
+    model->endParameterBatch();
+  }
+
+private:
+  /**
+   * @return The model whose matrices are updated when the parameters
+   * of the given model change, or 0 if it cannot defer its updates.
+   */
+  static AbstractSubstitutionModel* getBatchedModel_(TransitionModel* model);
+
+  SubstitutionModelBatchUpdate(const SubstitutionModelBatchUpdate&);
+  SubstitutionModelBatchUpdate& operator=(const SubstitutionModelBatchUpdate&);
+};
+
+
 /**
  * @brief Partial implementation of the ReversibleSubstitutionModel interface.
  *
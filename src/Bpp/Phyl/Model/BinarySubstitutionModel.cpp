@@ -60,7 +60,7 @@ BinarySubstitutionModel::BinarySubstitutionModel(const BinaryAlphabet* alpha, do
   p_(size_,size_)
 {
   addParameter_(new Parameter(getNamespace() + "kappa", kappa_, &Parameter::R_PLUS_STAR));
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -117,6 +117,7 @@ void BinarySubstitutionModel::updateMatrices()
 
 double BinarySubstitutionModel::Pij_t(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   exp_ = exp(-lambda_ * rate_ * d);
 
   switch (i)
@@ -143,6 +144,7 @@ double BinarySubstitutionModel::Pij_t(size_t i, size_t j, double d) const
 
 double BinarySubstitutionModel::dPij_dt(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   exp_ = rate_ * exp(-lambda_ * rate_ * d);
 
   switch (i)
@@ -169,6 +171,7 @@ double BinarySubstitutionModel::dPij_dt(size_t i, size_t j, double d) const
 
 double BinarySubstitutionModel::d2Pij_dt2(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   exp_ = rate_ * rate_ * exp(-lambda_ * rate_ * d);
 
   switch (i)
@@ -195,6 +198,7 @@ double BinarySubstitutionModel::d2Pij_dt2(size_t i, size_t j, double d) const
 
 const Matrix<double>& BinarySubstitutionModel::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   exp_ = exp(-lambda_ * rate_ * d);
 
   p_(0,0) = (1 + kappa_ * exp_) / (kappa_ + 1);
@@ -208,6 +212,7 @@ const Matrix<double>& BinarySubstitutionModel::getPij_t(double d) const
 
 const Matrix<double>& BinarySubstitutionModel::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   exp_ = rate_ * exp(-lambda_ * rate_ * d);
 
   p_(0,0) = -(kappa_ + 1) / 2 * exp_;
@@ -221,6 +226,7 @@ const Matrix<double>& BinarySubstitutionModel::getdPij_dt(double d) const
 
 const Matrix<double>& BinarySubstitutionModel::getd2Pij_dt2(double d) const
 {
+  updatePendingMatrices_();
   exp_ = rate_ * rate_ * exp(-lambda_ * rate_ * d);
 
   p_(0,0) = lambda_ * (kappa_ + 1) / 2 * exp_;
@@ -237,5 +243,5 @@ void BinarySubstitutionModel::setFreq(std::map<int, double>& freqs)
 {
   kappa_ = freqs[1] / freqs[0];
   setParameterValue("kappa",kappa_);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
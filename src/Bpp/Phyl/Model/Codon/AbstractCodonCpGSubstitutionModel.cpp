@@ -67,3 +67,13 @@ double AbstractCodonCpGSubstitutionModel::getCodonsMulRate(size_t i, size_t j) c
   return ((ii%16==7  && (ii-ij==2 || ij-ii==8)) || ((ii-1)/4==6 && (ii-ij==8 || (ij-ii==32))))?rho_:1;
 }
 
+void AbstractCodonCpGSubstitutionModel::multiplyCodonsMulRates(const CodonPairTable& table, const vector<size_t>& pairs, vector<double>& rates) const
+{
+  size_t n = table.getSize();
+  for (size_t k = 0; k < pairs.size(); k++)
+  {
+    if (table.isCpG(pairs[k] / n, pairs[k] % n))
+      rates[k] *= rho_;
+  }
+}
+
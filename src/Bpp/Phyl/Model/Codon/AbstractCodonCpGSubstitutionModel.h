@@ -41,6 +41,7 @@
 #define _ABSTRACTCODONCPGSUBSTITUTIONMODEL_H_
 
 #include "CodonSubstitutionModel.h"
+#include "CodonPairTable.h"
 #include <Bpp/Numeric/AbstractParameterAliasable.h>
 
 
@@ -97,6 +98,16 @@ public:
 
 public:
   double getCodonsMulRate(size_t i, size_t j) const;
+
+  /**
+   * @brief Multiply by @f$\rho@f$ the rates of the codon pairs in
+   * CpG context.
+   *
+   * @param table The classification of the codon pairs.
+   * @param pairs Row-wise indices of the codon pairs (see CodonPairTable).
+   * @param rates The rates of these pairs, multiplied in place.
+   */
+  void multiplyCodonsMulRates(const CodonPairTable& table, const std::vector<size_t>& pairs, std::vector<double>& rates) const;
 };
 
 } // end of namespace bpp.
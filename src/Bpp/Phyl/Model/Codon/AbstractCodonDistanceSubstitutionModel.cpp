@@ -54,7 +54,9 @@ AbstractCodonDistanceSubstitutionModel::AbstractCodonDistanceSubstitutionModel(
   pdistance_(pdist),
   alpha_(10000),
   beta_(1),
-  gamma_(1)
+  gamma_(1),
+  vDistFactor_(),
+  factorAlpha_(-1)
 {
   if (pdistance_)
     addParameter_(new Parameter(prefix + "alpha", 10000, &Parameter::R_PLUS_STAR));
@@ -83,3 +85,38 @@ double AbstractCodonDistanceSubstitutionModel::getCodonsMulRate(size_t i, size_t
                  getGeneticCode()->translate(static_cast<int>(j))) / alpha_) : 1);
 }
 
+void AbstractCodonDistanceSubstitutionModel::multiplyCodonsMulRates(const CodonPairTable& table, const vector<size_t>& pairs, vector<double>& rates)
+{
+  if (factorAlpha_ != alpha_ || vDistFactor_.size() != table.getSize() * table.getSize())
+    computeDistanceFactors_(table);
+
+  for (size_t k = 0; k < pairs.size(); k++)
+  {
+    double x = vDistFactor_[pairs[k]];
+    rates[k] *= (x < 0 ? gamma_ : beta_ * x);
+  }
+}
+
+void AbstractCodonDistanceSubstitutionModel::computeDistanceFactors_(const CodonPairTable& table)
+{
+  const GeneticCode* gCode = getGeneticCode();
+  size_t nbCodons = table.getSize();
+  vDistFactor_.resize(nbCodons * nbCodons);
+
+  for (size_t i = 0; i < nbCodons; i++)
+  {
+    for (size_t j = 0; j < nbCodons; j++)
+    {
+      double& x = vDistFactor_[i * nbCodons + j];
+      if (table.isStop(i) || table.isStop(j))
+        x = 0;
+      else if (table.isSynonymous(i, j))
+        x = -1;
+      else
+        x = pdistance_ ? exp(-pdistance_->getIndex(gCode->translate(static_cast<int>(i)), gCode->translate(static_cast<int>(j))) / alpha_) : 1;
+    }
+  }
+
+  factorAlpha_ = alpha_;
+}
+
@@ -41,6 +41,7 @@
 #define _ABSTRACTCODONDISTANCESUBSTITUTIONMODEL_H_
 
 #include "CodonSubstitutionModel.h"
+#include "CodonPairTable.h"
 #include <Bpp/Numeric/AbstractParameterAliasable.h>
 
 
@@ -88,6 +89,22 @@ private:
   double alpha_, beta_;
 
   double gamma_;
+
+  /**
+   * @brief Cached factors @f$\exp(-d(x,y)/\alpha)@f$ for all pairs
+   * of codons, stored row-wise, with -1 for synonymous pairs and 0
+   * for pairs involving a stop codon.
+   *
+   * They depend only on the genetic code and on \c "alpha", and are
+   * recomputed only when \c "alpha" changes.
+   */
+  std::vector<double> vDistFactor_;
+
+  /**
+   * @brief The value of alpha_ used to compute vDistFactor_.
+   */
+  double factorAlpha_;
+
 public:
   /**
    * @brief Build a new AbstractCodonDistanceSubstitutionModel object from
@@ -108,7 +125,9 @@ public:
     pdistance_(model.pdistance_),
     alpha_(model.alpha_),
     beta_(model.beta_),
-    gamma_(model.gamma_)
+    gamma_(model.gamma_),
+    vDistFactor_(model.vDistFactor_),
+    factorAlpha_(model.factorAlpha_)
   {}
 
   AbstractCodonDistanceSubstitutionModel& operator=(
@@ -119,6 +138,8 @@ public:
     alpha_ = model.alpha_;
     beta_ = model.beta_;
     gamma_ = model.gamma_;
+    vDistFactor_ = model.vDistFactor_;
+    factorAlpha_ = model.factorAlpha_;
     return *this;
   }
 
@@ -129,6 +150,22 @@ public:
 
 public:
   double getCodonsMulRate(size_t i, size_t j) const;
+
+  /**
+   * @brief Multiply the rates of codon pairs by the factors of this
+   * component.
+   *
+   * This gives the same values as getCodonsMulRate(), from the cached
+   * distance factors.
+   *
+   * @param table The classification of the codon pairs.
+   * @param pairs Row-wise indices of the codon pairs (see CodonPairTable).
+   * @param rates The rates of these pairs, multiplied in place.
+   */
+  void multiplyCodonsMulRates(const CodonPairTable& table, const std::vector<size_t>& pairs, std::vector<double>& rates);
+
+private:
+  void computeDistanceFactors_(const CodonPairTable& table);
 };
 
 } // end of namespace bpp.
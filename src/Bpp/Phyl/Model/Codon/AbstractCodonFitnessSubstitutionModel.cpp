@@ -81,3 +81,22 @@ double AbstractCodonFitnessSubstitutionModel::getCodonsMulRate(size_t i, size_t
   return mu;
 }
 
+void AbstractCodonFitnessSubstitutionModel::multiplyCodonsMulRates(const CodonPairTable& table, const vector<size_t>& pairs, vector<double>& rates) const
+{
+  Vdouble phi = pfitset_->getFrequencies();
+  size_t n = table.getSize();
+  for (size_t k = 0; k < pairs.size(); k++)
+  {
+    double phi_i = phi[pairs[k] / n];
+    double phi_j = phi[pairs[k] % n];
+    if (phi_i == phi_j)
+      continue;
+    else if (phi_i == 0)
+      rates[k] *= 100;
+    else if (phi_j == 0)
+      rates[k] = 0;
+    else
+      rates[k] *= -(log(phi_i / phi_j) / (1 - (phi_i / phi_j)));
+  }
+}
+
@@ -40,6 +40,7 @@
 # define _ABSTRACTCODONFITNESSSUBSTITUTIONMODEL_H_
 
 # include "CodonSubstitutionModel.h"
+#include "CodonPairTable.h"
 #include "../FrequenciesSet/CodonFrequenciesSet.h"
 namespace bpp
 {
@@ -97,6 +98,16 @@ namespace bpp
 
     double getCodonsMulRate(size_t i, size_t j) const;
 
+    /**
+     * @brief Multiply the rates of codon pairs by their fixation
+     * factors (see getCodonsMulRate()).
+     *
+     * @param table The classification of the codon pairs.
+     * @param pairs Row-wise indices of the codon pairs (see CodonPairTable).
+     * @param rates The rates of these pairs, multiplied in place.
+     */
+    void multiplyCodonsMulRates(const CodonPairTable& table, const std::vector<size_t>& pairs, std::vector<double>& rates) const;
+
     const FrequenciesSet* getFitness() const { return pfitset_;}
 
   };
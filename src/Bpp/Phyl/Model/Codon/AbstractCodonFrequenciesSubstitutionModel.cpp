@@ -52,7 +52,8 @@ AbstractCodonFrequenciesSubstitutionModel::AbstractCodonFrequenciesSubstitutionM
   CodonSubstitutionModel(),
   AbstractParameterAliasable(prefix),
   pfreqset_(pfreq),
-  freqName_("")
+  freqName_(""),
+  codonFreqs_(pfreq->getFrequencies())
 {
   if (dynamic_cast<CodonFrequenciesSet*>(pfreq) == NULL)
     throw Exception("Bad type for equilibrium frequencies " + pfreq->getName());
@@ -70,18 +71,42 @@ AbstractCodonFrequenciesSubstitutionModel::~AbstractCodonFrequenciesSubstitution
 
 void AbstractCodonFrequenciesSubstitutionModel::fireParameterChanged(const ParameterList& parameters)
 {
-  pfreqset_->matchParametersValues(parameters);
+  if (pfreqset_->matchParametersValues(parameters))
+    codonFreqs_ = pfreqset_->getFrequencies();
+}
+
+bool AbstractCodonFrequenciesSubstitutionModel::hasOnlyFrequenciesParameters(const ParameterList& parameters) const
+{
+  if (parameters.size() == 0)
+    return false;
+  const ParameterList& pl = pfreqset_->getParameters();
+  for (size_t i = 0; i < parameters.size(); i++)
+  {
+    if (!pl.hasParameter(parameters[i].getName()))
+      return false;
+  }
+  return true;
 }
 
 
 void AbstractCodonFrequenciesSubstitutionModel::setFreq(map<int, double>& frequencies)
 {
   pfreqset_->setFrequenciesFromAlphabetStatesFrequencies(frequencies);
+  codonFreqs_ = pfreqset_->getFrequencies();
   matchParametersValues(pfreqset_->getParameters());
 }
 
 double AbstractCodonFrequenciesSubstitutionModel::getCodonsMulRate(size_t i, size_t j) const
 {
-  return pfreqset_->getFrequencies()[j];
+  return codonFreqs_[j];
+}
+
+void AbstractCodonFrequenciesSubstitutionModel::multiplyCodonsMulRates(const CodonPairTable& table, const vector<size_t>& pairs, vector<double>& rates) const
+{
+  size_t n = table.getSize();
+  for (size_t k = 0; k < pairs.size(); k++)
+  {
+    rates[k] *= codonFreqs_[pairs[k] % n];
+  }
 }
 
@@ -40,6 +40,7 @@
 #define _ABSTRACTCODONFREQUENCIESSUBSTITUTIONMODEL_H_
 
 #include "CodonSubstitutionModel.h"
+#include "CodonPairTable.h"
 #include "../FrequenciesSet/CodonFrequenciesSet.h"
 
 namespace bpp
@@ -69,6 +70,12 @@ private:
   FrequenciesSet* pfreqset_;
   std::string freqName_;
 
+  /**
+   * @brief Copy of the codon frequencies of pfreqset_, updated when
+   * its parameters change.
+   */
+  Vdouble codonFreqs_;
+
 public:
   /**
    *@brief Build a AbstractCodonFrequenciesSubstitutionModel instance
@@ -84,7 +91,8 @@ public:
   AbstractCodonFrequenciesSubstitutionModel(const AbstractCodonFrequenciesSubstitutionModel& model) :
     AbstractParameterAliasable(model),
     pfreqset_(model.pfreqset_->clone()),
-    freqName_(model.freqName_)
+    freqName_(model.freqName_),
+    codonFreqs_(model.codonFreqs_)
   {}
 
   AbstractCodonFrequenciesSubstitutionModel& operator=(const AbstractCodonFrequenciesSubstitutionModel& model)
@@ -93,6 +101,7 @@ public:
     if (pfreqset_) delete pfreqset_;
     pfreqset_   = model.pfreqset_->clone();
     freqName_   = model.freqName_;
+    codonFreqs_ = model.codonFreqs_;
     return *this;
   }
 
@@ -104,12 +113,34 @@ public:
 
   const FrequenciesSet* getFrequenciesSet() const { return pfreqset_; }
 
+  /**
+   * @return The frequencies of the codons, as given by the
+   * FrequenciesSet.
+   */
+  const Vdouble& getCodonFrequencies() const { return codonFreqs_; }
+
+  /**
+   * @return true if all the parameters in the list are parameters
+   * of the FrequenciesSet.
+   */
+  bool hasOnlyFrequenciesParameters(const ParameterList& parameters) const;
+
   void setNamespace(const std::string& prefix)
   {
     pfreqset_->setNamespace(prefix + freqName_);
   }
 
   double getCodonsMulRate(size_t, size_t) const;
+
+  /**
+   * @brief Multiply the rates of codon pairs by the frequencies of
+   * their target codons.
+   *
+   * @param table The classification of the codon pairs.
+   * @param pairs Row-wise indices of the codon pairs (see CodonPairTable).
+   * @param rates The rates of these pairs, multiplied in place.
+   */
+  void multiplyCodonsMulRates(const CodonPairTable& table, const std::vector<size_t>& pairs, std::vector<double>& rates) const;
 };
 } // end of namespace bpp.
 
@@ -120,3 +120,35 @@ double AbstractCodonPhaseFrequenciesSubstitutionModel::getCodonsMulRate(size_t i
   return x;
 }
 
+void AbstractCodonPhaseFrequenciesSubstitutionModel::multiplyCodonsMulRates(const CodonPairTable& table, const vector<size_t>& pairs, vector<double>& rates) const
+{
+  // getFrequencies() returns copies: get them once.
+  vector<Vdouble> vFreq(3);
+  for (size_t p = 0; p < 3; p++)
+  {
+    vFreq[p] = posfreqset_->getFrequenciesSetForLetter(p).getFrequencies();
+  }
+
+  size_t n = table.getSize();
+  for (size_t k = 0; k < pairs.size(); k++)
+  {
+    size_t i = pairs[k] / n;
+    size_t j = pairs[k] % n;
+    int pos = table.getChangedPosition(i, j);
+    if (pos >= 0)
+    {
+      size_t p = static_cast<size_t>(pos);
+      rates[k] *= vFreq[p][(j >> (2 * (2 - p))) % 4];
+    }
+    else
+    {
+      for (size_t p = 0; p < 3; p++)
+      {
+        size_t shift = 2 * (2 - p);
+        if (((i >> shift) % 4) != ((j >> shift) % 4))
+          rates[k] *= vFreq[p][(j >> shift) % 4];
+      }
+    }
+  }
+}
+
@@ -40,6 +40,7 @@
 #define _ABSTRACTCODONPHASEFREQUENCIESSUBSTITUTIONMODEL_H_
 
 #include "CodonSubstitutionModel.h"
+#include "CodonPairTable.h"
 #include "../FrequenciesSet/CodonFrequenciesSet.h"
 
 namespace bpp
@@ -120,6 +121,18 @@ public:
   }
 
   double getCodonsMulRate(size_t, size_t) const;
+
+  /**
+   * @brief Same as getCodonsMulRate(), on several pairs at once.
+   *
+   * For pairs that differ at one position, the position is taken
+   * from the table.
+   *
+   * @param table The classification of the codon pairs.
+   * @param pairs Row-wise indices of the codon pairs (see CodonPairTable).
+   * @param rates The rates of these pairs, multiplied in place.
+   */
+  void multiplyCodonsMulRates(const CodonPairTable& table, const std::vector<size_t>& pairs, std::vector<double>& rates) const;
 };
 } // end of namespace bpp.
 
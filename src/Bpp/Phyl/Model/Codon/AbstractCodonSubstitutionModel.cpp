@@ -38,6 +38,9 @@
 
 #include "AbstractCodonSubstitutionModel.h"
 
+// From the STL:
+#include <typeinfo>
+
 using namespace bpp;
 
 using namespace std;
@@ -52,7 +55,10 @@ AbstractCodonSubstitutionModel::AbstractCodonSubstitutionModel(
   AbstractParameterAliasable(prefix),
   AbstractWordSubstitutionModel(gCode->getSourceAlphabet(), new CanonicalStateMap(gCode->getSourceAlphabet(), false), prefix),
   hasParametrizedRates_(paramRates),
-  gCode_(gCode)
+  gCode_(gCode),
+  pairTable_(new CodonPairTable(*gCode)),
+  pairRates_(),
+  onlyFrequenciesChanged_(false)
 {
   enableEigenDecomposition(true);
 
@@ -94,7 +100,10 @@ AbstractCodonSubstitutionModel::AbstractCodonSubstitutionModel(
   AbstractParameterAliasable(prefix),
   AbstractWordSubstitutionModel(gCode->getSourceAlphabet(), new CanonicalStateMap(gCode->getSourceAlphabet(), false), prefix),
   hasParametrizedRates_(paramRates),
-  gCode_(gCode)
+  gCode_(gCode),
+  pairTable_(new CodonPairTable(*gCode)),
+  pairRates_(),
+  onlyFrequenciesChanged_(false)
 {
   enableEigenDecomposition(1);
 
@@ -167,26 +176,115 @@ void AbstractCodonSubstitutionModel::updateMatrices()
     }
   }
 
-  AbstractWordSubstitutionModel::updateMatrices();
+  // The rates of the last full update are only reused if the model
+  // provides the target frequencies.
+  if (pairRates_.size() != pairTable_->getOneChangePairs().size() || !getTargetFrequencies_())
+    onlyFrequenciesChanged_ = false;
+
+  try
+  {
+    AbstractWordSubstitutionModel::updateMatrices();
+  }
+  catch (...)
+  {
+    onlyFrequenciesChanged_ = false;
+    throw;
+  }
+  onlyFrequenciesChanged_ = false;
+}
+
+void AbstractCodonSubstitutionModel::fireParameterChanged(const ParameterList& parameters)
+{
+  onlyFrequenciesChanged_ = false;
+  AbstractWordSubstitutionModel::fireParameterChanged(parameters);
+}
+
+void AbstractCodonSubstitutionModel::fireFrequenciesChanged_(const ParameterList& parameters)
+{
+  // A pending full update is kept as is.
+  if (!hasPendingUpdate())
+    onlyFrequenciesChanged_ = true;
+  AbstractWordSubstitutionModel::fireParameterChanged(parameters);
+}
+
+void AbstractCodonSubstitutionModel::fillBasicGenerator()
+{
+  if (!onlyFrequenciesChanged_)
+    AbstractWordSubstitutionModel::fillBasicGenerator();
+}
+
+bool AbstractCodonSubstitutionModel::copyMatricesFrom(const AbstractSubstitutionModel& model)
+{
+  if (typeid(model) != typeid(*this))
+    return false;
+  const AbstractCodonSubstitutionModel& cmodel = dynamic_cast<const AbstractCodonSubstitutionModel&>(model);
+  if (cmodel.gCode_ != gCode_)
+    return false;
+
+  copyBaseMatrices_(model);
+  pairRates_ = cmodel.pairRates_;
+  onlyFrequenciesChanged_ = false;
+  return true;
 }
 
 void AbstractCodonSubstitutionModel::completeMatrices()
 {
-  size_t i, j;
   size_t salph = getNumberOfStates();
+  const vector<size_t>& vPairs = pairTable_->getOneChangePairs();
+  const Vdouble* targetFreqs = getTargetFrequencies_();
 
-  for (i = 0; i < salph; i++)
+  if (onlyFrequenciesChanged_)
   {
-    for (j = 0; j < salph; j++)
+    // The other rates are still null from the last full update.
+    for (size_t k = 0; k < vPairs.size(); k++)
     {
-      if (gCode_->isStop(static_cast<int>(i)) || gCode_->isStop(static_cast<int>(j)))
+      generator_(vPairs[k] / salph, vPairs[k] % salph) = pairRates_[k] * (*targetFreqs)[vPairs[k] % salph];
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < salph; i++)
+  {
+    if (pairTable_->isStop(i))
+    {
+      for (size_t j = 0; j < salph; j++)
       {
         generator_(i, j) = 0;
+        generator_(j, i) = 0;
       }
-      else
-        generator_(i, j) *= getCodonsMulRate(i, j);
     }
   }
+
+  vector<double> vRates(vPairs.size(), 1.);
+  multiplyCodonsMulRates_(vPairs, vRates);
+  for (size_t k = 0; k < vPairs.size(); k++)
+  {
+    vRates[k] *= generator_(vPairs[k] / salph, vPairs[k] % salph);
+  }
+
+  if (targetFreqs)
+  {
+    pairRates_ = vRates;
+    for (size_t k = 0; k < vPairs.size(); k++)
+    {
+      vRates[k] *= (*targetFreqs)[vPairs[k] % salph];
+    }
+  }
+  else
+    pairRates_.clear();
+
+  for (size_t k = 0; k < vPairs.size(); k++)
+  {
+    generator_(vPairs[k] / salph, vPairs[k] % salph) = vRates[k];
+  }
 }
 
+void AbstractCodonSubstitutionModel::multiplyCodonsMulRates_(const vector<size_t>& pairs, vector<double>& rates)
+{
+  size_t salph = getNumberOfStates();
+  for (size_t k = 0; k < pairs.size(); k++)
+  {
+    rates[k] *= getCodonsMulRate(pairs[k] / salph, pairs[k] % salph);
+  }
+}
 
@@ -43,6 +43,7 @@
 #include "../AbstractWordSubstitutionModel.h"
 #include "../Nucleotide/NucleotideSubstitutionModel.h"
 #include "CodonSubstitutionModel.h"
+#include "CodonPairTable.h"
 
 // From bpp-seq:
 #include <Bpp/Seq/GeneticCode/GeneticCode.h>
@@ -81,6 +82,25 @@ namespace bpp
     bool hasParametrizedRates_;
     const GeneticCode* gCode_;
 
+    /**
+     * @brief Classification of codon pairs, computed once from the
+     * genetic code and shared between copies.
+     */
+    std::shared_ptr<const CodonPairTable> pairTable_;
+
+    /**
+     * @brief Rates of the one-change pairs of the last full update,
+     * before their multiplication by the target frequencies (see
+     * getTargetFrequencies_()).
+     */
+    std::vector<double> pairRates_;
+
+    /**
+     * @brief true if only the target frequencies have changed since
+     * the last update.
+     */
+    bool onlyFrequenciesChanged_;
+
   public:
     /**
      * @brief Build a new AbstractCodonSubstitutionModel object from
@@ -127,7 +147,10 @@ namespace bpp
       AbstractParameterAliasable(model),
       AbstractWordSubstitutionModel(model),
       hasParametrizedRates_(model.hasParametrizedRates_),
-      gCode_(model.gCode_)
+      gCode_(model.gCode_),
+      pairTable_(model.pairTable_),
+      pairRates_(model.pairRates_),
+      onlyFrequenciesChanged_(model.onlyFrequenciesChanged_)
     {}
 
     AbstractCodonSubstitutionModel& operator=(const AbstractCodonSubstitutionModel& model)
@@ -137,24 +160,92 @@ namespace bpp
       AbstractWordSubstitutionModel::operator=(model);
       hasParametrizedRates_ = model.hasParametrizedRates_;
       gCode_ = model.gCode_;
+      pairTable_ = model.pairTable_;
+      pairRates_ = model.pairRates_;
+      onlyFrequenciesChanged_ = model.onlyFrequenciesChanged_;
       return *this;
     }
 
     AbstractCodonSubstitutionModel* clone() const = 0;
 
+    void fireParameterChanged(const ParameterList& parameters);
+
   protected:
+    /**
+     * @brief Tell the model that only the parameters of the target
+     * frequencies (see getTargetFrequencies_()) have changed.
+     *
+     * The next update then takes the rates of the codon pairs from
+     * the last full update, and only multiplies them by the new
+     * frequencies, instead of building the generator again from the
+     * nucleotide models. Inheriting classes call it instead of
+     * fireParameterChanged() in this case.
+     */
+    void fireFrequenciesChanged_(const ParameterList& parameters);
+
+    /**
+     * @brief Frequencies of the target codons, by which the rate of
+     * each codon pair is finally multiplied.
+     *
+     * Models whose codon-codon rates end with such a factor return
+     * them here, and leave them out of multiplyCodonsMulRates_(). The
+     * default implementation returns 0, for no such factor.
+     */
+    virtual const Vdouble* getTargetFrequencies_() const { return 0; }
+
+    /**
+     * @brief Method inherited from AbstractWordSubstitutionModel
+     *
+     * The nucleotide generators are not used if only the target
+     * frequencies have changed.
+     */
+    void fillBasicGenerator();
+
     /**
      * @brief Method inherited from AbstractWordSubstitutionModel
      *
      * This method sets the rates to/from stop codons to zero and
      * performs the multiplication by the specific codon-codon rate.
+     *
+     * Only the pairs of sense codons that differ at one position are
+     * visited, since all other rates are null after
+     * fillBasicGenerator(). Their codon-codon rates are computed all
+     * at once by multiplyCodonsMulRates_(), then multiplied by the
+     * target frequencies, if any. The rates before this last product
+     * are kept for the next frequency-only update (see
+     * fireFrequenciesChanged_()).
      */
     void completeMatrices();
 
+    /**
+     * @brief Multiply the rates of codon pairs by their codon-codon
+     * rates (see getCodonsMulRate()).
+     *
+     * The default implementation calls getCodonsMulRate() on each
+     * pair. Models built from several components override it, so that
+     * each component processes all the pairs in one call, with the
+     * help of the CodonPairTable.
+     *
+     * @param pairs Row-wise indices of the codon pairs (see CodonPairTable).
+     * @param rates The rates of these pairs, multiplied in place.
+     */
+    virtual void multiplyCodonsMulRates_(const std::vector<size_t>& pairs, std::vector<double>& rates);
+
   public:
     void updateMatrices();
 
     const GeneticCode* getGeneticCode() const { return gCode_; }
+
+    const CodonPairTable& getCodonPairTable() const { return *pairTable_; }
+
+    /**
+     * @brief Method inherited from AbstractSubstitutionModel
+     *
+     * The matrices of codon models are entirely defined by the
+     * parameters, so they can be copied between objects of the same
+     * class.
+     */
+    bool copyMatricesFrom(const AbstractSubstitutionModel& model);
   
     /**
      * @brief Method inherited from CodonSubstitutionModel
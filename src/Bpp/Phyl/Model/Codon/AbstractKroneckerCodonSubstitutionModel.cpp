@@ -50,7 +50,8 @@ AbstractKroneckerCodonSubstitutionModel::AbstractKroneckerCodonSubstitutionModel
   const std::string& prefix) :
   AbstractParameterAliasable(prefix),
   AbstractKroneckerWordSubstitutionModel(gCode->getSourceAlphabet(), new CanonicalStateMap(gCode->getSourceAlphabet(), false), prefix),
-  gCode_(gCode)
+  gCode_(gCode),
+  pairTable_(new CodonPairTable(*gCode))
 {
   enableEigenDecomposition(true);
 
@@ -75,7 +76,8 @@ AbstractKroneckerCodonSubstitutionModel::AbstractKroneckerCodonSubstitutionModel
   const std::string& prefix) :
   AbstractParameterAliasable(prefix),
   AbstractKroneckerWordSubstitutionModel(gCode->getSourceAlphabet(), new CanonicalStateMap(gCode->getSourceAlphabet(), false), prefix),
-  gCode_(gCode)
+  gCode_(gCode),
+  pairTable_(new CodonPairTable(*gCode))
 {
   enableEigenDecomposition(true);
 
@@ -101,7 +103,8 @@ AbstractKroneckerCodonSubstitutionModel::AbstractKroneckerCodonSubstitutionModel
   const std::string& prefix) :
   AbstractParameterAliasable(prefix),
   AbstractKroneckerWordSubstitutionModel(gCode->getSourceAlphabet(), new CanonicalStateMap(gCode->getSourceAlphabet(), false), prefix),
-  gCode_(gCode)
+  gCode_(gCode),
+  pairTable_(new CodonPairTable(*gCode))
 {
   enableEigenDecomposition(true);
 
@@ -149,7 +152,8 @@ AbstractKroneckerCodonSubstitutionModel::AbstractKroneckerCodonSubstitutionModel
   const std::string& prefix) :
   AbstractParameterAliasable(prefix),
   AbstractKroneckerWordSubstitutionModel(gCode->getSourceAlphabet(), new CanonicalStateMap(gCode->getSourceAlphabet(), false), prefix),
-  gCode_(gCode)
+  gCode_(gCode),
+  pairTable_(new CodonPairTable(*gCode))
 {
   enableEigenDecomposition(true);
 
@@ -193,21 +197,37 @@ AbstractKroneckerCodonSubstitutionModel::AbstractKroneckerCodonSubstitutionModel
 
 void AbstractKroneckerCodonSubstitutionModel::completeMatrices()
 {
-  size_t i, j;
   size_t salph = getNumberOfStates();
 
-  for (i = 0; i < salph; i++)
+  // The changing positions are set at run time: collect the non-null
+  // rates between sense codons.
+  vector<size_t> vPairs;
+  for (size_t i = 0; i < salph; i++)
   {
-    for (j = 0; j < salph; j++)
+    for (size_t j = 0; j < salph; j++)
     {
-      if (gCode_->isStop(static_cast<int>(i)) || gCode_->isStop(static_cast<int>(j)))
-      {
+      if (pairTable_->isStop(i) || pairTable_->isStop(j))
         generator_(i, j) = 0;
-      }
-      else
-        generator_(i, j) *= getCodonsMulRate(i, j);
+      else if (i != j && generator_(i, j) != 0)
+        vPairs.push_back(i * salph + j);
     }
   }
+
+  vector<double> vRates(vPairs.size(), 1.);
+  multiplyCodonsMulRates_(vPairs, vRates);
+  for (size_t k = 0; k < vPairs.size(); k++)
+  {
+    generator_(vPairs[k] / salph, vPairs[k] % salph) *= vRates[k];
+  }
+}
+
+void AbstractKroneckerCodonSubstitutionModel::multiplyCodonsMulRates_(const vector<size_t>& pairs, vector<double>& rates)
+{
+  size_t salph = getNumberOfStates();
+  for (size_t k = 0; k < pairs.size(); k++)
+  {
+    rates[k] *= getCodonsMulRate(pairs[k] / salph, pairs[k] % salph);
+  }
 }
 
 
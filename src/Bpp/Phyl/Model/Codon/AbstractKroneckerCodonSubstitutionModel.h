@@ -43,6 +43,7 @@
 #include "../AbstractKroneckerWordSubstitutionModel.h"
 #include "../Nucleotide/NucleotideSubstitutionModel.h"
 #include "CodonSubstitutionModel.h"
+#include "CodonPairTable.h"
 
 // From bpp-seq:
 #include <Bpp/Seq/GeneticCode/GeneticCode.h>
@@ -78,6 +79,12 @@ namespace bpp
   private:
     const GeneticCode* gCode_;
 
+    /**
+     * @brief Classification of codon pairs, computed once from the
+     * genetic code and shared between copies.
+     */
+    std::shared_ptr<const CodonPairTable> pairTable_;
+
   public:
     /**
      * @brief Build a new AbstractKroneckerCodonSubstitutionModel object from
@@ -160,7 +167,8 @@ namespace bpp
     AbstractKroneckerCodonSubstitutionModel(const AbstractKroneckerCodonSubstitutionModel& model) :
       AbstractParameterAliasable(model),
       AbstractKroneckerWordSubstitutionModel(model),
-      gCode_(model.gCode_)
+      gCode_(model.gCode_),
+      pairTable_(model.pairTable_)
     {}
 
     AbstractKroneckerCodonSubstitutionModel& operator=(const AbstractKroneckerCodonSubstitutionModel& model)
@@ -168,6 +176,7 @@ namespace bpp
       AbstractParameterAliasable::operator=(model);
       AbstractKroneckerWordSubstitutionModel::operator=(model);
       gCode_ = model.gCode_;
+      pairTable_ = model.pairTable_;
       return *this;
     }
 
@@ -182,10 +191,24 @@ namespace bpp
      */
     void completeMatrices();
 
+    /**
+     * @brief Multiply the rates of codon pairs by their codon-codon
+     * rates.
+     *
+     * As in AbstractCodonSubstitutionModel, the default implementation
+     * calls getCodonsMulRate() on each pair.
+     *
+     * @param pairs Row-wise indices of the codon pairs (see CodonPairTable).
+     * @param rates The rates of these pairs, multiplied in place.
+     */
+    virtual void multiplyCodonsMulRates_(const std::vector<size_t>& pairs, std::vector<double>& rates);
+
   public:
 
     const GeneticCode* getGeneticCode() const { return gCode_; }
 
+    const CodonPairTable& getCodonPairTable() const { return *pairTable_; }
+
     /**
      * @brief Method inherited from CodonSubstitutionModel
      *
@@ -53,7 +53,7 @@ CodonDistanceCpGSubstitutionModel::CodonDistanceCpGSubstitutionModel(
   AbstractCodonDistanceSubstitutionModel(pdist, "CodonDistCpG."),
   AbstractCodonCpGSubstitutionModel("CodonDistCpG.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 CodonDistanceCpGSubstitutionModel::CodonDistanceCpGSubstitutionModel(
@@ -67,7 +67,7 @@ CodonDistanceCpGSubstitutionModel::CodonDistanceCpGSubstitutionModel(
   AbstractCodonDistanceSubstitutionModel(pdist, "CodonDistCpG."),
   AbstractCodonCpGSubstitutionModel("CodonDistCpG.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 std::string CodonDistanceCpGSubstitutionModel::getName() const
@@ -91,3 +91,9 @@ double CodonDistanceCpGSubstitutionModel::getCodonsMulRate(size_t i, size_t j) c
     * AbstractCodonSubstitutionModel::getCodonsMulRate(i,j);
 }
 
+void CodonDistanceCpGSubstitutionModel::multiplyCodonsMulRates_(const vector<size_t>& pairs, vector<double>& rates)
+{
+  AbstractCodonDistanceSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+  AbstractCodonCpGSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+}
+
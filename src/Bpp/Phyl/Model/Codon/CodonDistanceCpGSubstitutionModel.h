@@ -125,6 +125,9 @@ namespace bpp
     std::string getName() const;
 
     double getCodonsMulRate(size_t i, size_t j) const;
+
+  protected:
+    void multiplyCodonsMulRates_(const std::vector<size_t>& pairs, std::vector<double>& rates);
   };
   
 } // end of namespace bpp.
@@ -55,7 +55,7 @@ CodonDistanceFrequenciesSubstitutionModel::CodonDistanceFrequenciesSubstitutionM
   AbstractCodonDistanceSubstitutionModel(pdist, "CodonDistFreq.", paramSynRate),
   AbstractCodonFrequenciesSubstitutionModel(pfreq, "CodonDistFreq.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 CodonDistanceFrequenciesSubstitutionModel::CodonDistanceFrequenciesSubstitutionModel(
@@ -71,7 +71,7 @@ CodonDistanceFrequenciesSubstitutionModel::CodonDistanceFrequenciesSubstitutionM
   AbstractCodonDistanceSubstitutionModel(pdist, "CodonDistFreq.", paramSynRate),
   AbstractCodonFrequenciesSubstitutionModel(pfreq, "CodonDistFreq.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 std::string CodonDistanceFrequenciesSubstitutionModel::getName() const
@@ -85,7 +85,10 @@ void CodonDistanceFrequenciesSubstitutionModel::fireParameterChanged(const Param
   AbstractCodonFrequenciesSubstitutionModel::fireParameterChanged(parameters);
 
   // Beware: must be call at the end
-  AbstractCodonSubstitutionModel::fireParameterChanged(parameters);
+  if (hasOnlyFrequenciesParameters(parameters))
+    AbstractCodonSubstitutionModel::fireFrequenciesChanged_(parameters);
+  else
+    AbstractCodonSubstitutionModel::fireParameterChanged(parameters);
 }
 
 double CodonDistanceFrequenciesSubstitutionModel::getCodonsMulRate(size_t i, size_t j) const
@@ -95,6 +98,12 @@ double CodonDistanceFrequenciesSubstitutionModel::getCodonsMulRate(size_t i, siz
     * AbstractCodonFrequenciesSubstitutionModel::getCodonsMulRate(i,j);
 }
 
+void CodonDistanceFrequenciesSubstitutionModel::multiplyCodonsMulRates_(const vector<size_t>& pairs, vector<double>& rates)
+{
+  // The frequencies are applied afterwards, see getTargetFrequencies_().
+  AbstractCodonDistanceSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+}
+
 void CodonDistanceFrequenciesSubstitutionModel::setNamespace(const std::string& st)
 {
   AbstractParameterAliasable::setNamespace(st);
@@ -154,6 +154,10 @@ public:
 
   void setFreq(std::map<int,double>& frequencies);
 
+protected:
+  void multiplyCodonsMulRates_(const std::vector<size_t>& pairs, std::vector<double>& rates);
+
+  const Vdouble* getTargetFrequencies_() const { return &getCodonFrequencies(); }
 };
 
 } // end of namespace bpp.
@@ -54,7 +54,7 @@ CodonDistancePhaseFrequenciesSubstitutionModel::CodonDistancePhaseFrequenciesSub
   AbstractCodonDistanceSubstitutionModel(pdist, "CodonDistPhasFreq."),
   AbstractCodonPhaseFrequenciesSubstitutionModel(pfreq, "CodonDistPhasFreq.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 CodonDistancePhaseFrequenciesSubstitutionModel::CodonDistancePhaseFrequenciesSubstitutionModel(
@@ -69,7 +69,7 @@ CodonDistancePhaseFrequenciesSubstitutionModel::CodonDistancePhaseFrequenciesSub
   AbstractCodonDistanceSubstitutionModel(pdist, "CodonDistPhasFreq."),
   AbstractCodonPhaseFrequenciesSubstitutionModel(pfreq, "CodonDistPhasFreq.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 std::string CodonDistancePhaseFrequenciesSubstitutionModel::getName() const
@@ -93,6 +93,12 @@ double CodonDistancePhaseFrequenciesSubstitutionModel::getCodonsMulRate(size_t i
     * AbstractCodonPhaseFrequenciesSubstitutionModel::getCodonsMulRate(i,j);
 }
 
+void CodonDistancePhaseFrequenciesSubstitutionModel::multiplyCodonsMulRates_(const vector<size_t>& pairs, vector<double>& rates)
+{
+  AbstractCodonDistanceSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+  AbstractCodonPhaseFrequenciesSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+}
+
 void CodonDistancePhaseFrequenciesSubstitutionModel::setNamespace(const std::string& st)
 {
   AbstractParameterAliasable::setNamespace(st);
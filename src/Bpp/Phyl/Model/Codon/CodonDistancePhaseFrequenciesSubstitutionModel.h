@@ -135,6 +135,9 @@ public:
   void setNamespace(const std::string&);
 
   void setFreq(std::map<int,double>& frequencies);
+
+protected:
+  void multiplyCodonsMulRates_(const std::vector<size_t>& pairs, std::vector<double>& rates);
 };
 
 } // end of namespace bpp.
@@ -52,7 +52,7 @@ CodonDistanceSubstitutionModel::CodonDistanceSubstitutionModel(
   AbstractCodonSubstitutionModel(gCode, pmod, "CodonDist."),
   AbstractCodonDistanceSubstitutionModel(pdist, "CodonDist.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 CodonDistanceSubstitutionModel::CodonDistanceSubstitutionModel(
@@ -65,7 +65,7 @@ CodonDistanceSubstitutionModel::CodonDistanceSubstitutionModel(
   AbstractCodonSubstitutionModel(gCode, pmod1, pmod2, pmod3, "CodonDist."),
   AbstractCodonDistanceSubstitutionModel(pdist, "CodonDist.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 std::string CodonDistanceSubstitutionModel::getName() const
@@ -87,3 +87,8 @@ double CodonDistanceSubstitutionModel::getCodonsMulRate(size_t i, size_t j) cons
     * AbstractCodonSubstitutionModel::getCodonsMulRate(i,j);
 }
 
+void CodonDistanceSubstitutionModel::multiplyCodonsMulRates_(const vector<size_t>& pairs, vector<double>& rates)
+{
+  AbstractCodonDistanceSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+}
+
@@ -0,0 +1,95 @@
+//
+// File: CodonPairTable.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "CodonPairTable.h"
+
+using namespace bpp;
+
+using namespace std;
+
+/******************************************************************************/
+
+CodonPairTable::CodonPairTable(const GeneticCode& gCode) :
+  size_(gCode.getSourceAlphabet()->getSize()),
+  stop_(size_),
+  position_(size_ * size_, -1),
+  synonymous_(size_ * size_, false),
+  cpg_(size_ * size_, false),
+  oneChangePairs_()
+{
+  for (size_t i = 0; i < size_; ++i)
+  {
+    stop_[i] = gCode.isStop(static_cast<int>(i));
+  }
+
+  for (size_t i = 0; i < size_; ++i)
+  {
+    for (size_t j = 0; j < size_; ++j)
+    {
+      size_t ij = i * size_ + j;
+
+      int nbChanges = 0;
+      for (short p = 0; p < 3; ++p)
+      {
+        size_t d = (p == 0 ? 16 : (p == 1 ? 4 : 1));
+        size_t ni = (i / d) % 4;
+        size_t nj = (j / d) % 4;
+        if (ni != nj)
+        {
+          nbChanges++;
+          position_[ij] = p;
+        }
+      }
+      if (nbChanges != 1)
+        position_[ij] = -1;
+
+      int ii = static_cast<int>(i);
+      int ij2 = static_cast<int>(j);
+      cpg_[ij] = (ii % 16 == 7  && (ii - ij2 == 2 || ij2 - ii == 8)) || ((ii - 1) / 4 == 6 && (ii - ij2 == 8 || (ij2 - ii == 32)));
+
+      if (stop_[i] || stop_[j])
+        continue;
+
+      synonymous_[ij] = gCode.areSynonymous(ii, ij2);
+      if (nbChanges == 1)
+        oneChangePairs_.push_back(ij);
+    }
+  }
+}
+
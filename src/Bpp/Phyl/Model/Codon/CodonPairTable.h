@@ -0,0 +1,130 @@
+//
+// File: CodonPairTable.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef _CODONPAIRTABLE_H_
+#define _CODONPAIRTABLE_H_
+
+// From bpp-seq:
+#include <Bpp/Seq/GeneticCode/GeneticCode.h>
+
+// From the STL:
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Precomputed classification of all pairs of codons of a
+ * genetic code.
+ * @author agent
+ *
+ * Codon models fill their generator through many per-pair queries
+ * of the genetic code (stop codons, synonymy, changed position...).
+ * This table computes all these properties once, so that the
+ * components of the models compute their factors on all the pairs
+ * at once, with array lookups only (see
+ * AbstractCodonSubstitutionModel::multiplyCodonsMulRates_).
+ *
+ * Codons are numbered as in the CodonAlphabet, ie the nucleotide at
+ * position @f$p\in\{0,1,2\}@f$ of codon @f$i@f$ is @f$(i / 4^{2-p})
+ * \% 4@f$, with nucleotides A=0, C=1, G=2, T/U=3.
+ *
+ * All pair tables are stored row-wise, the property of pair
+ * @f$(i,j)@f$ being at index @f$i \times n + j@f$, where @f$n@f$ is
+ * the number of codons.
+ */
+  class CodonPairTable
+  {
+  private:
+    size_t size_;
+
+    /**
+     * @brief Stop codons.
+     */
+    std::vector<bool> stop_;
+
+    /**
+     * @brief Changed position (0, 1 or 2) for pairs of codons that
+     * differ at exactly one position, -1 otherwise.
+     */
+    std::vector<short> position_;
+
+    /**
+     * @brief Pairs of sense codons coding the same amino-acid.
+     */
+    std::vector<bool> synonymous_;
+
+    /**
+     * @brief One-position changes in CpG context, as defined in
+     * AbstractCodonCpGSubstitutionModel.
+     */
+    std::vector<bool> cpg_;
+
+    /**
+     * @brief Row-wise indices of the pairs of sense codons that differ
+     * at exactly one position, ie the only pairs with a non-null rate
+     * in single-change codon models.
+     */
+    std::vector<size_t> oneChangePairs_;
+
+  public:
+    CodonPairTable(const GeneticCode& gCode);
+
+    virtual ~CodonPairTable() {}
+
+  public:
+    size_t getSize() const { return size_; }
+
+    bool isStop(size_t i) const { return stop_[i]; }
+
+    /**
+     * @return The changed position (0, 1 or 2) if codons i and j
+     * differ at exactly one position, -1 otherwise.
+     */
+    int getChangedPosition(size_t i, size_t j) const { return position_[i * size_ + j]; }
+
+    bool isSynonymous(size_t i, size_t j) const { return synonymous_[i * size_ + j]; }
+
+    bool isCpG(size_t i, size_t j) const { return cpg_[i * size_ + j]; }
+
+    const std::vector<size_t>& getOneChangePairs() const { return oneChangePairs_; }
+  };
+} // end of namespace bpp.
+
+#endif // _CODONPAIRTABLE_H_
+
@@ -52,7 +52,7 @@ CodonRateFrequenciesSubstitutionModel::CodonRateFrequenciesSubstitutionModel(
   AbstractCodonSubstitutionModel(gCode, pmod, "CodonRateFreq.", true),
   AbstractCodonFrequenciesSubstitutionModel(pfreq, "CodonRateFreq.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 CodonRateFrequenciesSubstitutionModel::CodonRateFrequenciesSubstitutionModel(
@@ -65,7 +65,7 @@ CodonRateFrequenciesSubstitutionModel::CodonRateFrequenciesSubstitutionModel(
   AbstractCodonSubstitutionModel(gCode, pmod1, pmod2, pmod3, "CodonRateFreq.", true),
   AbstractCodonFrequenciesSubstitutionModel(pfreq, "CodonRateFreq.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 std::string CodonRateFrequenciesSubstitutionModel::getName() const
@@ -78,7 +78,10 @@ void CodonRateFrequenciesSubstitutionModel::fireParameterChanged(const Parameter
   AbstractCodonFrequenciesSubstitutionModel::fireParameterChanged(parameters);
 
   // Beware: must be call at the end
-  AbstractCodonSubstitutionModel::fireParameterChanged(parameters);
+  if (hasOnlyFrequenciesParameters(parameters))
+    AbstractCodonSubstitutionModel::fireFrequenciesChanged_(parameters);
+  else
+    AbstractCodonSubstitutionModel::fireParameterChanged(parameters);
 }
 
 double CodonRateFrequenciesSubstitutionModel::getCodonsMulRate(size_t i, size_t j) const
@@ -87,6 +90,12 @@ double CodonRateFrequenciesSubstitutionModel::getCodonsMulRate(size_t i, size_t
     * AbstractCodonFrequenciesSubstitutionModel::getCodonsMulRate(i,j);
 }
 
+void CodonRateFrequenciesSubstitutionModel::multiplyCodonsMulRates_(const vector<size_t>& /*pairs*/, vector<double>& /*rates*/)
+{
+  // The only codon-codon rates are the frequencies, which are applied
+  // afterwards, see getTargetFrequencies_().
+}
+
 void CodonRateFrequenciesSubstitutionModel::setNamespace(const std::string& st)
 {
   AbstractParameterAliasable::setNamespace(st);
@@ -116,6 +116,11 @@ public:
   void setNamespace(const std::string& st);
 
   void setFreq(std::map<int,double>& frequencies);
+
+protected:
+  void multiplyCodonsMulRates_(const std::vector<size_t>& pairs, std::vector<double>& rates);
+
+  const Vdouble* getTargetFrequencies_() const { return &getCodonFrequencies(); }
 };
 
 } // end of namespace bpp.
@@ -51,7 +51,7 @@ CodonRateSubstitutionModel::CodonRateSubstitutionModel(
   AbstractParameterAliasable("CodonRate."),
   AbstractCodonSubstitutionModel(gCode, pmod, "CodonRate.", true)
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 CodonRateSubstitutionModel::CodonRateSubstitutionModel(
@@ -62,7 +62,7 @@ CodonRateSubstitutionModel::CodonRateSubstitutionModel(
   AbstractParameterAliasable("CodonRate."),
   AbstractCodonSubstitutionModel(gCode, pmod1, pmod2, pmod3, "CodonRate.", true)
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 std::string CodonRateSubstitutionModel::getName() const
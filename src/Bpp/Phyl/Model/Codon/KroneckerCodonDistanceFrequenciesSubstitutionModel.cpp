@@ -54,7 +54,7 @@ KroneckerCodonDistanceFrequenciesSubstitutionModel::KroneckerCodonDistanceFreque
   AbstractCodonDistanceSubstitutionModel(pdist, "KronCodonDistFreq."),
   AbstractCodonFrequenciesSubstitutionModel(pfreq, "KronCodonDistFreq.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 KroneckerCodonDistanceFrequenciesSubstitutionModel::KroneckerCodonDistanceFrequenciesSubstitutionModel(
@@ -68,7 +68,7 @@ KroneckerCodonDistanceFrequenciesSubstitutionModel::KroneckerCodonDistanceFreque
   AbstractCodonDistanceSubstitutionModel(pdist, "KronCodonDistFreq."),
   AbstractCodonFrequenciesSubstitutionModel(pfreq, "KronCodonDistFreq.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 KroneckerCodonDistanceFrequenciesSubstitutionModel::KroneckerCodonDistanceFrequenciesSubstitutionModel(
@@ -83,7 +83,7 @@ KroneckerCodonDistanceFrequenciesSubstitutionModel::KroneckerCodonDistanceFreque
   AbstractCodonDistanceSubstitutionModel(pdist, "KronCodonDistFreq."),
   AbstractCodonFrequenciesSubstitutionModel(pfreq, "KronCodonDistFreq.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 KroneckerCodonDistanceFrequenciesSubstitutionModel::KroneckerCodonDistanceFrequenciesSubstitutionModel(
@@ -99,7 +99,7 @@ KroneckerCodonDistanceFrequenciesSubstitutionModel::KroneckerCodonDistanceFreque
   AbstractCodonDistanceSubstitutionModel(pdist, "KronCodonDistFreq."),
   AbstractCodonFrequenciesSubstitutionModel(pfreq, "KronCodonDistFreq.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 std::string KroneckerCodonDistanceFrequenciesSubstitutionModel::getName() const
@@ -123,6 +123,12 @@ double KroneckerCodonDistanceFrequenciesSubstitutionModel::getCodonsMulRate(size
     * AbstractCodonFrequenciesSubstitutionModel::getCodonsMulRate(i,j);
 }
 
+void KroneckerCodonDistanceFrequenciesSubstitutionModel::multiplyCodonsMulRates_(const vector<size_t>& pairs, vector<double>& rates)
+{
+  AbstractCodonDistanceSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+  AbstractCodonFrequenciesSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+}
+
 void KroneckerCodonDistanceFrequenciesSubstitutionModel::setNamespace(const std::string& st)
 {
   AbstractParameterAliasable::setNamespace(st);
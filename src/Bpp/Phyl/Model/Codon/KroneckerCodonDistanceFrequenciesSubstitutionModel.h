@@ -202,6 +202,8 @@ public:
 
   void setFreq(std::map<int,double>& frequencies);
 
+protected:
+  void multiplyCodonsMulRates_(const std::vector<size_t>& pairs, std::vector<double>& rates);
 };
 
 } // end of namespace bpp.
@@ -52,7 +52,7 @@ KroneckerCodonDistanceSubstitutionModel::KroneckerCodonDistanceSubstitutionModel
   AbstractKroneckerCodonSubstitutionModel(gCode, pmod, "KronCodonDist."),
   AbstractCodonDistanceSubstitutionModel(pdist, "KronCodonDist.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 KroneckerCodonDistanceSubstitutionModel::KroneckerCodonDistanceSubstitutionModel(
@@ -65,7 +65,7 @@ KroneckerCodonDistanceSubstitutionModel::KroneckerCodonDistanceSubstitutionModel
   AbstractKroneckerCodonSubstitutionModel(gCode, pmod1, pmod2, pmod3, "KronCodonDist."),
   AbstractCodonDistanceSubstitutionModel(pdist, "KronCodonDist.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 KroneckerCodonDistanceSubstitutionModel::KroneckerCodonDistanceSubstitutionModel(
@@ -77,7 +77,7 @@ KroneckerCodonDistanceSubstitutionModel::KroneckerCodonDistanceSubstitutionModel
   AbstractKroneckerCodonSubstitutionModel(gCode, pmod, vPos, "KronCodonDist."),
   AbstractCodonDistanceSubstitutionModel(pdist, "KronCodonDist.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 KroneckerCodonDistanceSubstitutionModel::KroneckerCodonDistanceSubstitutionModel(
@@ -91,7 +91,7 @@ KroneckerCodonDistanceSubstitutionModel::KroneckerCodonDistanceSubstitutionModel
   AbstractKroneckerCodonSubstitutionModel(gCode, pmod1, pmod2, pmod3, vPos, "KronCodonDist."),
   AbstractCodonDistanceSubstitutionModel(pdist, "KronCodonDist.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 std::string KroneckerCodonDistanceSubstitutionModel::getName() const
 {
@@ -112,6 +112,11 @@ double KroneckerCodonDistanceSubstitutionModel::getCodonsMulRate(size_t i, size_
     * AbstractKroneckerCodonSubstitutionModel::getCodonsMulRate(i,j);
 }
 
+void KroneckerCodonDistanceSubstitutionModel::multiplyCodonsMulRates_(const vector<size_t>& pairs, vector<double>& rates)
+{
+  AbstractCodonDistanceSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+}
+
 void KroneckerCodonDistanceSubstitutionModel::setNamespace(const std::string& st)
 {
   AbstractParameterAliasable::setNamespace(st);
@@ -182,6 +182,8 @@ namespace bpp
 
     void setNamespace(const std::string&);
 
+  protected:
+    void multiplyCodonsMulRates_(const std::vector<size_t>& pairs, std::vector<double>& rates);
   };
 
 } // end of namespace bpp.
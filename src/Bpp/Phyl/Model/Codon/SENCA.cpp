@@ -52,7 +52,7 @@ SENCA::SENCA(
   AbstractCodonDistanceSubstitutionModel(pdist, "SENCA."),
   AbstractCodonFitnessSubstitutionModel(pfit, "SENCA.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 SENCA::SENCA(
@@ -67,7 +67,7 @@ SENCA::SENCA(
   AbstractCodonDistanceSubstitutionModel(pdist, "SENCA."),
   AbstractCodonFitnessSubstitutionModel(pfit,"SENCA.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 string SENCA::getName() const
@@ -90,6 +90,12 @@ double SENCA::getCodonsMulRate(size_t i, size_t j) const
     * AbstractCodonFitnessSubstitutionModel::getCodonsMulRate(i,j);
 }
 
+void SENCA::multiplyCodonsMulRates_(const vector<size_t>& pairs, vector<double>& rates)
+{
+  AbstractCodonDistanceSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+  AbstractCodonFitnessSubstitutionModel::multiplyCodonsMulRates(getCodonPairTable(), pairs, rates);
+}
+
 void SENCA::setNamespace(const std::string& st)
 {
   AbstractParameterAliasable::setNamespace(st);
@@ -119,7 +125,7 @@ void SENCA::setFreq(map<int,double>& frequencies)
 
     AbstractCodonFitnessSubstitutionModel::setFreq(freq2);
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 
@@ -425,9 +425,7 @@ CodonFromIndependentFrequenciesSet::CodonFromIndependentFrequenciesSet(const Cod
   mStopNeigh_(iwfs.mStopNeigh_),
   mgmtStopCodon_(iwfs.mgmtStopCodon_),
   pgc_(iwfs.pgc_)
-{
-  updateFrequencies();
-}
+{}
 
 CodonFromIndependentFrequenciesSet& CodonFromIndependentFrequenciesSet::operator=(const CodonFromIndependentFrequenciesSet& iwfs)
 {
@@ -550,9 +548,7 @@ CodonFromUniqueFrequenciesSet::CodonFromUniqueFrequenciesSet(const CodonFromUniq
   mStopNeigh_(iwfs.mStopNeigh_),
   mgmtStopCodon_(iwfs.mgmtStopCodon_),
   pgc_(iwfs.pgc_)
-{
-  updateFrequencies();
-}
+{}
 
 CodonFromUniqueFrequenciesSet& CodonFromUniqueFrequenciesSet::operator=(const CodonFromUniqueFrequenciesSet& iwfs)
 {
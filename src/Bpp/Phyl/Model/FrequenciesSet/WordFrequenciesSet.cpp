@@ -108,7 +108,7 @@ WordFromIndependentFrequenciesSet::WordFromIndependentFrequenciesSet(const WordF
   {
     vFreq_[i] =  iwfs.vFreq_[i]->clone();
   }
-  updateFrequencies();
+  // Word frequencies are copied, no need to recompute them.
 }
 
 WordFromIndependentFrequenciesSet::~WordFromIndependentFrequenciesSet()
@@ -135,7 +135,6 @@ WordFromIndependentFrequenciesSet& WordFromIndependentFrequenciesSet::operator=(
   {
     vFreq_[i] = iwfs.vFreq_[i]->clone();
   }
-  updateFrequencies();
 
   return *this;
 }
@@ -281,7 +280,7 @@ WordFromUniqueFrequenciesSet::WordFromUniqueFrequenciesSet(const WordFromUniqueF
   NestedPrefix_(iwfs.NestedPrefix_),
   length_(iwfs.length_)
 {
-  updateFrequencies();
+  // Word frequencies are copied, no need to recompute them.
 }
 
 
@@ -293,7 +292,6 @@ WordFromUniqueFrequenciesSet& WordFromUniqueFrequenciesSet::operator=(const Word
   NestedPrefix_ = iwfs.NestedPrefix_;
   length_ = iwfs.length_;
 
-  updateFrequencies();
   return *this;
 }
 
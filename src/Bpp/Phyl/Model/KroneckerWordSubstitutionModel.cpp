@@ -63,7 +63,7 @@ KroneckerWordSubstitutionModel::KroneckerWordSubstitutionModel(
     modelList,
     (prefix == "") ? "Kron." : prefix)
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 KroneckerWordSubstitutionModel::KroneckerWordSubstitutionModel(
@@ -86,7 +86,7 @@ KroneckerWordSubstitutionModel::KroneckerWordSubstitutionModel(
                                 (prefix == "") ? "Kron." : prefix)
 {
   enableEigenDecomposition(true);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 KroneckerWordSubstitutionModel::KroneckerWordSubstitutionModel(
@@ -99,7 +99,7 @@ KroneckerWordSubstitutionModel::KroneckerWordSubstitutionModel(
     (prefix == "") ? "Kron." : prefix)
 {
   enableEigenDecomposition(true);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 KroneckerWordSubstitutionModel::KroneckerWordSubstitutionModel(
@@ -113,7 +113,7 @@ KroneckerWordSubstitutionModel::KroneckerWordSubstitutionModel(
                                          (prefix == "") ? "Kron." : prefix)
 {
   enableEigenDecomposition(true);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 
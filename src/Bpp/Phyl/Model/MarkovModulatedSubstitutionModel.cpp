@@ -43,6 +43,8 @@
 #include <Bpp/Numeric/Matrix/MatrixTools.h>
 #include <Bpp/Numeric/Matrix/EigenValue.h>
 
+#include <cmath>
+
 using namespace bpp;
 using namespace std;
 
@@ -66,6 +68,11 @@ MarkovModulatedSubstitutionModel::MarkovModulatedSubstitutionModel(
   eigenValues_         (model.eigenValues_),
   iEigenValues_        (model.iEigenValues_),
   eigenDecompose_      (model.eigenDecompose_),
+  modelRightEigenVectors_(model.modelRightEigenVectors_),
+  modelLeftEigenVectors_ (model.modelLeftEigenVectors_),
+  blockRightEigenVectors_(model.blockRightEigenVectors_),
+  blockLeftEigenVectors_ (model.blockLeftEigenVectors_),
+  blockExp_            (),
   pijt_                (model.pijt_),
   dpijt_               (model.dpijt_),
   d2pijt_              (model.d2pijt_),
@@ -93,6 +100,10 @@ MarkovModulatedSubstitutionModel& MarkovModulatedSubstitutionModel::operator=(
   eigenValues_          = model.eigenValues_;
   iEigenValues_         = model.iEigenValues_;
   eigenDecompose_       = model.eigenDecompose_;
+  modelRightEigenVectors_ = model.modelRightEigenVectors_;
+  modelLeftEigenVectors_  = model.modelLeftEigenVectors_;
+  blockRightEigenVectors_ = model.blockRightEigenVectors_;
+  blockLeftEigenVectors_  = model.blockLeftEigenVectors_;
   pijt_                 = model.pijt_;
   dpijt_                = model.dpijt_;
   d2pijt_               = model.d2pijt_;
@@ -137,41 +148,108 @@ void MarkovModulatedSubstitutionModel::updateMatrices()
       MatrixTools::scale(exchangeability_, 1. / scale);
   }
 
-  // Compute eigen values and vectors:
-  eigenValues_.resize(nbRates_ * nbStates_);
-  iEigenValues_.resize(nbRates_ * nbStates_);
-  rightEigenVectors_.resize(nbStates_ * nbRates_, nbStates_ * nbRates_);
-  pijt_.resize(nbStates_ * nbRates_, nbStates_ * nbRates_);
-  dpijt_.resize(nbStates_ * nbRates_, nbStates_ * nbRates_);
-  d2pijt_.resize(nbStates_ * nbRates_, nbStates_ * nbRates_);
-
-  vector<double>    modelEigenValues       = model_->getEigenValues();
-  RowMatrix<double> modelRightEigenVectors = model_->getColumnRightEigenVectors();
-  for (unsigned int i = 0; i < nbStates_; i++)
+  // Compute eigen values and vectors, block by block:
+  size_t n = nbStates_ * nbRates_;
+  eigenValues_.resize(n);
+  iEigenValues_.assign(n, 0);
+  rightEigenVectors_.resize(n, n);
+  leftEigenVectors_.resize(n, n);
+  pijt_.resize(n, n);
+  dpijt_.resize(n, n);
+  d2pijt_.resize(n, n);
+  blockRightEigenVectors_.resize(nbStates_);
+  blockLeftEigenVectors_.resize(nbStates_);
+
+  vector<double> modelEigenValues = model_->getEigenValues();
+  modelRightEigenVectors_ = model_->getColumnRightEigenVectors();
+  modelLeftEigenVectors_  = model_->getRowLeftEigenVectors();
+  for (size_t i = 0; i < nbStates_; i++)
   {
     RowMatrix<double> tmp = rates_;
     MatrixTools::scale(tmp, modelEigenValues[i]);
     MatrixTools::add(tmp, ratesGenerator_);
     EigenValue<double> ev(tmp);
-    vector<double>    values  = ev.getRealEigenValues();
-    RowMatrix<double> vectors = ev.getV();
+    vector<double> values = ev.getRealEigenValues();
+    RowMatrix<double>& vectors = blockRightEigenVectors_[i];
+    RowMatrix<double>& invVectors = blockLeftEigenVectors_[i];
+    vectors = ev.getV();
+    // Only a matrix of size nbRates_ needs to be inverted:
+    MatrixTools::inv(vectors, invVectors);
     for (size_t j = 0; j < nbRates_; j++)
     {
       size_t c = i * nbRates_ + j; // Current eigen value index.
       eigenValues_[c] = values[j];
-      // Compute the Kronecker product of the jth vector and the ith modelRightEigenVector.
-      for (unsigned int ii = 0; ii < nbRates_; ii++)
+      // Right eigen vector: Kronecker product of the jth vector and the ith model right eigen vector.
+      // Left eigen vector: Kronecker product of the jth inverse row and the ith model left eigen vector.
+      for (size_t ii = 0; ii < nbRates_; ii++)
       {
         double vii = vectors(ii, j);
-        for (unsigned int jj = 0; jj < nbStates_; jj++)
+        double wii = invVectors(j, ii);
+        for (size_t jj = 0; jj < nbStates_; jj++)
+        {
+          rightEigenVectors_(ii * nbStates_ + jj, c) = vii * modelRightEigenVectors_(jj, i);
+          leftEigenVectors_(c, ii * nbStates_ + jj) = wii * modelLeftEigenVectors_(i, jj);
+        }
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+void MarkovModulatedSubstitutionModel::computeBlockExponentials_(double t, unsigned int order) const
+{
+  blockExp_.assign(nbRates_ * nbRates_ * nbStates_, 0.);
+  Vdouble f(nbRates_);
+  for (size_t i = 0; i < nbStates_; i++)
+  {
+    const RowMatrix<double>& vectors = blockRightEigenVectors_[i];
+    const RowMatrix<double>& invVectors = blockLeftEigenVectors_[i];
+    for (size_t j = 0; j < nbRates_; j++)
+    {
+      double mu = eigenValues_[i * nbRates_ + j];
+      f[j] = exp(mu * t);
+      for (unsigned int o = 0; o < order; o++)
+        f[j] *= mu;
+    }
+    for (size_t a = 0; a < nbRates_; a++)
+    {
+      for (size_t b = 0; b < nbRates_; b++)
+      {
+        double e = 0;
+        for (size_t j = 0; j < nbRates_; j++)
+          e += vectors(a, j) * f[j] * invVectors(j, b);
+        blockExp_[(a * nbRates_ + b) * nbStates_ + i] = e;
+      }
+    }
+  }
+}
+
+void MarkovModulatedSubstitutionModel::computeBlockMatrix_(double t, unsigned int order, RowMatrix<double>& m) const
+{
+  computeBlockExponentials_(t, order);
+  size_t n = nbStates_ * nbRates_;
+  m.resize(n, n);
+  for (size_t a = 0; a < nbRates_; a++)
+  {
+    for (size_t b = 0; b < nbRates_; b++)
+    {
+      const double* e = &blockExp_[(a * nbRates_ + b) * nbStates_];
+      for (size_t k = 0; k < nbStates_; k++)
+      {
+        size_t r = a * nbStates_ + k;
+        for (size_t l = 0; l < nbStates_; l++)
+          m(r, b * nbStates_ + l) = 0;
+        for (size_t i = 0; i < nbStates_; i++)
         {
-          rightEigenVectors_(ii * nbStates_ + jj, c) = vii * modelRightEigenVectors(jj, i);
+          double c = modelRightEigenVectors_(k, i) * e[i];
+          if (c == 0) continue;
+          for (size_t l = 0; l < nbStates_; l++)
+            m(r, b * nbStates_ + l) += c * modelLeftEigenVectors_(i, l);
         }
       }
     }
   }
-  // Now compute left eigen vectors by inversion:
-  MatrixTools::inv(rightEigenVectors_, leftEigenVectors_);
 }
 
 /******************************************************************************/
@@ -181,19 +259,19 @@ const Matrix<double>& MarkovModulatedSubstitutionModel::getPij_t(double t) const
   if (t == 0)
     MatrixTools::getId< RowMatrix<double> >(nbStates_ * nbRates_, pijt_);
   else
-    MatrixTools::mult(rightEigenVectors_, VectorTools::exp(eigenValues_ * t), leftEigenVectors_, pijt_);
+    computeBlockMatrix_(t, 0, pijt_);
   return pijt_;
 }
 
 const Matrix<double>& MarkovModulatedSubstitutionModel::getdPij_dt(double t) const
 {
-  MatrixTools::mult(rightEigenVectors_, eigenValues_ * VectorTools::exp(eigenValues_ * t), leftEigenVectors_, dpijt_);
+  computeBlockMatrix_(t, 1, dpijt_);
   return dpijt_;
 }
 
 const Matrix<double>& MarkovModulatedSubstitutionModel::getd2Pij_dt2(double t) const
 {
-  MatrixTools::mult(rightEigenVectors_, VectorTools::sqr(eigenValues_) * VectorTools::exp(eigenValues_ * t), leftEigenVectors_, d2pijt_);
+  computeBlockMatrix_(t, 2, d2pijt_);
   return d2pijt_;
 }
 
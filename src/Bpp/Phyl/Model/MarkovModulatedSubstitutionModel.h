@@ -69,6 +69,17 @@ namespace bpp
    * where susbstitution here means "change of alphabet state".
    * Rate changes are not counted.
    *
+   * The eigen decomposition of @f$Q@f$ is obtained block by block: if @f$M = U \Lambda U^{-1}@f$ and, for each eigen value
+   * @f$\lambda_i@f$ of @f$M@f$, @f$\lambda_i D_R + G = V_i \Lambda_i V_i^{-1}@f$, the right eigen vectors of @f$Q@f$ are the
+   * @f$V_i \otimes U_{.,i}@f$ and the left ones the @f$V_i^{-1} \otimes U^{-1}_{i,.}@f$.
+   * No matrix of size @f$gm@f$ is ever diagonalized or inverted, and the transition probabilities are computed as
+   * @f[
+   * P_{ab}(t) = U \mathrm{diag}_i\left(\left(e^{(\lambda_i D_R + G)t}\right)_{ab}\right) U^{-1},
+   * @f]
+   * for each block @f$(a,b)@f$ of rate classes. The @f$m@f$ exponentials of size @f$g@f$ cost @f$O(mg^3)@f$, and the
+   * @f$g^2@f$ products of size @f$m@f$ cost @f$O(g^2m^3)@f$, so that a matrix costs @f$O(mg^3 + g^2m^3)@f$ instead of
+   * @f$O(g^3m^3)@f$ with the eigen decomposition of @f$Q@f$.
+   *
    * Galtier N. and Jean-Marie A., Markov-modulated Markov chains and the covarion process of molecular evolution (2004).
    * _Journal of Computational Biology_, 11:727-33.
    */
@@ -131,6 +142,24 @@ namespace bpp
      */
     bool eigenDecompose_;
 
+    /**
+     * @name Block-structured decomposition.
+     *
+     * Eigen vectors of the nested model, and for each of its eigen values @f$\lambda_i@f$,
+     * eigen vectors of @f$\lambda_i D_R + G@f$.
+     * @{
+     */
+    RowMatrix<double> modelRightEigenVectors_;
+    RowMatrix<double> modelLeftEigenVectors_;
+    std::vector< RowMatrix<double> > blockRightEigenVectors_;
+    std::vector< RowMatrix<double> > blockLeftEigenVectors_;
+    /**@}*/
+
+    /**
+     * @brief Workspace for the per-block exponentials, indexed by [(a * nbRates_ + b) * nbStates_ + i].
+     */
+    mutable Vdouble blockExp_;
+
     /**
      * @brief These ones are for bookkeeping:
      */
@@ -163,7 +192,9 @@ namespace bpp
       model_(model), stateMap_(model->getStateMap(), nbRates), nbStates_(model->getNumberOfStates()),
       nbRates_(nbRates), rates_(nbRates, nbRates), ratesExchangeability_(nbRates, nbRates),
       ratesFreq_(nbRates), ratesGenerator_(nbRates, nbRates), generator_(), exchangeability_(),
-      leftEigenVectors_(), rightEigenVectors_(), eigenValues_(), iEigenValues_(), eigenDecompose_(true), 
+      leftEigenVectors_(), rightEigenVectors_(), eigenValues_(), iEigenValues_(), eigenDecompose_(true),
+      modelRightEigenVectors_(), modelLeftEigenVectors_(),
+      blockRightEigenVectors_(), blockLeftEigenVectors_(), blockExp_(),
       pijt_(), dpijt_(), d2pijt_(), freq_(),
       normalizeRateChanges_(normalizeRateChanges),
       nestedPrefix_("model_" + model->getNamespace())
@@ -307,6 +338,22 @@ namespace bpp
     
     virtual void updateMatrices();
 
+    /**
+     * @brief Compute @f$U f(\Lambda) U^{-1}@f$ block by block, with @f$f(\mu) = \mu^k e^{\mu t}@f$.
+     *
+     * This costs @f$O(mg^3)@f$ for the block exponentials, and @f$O(m^3)@f$ for each of the @f$g^2@f$ blocks.
+     *
+     * @param t The branch length.
+     * @param order The order @f$k@f$ of the derivative.
+     * @param m [out] The resulting matrix.
+     */
+    void computeBlockMatrix_(double t, unsigned int order, RowMatrix<double>& m) const;
+
+    /**
+     * @brief Fill blockExp_ with the entries of @f$V_i \mu^k e^{\Lambda_i t} V_i^{-1}@f$, for all @f$i@f$.
+     */
+    void computeBlockExponentials_(double t, unsigned int order) const;
+
     /**
      * @brief Update the rates vector, generator and equilibrium frequencies.
      *
@@ -133,7 +133,8 @@ MixtureOfASubstitutionModel::MixtureOfASubstitutionModel(
     else
       addParameter_(new Parameter(it->first, pd->getCategory(0), (pd->getParameter("value").getConstraint()) ? pd->getParameter("value").getConstraint()->clone() : 0, true));
   }
-  updateMatrices();
+
+  requestUpdateMatrices_();
 }
 
 MixtureOfASubstitutionModel::MixtureOfASubstitutionModel(const MixtureOfASubstitutionModel& msm) :
@@ -223,27 +224,29 @@ void MixtureOfASubstitutionModel::updateMatrices()
     }
   }
 
-  for (i = 0; i < modelsContainer_.size(); i++)
-  {
-    vProbas_[i] = 1;
-    j = i;
-    for (it = distributionMap_.begin(); it != distributionMap_.end(); it++)
-    {
-      s = it->first;
-      l = j % it->second->getNumberOfCategories();
+  // all submodels are clones of the same model, so identical
+  // submodels can share their eigen decomposition.
+  updateSubModels_(
+    [&](size_t k) {
+      vProbas_[k] = 1;
+      size_t m = k;
+      for (it = distributionMap_.begin(); it != distributionMap_.end(); it++)
+      {
+        s = it->first;
+        l = m % it->second->getNumberOfCategories();
 
-      d = it->second->getCategory(l);
-      vProbas_[i] *= it->second->getProbability(l);
-      if (pl.hasParameter(s))
-        pl.setParameterValue(s, d);
-      else
-        pl.addParameter(Parameter(s, d));
+        d = it->second->getCategory(l);
+        vProbas_[k] *= it->second->getProbability(l);
+        if (pl.hasParameter(s))
+          pl.setParameterValue(s, d);
+        else
+          pl.addParameter(Parameter(s, d));
 
-      j = j / it->second->getNumberOfCategories();
-    }
+        m = m / it->second->getNumberOfCategories();
+      }
 
-    modelsContainer_[i]->matchParametersValues(pl);
-  }
+      modelsContainer_[k]->matchParametersValues(pl);
+    }, true);
 
   //  setting the equilibrium freqs
   for (i = 0; i < getNumberOfStates(); i++)
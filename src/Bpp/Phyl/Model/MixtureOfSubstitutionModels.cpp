@@ -92,7 +92,7 @@ MixtureOfSubstitutionModels::MixtureOfSubstitutionModels(
     addParameters_(vpModel[i]->getParameters());
   }
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 MixtureOfSubstitutionModels::MixtureOfSubstitutionModels(
@@ -173,7 +173,7 @@ MixtureOfSubstitutionModels::MixtureOfSubstitutionModels(
     addParameters_(vpModel[i]->getParameters());
   }
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 MixtureOfSubstitutionModels::MixtureOfSubstitutionModels(const MixtureOfSubstitutionModels& msm) :
@@ -256,11 +256,11 @@ void MixtureOfSubstitutionModels::updateMatrices()
 
   // / models
 
-  for (i = 0; i < nbmod; i++)
-  {
-    modelsContainer_[i]->setRate(rate_ * vRates_[i]);
-    modelsContainer_[i]->matchParametersValues(getParameters());
-  }
+  updateSubModels_(
+    [this](size_t k) {
+      modelsContainer_[k]->setRate(rate_ * vRates_[k]);
+      modelsContainer_[k]->matchParametersValues(getParameters());
+    }, false);
 
   // / freq_
 
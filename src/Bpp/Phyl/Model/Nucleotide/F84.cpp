@@ -70,7 +70,7 @@ F84::F84(
   addParameter_(new Parameter("F84.theta" , theta_ , &FrequenciesSet::FREQUENCE_CONSTRAINT_SMALL));
   addParameter_(new Parameter("F84.theta1", theta1_, &FrequenciesSet::FREQUENCE_CONSTRAINT_SMALL));
   addParameter_(new Parameter("F84.theta2", theta2_, &FrequenciesSet::FREQUENCE_CONSTRAINT_SMALL));
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -194,6 +194,7 @@ void F84::updateMatrices()
 
 double F84::Pij_t(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-k1_*l_);
   exp2_ = exp(-k2_*l_);
@@ -243,6 +244,7 @@ double F84::Pij_t(size_t i, size_t j, double d) const
 
 double F84::dPij_dt(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-k1_*l_);
   exp2_ = exp(-k2_*l_);
@@ -292,6 +294,7 @@ double F84::dPij_dt(size_t i, size_t j, double d) const
 
 double F84::d2Pij_dt2(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   double r_2 = rate_ * rate_ * r_ * r_;
   l_ = rate_ * r_ * d;
   double k2_2 = k2_ * k2_;
@@ -343,6 +346,7 @@ double F84::d2Pij_dt2(size_t i, size_t j, double d) const
 
 const Matrix<double> & F84::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-k1_*l_);
   exp2_ = exp(-k2_*l_);
@@ -374,8 +378,51 @@ const Matrix<double> & F84::getPij_t(double d) const
   return p_;
 }
 
+/******************************************************************************/
+
+void F84::fillPij_t(const Vdouble& times, VVVdouble& pijt) const
+{
+  updatePendingMatrices_();
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-k1_));
+  Vdouble vexp2 = VectorTools::exp(l * (-k2_));
+  pijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e2 = vexp2[k];
+    VVdouble& p = pijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    //A
+    p[0][0] = piA_ * (1. + (piY_/piR_) * e1) + (piG_/piR_) * e2; //A
+    p[0][1] = piC_ * (1. -               e1);                       //C
+    p[0][2] = piG_ * (1. + (piY_/piR_) * e1) - (piG_/piR_) * e2; //G
+    p[0][3] = piT_ * (1. -               e1);                       //T, U
+
+    //C
+    p[1][0] = piA_ * (1. -               e1);                       //A
+    p[1][1] = piC_ * (1. + (piR_/piY_) * e1) + (piT_/piY_) * e2; //C
+    p[1][2] = piG_ * (1. -               e1);                       //G
+    p[1][3] = piT_ * (1. + (piR_/piY_) * e1) - (piT_/piY_) * e2; //T, U
+
+    //G
+    p[2][0] = piA_ * (1. + (piY_/piR_) * e1) - (piA_/piR_) * e2; //A
+    p[2][1] = piC_ * (1. -               e1);                       //C
+    p[2][2] = piG_ * (1. + (piY_/piR_) * e1) + (piA_/piR_) * e2; //G
+    p[2][3] = piT_ * (1. -               e1);                       //T, U
+
+    //T, U
+    p[3][0] = piA_ * (1. -               e1);                       //A
+    p[3][1] = piC_ * (1. + (piR_/piY_) * e1) - (piC_/piY_) * e2; //C
+    p[3][2] = piG_ * (1. -               e1);                       //G
+    p[3][3] = piT_ * (1. + (piR_/piY_) * e1) + (piC_/piY_) * e2; //T, U
+  }
+}
+
 const Matrix<double> & F84::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-k1_*l_);
   exp2_ = exp(-k2_*l_);
@@ -407,8 +454,49 @@ const Matrix<double> & F84::getdPij_dt(double d) const
   return p_;
 }
 
+void F84::filldPij_dt(const Vdouble& times, VVVdouble& dpijt) const
+{
+  updatePendingMatrices_();
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-k1_));
+  Vdouble vexp2 = VectorTools::exp(l * (-k2_));
+  dpijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e2 = vexp2[k];
+    VVdouble& p = dpijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    //A
+    p[0][0] = rate_ * r_ * (piA_ * -(piY_/piR_) * e1 - (piG_/piR_) * k2_ * e2); //A
+    p[0][1] = rate_ * r_ * (piC_ *                e1);                             //C
+    p[0][2] = rate_ * r_ * (piG_ * -(piY_/piR_) * e1 + (piG_/piR_) * k2_ * e2); //G
+    p[0][3] = rate_ * r_ * (piT_ *                e1);                             //T, U
+
+    //C
+    p[1][0] = rate_ * r_ * (piA_ *                e1);                             //A
+    p[1][1] = rate_ * r_ * (piC_ * -(piR_/piY_) * e1 - (piT_/piY_) * k2_ * e2); //C
+    p[1][2] = rate_ * r_ * (piG_ *                e1);                             //G
+    p[1][3] = rate_ * r_ * (piT_ * -(piR_/piY_) * e1 + (piT_/piY_) * k2_ * e2); //T, U
+
+    //G
+    p[2][0] = rate_ * r_ * (piA_ * -(piY_/piR_) * e1 + (piA_/piR_) * k2_ * e2); //A
+    p[2][1] = rate_ * r_ * (piC_ *                e1);                             //C
+    p[2][2] = rate_ * r_ * (piG_ * -(piY_/piR_) * e1 - (piA_/piR_) * k2_ * e2); //G
+    p[2][3] = rate_ * r_ * (piT_ *                e1);                             //T, U
+
+    //T, U
+    p[3][0] = rate_ * r_ * (piA_ *                e1);                             //A
+    p[3][1] = rate_ * r_ * (piC_ * -(piR_/piY_) * e1 + (piC_/piY_) * k2_ * e2); //C
+    p[3][2] = rate_ * r_ * (piG_ *                e1);                             //G
+    p[3][3] = rate_ * r_ * (piT_ * -(piR_/piY_) * e1 - (piC_/piY_) * k2_ * e2); //T, U
+  }
+}
+
 const Matrix<double> & F84::getd2Pij_dt2(double d) const
 {
+  updatePendingMatrices_();
   double r_2 = rate_ * rate_ * r_ * r_;
   l_ = rate_ * r_ * d;
   double k2_2 = k2_ * k2_;
@@ -442,6 +530,48 @@ const Matrix<double> & F84::getd2Pij_dt2(double d) const
   return p_;
 }
 
+void F84::filld2Pij_dt2(const Vdouble& times, VVVdouble& d2pijt) const
+{
+  updatePendingMatrices_();
+  double r_2 = rate_ * rate_ * r_ * r_;
+  double k2_2 = k2_ * k2_;
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-k1_));
+  Vdouble vexp2 = VectorTools::exp(l * (-k2_));
+  d2pijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e2 = vexp2[k];
+    VVdouble& p = d2pijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    //A
+    p[0][0] = r_2 * (piA_ * (piY_/piR_) * e1 + (piG_/piR_) * k2_2 * e2); //A
+    p[0][1] = r_2 * (piC_ *             - e1);                              //C
+    p[0][2] = r_2 * (piG_ * (piY_/piR_) * e1 - (piG_/piR_) * k2_2 * e2); //G
+    p[0][3] = r_2 * (piT_ *             - e1);                              //T, U
+
+    //C
+    p[1][0] = r_2 * (piA_ *             - e1);                              //A
+    p[1][1] = r_2 * (piC_ * (piR_/piY_) * e1 + (piT_/piY_) * k2_2 * e2); //C
+    p[1][2] = r_2 * (piG_ *             - e1);                              //G
+    p[1][3] = r_2 * (piT_ * (piR_/piY_) * e1 - (piT_/piY_) * k2_2 * e2); //T, U
+
+    //G
+    p[2][0] = r_2 * (piA_ * (piY_/piR_) * e1 - (piA_/piR_) * k2_2 * e2); //A
+    p[2][1] = r_2 * (piC_ *             - e1);                              //C
+    p[2][2] = r_2 * (piG_ * (piY_/piR_) * e1 + (piA_/piR_) * k2_2 * e2); //G
+    p[2][3] = r_2 * (piT_ *             - e1);                              //T, U
+ 
+    //T, U
+    p[3][0] = r_2 * (piA_ *             - e1);                              //A
+    p[3][1] = r_2 * (piC_ * (piR_/piY_) * e1 - (piC_/piY_) * k2_2 * e2); //C
+    p[3][2] = r_2 * (piG_ *             - e1);                              //G
+    p[3][3] = r_2 * (piT_ * (piR_/piY_) * e1 + (piC_/piY_) * k2_2 * e2); //T, U
+  }
+}
+
 /******************************************************************************/
 
 void F84::setFreq(map<int, double>& freqs)
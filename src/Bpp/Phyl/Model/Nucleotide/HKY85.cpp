@@ -72,7 +72,7 @@ HKY85::HKY85(
   addParameter_(new Parameter("HKY85.theta" , theta_, &FrequenciesSet::FREQUENCE_CONSTRAINT_SMALL));
   addParameter_(new Parameter("HKY85.theta1", theta1_, &FrequenciesSet::FREQUENCE_CONSTRAINT_SMALL));
   addParameter_(new Parameter("HKY85.theta2", theta2_, &FrequenciesSet::FREQUENCE_CONSTRAINT_SMALL));
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -194,6 +194,7 @@ void HKY85::updateMatrices()
 
 double HKY85::Pij_t(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_     = rate_ * r_ * d;
   exp1_  = exp(-l_);
   exp22_ = exp(-k2_ * l_);
@@ -245,6 +246,7 @@ double HKY85::Pij_t(size_t i, size_t j, double d) const
 
 double HKY85::dPij_dt(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_     = rate_ * r_ * d;
   exp1_  = exp(-l_);
   exp22_ = exp(-k2_ * l_);
@@ -296,6 +298,7 @@ double HKY85::dPij_dt(size_t i, size_t j, double d) const
 
 double HKY85::d2Pij_dt2(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   double r_2 = rate_ * rate_ * r_ * r_;
   l_ = rate_ * r_ * d;
   double k1_2 = k1_ * k1_;
@@ -350,6 +353,7 @@ double HKY85::d2Pij_dt2(size_t i, size_t j, double d) const
 
 const Matrix<double> & HKY85::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp22_ = exp(-k2_ * l_);
@@ -382,8 +386,53 @@ const Matrix<double> & HKY85::getPij_t(double d) const
   return p_;
 }
 
+/******************************************************************************/
+
+void HKY85::fillPij_t(const Vdouble& times, VVVdouble& pijt) const
+{
+  updatePendingMatrices_();
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-1.));
+  Vdouble vexp22 = VectorTools::exp(l * (-k2_));
+  Vdouble vexp21 = VectorTools::exp(l * (-k1_));
+  pijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e22 = vexp22[k];
+    double e21 = vexp21[k];
+    VVdouble& p = pijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    //A
+    p[0][0] = piA_ * (1. + (piY_/piR_) * e1) + (piG_/piR_) * e22; //A
+    p[0][1] = piC_ * (1. -               e1);                        //C
+    p[0][2] = piG_ * (1. + (piY_/piR_) * e1) - (piG_/piR_) * e22; //G
+    p[0][3] = piT_ * (1. -               e1);                        //T, U
+
+    //C
+    p[1][0] = piA_ * (1. -               e1);                        //A
+    p[1][1] = piC_ * (1. + (piR_/piY_) * e1) + (piT_/piY_) * e21; //C
+    p[1][2] = piG_ * (1. -               e1);                        //G
+    p[1][3] = piT_ * (1. + (piR_/piY_) * e1) - (piT_/piY_) * e21; //T, U
+
+    //G
+    p[2][0] = piA_ * (1. + (piY_/piR_) * e1) - (piA_/piR_) * e22; //A
+    p[2][1] = piC_ * (1. -               e1);                        //C
+    p[2][2] = piG_ * (1. + (piY_/piR_) * e1) + (piA_/piR_) * e22; //G
+    p[2][3] = piT_ * (1. -               e1);                        //T, U
+
+    //T, U
+    p[3][0] = piA_ * (1. -               e1);                        //A
+    p[3][1] = piC_ * (1. + (piR_/piY_) * e1) - (piC_/piY_) * e21; //C
+    p[3][2] = piG_ * (1. -               e1);                        //G
+    p[3][3] = piT_ * (1. + (piR_/piY_) * e1) + (piC_/piY_) * e21; //T, U
+  }
+}
+
 const Matrix<double> & HKY85::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp22_ = exp(-k2_ * l_);
@@ -416,8 +465,51 @@ const Matrix<double> & HKY85::getdPij_dt(double d) const
   return p_;
 }
 
+void HKY85::filldPij_dt(const Vdouble& times, VVVdouble& dpijt) const
+{
+  updatePendingMatrices_();
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-1.));
+  Vdouble vexp22 = VectorTools::exp(l * (-k2_));
+  Vdouble vexp21 = VectorTools::exp(l * (-k1_));
+  dpijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e22 = vexp22[k];
+    double e21 = vexp21[k];
+    VVdouble& p = dpijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    //A
+    p[0][0] = rate_ * r_ * (piA_ * -(piY_/piR_) * e1 - (piG_/piR_) * k2_ * e22); //A
+    p[0][1] = rate_ * r_ * (piC_ *                e1);                              //C
+    p[0][2] = rate_ * r_ * (piG_ * -(piY_/piR_) * e1 + (piG_/piR_) * k2_ * e22); //G
+    p[0][3] = rate_ * r_ * (piT_ *                e1);                              //T, U
+
+    //C
+    p[1][0] = rate_ * r_ * (piA_ *                e1);                              //A
+    p[1][1] = rate_ * r_ * (piC_ * -(piR_/piY_) * e1 - (piT_/piY_) * k1_ * e21); //C
+    p[1][2] = rate_ * r_ * (piG_ *                e1);                              //G
+    p[1][3] = rate_ * r_ * (piT_ * -(piR_/piY_) * e1 + (piT_/piY_) * k1_ * e21); //T, U
+
+    //G
+    p[2][0] = rate_ * r_ * (piA_ * -(piY_/piR_) * e1 + (piA_/piR_) * k2_ * e22); //A
+    p[2][1] = rate_ * r_ * (piC_ *                e1);                              //C
+    p[2][2] = rate_ * r_ * (piG_ * -(piY_/piR_) * e1 - (piA_/piR_) * k2_ * e22); //G
+    p[2][3] = rate_ * r_ * (piT_ *                e1);                              //T, U
+
+    //T, U
+    p[3][0] = rate_ * r_ * (piA_ *                e1);                              //A
+    p[3][1] = rate_ * r_ * (piC_ * -(piR_/piY_) * e1 + (piC_/piY_) * k1_ * e21); //C
+    p[3][2] = rate_ * r_ * (piG_ *                e1);                              //G
+    p[3][3] = rate_ * r_ * (piT_ * -(piR_/piY_) * e1 - (piC_/piY_) * k1_ * e21); //T, U
+  }
+}
+
 const Matrix<double> & HKY85::getd2Pij_dt2(double d) const
 {
+  updatePendingMatrices_();
   double r_2 = rate_ * rate_ * r_ * r_;
   l_ = rate_ * r_ * d;
   double k1_2 = k1_ * k1_;
@@ -453,6 +545,51 @@ const Matrix<double> & HKY85::getd2Pij_dt2(double d) const
   return p_;
 }
 
+void HKY85::filld2Pij_dt2(const Vdouble& times, VVVdouble& d2pijt) const
+{
+  updatePendingMatrices_();
+  double r_2 = rate_ * rate_ * r_ * r_;
+  double k1_2 = k1_ * k1_;
+  double k2_2 = k2_ * k2_;
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-1.));
+  Vdouble vexp22 = VectorTools::exp(l * (-k2_));
+  Vdouble vexp21 = VectorTools::exp(l * (-k1_));
+  d2pijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e22 = vexp22[k];
+    double e21 = vexp21[k];
+    VVdouble& p = d2pijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    //A
+    p[0][0] = r_2 * (piA_ * (piY_/piR_) * e1 + (piG_/piR_) * k2_2 * e22); //A
+    p[0][1] = r_2 * (piC_ *             - e1);                               //C
+    p[0][2] = r_2 * (piG_ * (piY_/piR_) * e1 - (piG_/piR_) * k2_2 * e22); //G
+    p[0][3] = r_2 * (piT_ *             - e1);                               //T, U
+
+    //C
+    p[1][0] = r_2 * (piA_ *             - e1);                               //A
+    p[1][1] = r_2 * (piC_ * (piR_/piY_) * e1 + (piT_/piY_) * k1_2 * e21); //C
+    p[1][2] = r_2 * (piG_ *             - e1);                               //G
+    p[1][3] = r_2 * (piT_ * (piR_/piY_) * e1 - (piT_/piY_) * k1_2 * e21); //T, U
+
+    //G
+    p[2][0] = r_2 * (piA_ * (piY_/piR_) * e1 - (piA_/piR_) * k2_2 * e22); //A
+    p[2][1] = r_2 * (piC_ *             - e1);                               //C
+    p[2][2] = r_2 * (piG_ * (piY_/piR_) * e1 + (piA_/piR_) * k2_2 * e22); //G
+    p[2][3] = r_2 * (piT_ *             - e1);                               //T, U
+
+    //T, U
+    p[3][0] = r_2 * (piA_ *             - e1);                               //A
+    p[3][1] = r_2 * (piC_ * (piR_/piY_) * e1 - (piC_/piY_) * k1_2 * e21); //C
+    p[3][2] = r_2 * (piG_ *             - e1);                               //G
+    p[3][3] = r_2 * (piT_ * (piR_/piY_) * e1 + (piC_/piY_) * k1_2 * e21); //T, U
+  }
+}
+
 /******************************************************************************/
 
 void HKY85::setFreq(std::map<int, double>& freqs)
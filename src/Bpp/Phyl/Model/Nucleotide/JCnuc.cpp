@@ -53,7 +53,7 @@ JCnuc::JCnuc(const NucleicAlphabet* alpha) :
   exp_(),
   p_(size_, size_)
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -117,6 +117,7 @@ void JCnuc::updateMatrices()
 
 double JCnuc::Pij_t(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   if (i == j)
     return 1. / 4. + 3. / 4. * exp(-rate_ * 4. / 3. * d);
   else
@@ -127,6 +128,7 @@ double JCnuc::Pij_t(size_t i, size_t j, double d) const
 
 double JCnuc::dPij_dt(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   if (i == j)
     return -exp(-rate_ * 4. / 3. * d) * rate_;
   else
@@ -137,6 +139,7 @@ double JCnuc::dPij_dt(size_t i, size_t j, double d) const
 
 double JCnuc::d2Pij_dt2(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   if (i == j)
     return 4. / 3. * exp(-rate_ * 4. / 3. * d) * rate_ * rate_;
   else
@@ -147,6 +150,7 @@ double JCnuc::d2Pij_dt2(size_t i, size_t j, double d) const
 
 const Matrix<double>& JCnuc::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   exp_ = exp(-4. / 3. * d * rate_);
   for (size_t i = 0; i < size_; i++)
   {
@@ -158,8 +162,32 @@ const Matrix<double>& JCnuc::getPij_t(double d) const
   return p_;
 }
 
+/******************************************************************************/
+
+void JCnuc::fillPij_t(const Vdouble& times, VVVdouble& pijt) const
+{
+  updatePendingMatrices_();
+  Vdouble vexp = VectorTools::exp(times * (-4. / 3. * rate_));
+  pijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e = vexp[k];
+    VVdouble& p = pijt[k];
+    VectorTools::resize2(p, size_, size_);
+
+    for (size_t i = 0; i < size_; i++)
+    {
+      for (size_t j = 0; j < size_; j++)
+      {
+        p[i][j] = (i == j) ? 1. / 4. + 3. / 4. * e : 1. / 4. - 1. / 4. * e;
+      }
+    }
+  }
+}
+
 const Matrix<double>& JCnuc::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   exp_ = exp(-4. / 3. * d * rate_);
   for (size_t i = 0; i < size_; i++)
   {
@@ -171,8 +199,30 @@ const Matrix<double>& JCnuc::getdPij_dt(double d) const
   return p_;
 }
 
+void JCnuc::filldPij_dt(const Vdouble& times, VVVdouble& dpijt) const
+{
+  updatePendingMatrices_();
+  Vdouble vexp = VectorTools::exp(times * (-4. / 3. * rate_));
+  dpijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e = vexp[k];
+    VVdouble& p = dpijt[k];
+    VectorTools::resize2(p, size_, size_);
+
+    for (size_t i = 0; i < size_; i++)
+    {
+      for (size_t j = 0; j < size_; j++)
+      {
+        p[i][j] = rate_ * ((i == j) ? -e : 1. / 3. * e);
+      }
+    }
+  }
+}
+
 const Matrix<double>& JCnuc::getd2Pij_dt2(double d) const
 {
+  updatePendingMatrices_();
   exp_ = exp(-4. / 3. * d * rate_);
   for (size_t i = 0; i < size_; i++)
   {
@@ -184,5 +234,26 @@ const Matrix<double>& JCnuc::getd2Pij_dt2(double d) const
   return p_;
 }
 
+void JCnuc::filld2Pij_dt2(const Vdouble& times, VVVdouble& d2pijt) const
+{
+  updatePendingMatrices_();
+  Vdouble vexp = VectorTools::exp(times * (-4. / 3. * rate_));
+  d2pijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e = vexp[k];
+    VVdouble& p = d2pijt[k];
+    VectorTools::resize2(p, size_, size_);
+
+    for (size_t i = 0; i < size_; i++)
+    {
+      for (size_t j = 0; j < size_; j++)
+      {
+        p[i][j] = rate_ * rate_ * ((i == j) ? 4. / 3. * e : -4. / 9. * e);
+      }
+    }
+  }
+}
+
 /******************************************************************************/
 
@@ -56,7 +56,7 @@ AbstractParameterAliasable("K80."),
   kappa_(kappa), r_(), l_(), k_(), exp1_(), exp2_(), p_(size_, size_)
 {
   addParameter_(new Parameter("K80.kappa", kappa, &Parameter::R_PLUS_STAR));
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -143,6 +143,7 @@ void K80::updateMatrices()
 
 double K80::Pij_t(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp2_ = exp(-k_ * l_);
@@ -192,6 +193,7 @@ double K80::Pij_t(size_t i, size_t j, double d) const
 
 double K80::dPij_dt(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp2_ = exp(-k_ * l_);
@@ -241,6 +243,7 @@ double K80::dPij_dt(size_t i, size_t j, double d) const
 
 double K80::d2Pij_dt2(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   double k_2 = k_ * k_;
   double r_2 = rate_ * rate_ * r_ * r_;
   l_ = rate_ * r_ * d;
@@ -292,6 +295,7 @@ double K80::d2Pij_dt2(size_t i, size_t j, double d) const
 
 const Matrix<double> & K80::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp2_ = exp(-k_ * l_);
@@ -323,8 +327,51 @@ const Matrix<double> & K80::getPij_t(double d) const
   return p_;
 }
 
+/******************************************************************************/
+
+void K80::fillPij_t(const Vdouble& times, VVVdouble& pijt) const
+{
+  updatePendingMatrices_();
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-1.));
+  Vdouble vexp2 = VectorTools::exp(l * (-k_));
+  pijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e2 = vexp2[k];
+    VVdouble& p = pijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    //A
+    p[0][0] = 0.25 * (1. + e1) + 0.5 * e2; //A
+    p[0][1] = 0.25 * (1. - e1);               //C
+    p[0][2] = 0.25 * (1. + e1) - 0.5 * e2; //G
+    p[0][3] = 0.25 * (1. - e1);               //T, U
+
+    //C
+    p[1][0] = 0.25 * (1. - e1);               //A
+    p[1][1] = 0.25 * (1. + e1) + 0.5 * e2; //C
+    p[1][2] = 0.25 * (1. - e1);               //G
+    p[1][3] = 0.25 * (1. + e1) - 0.5 * e2; //T, U
+
+    //G
+    p[2][0] = 0.25 * (1. + e1) - 0.5 * e2; //A
+    p[2][1] = 0.25 * (1. - e1);               //C
+    p[2][2] = 0.25 * (1. + e1) + 0.5 * e2; //G
+    p[2][3] = 0.25 * (1. - e1);               //T, U
+
+    //T, U
+    p[3][0] = 0.25 * (1. - e1);               //A
+    p[3][1] = 0.25 * (1. + e1) - 0.5 * e2; //C
+    p[3][2] = 0.25 * (1. - e1);               //G
+    p[3][3] = 0.25 * (1. + e1) + 0.5 * e2; //T, U
+  }
+}
+
 const Matrix<double> & K80::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp2_ = exp(-k_ * l_);
@@ -355,8 +402,48 @@ const Matrix<double> & K80::getdPij_dt(double d) const
   return p_;
 }
 
+void K80::filldPij_dt(const Vdouble& times, VVVdouble& dpijt) const
+{
+  updatePendingMatrices_();
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-1.));
+  Vdouble vexp2 = VectorTools::exp(l * (-k_));
+  dpijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e2 = vexp2[k];
+    VVdouble& p = dpijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    p[0][0] = rate_ * r_/4. * (- e1 - 2. * k_ * e2); //A
+    p[0][1] = rate_ * r_/4. * (  e1);                   //C
+    p[0][2] = rate_ * r_/4. * (- e1 + 2. * k_ * e2); //G
+    p[0][3] = rate_ * r_/4. * (  e1);                   //T, U
+
+    //C
+    p[1][0] = rate_ * r_/4. * (  e1);                   //A
+    p[1][1] = rate_ * r_/4. * (- e1 - 2. * k_ * e2); //C
+    p[1][2] = rate_ * r_/4. * (  e1);                   //G
+    p[1][3] = rate_ * r_/4. * (- e1 + 2. * k_ * e2); //T, U
+
+    //G
+    p[2][0] = rate_ * r_/4. * (- e1 + 2. * k_ * e2); //A
+    p[2][1] = rate_ * r_/4. * (  e1);                   //C
+    p[2][2] = rate_ * r_/4. * (- e1 - 2. * k_ * e2); //G
+    p[2][3] = rate_ * r_/4. * (  e1);                   //T, U
+
+    //T, U
+    p[3][0] = rate_ * r_/4. * (  e1);                   //A
+    p[3][1] = rate_ * r_/4. * (- e1 + 2. * k_ * e2); //C
+    p[3][2] = rate_ * r_/4. * (  e1);                   //G
+    p[3][3] = rate_ * r_/4. * (- e1 - 2. * k_ * e2); //T, U
+  }
+}
+
 const Matrix<double> & K80::getd2Pij_dt2(double d) const
 {
+  updatePendingMatrices_();
   double k_2 = k_ * k_;
   double r_2 = rate_ * rate_ * r_ * r_;
   l_ = rate_ * r_ * d;
@@ -389,5 +476,46 @@ const Matrix<double> & K80::getd2Pij_dt2(double d) const
   return p_;
 }
 
+void K80::filld2Pij_dt2(const Vdouble& times, VVVdouble& d2pijt) const
+{
+  updatePendingMatrices_();
+  double k_2 = k_ * k_;
+  double r_2 = rate_ * rate_ * r_ * r_;
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-1.));
+  Vdouble vexp2 = VectorTools::exp(l * (-k_));
+  d2pijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e2 = vexp2[k];
+    VVdouble& p = d2pijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    p[0][0] = r_2/4. * (  e1 + 2. * k_2 * e2); //A
+    p[0][1] = r_2/4. * (- e1);                    //C
+    p[0][2] = r_2/4. * (  e1 - 2. * k_2 * e2); //G
+    p[0][3] = r_2/4. * (- e1);                    //T, U
+
+    //C
+    p[1][0] = r_2/4. * (- e1);                    //A
+    p[1][1] = r_2/4. * (  e1 + 2. * k_2 * e2); //C
+    p[1][2] = r_2/4. * (- e1);                    //G
+    p[1][3] = r_2/4. * (  e1 - 2. * k_2 * e2); //T, U
+
+    //G
+    p[2][0] = r_2/4. * (  e1 - 2. * k_2 * e2); //A
+    p[2][1] = r_2/4. * (- e1);                    //C
+    p[2][2] = r_2/4. * (  e1 + 2. * k_2 * e2); //G
+    p[2][3] = r_2/4. * (- e1);                    //T, U
+
+    //T, U
+    p[3][0] = r_2/4. * (- e1);                    //A
+    p[3][1] = r_2/4. * (  e1 - 2. * k_2 * e2); //C
+    p[3][2] = r_2/4. * (- e1);                    //G
+    p[3][3] = r_2/4. * (  e1 + 2. * k_2 * e2); //T, U
+  }
+}
+
 /******************************************************************************/
 
@@ -66,7 +66,7 @@ L95::L95(
   addParameter_(new Parameter("L95.kappa", kappa, new IntervalConstraint(0, 1000, false, false, NumConstants::MILLI()), true));
   addParameter_(new Parameter("L95.theta", theta, new IntervalConstraint(0, 1, false, false, NumConstants::MILLI()), true));
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -112,7 +112,7 @@ void L95::updateMatrices()
 void L95::setFreq(map<int, double>& freqs)
 {
   setParameterValue("theta",freqs[1]+freqs[2]);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -114,7 +114,7 @@ RN95::RN95(
   addParameter_(new Parameter("RN95.alphaP", alphaP, new IntervalConstraint(1, 1, false), true));
   addParameter_(new Parameter("RN95.sigmaP", sigmaP, new IntervalConstraint(1, 1, false), true));
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -254,6 +254,7 @@ void RN95::updateMatrices()
 /******************************************************************************/
 double RN95::Pij_t(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-c1_ * l_);
   exp3_ = exp(-c3_ * l_);
@@ -310,6 +311,7 @@ double RN95::Pij_t(size_t i, size_t j, double d) const
 /******************************************************************************/
 double RN95::dPij_dt(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = -c1_* rate_* r_* exp(-c1_ * l_);
   exp3_ = -c3_* rate_* r_* exp(-c3_ * l_);
@@ -366,6 +368,7 @@ double RN95::dPij_dt(size_t i, size_t j, double d) const
 /******************************************************************************/
 double RN95::d2Pij_dt2(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = c1_ * rate_ * r_ * c1_ * rate_ * r_ * exp(-c1_ * l_);
   exp3_ = c3_ * rate_ * r_ * c3_ * rate_ * r_ * exp(-c3_ * l_);
@@ -423,6 +426,7 @@ double RN95::d2Pij_dt2(size_t i, size_t j, double d) const
 
 const Matrix<double>& RN95::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-c1_ * l_);
   exp3_ = exp(-c3_ * l_);
@@ -456,6 +460,7 @@ const Matrix<double>& RN95::getPij_t(double d) const
 
 const Matrix<double>&  RN95::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = -c1_* rate_* r_* exp(-c1_ * l_);
   exp3_ = -c3_* rate_* r_* exp(-c3_ * l_);
@@ -488,6 +493,7 @@ const Matrix<double>&  RN95::getdPij_dt(double d) const
 
 const Matrix<double>&  RN95::getd2Pij_dt2(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = c1_ * rate_ * r_ * c1_ * rate_ * r_ * exp(-c1_ * l_);
   exp3_ = c3_ * rate_ * r_ * c3_ * rate_ * r_ * exp(-c3_ * l_);
@@ -524,7 +530,7 @@ void RN95::setFreq(map<int, double>& freqs)
   setParameterValue("thetaC", freqs[1] / (freqs[1] + freqs[3]));
   setParameterValue("thetaG", freqs[2] / (freqs[0] + freqs[2]));
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
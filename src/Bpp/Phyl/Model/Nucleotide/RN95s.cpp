@@ -85,7 +85,7 @@ RN95s::RN95s(const NucleicAlphabet* alphabet,
   addParameter_(new Parameter("RN95s.gamma", gamma_, new IntervalConstraint(0, 0.5, false, false), true));
   addParameter_(new Parameter("RN95s.alphaP", alphaP, new IntervalConstraint(1, 1, false), true));
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -210,6 +210,7 @@ void RN95s::updateMatrices()
 /******************************************************************************/
 double RN95s::Pij_t(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp3_ = exp(-c3_ * l_);
@@ -265,6 +266,7 @@ double RN95s::Pij_t(size_t i, size_t j, double d) const
 /******************************************************************************/
 double RN95s::dPij_dt(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = -1.* rate_* r_* exp(-1. * l_);
   exp3_ = -c3_* rate_* r_* exp(-c3_ * l_);
@@ -320,6 +322,7 @@ double RN95s::dPij_dt(size_t i, size_t j, double d) const
 /******************************************************************************/
 double RN95s::d2Pij_dt2(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = 1. * rate_ * r_ * 1.* rate_* r_* exp(-1. * l_);
   exp3_ = c3_ * rate_ * r_ * c3_ * rate_ * r_ * exp(-c3_ * l_);
@@ -376,6 +379,7 @@ double RN95s::d2Pij_dt2(size_t i, size_t j, double d) const
 
 const Matrix<double>& RN95s::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-1. * l_);
   exp3_ = exp(-c3_ * l_);
@@ -408,6 +412,7 @@ const Matrix<double>& RN95s::getPij_t(double d) const
 
 const Matrix<double>&  RN95s::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = -1.* rate_* r_* exp(-1. * l_);
   exp3_ = -c3_* rate_* r_* exp(-c3_ * l_);
@@ -439,6 +444,7 @@ const Matrix<double>&  RN95s::getdPij_dt(double d) const
 
 const Matrix<double>&  RN95s::getd2Pij_dt2(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = 1. * rate_ * r_ * 1.* rate_* r_* exp(-1. * l_);
   exp3_ = c3_ * rate_ * r_ * c3_ * rate_ * r_ * exp(-c3_ * l_);
@@ -472,7 +478,7 @@ void RN95s::setFreq(map<int, double>& freqs)
 {
   setParameterValue("thetaA", (freqs[0] + freqs[3]) / 2);
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -67,7 +67,7 @@ SSR::SSR(
   addParameter_(new Parameter("SSR.gamma", gamma, &Parameter::R_PLUS_STAR));
   addParameter_(new Parameter("SSR.delta", delta, &Parameter::R_PLUS_STAR));
   addParameter_(new Parameter("SSR.theta" , theta , &Parameter::PROP_CONSTRAINT_EX));
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -112,7 +112,7 @@ void SSR::setFreq(map<int, double>& freqs)
   piC_ = freqs[1];
   piG_ = freqs[2];
   setParameterValue("theta",piC_ + piG_);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
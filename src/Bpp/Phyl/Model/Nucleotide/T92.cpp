@@ -73,7 +73,7 @@ T92::T92(const NucleicAlphabet* alpha, double kappa, double theta) :
   addParameter_(new Parameter("T92.kappa", kappa, &Parameter::R_PLUS_STAR));
   addParameter_(new Parameter("T92.theta", theta, &FrequenciesSet::FREQUENCE_CONSTRAINT_SMALL));
   p_.resize(size_, size_);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -190,6 +190,7 @@ void T92::updateMatrices()
 
 double T92::Pij_t(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp2_ = exp(-k_ * l_);
@@ -244,6 +245,7 @@ double T92::Pij_t(size_t i, size_t j, double d) const
 
 double T92::dPij_dt(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp2_ = exp(-k_ * l_);
@@ -298,6 +300,7 @@ double T92::dPij_dt(size_t i, size_t j, double d) const
 
 double T92::d2Pij_dt2(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   double k2_ = k_ * k_;
   l_ = rate_ * r_ * d;
   double r2 = rate_ * rate_ * r_ * r_;
@@ -354,6 +357,7 @@ double T92::d2Pij_dt2(size_t i, size_t j, double d) const
 
 const Matrix<double>& T92::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp2_ = exp(-k_ * l_);
@@ -385,8 +389,51 @@ const Matrix<double>& T92::getPij_t(double d) const
   return p_;
 }
 
+/******************************************************************************/
+
+void T92::fillPij_t(const Vdouble& times, VVVdouble& pijt) const
+{
+  updatePendingMatrices_();
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-1.));
+  Vdouble vexp2 = VectorTools::exp(l * (-k_));
+  pijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e2 = vexp2[k];
+    VVdouble& p = pijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    // A
+    p[0][0] = piA_ * (1. + e1) + theta_ * e2; // A
+    p[0][1] = piC_ * (1. - e1);                  // C
+    p[0][2] = piG_ * (1. + e1) - theta_ * e2; // G
+    p[0][3] = piT_ * (1. - e1);                  // T, U
+
+    // C
+    p[1][0] = piA_ * (1. - e1);                         // A
+    p[1][1] = piC_ * (1. + e1) + (1. - theta_) * e2; // C
+    p[1][2] = piG_ * (1. - e1);                         // G
+    p[1][3] = piT_ * (1. + e1) - (1. - theta_) * e2; // T, U
+
+    // G
+    p[2][0] = piA_ * (1. + e1) - (1. - theta_) * e2; // A
+    p[2][1] = piC_ * (1. - e1);                         // C
+    p[2][2] = piG_ * (1. + e1) + (1. - theta_) * e2; // G
+    p[2][3] = piT_ * (1. - e1);                         // T, U
+
+    // T, U
+    p[3][0] = piA_ * (1. - e1);                  // A
+    p[3][1] = piC_ * (1. + e1) - theta_ * e2; // C
+    p[3][2] = piG_ * (1. - e1);                  // G
+    p[3][3] = piT_ * (1. + e1) + theta_ * e2; // T, U
+  }
+}
+
 const Matrix<double>& T92::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   l_ = rate_ * r_ * d;
   exp1_ = exp(-l_);
   exp2_ = exp(-k_ * l_);
@@ -418,8 +465,49 @@ const Matrix<double>& T92::getdPij_dt(double d) const
   return p_;
 }
 
+void T92::filldPij_dt(const Vdouble& times, VVVdouble& dpijt) const
+{
+  updatePendingMatrices_();
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-1.));
+  Vdouble vexp2 = VectorTools::exp(l * (-k_));
+  dpijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e2 = vexp2[k];
+    VVdouble& p = dpijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    // A
+    p[0][0] = rate_ * r_ * (piA_ * -e1 + theta_ * -k_ * e2); // A
+    p[0][1] = rate_ * r_ * (piC_ *   e1);                        // C
+    p[0][2] = rate_ * r_ * (piG_ * -e1 - theta_ * -k_ * e2); // G
+    p[0][3] = rate_ * r_ * (piT_ *   e1);                        // T, U
+
+    // C
+    p[1][0] = rate_ * r_ * (piA_ *   e1);                               // A
+    p[1][1] = rate_ * r_ * (piC_ * -e1 + (1. - theta_) * -k_ * e2); // C
+    p[1][2] = rate_ * r_ * (piG_ *   e1);                               // G
+    p[1][3] = rate_ * r_ * (piT_ * -e1 - (1. - theta_) * -k_ * e2); // T, U
+
+    // G
+    p[2][0] = rate_ * r_ * (piA_ * -e1 - (1. - theta_) * -k_ * e2); // A
+    p[2][1] = rate_ * r_ * (piC_ *   e1);                               // C
+    p[2][2] = rate_ * r_ * (piG_ * -e1 + (1. - theta_) * -k_ * e2); // G
+    p[2][3] = rate_ * r_ * (piT_ *   e1);                               // T, U
+
+    // T, U
+    p[3][0] = rate_ * r_ * (piA_ *   e1);                        // A
+    p[3][1] = rate_ * r_ * (piC_ * -e1 - theta_ * -k_ * e2); // C
+    p[3][2] = rate_ * r_ * (piG_ *   e1);                        // G
+    p[3][3] = rate_ * r_ * (piT_ * -e1 + theta_ * -k_ * e2); // T, U
+  }
+}
+
 const Matrix<double>& T92::getd2Pij_dt2(double d) const
 {
+  updatePendingMatrices_();
   double k2 = k_ * k_;
   l_ = rate_ * r_ * d;
   double r2 = rate_ * rate_ * r_ * r_;
@@ -453,13 +541,55 @@ const Matrix<double>& T92::getd2Pij_dt2(double d) const
   return p_;
 }
 
+void T92::filld2Pij_dt2(const Vdouble& times, VVVdouble& d2pijt) const
+{
+  updatePendingMatrices_();
+  double k2 = k_ * k_;
+  double r2 = rate_ * rate_ * r_ * r_;
+  Vdouble l = times * (rate_ * r_);
+  Vdouble vexp1 = VectorTools::exp(l * (-1.));
+  Vdouble vexp2 = VectorTools::exp(l * (-k_));
+  d2pijt.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    double e1 = vexp1[k];
+    double e2 = vexp2[k];
+    VVdouble& p = d2pijt[k];
+    VectorTools::resize2(p, 4, 4);
+
+    // A
+    p[0][0] = r2 * (piA_ *   e1 + theta_ * k2 * e2); // A
+    p[0][1] = r2 * (piC_ * -e1);                      // C
+    p[0][2] = r2 * (piG_ *   e1 - theta_ * k2 * e2); // G
+    p[0][3] = r2 * (piT_ * -e1);                      // T, U
+
+    // C
+    p[1][0] = r2 * (piA_ * -e1);                             // A
+    p[1][1] = r2 * (piC_ *   e1 + (1. - theta_) * k2 * e2); // C
+    p[1][2] = r2 * (piG_ * -e1);                             // G
+    p[1][3] = r2 * (piT_ *   e1 - (1. - theta_) * k2 * e2); // T, U
+
+    // G
+    p[2][0] = r2 * (piA_ *   e1 - (1. - theta_) * k2 * e2); // A
+    p[2][1] = r2 * (piC_ * -e1);                             // C
+    p[2][2] = r2 * (piG_ *   e1 + (1. - theta_) * k2 * e2); // G
+    p[2][3] = r2 * (piT_ * -e1);                             // T, U
+
+    // T, U
+    p[3][0] = r2 * (piA_ * -e1);                      // A
+    p[3][1] = r2 * (piC_ *   e1 - theta_ * k2 * e2); // C
+    p[3][2] = r2 * (piG_ * -e1);                      // G
+    p[3][3] = r2 * (piT_ *   e1 + theta_ * k2 * e2); // T, U
+  }
+}
+
 /******************************************************************************/
 
 void T92::setFreq(std::map<int, double>& freqs)
 {
   double f = (freqs[1] + freqs[2]) / (freqs[0] + freqs[1] + freqs[2] + freqs[3]);
   setParameterValue("theta", f);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
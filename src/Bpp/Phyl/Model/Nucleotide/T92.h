@@ -178,6 +178,10 @@ public:
   const Matrix<double>& getPij_t(double d) const;
   const Matrix<double>& getdPij_dt(double d) const;
   const Matrix<double>& getd2Pij_dt2(double d) const;
+  bool hasClosedFormPij_t() const { return true; }
+  void fillPij_t(const Vdouble& times, VVVdouble& pijt) const;
+  void filldPij_dt(const Vdouble& times, VVVdouble& dpijt) const;
+  void filld2Pij_dt2(const Vdouble& times, VVVdouble& d2pijt) const;
 
   std::string getName() const { return "T92"; }
 
@@ -410,7 +410,7 @@ YpR_Sym::YpR_Sym(const RNY* alph,
   addParameter_(new Parameter("YpR_Sym.rCaT", CaT, &Parameter::R_PLUS));
   addParameter_(new Parameter("YpR_Sym.rTaC", TaC, &Parameter::R_PLUS));
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 void YpR_Sym::updateMatrices()
@@ -457,7 +457,7 @@ YpR_Gen::YpR_Gen(const RNY* alph,
   addParameter_(new Parameter("YpR_Gen.rTaC", TaC, &Parameter::R_PLUS));
   addParameter_(new Parameter("YpR_Gen.rtAG", tAG, &Parameter::R_PLUS));
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 void YpR_Gen::updateMatrices()
@@ -477,7 +477,7 @@ void YpR_Gen::updateMatrices()
 YpR_Gen::YpR_Gen(const YpR_Gen& ypr) : AbstractParameterAliasable(ypr),
   YpR(ypr, "YpR_Gen.")
 {
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
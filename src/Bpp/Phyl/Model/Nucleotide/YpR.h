@@ -185,7 +185,7 @@ public:
   {
     AbstractSubstitutionModel::fireParameterChanged(parameters);
     pmodel_->matchParametersValues(parameters);
-    updateMatrices();
+    requestUpdateMatrices_();
   }
 };
 }
@@ -61,7 +61,7 @@ gBGC::gBGC(const NucleicAlphabet* alph, NucleotideSubstitutionModel* const pm, d
   addParameters_(model_->getParameters());
   addParameter_(new Parameter("gBGC.B", B_, new IntervalConstraint(-999, 10, true, true), true));
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 gBGC::gBGC(const gBGC& gbgc) :
@@ -86,7 +86,7 @@ void gBGC::fireParameterChanged(const ParameterList& parameters)
 {
   AbstractSubstitutionModel::fireParameterChanged(parameters);
   model_->matchParametersValues(parameters);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 void gBGC::updateMatrices()
@@ -80,7 +80,7 @@ Coala::Coala(
 
   // Setting the exchangeability matrix
   exchangeability_ = model.getExchangeabilityMatrix();
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -182,7 +182,7 @@ void Coala::setFreqFromData(const SequenceContainer& data, double pseudoCount)
   // Compute the COA from the observed frequencies, add the axis position parameters and update the Markov matrix
   ParameterList pList = computeCOA(data, param_);
   addParameters_(pList);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -58,7 +58,7 @@ DSO78::DSO78(const ProteicAlphabet* alpha) :
   #include "__DSO78ExchangeabilityCode"
   #include "__DSO78FrequenciesCode"
   freqSet_ = new FixedProteinFrequenciesSet(alpha, freq_);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 DSO78::DSO78(const ProteicAlphabet* alpha, ProteinFrequenciesSet* freqSet, bool initFreqs) :
@@ -72,7 +72,7 @@ DSO78::DSO78(const ProteicAlphabet* alpha, ProteinFrequenciesSet* freqSet, bool
   if (initFreqs) freqSet_->setFrequencies(freq_);
   else freq_ = freqSet_->getFrequencies();
   addParameters_(freqSet_->getParameters());
-  updateMatrices();  
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
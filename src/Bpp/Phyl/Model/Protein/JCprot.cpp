@@ -57,7 +57,7 @@ JCprot::JCprot(const ProteicAlphabet* alpha) :
   exp_(), p_(size_, size_), freqSet_(0)
 {
   freqSet_ = new FixedProteinFrequenciesSet(alpha, freq_);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 JCprot::JCprot(const ProteicAlphabet* alpha, ProteinFrequenciesSet* freqSet, bool initFreqs) :
@@ -69,7 +69,7 @@ JCprot::JCprot(const ProteicAlphabet* alpha, ProteinFrequenciesSet* freqSet, boo
   if (initFreqs) freqSet_->setFrequencies(freq_);
   else freq_ = freqSet_->getFrequencies();
   addParameters_(freqSet_->getParameters());
-  updateMatrices();  
+  requestUpdateMatrices_();
 }
 
 
@@ -114,6 +114,7 @@ void JCprot::updateMatrices()
 
 double JCprot::Pij_t(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   if(i == j) return 1./20. + 19./20. * exp(-  rate_ * 20./19. * d);
   else       return 1./20. -  1./20. * exp(-  rate_ * 20./19. * d);
 }
@@ -122,6 +123,7 @@ double JCprot::Pij_t(size_t i, size_t j, double d) const
 
 double JCprot::dPij_dt(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   if(i == j) return -  rate_ *        exp(-  rate_ * 20./19. * d);
   else       return  rate_ * 1./19. * exp(-  rate_ * 20./19. * d);
 }
@@ -130,6 +132,7 @@ double JCprot::dPij_dt(size_t i, size_t j, double d) const
 
 double JCprot::d2Pij_dt2(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   if(i == j) return    rate_ *  rate_ * 20./19.  * exp(-  rate_ * 20./19. * d);
   else       return -  rate_ *  rate_ * 20./361. * exp(-  rate_ * 20./19. * d);
 }
@@ -138,6 +141,7 @@ double JCprot::d2Pij_dt2(size_t i, size_t j, double d) const
 
 const Matrix<double>& JCprot::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   exp_ = exp(-  rate_ * 20./19. * d);
 	for(unsigned int i = 0; i < size_; i++)
   {
@@ -151,6 +155,7 @@ const Matrix<double>& JCprot::getPij_t(double d) const
 
 const Matrix<double>& JCprot::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   exp_ = exp(-  rate_ * 20./19. * d);
 	for(unsigned int i = 0; i < size_; i++)
   {
@@ -164,6 +169,7 @@ const Matrix<double>& JCprot::getdPij_dt(double d) const
 
 const Matrix<double>& JCprot::getd2Pij_dt2(double d) const
 {
+  updatePendingMatrices_();
   exp_ = exp( rate_ * - 20./19. * d);
 	for(unsigned int i = 0; i < size_; i++)
   {
@@ -58,7 +58,7 @@ JTT92::JTT92(const ProteicAlphabet* alpha) :
   #include "__JTT92ExchangeabilityCode"
   #include "__JTT92FrequenciesCode"
   freqSet_ = new FixedProteinFrequenciesSet(alpha, freq_);
-  updateMatrices();  
+  requestUpdateMatrices_();
 }
 
 JTT92::JTT92(const ProteicAlphabet* alpha, ProteinFrequenciesSet* freqSet, bool initFreqs) :
@@ -72,7 +72,7 @@ JTT92::JTT92(const ProteicAlphabet* alpha, ProteinFrequenciesSet* freqSet, bool
   if (initFreqs) freqSet_->setFrequencies(freq_);
   else freq_ = freqSet_->getFrequencies();
   addParameters_(freqSet_->getParameters());
-  updateMatrices();  
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
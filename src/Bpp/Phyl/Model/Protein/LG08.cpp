@@ -58,7 +58,7 @@ LG08::LG08(const ProteicAlphabet* alpha) :
   #include "__LG08ExchangeabilityCode"
   #include "__LG08FrequenciesCode"
   freqSet_ = new FixedProteinFrequenciesSet(alpha, freq_);
-  updateMatrices();  
+  requestUpdateMatrices_();
 }
 
 LG08::LG08(const ProteicAlphabet* alpha, ProteinFrequenciesSet* freqSet, bool initFreqs) :
@@ -76,7 +76,7 @@ LG08::LG08(const ProteicAlphabet* alpha, ProteinFrequenciesSet* freqSet, bool in
 
   addParameters_(freqSet_->getParameters());
   
-  updateMatrices();  
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
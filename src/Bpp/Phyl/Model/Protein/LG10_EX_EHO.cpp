@@ -84,7 +84,7 @@ LG10_EX_EHO::LG10_EX_EHO(const ProteicAlphabet* alpha) :
                             pmixmodel_->getParameter(st).hasConstraint()? pmixmodel_->getParameter(st).getConstraint()->clone():0,true));
   }
 	
-  updateMatrices();	
+  requestUpdateMatrices_();
 }
 
 /**************** sub model classes *///////////
@@ -98,6 +98,6 @@ LG10_EX_EHO::EmbeddedModel::EmbeddedModel(const ProteicAlphabet* alpha, string n
 #include "__LG10_EX_EHOExchangeabilityCode"
 #include "__LG10_EX_EHOFrequenciesCode"
 #include "__LG10_EX_EHORatesProps"
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
@@ -80,7 +80,7 @@ LGL08_CAT::LGL08_CAT(const ProteicAlphabet* alpha, unsigned int nbCat) :
                             pmixmodel_->getParameter(st).hasConstraint() ? pmixmodel_->getParameter(st).getConstraint()->clone() : 0, true));
   }
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /**************** sub model classes */ // ////////
@@ -137,7 +137,7 @@ LGL08_CAT::EmbeddedModel::EmbeddedModel(const ProteicAlphabet* alpha, string nam
   else
   throw Exception("LGL08_CAT.cpp: incorrect number of profiles. This number has to be 10, 20, 30, 40, 50 or 60.");
   
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 
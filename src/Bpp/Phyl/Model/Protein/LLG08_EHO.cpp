@@ -81,7 +81,7 @@ LLG08_EHO::LLG08_EHO(const ProteicAlphabet* alpha) :
                                 pmixmodel_->getParameter(st).hasConstraint() ? pmixmodel_->getParameter(st).getConstraint()->clone() : 0, true));
   }
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /**************** sub model classes */ // ////////
@@ -95,7 +95,7 @@ LLG08_EHO::EmbeddedModel::EmbeddedModel(const ProteicAlphabet* alpha, string nam
 #include "__LLG08_EHOExchangeabilityCode"
 #include "__LLG08_EHOFrequenciesCode"
 #include "__LLG08_EHORatesProps"
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 
@@ -80,7 +80,7 @@ LLG08_EX2::LLG08_EX2(const ProteicAlphabet* alpha) :
                                 pmixmodel_->getParameter(st).hasConstraint() ? pmixmodel_->getParameter(st).getConstraint()->clone() : 0, true));
   }
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /**************** sub model classes */ // ////////
@@ -94,7 +94,7 @@ LLG08_EX2::EmbeddedModel::EmbeddedModel(const ProteicAlphabet* alpha, string nam
 #include "__LLG08_EX2ExchangeabilityCode"
 #include "__LLG08_EX2FrequenciesCode"
 #include "__LLG08_EX2RatesProps"
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 
@@ -81,7 +81,7 @@ LLG08_EX3::LLG08_EX3(const ProteicAlphabet* alpha) :
                             pmixmodel_->getParameter(st).hasConstraint() ? pmixmodel_->getParameter(st).getConstraint()->clone() : 0, true));
   }
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /**************** sub model classes */ // ////////
@@ -95,7 +95,7 @@ LLG08_EX3::EmbeddedModel::EmbeddedModel(const ProteicAlphabet* alpha, string nam
 #include "__LLG08_EX3ExchangeabilityCode"
 #include "__LLG08_EX3FrequenciesCode"
 #include "__LLG08_EX3RatesProps"
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 
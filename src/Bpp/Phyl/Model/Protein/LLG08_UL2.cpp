@@ -80,7 +80,7 @@ LLG08_UL2::LLG08_UL2(const ProteicAlphabet* alpha) :
                             pmixmodel_->getParameter(st).hasConstraint() ? pmixmodel_->getParameter(st).getConstraint()->clone() : 0, true));
   }
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /**************** sub model classes */ // ////////
@@ -94,7 +94,7 @@ LLG08_UL2::EmbeddedModel::EmbeddedModel(const ProteicAlphabet* alpha, string nam
 #include "__LLG08_UL2ExchangeabilityCode"
 #include "__LLG08_UL2FrequenciesCode"
 #include "__LLG08_UL2RatesProps"
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 
@@ -81,7 +81,7 @@ LLG08_UL3::LLG08_UL3(const ProteicAlphabet* alpha) :
                             pmixmodel_->getParameter(st).hasConstraint() ? pmixmodel_->getParameter(st).getConstraint()->clone() : 0, true));
   }
 
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 
@@ -96,7 +96,7 @@ LLG08_UL3::EmbeddedModel::EmbeddedModel(const ProteicAlphabet* alpha, string nam
 #include "__LLG08_UL3ExchangeabilityCode"
 #include "__LLG08_UL3FrequenciesCode"
 #include "__LLG08_UL3RatesProps"
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 
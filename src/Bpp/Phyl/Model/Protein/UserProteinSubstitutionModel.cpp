@@ -69,7 +69,7 @@ UserProteinSubstitutionModel::UserProteinSubstitutionModel(
 {
   readFromFile();
   freqSet_ = new FixedProteinFrequenciesSet(alpha, freq_);
-  updateMatrices();  
+  requestUpdateMatrices_();
 }
 
 UserProteinSubstitutionModel::UserProteinSubstitutionModel(
@@ -86,7 +86,7 @@ UserProteinSubstitutionModel::UserProteinSubstitutionModel(
   if (initFreqs) freqSet->setFrequencies(freq_);
   else freq_ = freqSet_->getFrequencies();
   addParameters_(freqSet_->getParameters());
-  updateMatrices();  
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -55,7 +55,7 @@ WAG01::WAG01(const ProteicAlphabet* alpha) :
   #include "__WAG01ExchangeabilityCode"
   #include "__WAG01FrequenciesCode"
   freqSet_ = new FixedProteinFrequenciesSet(alpha, freq_);
-  updateMatrices();  
+  requestUpdateMatrices_();
 }
 
 WAG01::WAG01(const ProteicAlphabet* alpha, ProteinFrequenciesSet* freqSet, bool initFreqs) :
@@ -69,7 +69,7 @@ WAG01::WAG01(const ProteicAlphabet* alpha, ProteinFrequenciesSet* freqSet, bool
   if (initFreqs) freqSet_->setFrequencies(freq_);
   else freq_ = freqSet_->getFrequencies();
   addParameters_(freqSet_->getParameters());
-  updateMatrices();  
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -70,7 +70,7 @@ RE08::RE08(ReversibleSubstitutionModel* simpleModel, double lambda, double mu) :
   leftEigenVectors_.resize(size_, size_);
   rightEigenVectors_.resize(size_, size_);
   p_.resize(size_,size_);
-  updateMatrices();
+  requestUpdateMatrices_();
 }
 
 /******************************************************************************/
@@ -119,6 +119,7 @@ void RE08::updateMatrices()
 
 double RE08::Pij_t(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   double f = (lambda_ == 0 && mu_ == 0) ? 1. : lambda_ / (lambda_ + mu_);
   if(i < size_ - 1 && j < size_ - 1)
   {
@@ -149,6 +150,7 @@ double RE08::Pij_t(size_t i, size_t j, double d) const
 
 double RE08::dPij_dt(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   double f = (lambda_ == 0 && mu_ == 0) ? 1. : lambda_ / (lambda_ + mu_);
   if(i < size_ - 1 && j < size_ - 1)
   {
@@ -180,6 +182,7 @@ double RE08::dPij_dt(size_t i, size_t j, double d) const
 
 double RE08::d2Pij_dt2(size_t i, size_t j, double d) const
 {
+  updatePendingMatrices_();
   double f = (lambda_ == 0 && mu_ == 0) ? 1. : lambda_ / (lambda_ + mu_);
   if(i < size_ - 1 && j < size_ - 1)
   {
@@ -212,6 +215,7 @@ double RE08::d2Pij_dt2(size_t i, size_t j, double d) const
 
 const Matrix<double>& RE08::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   RowMatrix<double> simpleP = simpleModel_->getPij_t(d);
   double f = (lambda_ == 0 && mu_ == 0) ? 1. : lambda_ / (lambda_ + mu_);
   for (size_t i = 0; i < size_ - 1; i++)
@@ -238,6 +242,7 @@ const Matrix<double>& RE08::getPij_t(double d) const
 
 const Matrix<double>& RE08::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   RowMatrix<double> simpleP = simpleModel_->getPij_t(d);
   RowMatrix<double> simpleDP = simpleModel_->getdPij_dt(d);
   double f = (lambda_ == 0 && mu_ == 0) ? 1. : lambda_ / (lambda_ + mu_);
@@ -266,6 +271,7 @@ const Matrix<double>& RE08::getdPij_dt(double d) const
 
 const Matrix<double>& RE08::getd2Pij_dt2(double d) const
 {
+  updatePendingMatrices_();
   RowMatrix<double> simpleP = simpleModel_->getPij_t(d);
   RowMatrix<double> simpleDP = simpleModel_->getdPij_dt(d);
   RowMatrix<double> simpleD2P = simpleModel_->getd2Pij_dt2(d);
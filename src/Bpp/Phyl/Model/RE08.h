@@ -185,7 +185,7 @@ namespace bpp
       simpleModel_->matchParametersValues(parameters);
       lambda_ = getParameter_(0).getValue();
       mu_     = getParameter_(1).getValue();
-      updateMatrices();
+      requestUpdateMatrices_();
     }
 
     size_t getNumberOfStates() const { return size_; }
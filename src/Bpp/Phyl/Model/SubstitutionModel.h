@@ -228,6 +228,60 @@ namespace bpp
      */
     virtual const Matrix<double>& getd2Pij_dt2(double t) const = 0;
 
+    /**
+     * @return True if fillPij_t(), filldPij_dt() and filld2Pij_dt2() compute the transition
+     * probabilities and their derivatives from analytical formulas, without any eigen vectors product.
+     */
+    virtual bool hasClosedFormPij_t() const { return false; }
+
+    /**
+     * @brief Compute the transition probabilities for several times at once.
+     *
+     * This is typically used to get the matrices of all rate classes of a branch in one call.
+     * The default implementation calls getPij_t() for each time, models with closed formulas
+     * should compute them directly (see hasClosedFormPij_t()).
+     *
+     * @param times  The times to consider.
+     * @param pijt   [out] A vector with, for each time t, the matrix P_{i,j}(t).
+     * Resized if needed.
+     */
+    virtual void fillPij_t(const Vdouble& times, VVVdouble& pijt) const
+    {
+      pijt.resize(times.size());
+      for (size_t k = 0; k < times.size(); ++k)
+        copyMatrix_(getPij_t(times[k]), pijt[k]);
+    }
+
+    /**
+     * @brief Compute the first order derivatives of the transition probabilities for several times at once.
+     *
+     * @param times  The times to consider.
+     * @param dpijt  [out] A vector with, for each time t, the matrix dP_{i,j}(t)/dt.
+     * Resized if needed.
+     * @see fillPij_t()
+     */
+    virtual void filldPij_dt(const Vdouble& times, VVVdouble& dpijt) const
+    {
+      dpijt.resize(times.size());
+      for (size_t k = 0; k < times.size(); ++k)
+        copyMatrix_(getdPij_dt(times[k]), dpijt[k]);
+    }
+
+    /**
+     * @brief Compute the second order derivatives of the transition probabilities for several times at once.
+     *
+     * @param times  The times to consider.
+     * @param d2pijt [out] A vector with, for each time t, the matrix d2P_{i,j}(t)/dt2.
+     * Resized if needed.
+     * @see fillPij_t()
+     */
+    virtual void filld2Pij_dt2(const Vdouble& times, VVVdouble& d2pijt) const
+    {
+      d2pijt.resize(times.size());
+      for (size_t k = 0; k < times.size(); ++k)
+        copyMatrix_(getd2Pij_dt2(times[k]), d2pijt[k]);
+    }
+
     /**
      * @return Get the alphabet associated to this model.
      */
@@ -299,6 +353,20 @@ namespace bpp
      */
     
     virtual const FrequenciesSet* getFrequenciesSet() const {return NULL;}
+
+  protected:
+    static void copyMatrix_(const Matrix<double>& m, VVdouble& v)
+    {
+      size_t nr = m.getNumberOfRows();
+      size_t nc = m.getNumberOfColumns();
+      v.resize(nr);
+      for (size_t i = 0; i < nr; ++i)
+      {
+        v[i].resize(nc);
+        for (size_t j = 0; j < nc; ++j)
+          v[i][j] = m(i, j);
+      }
+    }
   };
 
   
@@ -142,6 +142,7 @@ void WordSubstitutionModel::completeMatrices()
 
 const RowMatrix<double>& WordSubstitutionModel::getPij_t(double d) const
 {
+  updatePendingMatrices_();
   vector<const Matrix<double>*> vM;
   size_t nbmod = VSubMod_.size();
   size_t i, j;
@@ -180,6 +181,7 @@ const RowMatrix<double>& WordSubstitutionModel::getPij_t(double d) const
 
 const RowMatrix<double>& WordSubstitutionModel::getdPij_dt(double d) const
 {
+  updatePendingMatrices_();
   vector<const Matrix<double>*> vM, vdM;
   size_t nbmod = VSubMod_.size();
   size_t i, j;
@@ -227,6 +229,7 @@ const RowMatrix<double>& WordSubstitutionModel::getdPij_dt(double d) const
 const RowMatrix<double>& WordSubstitutionModel::getd2Pij_dt2(double d) const
 
 {
+  updatePendingMatrices_();
   vector<const Matrix<double>*> vM, vdM, vd2M;
   size_t nbmod = VSubMod_.size();
   size_t i, j;
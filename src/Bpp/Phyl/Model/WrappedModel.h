@@ -95,6 +95,14 @@ namespace bpp
 
     const Matrix<double>& getd2Pij_dt2(double t) const { return getModel().getd2Pij_dt2(t); }
 
+    bool hasClosedFormPij_t() const { return getModel().hasClosedFormPij_t(); }
+
+    void fillPij_t(const Vdouble& times, VVVdouble& pijt) const { getModel().fillPij_t(times, pijt); }
+
+    void filldPij_dt(const Vdouble& times, VVVdouble& dpijt) const { getModel().filldPij_dt(times, dpijt); }
+
+    void filld2Pij_dt2(const Vdouble& times, VVVdouble& d2pijt) const { getModel().filld2Pij_dt2(times, d2pijt); }
+
     const Alphabet* getAlphabet() const { return getModel().getAlphabet(); }
 
     size_t getNumberOfStates() const { return getModel().getNumberOfStates(); }
@@ -94,7 +94,7 @@ namespace bpp
  * 
  */
 class NNISearchable:
-  public TopologyListener,
+  public virtual TopologyListener,
   public virtual Clonable
 {
 	public:
@@ -119,6 +119,26 @@ class NNISearchable:
 		 */
 		virtual double testNNI(int nodeId) const throw (NodeException) = 0;
 
+		/**
+		 * @brief Send the score variations of several NNI movements, without performing them.
+		 *
+		 * The default implementation calls testNNI() for each node in turn.
+		 * Implementations may test the movements concurrently,
+		 * the results must then not depend on the number of threads.
+		 *
+		 * @param nodeIds   The ids of the nodes defining the NNI movements.
+		 * @param nbThreads The number of threads to use (0 for all cores).
+		 * @return The score variation of each NNI.
+		 * @throw NodeException If a node does not define a valid NNI.
+		 */
+		virtual std::vector<double> testNNIs(const std::vector<int>& nodeIds, unsigned int nbThreads = 1) const throw (NodeException)
+		{
+			std::vector<double> diffs(nodeIds.size());
+			for (size_t i = 0; i < nodeIds.size(); i++)
+				diffs[i] = testNNI(nodeIds[i]);
+			return diffs;
+		}
+
 		/**
 		 * @brief Perform a NNI movement.
 		 *
@@ -82,6 +82,16 @@ void NNITopologySearch::notifyAllSuccessful(const TopologyChangeEvent& event)
   }
 }
 
+vector<double> NNITopologySearch::testAllNNIs_(const vector<Node*>& nodes) const throw (NodeException)
+{
+  vector<int> ids(nodes.size());
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    ids[i] = nodes[i]->getId();
+  }
+  return searchableTree_->testNNIs(ids, nbThreads_);
+}
+
 void NNITopologySearch::search() throw (Exception)
 {
   if (algorithm_ == FAST)
@@ -171,10 +181,11 @@ void NNITopologySearch::searchBetter() throw (Exception)
     vector<double> improvement;
     if (verbose_ >= 2 && ApplicationTools::message)
       ApplicationTools::message->endLine();
+    vector<double> diffs = testAllNNIs_(nodesSub);
     for (size_t i = 0; i < nodesSub.size(); i++)
     {
       Node* node = nodesSub[i];
-      double diff = searchableTree_->testNNI(node->getId());
+      double diff = diffs[i];
       if (verbose_ >= 3)
       {
         ApplicationTools::displayResult("   Testing node " + TextTools::toString(node->getId())
@@ -236,10 +247,11 @@ void NNITopologySearch::searchPhyML() throw (Exception)
     vector<double> improvement;
     if (verbose_ >= 2 && ApplicationTools::message)
       ApplicationTools::message->endLine();
+    vector<double> diffs = testAllNNIs_(nodesSub);
     for (size_t i = 0; i < nodesSub.size(); i++)
     {
       Node* node = nodesSub[i];
-      double diff = searchableTree_->testNNI(node->getId());
+      double diff = diffs[i];
       if (verbose_ >= 3)
       {
         ApplicationTools::displayResult("   Testing node " + TextTools::toString(node->getId())
@@ -57,6 +57,9 @@ namespace bpp
  *   Then re-loop over all nodes.
  * - PhyML algorithm (not fully tested, use with care): as the previous one, but perform all NNI improving the score at the same time.
  *   Leads to faster convergence.
+ *
+ * With the Better and PhyML algorithms, all NNIs of a round are tested at once (see NNISearchable::testNNIs),
+ * which may be done on several threads.
  */
 class NNITopologySearch :
   public virtual TopologySearch
@@ -70,20 +73,31 @@ class NNITopologySearch :
 		NNISearchable* searchableTree_;
     std::string algorithm_;
 		unsigned int verbose_;
+    unsigned int nbThreads_;
     std::vector<TopologyListener*> topoListeners_;
 		
 	public:
+    /**
+     * @brief Build a new NNITopologySearch object.
+     *
+     * @param tree      The object to optimize.
+     * @param algorithm The algorithm to use.
+     * @param verbose   The verbose level.
+     * @param nbThreads The number of threads used to test NNIs with the Better and PhyML algorithms (0 for all cores).
+     */
 		NNITopologySearch(
         NNISearchable& tree,
         const std::string& algorithm = FAST,
-        unsigned int verbose = 2) :
-      searchableTree_(&tree), algorithm_(algorithm), verbose_(verbose), topoListeners_()
+        unsigned int verbose = 2,
+        unsigned int nbThreads = 1) :
+      searchableTree_(&tree), algorithm_(algorithm), verbose_(verbose), nbThreads_(nbThreads), topoListeners_()
     {}
 
     NNITopologySearch(const NNITopologySearch& ts) :
       searchableTree_(ts.searchableTree_),
       algorithm_(ts.algorithm_),
       verbose_(ts.verbose_),
+      nbThreads_(ts.nbThreads_),
       topoListeners_(ts.topoListeners_)
     {
       //Hard-copy all listeners:
@@ -96,6 +110,7 @@ class NNITopologySearch :
       searchableTree_ = ts.searchableTree_;
       algorithm_      = ts.algorithm_;
       verbose_        = ts.verbose_;
+      nbThreads_      = ts.nbThreads_;
       topoListeners_  = ts.topoListeners_;
       //Hard-copy all listeners:
       for (unsigned int i = 0; i < topoListeners_.size(); i++)
@@ -137,6 +152,11 @@ class NNITopologySearch :
 		 */
 		const Tree& getTopology() const { return searchableTree_->getTopology(); }
 		
+    /**
+     * @brief Set the number of threads used to test NNIs (0 for all cores).
+     */
+    void setNumberOfThreads(unsigned int nbThreads) { nbThreads_ = nbThreads; }
+
     /**
      * @return The NNISearchable object associated to this instance.
      */
@@ -151,6 +171,14 @@ class NNITopologySearch :
 		void searchBetter() throw (Exception);
 		void searchPhyML()  throw (Exception);
 
+    /**
+     * @brief Test the NNIs defined by a set of nodes, with the number of threads of this instance.
+     *
+     * @param nodes The nodes defining the NNIs, in a copy of the tree.
+     * @return The score variation of each NNI.
+     */
+    std::vector<double> testAllNNIs_(const std::vector<Node*>& nodes) const throw (NodeException);
+
     /**
      * @brief Process a TopologyChangeEvent to all listeners.
      */
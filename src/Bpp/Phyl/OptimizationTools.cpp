@@ -575,7 +575,8 @@ NNIHomogeneousTreeLikelihood* OptimizationTools::optimizeTreeNNI(
   unsigned int verbose,
   const std::string& optMethodDeriv,
   unsigned int nStep,
-  const std::string& nniMethod)
+  const std::string& nniMethod,
+  unsigned int nbThreads)
 throw (Exception)
 {
   // Roughly optimize parameter
@@ -584,7 +585,7 @@ throw (Exception)
     OptimizationTools::optimizeNumericalParameters(tl, parameters, NULL, nStep, tolBefore, 1000000, messageHandler, profiler, reparametrization, verbose, optMethodDeriv);
   }
   // Begin topo search:
-  NNITopologySearch topoSearch(*tl, nniMethod, verbose > 2 ? verbose - 2 : 0);
+  NNITopologySearch topoSearch(*tl, nniMethod, verbose > 2 ? verbose - 2 : 0, nbThreads);
   NNITopologyListener* topoListener = new NNITopologyListener(&topoSearch, parameters, tolDuring, messageHandler, profiler, verbose, optMethodDeriv, nStep, reparametrization);
   topoListener->setNumericalOptimizationCounter(numStep);
   topoSearch.addTopologyListener(topoListener);
@@ -607,7 +608,8 @@ NNIHomogeneousTreeLikelihood* OptimizationTools::optimizeTreeNNI2(
   bool reparametrization,
   unsigned int verbose,
   const std::string& optMethodDeriv,
-  const std::string& nniMethod)
+  const std::string& nniMethod,
+  unsigned int nbThreads)
 throw (Exception)
 {
   // Roughly optimize parameter
@@ -616,7 +618,7 @@ throw (Exception)
     OptimizationTools::optimizeNumericalParameters2(tl, parameters, NULL, tolBefore, 1000000, messageHandler, profiler, reparametrization, false, verbose, optMethodDeriv);
   }
   // Begin topo search:
-  NNITopologySearch topoSearch(*tl, nniMethod, verbose > 2 ? verbose - 2 : 0);
+  NNITopologySearch topoSearch(*tl, nniMethod, verbose > 2 ? verbose - 2 : 0, nbThreads);
   NNITopologyListener2* topoListener = new NNITopologyListener2(&topoSearch, parameters, tolDuring, messageHandler, profiler, verbose, optMethodDeriv, reparametrization);
   topoListener->setNumericalOptimizationCounter(numStep);
   topoSearch.addTopologyListener(topoListener);
@@ -638,6 +640,41 @@ DRTreeParsimonyScore* OptimizationTools::optimizeTreeNNI(
 
 /******************************************************************************/
 
+unsigned int OptimizationTools::optimizeTreeSPR(
+  DRTreeParsimonyScore* tp,
+  unsigned int radius,
+  bool tbr,
+  unsigned int verbose)
+{
+  unsigned int nbMoves = 0;
+  bool improved = true;
+  while (improved)
+  {
+    improved = false;
+    // Node ids do not change with rearrangements, only the root node does:
+    vector<int> ids = tp->getTree().getNodesId();
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+      if (ids[i] == tp->getTree().getRootId())
+        continue;
+      DRTreeParsimonyScore::Rearrangement move = tp->testRearrangements(ids[i], radius, tbr);
+      if (move.isValid() && move.scoreDifference < 0)
+      {
+        tp->doRearrangement(move);
+        nbMoves++;
+        improved = true;
+        if (verbose > 1)
+          ApplicationTools::displayResult("Rearrangement on node " + TextTools::toString(ids[i]), TextTools::toString(tp->getScore()));
+      }
+    }
+    if (verbose > 0)
+      ApplicationTools::displayResult((tbr ? "TBR" : "SPR") + string(" round, parsimony score"), TextTools::toString(tp->getScore()));
+  }
+  return nbMoves;
+}
+
+/******************************************************************************/
+
 std::string OptimizationTools::DISTANCEMETHOD_INIT       = "init";
 std::string OptimizationTools::DISTANCEMETHOD_PAIRWISE   = "pairwise";
 std::string OptimizationTools::DISTANCEMETHOD_ITERATIONS = "iterations";
@@ -598,6 +598,7 @@ public:
    * @param optMethod         Option passed to optimizeNumericalParameters.
    * @param nStep             Option passed to optimizeNumericalParameters.
    * @param nniMethod         NNI algorithm to use.
+   * @param nbThreads         Number of threads used to test NNIs (see NNITopologySearch).
    * @return A pointer toward the final likelihood object.
    * This pointer may be the same as passed in argument (tl), but in some cases the algorithm
    * clone this object. We may change this bahavior in the future...
@@ -621,7 +622,8 @@ public:
     unsigned int verbose         = 1,
     const std::string& optMethod = OptimizationTools::OPTIMIZATION_NEWTON,
     unsigned int nStep           = 1,
-    const std::string& nniMethod = NNITopologySearch::PHYML)
+    const std::string& nniMethod = NNITopologySearch::PHYML,
+    unsigned int nbThreads       = 1)
   throw (Exception);
 
   /**
@@ -653,6 +655,7 @@ public:
    * @param verbose           The verbose level.
    * @param optMethod         Option passed to optimizeNumericalParameters2.
    * @param nniMethod         NNI algorithm to use.
+   * @param nbThreads         Number of threads used to test NNIs (see NNITopologySearch).
    * @return A pointer toward the final likelihood object.
    * This pointer may be the same as passed in argument (tl), but in some cases the algorithm
    * clone this object. We may change this bahavior in the future...
@@ -675,7 +678,8 @@ public:
     bool reparametrization       = false,
     unsigned int verbose         = 1,
     const std::string& optMethod = OptimizationTools::OPTIMIZATION_NEWTON,
-    const std::string& nniMethod = NNITopologySearch::PHYML)
+    const std::string& nniMethod = NNITopologySearch::PHYML,
+    unsigned int nbThreads       = 1)
   throw (Exception);
 
   /**
@@ -696,6 +700,26 @@ public:
     DRTreeParsimonyScore* tp,
     unsigned int verbose = 1);
 
+  /**
+   * @brief Optimize tree topology from a DRTreeParsimonyScore using Subtree Pruning and Regrafting,
+   * or Tree Bisection and Reconnection.
+   *
+   * Each subtree is pruned in turn, and the best rearrangement within the given radius is
+   * performed if it improves the score (see DRTreeParsimonyScore::testRearrangements).
+   * Rounds are repeated until no improving rearrangement is found.
+   *
+   * @param tp      A pointer toward the DRTreeParsimonyScore object to optimize.
+   * @param radius  The maximum number of branches between the pruning and regrafting points.
+   * @param tbr     Tell if pruned subtrees can also be rerooted (TBR).
+   * @param verbose The verbose level.
+   * @return The number of rearrangements performed.
+   */
+  static unsigned int optimizeTreeSPR(
+    DRTreeParsimonyScore* tp,
+    unsigned int radius = 5,
+    bool tbr = false,
+    unsigned int verbose = 1);
+
   /**
    * @brief Estimate a distance matrix using maximum likelihood.
    *
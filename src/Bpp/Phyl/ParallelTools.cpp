@@ -0,0 +1,110 @@
+//
+// File: ParallelTools.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "ParallelTools.h"
+
+// From the STL:
+#include <exception>
+#include <thread>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+unsigned int ParallelTools::getNumberOfCores()
+{
+  unsigned int n = thread::hardware_concurrency();
+  return n == 0 ? 1 : n;
+}
+
+/******************************************************************************/
+
+unsigned int ParallelTools::getNumberOfBlocks(size_t n, unsigned int nbThreads)
+{
+  if (nbThreads == 0)
+    nbThreads = getNumberOfCores();
+  if (n < nbThreads)
+    nbThreads = static_cast<unsigned int>(n);
+  return nbThreads == 0 ? 1 : nbThreads;
+}
+
+/******************************************************************************/
+
+void ParallelTools::forEachBlock(
+  size_t n,
+  unsigned int nbThreads,
+  const std::function<void (size_t, size_t, unsigned int)>& f)
+{
+  unsigned int nbBlocks = getNumberOfBlocks(n, nbThreads);
+  if (nbBlocks == 1)
+  {
+    f(0, n, 0);
+    return;
+  }
+
+  vector<exception_ptr> errors(nbBlocks);
+  vector<thread> threads;
+  for (unsigned int t = 0; t < nbBlocks; t++)
+  {
+    size_t begin = n * t / nbBlocks;
+    size_t end = n * (t + 1) / nbBlocks;
+    threads.push_back(thread([&f, &errors, begin, end, t]() {
+        try
+        {
+          f(begin, end, t);
+        }
+        catch (...)
+        {
+          errors[t] = current_exception();
+        }
+      }));
+  }
+  for (size_t t = 0; t < threads.size(); t++)
+  {
+    threads[t].join();
+  }
+  for (size_t t = 0; t < errors.size(); t++)
+  {
+    if (errors[t])
+      rethrow_exception(errors[t]);
+  }
+}
+
@@ -0,0 +1,95 @@
+//
+// File: ParallelTools.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef _PARALLELTOOLS_H_
+#define _PARALLELTOOLS_H_
+
+// From the STL:
+#include <cstddef>
+#include <functional>
+
+namespace bpp
+{
+/**
+ * @brief Tools for running independent computations on several
+ * threads.
+ *
+ * Work is split into contiguous blocks, one per thread, so that
+ * results written at fixed positions do not depend on the number
+ * of threads.
+ */
+class ParallelTools
+{
+public:
+  /**
+   * @return The number of threads supported by the hardware (at
+   * least 1).
+   */
+  static unsigned int getNumberOfCores();
+
+  /**
+   * @brief Call f(begin, end, thread) on contiguous blocks covering
+   * [0, n), each block on its own thread.
+   *
+   * With nbThreads <= 1 (or n <= 1), f(0, n, 0) is called in the
+   * current thread. The first exception thrown by a block is
+   * rethrown once all threads have finished.
+   *
+   * @param n Number of items.
+   * @param nbThreads Maximum number of threads to use (0 means
+   * getNumberOfCores()).
+   * @param f The function to call on each block. The thread argument
+   * is the block index, in [0, nbThreads), to be used to access
+   * per-thread workspaces.
+   */
+  static void forEachBlock(
+    size_t n,
+    unsigned int nbThreads,
+    const std::function<void (size_t, size_t, unsigned int)>& f);
+
+  /**
+   * @return The actual number of blocks used by forEachBlock for n
+   * items and nbThreads threads.
+   */
+  static unsigned int getNumberOfBlocks(size_t n, unsigned int nbThreads);
+};
+} // end of namespace bpp.
+
+#endif // _PARALLELTOOLS_H_
+
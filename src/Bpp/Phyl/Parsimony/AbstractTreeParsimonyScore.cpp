@@ -42,6 +42,7 @@
 #include "../TreeTemplateTools.h"
 
 #include <Bpp/App/ApplicationTools.h>
+#include <Bpp/Seq/Alphabet/AlphabetExceptions.h>
 
 using namespace bpp;
 using namespace std;
@@ -93,7 +94,9 @@ void AbstractTreeParsimonyScore::init_(const SiteContainer& data, bool verbose)
   data_ = PatternTools::getSequenceSubset(data, *tree_->getRootNode());
   if (data_->getNumberOfSequences() == 1) throw Exception("Error, only 1 sequence!");
   if (data_->getNumberOfSequences() == 0) throw Exception("Error, no sequence!");
-  if (data_->getAlphabet()->getSize() > 20) throw Exception("Error, only alphabet with size <= 20 are supported. See the source file of AbstractTreeParsimonyScore.");
+  if (statesMap_->getAlphabet()->getAlphabetType() != data_->getAlphabet()->getAlphabetType())
+    throw AlphabetMismatchException("AbstractTreeParsimonyScore::init_. Data and states map must have the same alphabet type.", data_->getAlphabet(), statesMap_->getAlphabet());
+  if (nbStates_ == 0) throw Exception("AbstractTreeParsimonyScore::init_. The states map is empty.");
 }
 
 std::vector<unsigned int> AbstractTreeParsimonyScore::getScoreForEachSite() const
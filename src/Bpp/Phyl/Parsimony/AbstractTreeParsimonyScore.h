@@ -56,7 +56,7 @@ class AbstractTreeParsimonyScore :
 {
 private:
   TreeTemplate<Node>* tree_;
-  const SiteContainer* data_;
+  SiteContainer* data_;
   const Alphabet* alphabet_;
   const StateMap* statesMap_;
   size_t nbStates_;
@@ -115,6 +115,13 @@ public:
 protected:
   const TreeTemplate<Node>* getTreeP_() const { return tree_; }
   TreeTemplate<Node>* getTreeP_() { return tree_; }
+
+  /**
+   * @brief Add the sequence of a new leaf to the data set.
+   *
+   * To be called by derived classes adding leaves to the tree.
+   */
+  void addSequence_(const Sequence& sequence) throw (Exception) { data_->addSequence(sequence, false); }
 };
 } // end of namespace bpp.
 
@@ -49,16 +49,25 @@ using namespace std;
 
 /******************************************************************************/
 
+const size_t DRTreeParsimonyData::WORDS_PER_BLOCK = 4;
+const size_t DRTreeParsimonyData::SITES_PER_BLOCK = 64 * DRTreeParsimonyData::WORDS_PER_BLOCK;
+
+/******************************************************************************/
+
 DRTreeParsimonyData::DRTreeParsimonyData(const DRTreeParsimonyData& data) :
   AbstractTreeParsimonyData(data),
   nodeData_(data.nodeData_),
   leafData_(data.leafData_),
   rootBitsets_(data.rootBitsets_),
   rootScores_(data.rootScores_),
+  rootWeightedScore_(data.rootWeightedScore_),
+  weightBitsets_(data.weightBitsets_),
+  nbWeightBits_(data.nbWeightBits_),
   shrunkData_(0),
   nbSites_(data.nbSites_),
   nbStates_(data.nbStates_),
-  nbDistinctSites_(data.nbDistinctSites_)
+  nbDistinctSites_(data.nbDistinctSites_),
+  nbBlocks_(data.nbBlocks_)
 {
   if (data.shrunkData_)
     shrunkData_ = dynamic_cast<SiteContainer*>(data.shrunkData_->clone());
@@ -71,10 +80,13 @@ DRTreeParsimonyData::DRTreeParsimonyData(const DRTreeParsimonyData& data) :
 DRTreeParsimonyData& DRTreeParsimonyData::operator=(const DRTreeParsimonyData& data)
 {
   AbstractTreeParsimonyData::operator=(data);
-  nodeData_        = data.nodeData_;
-  leafData_        = data.leafData_;
-  rootBitsets_     = data.rootBitsets_;
-  rootScores_      = data.rootScores_;
+  nodeData_          = data.nodeData_;
+  leafData_          = data.leafData_;
+  rootBitsets_       = data.rootBitsets_;
+  rootScores_        = data.rootScores_;
+  rootWeightedScore_ = data.rootWeightedScore_;
+  weightBitsets_     = data.weightBitsets_;
+  nbWeightBits_      = data.nbWeightBits_;
   if (shrunkData_) delete shrunkData_;
   if (data.shrunkData_)
     shrunkData_ = dynamic_cast<SiteContainer*>(data.shrunkData_->clone());
@@ -83,6 +95,7 @@ DRTreeParsimonyData& DRTreeParsimonyData::operator=(const DRTreeParsimonyData& d
   nbSites_         = data.nbSites_;
   nbStates_        = data.nbStates_;
   nbDistinctSites_ = data.nbDistinctSites_;
+  nbBlocks_        = data.nbBlocks_;
   return *this;
 }
 
@@ -92,10 +105,32 @@ void DRTreeParsimonyData::init(const SiteContainer& sites, const StateMap& state
   nbStates_         = stateMap.getNumberOfModelStates();
   nbSites_          = sites.getNumberOfSites();
   SitePatterns pattern(&sites);
+  if (shrunkData_) delete shrunkData_;
   shrunkData_       = pattern.getSites();
   rootWeights_      = pattern.getWeights();
   rootPatternLinks_ = pattern.getIndices();
   nbDistinctSites_  = shrunkData_->getNumberOfSites();
+  nbBlocks_         = (nbDistinctSites_ + SITES_PER_BLOCK - 1) / SITES_PER_BLOCK;
+
+  // Transpose weights. Padding sites have a null weight:
+  unsigned int maxWeight = 0;
+  for (size_t i = 0; i < nbDistinctSites_; i++)
+  {
+    if (rootWeights_[i] > maxWeight) maxWeight = rootWeights_[i];
+  }
+  for (nbWeightBits_ = 0; (maxWeight >> nbWeightBits_) > 0; nbWeightBits_++) {}
+  weightBitsets_.assign(nbBlocks_ * nbWeightBits_ * WORDS_PER_BLOCK, 0);
+  for (size_t i = 0; i < nbDistinctSites_; i++)
+  {
+    size_t block = i / SITES_PER_BLOCK;
+    size_t word  = (i % SITES_PER_BLOCK) / 64;
+    ParsimonyWord bit = static_cast<ParsimonyWord>(1) << (i % 64);
+    for (size_t b = 0; b < nbWeightBits_; b++)
+    {
+      if ((rootWeights_[i] >> b) & 1)
+        weightBitsets_[(block * nbWeightBits_ + b) * WORDS_PER_BLOCK + word] |= bit;
+    }
+  }
 
   // Init data:
   // Clone data for more efficiency on sequences access:
@@ -104,14 +139,14 @@ void DRTreeParsimonyData::init(const SiteContainer& sites, const StateMap& state
   delete sequences;
 
   // Now initialize root arrays:
-  rootBitsets_.resize(nbDistinctSites_);
+  rootBitsets_.resize(getBitsetsArraySize());
   rootScores_.resize(nbDistinctSites_);
+  rootWeightedScore_ = 0;
 }
 
 /******************************************************************************/
 void DRTreeParsimonyData::init(const Node* node, const SiteContainer& sites, const StateMap& stateMap) throw (Exception)
 {
-  const Alphabet* alphabet = sites.getAlphabet();
   if (node->isLeaf())
   {
     const Sequence* seq;
@@ -123,28 +158,9 @@ void DRTreeParsimonyData::init(const Node* node, const SiteContainer& sites, con
     {
       throw SequenceNotFoundException("DRTreeParsimonyData:init(node, sites). Leaf name in tree not found in site container: ", (node->getName()));
     }
-    DRTreeParsimonyLeafData* leafData    = &leafData_[node->getId()];
-    vector<Bitset>* leafData_bitsets     = &leafData->getBitsetsArray();
+    DRTreeParsimonyLeafData* leafData = &leafData_[node->getId()];
     leafData->setNode(node);
-
-    leafData_bitsets->resize(nbDistinctSites_);
-
-    for (unsigned int i = 0; i < nbDistinctSites_; i++)
-    {
-      Bitset* leafData_bitsets_i = &(*leafData_bitsets)[i];
-      for (unsigned int s = 0; s < nbStates_; s++)
-      {
-        // Leaves bitset are set to 1 if the char correspond to the site in the sequence,
-        // otherwise value set to 0:
-        int state = seq->getValue(i);
-        vector<int> states = alphabet->getAlias(state);
-        for (size_t j = 0; j < states.size(); j++)
-        {
-          if (stateMap.getAlphabetStateAsInt(s) == states[j])
-            (*leafData_bitsets_i)[s].flip();
-        }
-      }
-    }
+    initLeafBitsets_(*seq, stateMap, leafData->getBitsetsArray());
   }
   else
   {
@@ -157,11 +173,8 @@ void DRTreeParsimonyData::init(const Node* node, const SiteContainer& sites, con
     for (int n = (node->hasFather() ? -1 : 0); n < nbSons; n++)
     {
       const Node* neighbor = (*node)[n];
-      vector<Bitset>* neighborData_bitsets       = &nodeData->getBitsetsArrayForNeighbor(neighbor->getId());
-      vector<unsigned int>* neighborData_scores  = &nodeData->getScoresArrayForNeighbor(neighbor->getId());
-
-      neighborData_bitsets->resize(nbDistinctSites_);
-      neighborData_scores->resize(nbDistinctSites_);
+      nodeData->getBitsetsArrayForNeighbor(neighbor->getId()).resize(getBitsetsArraySize());
+      nodeData->getScoreForNeighbor(neighbor->getId()) = 0;
     }
   }
 
@@ -174,6 +187,89 @@ void DRTreeParsimonyData::init(const Node* node, const SiteContainer& sites, con
   }
 }
 
+/******************************************************************************/
+void DRTreeParsimonyData::initLeafBitsets_(const Sequence& seq, const StateMap& stateMap, vector<ParsimonyWord>& bitsets) const
+{
+  const Alphabet* alphabet = seq.getAlphabet();
+
+  // Model states corresponding to each alphabet state, as large alphabets have many of them:
+  map<int, vector<size_t> > modelStates;
+  for (size_t s = 0; s < nbStates_; s++)
+  {
+    modelStates[stateMap.getAlphabetStateAsInt(s)].push_back(s);
+  }
+
+  // Padding sites are compatible with all states:
+  bitsets.assign(getBitsetsArraySize(), 0);
+  for (size_t i = 0; i < nbBlocks_ * SITES_PER_BLOCK; i++)
+  {
+    size_t block = i / SITES_PER_BLOCK;
+    size_t word  = (i % SITES_PER_BLOCK) / 64;
+    ParsimonyWord bit = static_cast<ParsimonyWord>(1) << (i % 64);
+    ParsimonyWord* bitsets_i = &bitsets[block * nbStates_ * WORDS_PER_BLOCK + word];
+    if (i >= nbDistinctSites_)
+    {
+      for (size_t s = 0; s < nbStates_; s++)
+      {
+        bitsets_i[s * WORDS_PER_BLOCK] |= bit;
+      }
+      continue;
+    }
+    // Leaves bitset are set to 1 if the char correspond to the site in the sequence,
+    // otherwise value set to 0:
+    int state = seq.getValue(i);
+    vector<int> states = alphabet->getAlias(state);
+    for (size_t j = 0; j < states.size(); j++)
+    {
+      map<int, vector<size_t> >::const_iterator it = modelStates.find(states[j]);
+      if (it == modelStates.end()) continue;
+      for (size_t s = 0; s < it->second.size(); s++)
+      {
+        bitsets_i[it->second[s] * WORDS_PER_BLOCK] |= bit;
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+void DRTreeParsimonyData::computeLeafBitsets(const string& name, const StateMap& stateMap, vector<ParsimonyWord>& bitsets) const throw (Exception)
+{
+  if (!shrunkData_)
+    throw Exception("DRTreeParsimonyData::computeLeafBitsets. Data are not initialized.");
+  const Sequence* seq;
+  try
+  {
+    seq = &shrunkData_->getSequence(name);
+  }
+  catch (SequenceNotFoundException& snfe)
+  {
+    throw SequenceNotFoundException("DRTreeParsimonyData::computeLeafBitsets. Sequence not found in site container: ", name);
+  }
+  initLeafBitsets_(*seq, stateMap, bitsets);
+}
+
+/******************************************************************************/
+Sequence* DRTreeParsimonyData::getSequence(const string& name) const throw (Exception)
+{
+  if (!shrunkData_)
+    throw Exception("DRTreeParsimonyData::getSequence. Data are not initialized.");
+  const Sequence* seq;
+  try
+  {
+    seq = &shrunkData_->getSequence(name);
+  }
+  catch (SequenceNotFoundException& snfe)
+  {
+    throw SequenceNotFoundException("DRTreeParsimonyData::getSequence. Sequence not found in site container: ", name);
+  }
+  vector<int> content(nbSites_);
+  for (size_t i = 0; i < nbSites_; i++)
+  {
+    content[i] = (*seq)[rootPatternLinks_[i]];
+  }
+  return new BasicSequence(name, content, shrunkData_->getAlphabet());
+}
+
 /******************************************************************************/
 void DRTreeParsimonyData::reInit() throw (Exception)
 {
@@ -198,11 +294,8 @@ void DRTreeParsimonyData::reInit(const Node* node) throw (Exception)
     for (int n = (node->hasFather() ? -1 : 0); n < nbSons; n++)
     {
       const Node* neighbor = (*node)[n];
-      vector<Bitset>* neighborData_bitsets       = &nodeData->getBitsetsArrayForNeighbor(neighbor->getId());
-      vector<unsigned int>* neighborData_scores  = &nodeData->getScoresArrayForNeighbor(neighbor->getId());
-
-      neighborData_bitsets->resize(nbDistinctSites_);
-      neighborData_scores->resize(nbDistinctSites_);
+      nodeData->getBitsetsArrayForNeighbor(neighbor->getId()).resize(getBitsetsArraySize());
+      nodeData->getScoreForNeighbor(neighbor->getId()) = 0;
     }
   }
 
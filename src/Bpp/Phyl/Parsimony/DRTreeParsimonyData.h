@@ -48,11 +48,20 @@
 #include <Bpp/Seq/Container/SiteContainer.h>
 
 // From the STL:
-#include <bitset>
+#include <cstdint>
 
 namespace bpp
 {
-typedef std::bitset<21> Bitset; // 20AA + gaps, codon not lalowed so far :s
+/**
+ * @brief Word of the transposed (bit-parallel) parsimony layout.
+ *
+ * Sites are packed by blocks of DRTreeParsimonyData::SITES_PER_BLOCK.
+ * Within a block, each state is coded by DRTreeParsimonyData::WORDS_PER_BLOCK
+ * consecutive words, bit j of word l being set if the state is possible
+ * at site 64 * l + j of the block. An array of words for n states
+ * is hence stored as [block][state][word].
+ */
+typedef std::uint64_t ParsimonyWord;
 
 /**
  * @brief Parsimony data structure for a node.
@@ -60,8 +69,8 @@ typedef std::bitset<21> Bitset; // 20AA + gaps, codon not lalowed so far :s
  * This class is for use with the DRTreeParsimonyData class.
  *
  * Store for each neighbor node
- * - a vector of bitsets,
- * - a vector of score for the corresponding subtree.
+ * - a vector of packed bitsets (see ParsimonyWord),
+ * - the weighted score of the corresponding subtree.
  *
  * @see DRTreeParsimonyData
  */
@@ -69,8 +78,8 @@ class DRTreeParsimonyNodeData :
   public TreeParsimonyNodeData
 {
 private:
-  mutable std::map<int, std::vector<Bitset> > nodeBitsets_;
-  mutable std::map<int, std::vector<unsigned int> > nodeScores_;
+  mutable std::map<int, std::vector<ParsimonyWord> > nodeBitsets_;
+  mutable std::map<int, unsigned int> nodeScores_;
   const Node* node_;
 
 public:
@@ -101,19 +110,19 @@ public:
 
   void setNode(const Node* node) { node_ = node; }
 
-  std::vector<Bitset>& getBitsetsArrayForNeighbor(int neighborId)
+  std::vector<ParsimonyWord>& getBitsetsArrayForNeighbor(int neighborId)
   {
     return nodeBitsets_[neighborId];
   }
-  const std::vector<Bitset>& getBitsetsArrayForNeighbor(int neighborId) const
+  const std::vector<ParsimonyWord>& getBitsetsArrayForNeighbor(int neighborId) const
   {
     return nodeBitsets_[neighborId];
   }
-  std::vector<unsigned int>& getScoresArrayForNeighbor(int neighborId)
+  unsigned int& getScoreForNeighbor(int neighborId)
   {
     return nodeScores_[neighborId];
   }
-  const std::vector<unsigned int>& getScoresArrayForNeighbor(int neighborId) const
+  unsigned int getScoreForNeighbor(int neighborId) const
   {
     return nodeScores_[neighborId];
   }
@@ -135,7 +144,7 @@ public:
  *
  * This class is for use with the DRTreeParsimonyData class.
  *
- * Store the vector of bitsets associated to a leaf.
+ * Store the vector of packed bitsets associated to a leaf.
  *
  * @see DRTreeParsimonyData
  */
@@ -143,7 +152,7 @@ class DRTreeParsimonyLeafData :
   public TreeParsimonyNodeData
 {
 private:
-  mutable std::vector<Bitset> leafBitsets_;
+  mutable std::vector<ParsimonyWord> leafBitsets_;
   const Node* leaf_;
 
 public:
@@ -171,11 +180,11 @@ public:
   const Node* getNode() const { return leaf_; }
   void setNode(const Node* node) { leaf_ = node; }
 
-  std::vector<Bitset>& getBitsetsArray()
+  std::vector<ParsimonyWord>& getBitsetsArray()
   {
     return leafBitsets_;
   }
-  const std::vector<Bitset>& getBitsetsArray() const
+  const std::vector<ParsimonyWord>& getBitsetsArray() const
   {
     return leafBitsets_;
   }
@@ -185,25 +194,45 @@ public:
  * @brief Parsimony data structure for double-recursive (DR) algorithm.
  *
  * States are coded using bitsets for faster computing (@see AbstractTreeParsimonyData).
+ * Bitsets are transposed: each word holds one state for 64 sites (see ParsimonyWord),
+ * so that the Fitch algorithm processes many sites with each bitwise operation.
  * For each inner node in the tree, we store a DRTreeParsimonyNodeData object in nodeData_.
  * For each leaf node in the tree, we store a DRTreeParsimonyLeafData object in leafData_.
  *
  * The dataset is first compressed, removing all identical sites.
  * The resulting dataset is stored in shrunkData_.
  * The corresponding positions are stored in rootPatternLinks_, inherited from AbstractTreeParsimonyData.
+ * The last block is padded with sites where all states are possible, which hence never
+ * increase the score. Site weights are stored in the same transposed way, one bitset per
+ * bit of the weights, so that weighted scores can be computed with population counts.
  */
 class DRTreeParsimonyData :
   public AbstractTreeParsimonyData
 {
+public:
+  /**
+   * @brief The number of words per state in a block of sites.
+   */
+  static const size_t WORDS_PER_BLOCK;
+
+  /**
+   * @brief The number of sites in a block.
+   */
+  static const size_t SITES_PER_BLOCK;
+
 private:
   mutable std::map<int, DRTreeParsimonyNodeData> nodeData_;
   mutable std::map<int, DRTreeParsimonyLeafData> leafData_;
-  mutable std::vector<Bitset> rootBitsets_;
+  mutable std::vector<ParsimonyWord> rootBitsets_;
   mutable std::vector<unsigned int> rootScores_;
+  mutable unsigned int rootWeightedScore_;
+  std::vector<ParsimonyWord> weightBitsets_;
+  size_t nbWeightBits_;
   SiteContainer* shrunkData_;
   size_t nbSites_;
   size_t nbStates_;
   size_t nbDistinctSites_;
+  size_t nbBlocks_;
 
 public:
   DRTreeParsimonyData(const TreeTemplate<Node>* tree) :
@@ -212,10 +241,14 @@ public:
     leafData_(),
     rootBitsets_(),
     rootScores_(),
+    rootWeightedScore_(0),
+    weightBitsets_(),
+    nbWeightBits_(0),
     shrunkData_(0),
     nbSites_(0),
     nbStates_(0),
-    nbDistinctSites_(0)
+    nbDistinctSites_(0),
+    nbBlocks_(0)
   {}
 
   DRTreeParsimonyData(const DRTreeParsimonyData& data);
@@ -269,22 +302,22 @@ public:
     return leafData_[nodeId];
   }
 
-  std::vector<Bitset>& getBitsetsArray(int nodeId, int neighborId)
+  std::vector<ParsimonyWord>& getBitsetsArray(int nodeId, int neighborId)
   {
     return nodeData_[nodeId].getBitsetsArrayForNeighbor(neighborId);
   }
-  const std::vector<Bitset>& getBitsetsArray(int nodeId, int neighborId) const
+  const std::vector<ParsimonyWord>& getBitsetsArray(int nodeId, int neighborId) const
   {
     return nodeData_[nodeId].getBitsetsArrayForNeighbor(neighborId);
   }
 
-  std::vector<unsigned int>& getScoresArray(int nodeId, int neighborId)
+  unsigned int& getScore(int nodeId, int neighborId)
   {
-    return nodeData_[nodeId].getScoresArrayForNeighbor(neighborId);
+    return nodeData_[nodeId].getScoreForNeighbor(neighborId);
   }
-  const std::vector<unsigned int>& getScoresArray(int nodeId, int neighborId) const
+  unsigned int getScore(int nodeId, int neighborId) const
   {
-    return nodeData_[nodeId].getScoresArrayForNeighbor(neighborId);
+    return nodeData_[nodeId].getScoreForNeighbor(neighborId);
   }
 
   size_t getArrayPosition(int parentId, int sonId, size_t currentPosition) const
@@ -292,24 +325,103 @@ public:
     return currentPosition;
   }
 
-  std::vector<Bitset>& getRootBitsets() { return rootBitsets_; }
-  const std::vector<Bitset>& getRootBitsets() const { return rootBitsets_; }
-  const Bitset& getRootBitset(size_t i) const { return rootBitsets_[i]; }
+  std::vector<ParsimonyWord>& getRootBitsets() { return rootBitsets_; }
+  const std::vector<ParsimonyWord>& getRootBitsets() const { return rootBitsets_; }
 
+  /**
+   * @return The (unweighted) score of each distinct site.
+   */
   std::vector<unsigned int>& getRootScores() { return rootScores_; }
   const std::vector<unsigned int>& getRootScores() const { return rootScores_; }
   unsigned int getRootScore(size_t i) const { return rootScores_[i]; }
 
+  /**
+   * @return The score of the tree, that is the sum of the site scores weighted by the number of identical sites.
+   */
+  unsigned int& getRootWeightedScore() { return rootWeightedScore_; }
+  unsigned int getRootWeightedScore() const { return rootWeightedScore_; }
+
   size_t getNumberOfDistinctSites() const { return nbDistinctSites_; }
   size_t getNumberOfSites() const { return nbSites_; }
   size_t getNumberOfStates() const { return nbStates_; }
 
+  /**
+   * @return The number of blocks of sites, that is the number of distinct sites divided by SITES_PER_BLOCK, rounded up.
+   */
+  size_t getNumberOfBlocks() const { return nbBlocks_; }
+
+  /**
+   * @return The size of a bitsets array, that is nbBlocks * nbStates * WORDS_PER_BLOCK.
+   */
+  size_t getBitsetsArraySize() const { return nbBlocks_ * nbStates_ * WORDS_PER_BLOCK; }
+
+  /**
+   * @brief Get the sum of the weights of a set of sites in a block.
+   *
+   * @param block The index of the block.
+   * @param sites WORDS_PER_BLOCK words coding the set of sites in the block.
+   * @return The sum of the weights of the sites in the set.
+   */
+  unsigned int getWeightedCount(size_t block, const ParsimonyWord* sites) const
+  {
+    unsigned int count = 0;
+    const ParsimonyWord* weights = &weightBitsets_[block * nbWeightBits_ * WORDS_PER_BLOCK];
+    for (size_t b = 0; b < nbWeightBits_; ++b)
+    {
+      unsigned int n = 0;
+      for (size_t l = 0; l < WORDS_PER_BLOCK; ++l)
+      {
+        n += bitCount(sites[l] & weights[l]);
+      }
+      count += n << b;
+      weights += WORDS_PER_BLOCK;
+    }
+    return count;
+  }
+
+  /**
+   * @return The number of bits set in a word.
+   */
+  static unsigned int bitCount(ParsimonyWord word)
+  {
+#if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_popcountll(word));
+#else
+    unsigned int n = 0;
+    for (; word; ++n) word &= word - 1;
+    return n;
+#endif
+  }
+
   void init(const SiteContainer& sites, const StateMap& stateMap) throw (Exception);
   void reInit() throw (Exception);
 
+  /**
+   * @brief Compute the bitsets of a sequence, as for a leaf of the tree.
+   *
+   * The sequence must be in the data set given to init(), which may hence contain
+   * more sequences than the tree.
+   *
+   * @param name     The name of the sequence.
+   * @param stateMap The state map used in init().
+   * @param bitsets  The array where to store the bitsets.
+   * @throw SequenceNotFoundException If the sequence is not in the data set.
+   */
+  void computeLeafBitsets(const std::string& name, const StateMap& stateMap, std::vector<ParsimonyWord>& bitsets) const throw (Exception);
+
+  /**
+   * @brief Get a sequence of the data set given to init(), with all its sites.
+   *
+   * @param name The name of the sequence.
+   * @return A new sequence, rebuilt from the distinct sites.
+   * @throw SequenceNotFoundException If the sequence is not in the data set.
+   */
+  Sequence* getSequence(const std::string& name) const throw (Exception);
+
 protected:
   void init(const Node* node, const SiteContainer& sites, const StateMap& stateMap) throw (Exception);
   void reInit(const Node* node) throw (Exception);
+  void initLeafBitsets_(const Sequence& seq, const StateMap& stateMap, std::vector<ParsimonyWord>& bitsets) const;
 };
 } // end of namespace bpp.
 
@@ -44,6 +44,9 @@
 #include <Bpp/App/ApplicationTools.h>
 #include <Bpp/Numeric/VectorTools.h>
 
+// From the STL:
+#include <memory>
+
 using namespace bpp;
 using namespace std;
 
@@ -57,7 +60,8 @@ DRTreeParsimonyScore::DRTreeParsimonyScore(
 throw (Exception) :
   AbstractTreeParsimonyScore(tree, data, verbose, includeGaps),
   parsimonyData_(new DRTreeParsimonyData(getTreeP_())),
-  nbDistinctSites_()
+  nbDistinctSites_(),
+  siteScoresComputed_(false)
 {
   init_(data, verbose);
 }
@@ -70,7 +74,8 @@ DRTreeParsimonyScore::DRTreeParsimonyScore(
 throw (Exception) :
   AbstractTreeParsimonyScore(tree, data, statesMap, verbose),
   parsimonyData_(new DRTreeParsimonyData(getTreeP_())),
-  nbDistinctSites_()
+  nbDistinctSites_(),
+  siteScoresComputed_(false)
 {
   init_(data, verbose);
 }
@@ -94,7 +99,8 @@ void DRTreeParsimonyScore::init_(const SiteContainer& data, bool verbose)
 DRTreeParsimonyScore::DRTreeParsimonyScore(const DRTreeParsimonyScore& tp) :
   AbstractTreeParsimonyScore(tp),
   parsimonyData_(dynamic_cast<DRTreeParsimonyData*>(tp.parsimonyData_->clone())),
-  nbDistinctSites_(tp.nbDistinctSites_)
+  nbDistinctSites_(tp.nbDistinctSites_),
+  siteScoresComputed_(tp.siteScoresComputed_)
 {
   parsimonyData_->setTree(getTreeP_());
 }
@@ -107,6 +113,7 @@ DRTreeParsimonyScore& DRTreeParsimonyScore::operator=(const DRTreeParsimonyScore
   parsimonyData_ = dynamic_cast<DRTreeParsimonyData*>(tp.parsimonyData_->clone());
   parsimonyData_->setTree(getTreeP_());
   nbDistinctSites_ = tp.nbDistinctSites_;
+  siteScoresComputed_ = tp.siteScoresComputed_;
   return *this;
 }
 
@@ -125,7 +132,8 @@ void DRTreeParsimonyScore::computeScores()
   computeScoresForNode(
     parsimonyData_->getNodeData(getTree().getRootId()),
     parsimonyData_->getRootBitsets(),
-    parsimonyData_->getRootScores());
+    parsimonyData_->getRootWeightedScore());
+  siteScoresComputed_ = false;
 }
 
 void DRTreeParsimonyScore::computeScoresPostorder(const Node* node)
@@ -136,48 +144,44 @@ void DRTreeParsimonyScore::computeScoresPostorder(const Node* node)
   {
     const Node* son = node->getSon(k);
     computeScoresPostorder(son);
-    vector<Bitset>* bitsets      = &pData->getBitsetsArrayForNeighbor(son->getId());
-    vector<unsigned int>* scores = &pData->getScoresArrayForNeighbor(son->getId());
+    vector<ParsimonyWord>* bitsets = &pData->getBitsetsArrayForNeighbor(son->getId());
+    unsigned int* score = &pData->getScoreForNeighbor(son->getId());
     if (son->isLeaf())
     {
       // son has no NodeData associated, must use LeafData instead
-      vector<Bitset>* sonBitsets = &parsimonyData_->getLeafData(son->getId()).getBitsetsArray();
-      for (unsigned int i = 0; i < sonBitsets->size(); i++)
-      {
-        (*bitsets)[i] = (*sonBitsets)[i];
-        (*scores)[i]  = 0;
-      }
+      *bitsets = parsimonyData_->getLeafData(son->getId()).getBitsetsArray();
+      *score   = 0;
     }
     else
     {
       computeScoresPostorderForNode(
         parsimonyData_->getNodeData(son->getId()),
         *bitsets,
-        *scores);
+        *score);
     }
   }
 }
 
-void DRTreeParsimonyScore::computeScoresPostorderForNode(const DRTreeParsimonyNodeData& pData, vector<Bitset>& rBitsets, vector<unsigned int>& rScores)
+void DRTreeParsimonyScore::computeScoresPostorderForNode(const DRTreeParsimonyNodeData& pData, vector<ParsimonyWord>& rBitsets, unsigned int& rScore) const
 {
   // First initialize the vectors from input:
   const Node* node = pData.getNode();
   const Node* source = node->getFather();
   vector<const Node*> neighbors = node->getNeighbors();
   size_t nbNeighbors = node->degree();
-  vector< const vector<Bitset>*> iBitsets;
-  vector< const vector<unsigned int>*> iScores;
+  vector< const vector<ParsimonyWord>*> iBitsets;
+  vector<unsigned int> iScores;
   for (unsigned int k = 0; k < nbNeighbors; k++)
   {
     const Node* n = neighbors[k];
     if (n != source)
     {
       iBitsets.push_back(&pData.getBitsetsArrayForNeighbor(n->getId()));
-      iScores.push_back(&pData.getScoresArrayForNeighbor(n->getId()));
+      iScores.push_back(pData.getScoreForNeighbor(n->getId()));
     }
   }
   // Then call the general method on these arrays:
-  computeScoresFromArrays(iBitsets, iScores, rBitsets, rScores);
+  computeScoresFromArrays(iBitsets, iScores, rBitsets, rScore);
 }
 
 void DRTreeParsimonyScore::computeScoresPreorder(const Node* node)
@@ -187,17 +191,13 @@ void DRTreeParsimonyScore::computeScoresPreorder(const Node* node)
   if (node->hasFather())
   {
     const Node* father = node->getFather();
-    vector<Bitset>* bitsets      = &pData->getBitsetsArrayForNeighbor(father->getId());
-    vector<unsigned int>* scores = &pData->getScoresArrayForNeighbor(father->getId());
+    vector<ParsimonyWord>* bitsets = &pData->getBitsetsArrayForNeighbor(father->getId());
+    unsigned int* score = &pData->getScoreForNeighbor(father->getId());
     if (father->isLeaf())
     { // Means that the tree is rooted by a leaf... dunno if we must allow that! Let it be for now.
       // son has no NodeData associated, must use LeafData instead
-      vector<Bitset>* sonBitsets = &parsimonyData_->getLeafData(father->getId()).getBitsetsArray();
-      for (unsigned int i = 0; i < sonBitsets->size(); i++)
-      {
-        (*bitsets)[i] = (*sonBitsets)[i];
-        (*scores)[i]  = 0;
-      }
+      *bitsets = parsimonyData_->getLeafData(father->getId()).getBitsetsArray();
+      *score   = 0;
     }
     else
     {
@@ -205,7 +205,7 @@ void DRTreeParsimonyScore::computeScoresPreorder(const Node* node)
         parsimonyData_->getNodeData(father->getId()),
         node,
         *bitsets,
-        *scores);
+        *score);
     }
   }
   // Recurse call:
@@ -215,98 +215,183 @@ void DRTreeParsimonyScore::computeScoresPreorder(const Node* node)
   }
 }
 
-void DRTreeParsimonyScore::computeScoresPreorderForNode(const DRTreeParsimonyNodeData& pData, const Node* source, std::vector<Bitset>& rBitsets, std::vector<unsigned int>& rScores)
+void DRTreeParsimonyScore::computeScoresPreorderForNode(const DRTreeParsimonyNodeData& pData, const Node* source, std::vector<ParsimonyWord>& rBitsets, unsigned int& rScore) const
 {
   // First initialize the vectors from input:
   const Node* node = pData.getNode();
   vector<const Node*> neighbors = node->getNeighbors();
   size_t nbNeighbors = node->degree();
-  vector< const vector<Bitset>*> iBitsets;
-  vector< const vector<unsigned int>*> iScores;
+  vector< const vector<ParsimonyWord>*> iBitsets;
+  vector<unsigned int> iScores;
   for (unsigned int k = 0; k < nbNeighbors; k++)
   {
     const Node* n = neighbors[k];
     if (n != source)
     {
       iBitsets.push_back(&pData.getBitsetsArrayForNeighbor(n->getId()));
-      iScores.push_back(&pData.getScoresArrayForNeighbor(n->getId()));
+      iScores.push_back(pData.getScoreForNeighbor(n->getId()));
     }
   }
   // Then call the general method on these arrays:
-  computeScoresFromArrays(iBitsets, iScores, rBitsets, rScores);
+  computeScoresFromArrays(iBitsets, iScores, rBitsets, rScore);
 }
 
-void DRTreeParsimonyScore::computeScoresForNode(const DRTreeParsimonyNodeData& pData, std::vector<Bitset>& rBitsets, std::vector<unsigned int>& rScores)
+void DRTreeParsimonyScore::computeScoresForNode(const DRTreeParsimonyNodeData& pData, std::vector<ParsimonyWord>& rBitsets, unsigned int& rScore) const
 {
   const Node* node = pData.getNode();
   size_t nbNeighbors = node->degree();
   vector<const Node*> neighbors = node->getNeighbors();
   // First initialize the vectors fro input:
-  vector< const vector<Bitset>*> iBitsets(nbNeighbors);
-  vector< const vector<unsigned int>*> iScores(nbNeighbors);
+  vector< const vector<ParsimonyWord>*> iBitsets(nbNeighbors);
+  vector<unsigned int> iScores(nbNeighbors);
   for (unsigned int k = 0; k < nbNeighbors; k++)
   {
     const Node* n = neighbors[k];
     iBitsets[k] =  &pData.getBitsetsArrayForNeighbor(n->getId());
-    iScores [k] =  &pData.getScoresArrayForNeighbor(n->getId());
+    iScores [k] =  pData.getScoreForNeighbor(n->getId());
   }
   // Then call the general method on these arrays:
-  computeScoresFromArrays(iBitsets, iScores, rBitsets, rScores);
+  computeScoresFromArrays(iBitsets, iScores, rBitsets, rScore);
 }
 
 /******************************************************************************/
-unsigned int DRTreeParsimonyScore::getScore() const
+void DRTreeParsimonyScore::computeSiteScores_() const
 {
-  unsigned int score = 0;
-  for (unsigned int i = 0; i < nbDistinctSites_; i++)
+  vector<unsigned int>& siteScores = parsimonyData_->getRootScores();
+  siteScores.assign(nbDistinctSites_, 0);
+  vector<ParsimonyWord> bitsets(parsimonyData_->getBitsetsArraySize());
+  unsigned int score;
+  // Each union in the rooted postorder traversal costs one step:
+  vector<const Node*> nodes = getTreeP_()->getInnerNodes();
+  for (size_t i = 0; i < nodes.size(); i++)
   {
-    score += parsimonyData_->getRootScore(i) * parsimonyData_->getWeight(i);
+    const DRTreeParsimonyNodeData& pData = parsimonyData_->getNodeData(nodes[i]->getId());
+    vector< const vector<ParsimonyWord>*> iBitsets;
+    vector<unsigned int> iScores;
+    for (unsigned int k = 0; k < nodes[i]->getNumberOfSons(); k++)
+    {
+      int sonId = nodes[i]->getSon(k)->getId();
+      iBitsets.push_back(&pData.getBitsetsArrayForNeighbor(sonId));
+      iScores.push_back(pData.getScoreForNeighbor(sonId));
+    }
+    computeScoresFromArrays(iBitsets, iScores, bitsets, score, &siteScores);
   }
-  return score;
+  siteScoresComputed_ = true;
+}
+
+/******************************************************************************/
+unsigned int DRTreeParsimonyScore::getScore() const
+{
+  return parsimonyData_->getRootWeightedScore();
 }
 
 /******************************************************************************/
 unsigned int DRTreeParsimonyScore::getScoreForSite(size_t site) const
 {
+  if (!siteScoresComputed_)
+    computeSiteScores_();
   return parsimonyData_->getRootScore(parsimonyData_->getRootArrayPosition(site));
 }
 
 /******************************************************************************/
 void DRTreeParsimonyScore::computeScoresFromArrays(
-  const vector< const vector<Bitset>*>& iBitsets,
-  const vector< const vector<unsigned int>*>& iScores,
-  vector<Bitset>& oBitsets,
-  vector<unsigned int>& oScores)
+  const vector< const vector<ParsimonyWord>*>& iBitsets,
+  const vector<unsigned int>& iScores,
+  vector<ParsimonyWord>& oBitsets,
+  unsigned int& oScore,
+  vector<unsigned int>* siteScores) const
 {
-  size_t nbPos  = oBitsets.size();
   size_t nbNodes = iBitsets.size();
   if (iScores.size() != nbNodes)
     throw Exception("DRTreeParsimonyScore::computeScores(); Error, input arrays must have the same length.");
   if (nbNodes < 1)
     throw Exception("DRTreeParsimonyScore::computeScores(); Error, input arrays must have a size >= 1.");
-  const vector<Bitset>* bitsets0 = iBitsets[0];
-  const vector<unsigned int>* scores0 = iScores[0];
-  for (size_t i = 0; i < nbPos; i++)
+  size_t nbStates = parsimonyData_->getNumberOfStates();
+  oBitsets = *iBitsets[0];
+  oScore = iScores[0];
+  for (size_t k = 1; k < nbNodes; k++)
   {
-    oBitsets[i] = (*bitsets0)[i];
-    oScores[i]  = (*scores0)[i];
+    oScore += iScores[k];
+    // Common numbers of states are hard-coded, so that state loops can be unrolled:
+    switch (nbStates)
+    {
+    case 4:  oScore += computeFitchStep_<4>(*parsimonyData_, nbStates, iBitsets[k]->data(), oBitsets.data(), siteScores); break;
+    case 5:  oScore += computeFitchStep_<5>(*parsimonyData_, nbStates, iBitsets[k]->data(), oBitsets.data(), siteScores); break;
+    case 20: oScore += computeFitchStep_<20>(*parsimonyData_, nbStates, iBitsets[k]->data(), oBitsets.data(), siteScores); break;
+    case 21: oScore += computeFitchStep_<21>(*parsimonyData_, nbStates, iBitsets[k]->data(), oBitsets.data(), siteScores); break;
+    case 61: oScore += computeFitchStep_<61>(*parsimonyData_, nbStates, iBitsets[k]->data(), oBitsets.data(), siteScores); break;
+    case 64: oScore += computeFitchStep_<64>(*parsimonyData_, nbStates, iBitsets[k]->data(), oBitsets.data(), siteScores); break;
+    case 65: oScore += computeFitchStep_<65>(*parsimonyData_, nbStates, iBitsets[k]->data(), oBitsets.data(), siteScores); break;
+    default: oScore += computeFitchStep_<0>(*parsimonyData_, nbStates, iBitsets[k]->data(), oBitsets.data(), siteScores);
+    }
   }
-  for (size_t k = 1; k < nbNodes; k++)
+}
+
+template<size_t NbStates>
+unsigned int DRTreeParsimonyScore::computeFitchStep_(
+  const DRTreeParsimonyData& data,
+  size_t nbStates,
+  const ParsimonyWord* in,
+  ParsimonyWord* out,
+  vector<unsigned int>* siteScores)
+{
+  const size_t nbWords = DRTreeParsimonyData::WORDS_PER_BLOCK;
+  const size_t blockSize = (NbStates > 0 ? NbStates : nbStates) * nbWords;
+  size_t nbBlocks = data.getNumberOfBlocks();
+  unsigned int score = 0;
+  for (size_t b = 0; b < nbBlocks; b++, in += blockSize, out += blockSize)
   {
-    const vector<Bitset>* bitsetsk = iBitsets[k];
-    const vector<unsigned int>* scoresk = iScores[k];
-    for (unsigned int i = 0; i < nbPos; i++)
+    // Sites where the intersection is not empty:
+    ParsimonyWord any[DRTreeParsimonyData::WORDS_PER_BLOCK];
+    for (size_t l = 0; l < nbWords; l++)
+    {
+      any[l] = 0;
+    }
+    for (size_t j = 0; j < blockSize; j += nbWords)
     {
-      Bitset bs = oBitsets[i] & (*bitsetsk)[i];
-      oScores[i] += (*scoresk)[i];
-      if (bs == 0)
+      for (size_t l = 0; l < nbWords; l++)
       {
-        bs = oBitsets[i] | (*bitsetsk)[i];
-        oScores[i] += 1;
+        any[l] |= out[j + l] & in[j + l];
+      }
+    }
+    ParsimonyWord empty[DRTreeParsimonyData::WORDS_PER_BLOCK];
+    ParsimonyWord hasEmpty = 0;
+    for (size_t l = 0; l < nbWords; l++)
+    {
+      empty[l] = ~any[l];
+      hasEmpty |= empty[l];
+    }
+    if (hasEmpty == 0)
+    {
+      for (size_t j = 0; j < blockSize; j++)
+      {
+        out[j] &= in[j];
+      }
+      continue;
+    }
+    // Intersection where not empty, union elsewhere:
+    for (size_t j = 0; j < blockSize; j += nbWords)
+    {
+      for (size_t l = 0; l < nbWords; l++)
+      {
+        out[j + l] = (out[j + l] & in[j + l]) | ((out[j + l] | in[j + l]) & empty[l]);
+      }
+    }
+    score += data.getWeightedCount(b, empty);
+    if (siteScores)
+    {
+      // Padding sites never have an empty intersection:
+      for (size_t l = 0; l < nbWords; l++)
+      {
+        for (size_t i = 0; i < 64; i++)
+        {
+          if ((empty[l] >> i) & 1)
+            (*siteScores)[b * DRTreeParsimonyData::SITES_PER_BLOCK + l * 64 + i]++;
+        }
       }
-      oBitsets[i] = bs;
     }
   }
+  return score;
 }
 
 /******************************************************************************/
@@ -325,60 +410,55 @@ double DRTreeParsimonyScore::testNNI(int nodeId) const throw (NodeException)
 
   // Retrieving arrays of interest:
   const DRTreeParsimonyNodeData* parentData = &parsimonyData_->getNodeData(parent->getId());
-  const vector<Bitset>* sonBitsets = &parentData->getBitsetsArrayForNeighbor(son->getId());
-  const vector<unsigned int>* sonScores  = &parentData->getScoresArrayForNeighbor(son->getId());
+  const vector<ParsimonyWord>* sonBitsets = &parentData->getBitsetsArrayForNeighbor(son->getId());
+  unsigned int sonScore = parentData->getScoreForNeighbor(son->getId());
   vector<const Node*> parentNeighbors = TreeTemplateTools::getRemainingNeighbors(parent, grandFather, son);
   size_t nbParentNeighbors = parentNeighbors.size();
-  vector< const vector<Bitset>*> parentBitsets(nbParentNeighbors);
-  vector< const vector<unsigned int>*> parentScores(nbParentNeighbors);
+  vector< const vector<ParsimonyWord>*> parentBitsets(nbParentNeighbors);
+  vector<unsigned int> parentScores(nbParentNeighbors);
   for (unsigned int k = 0; k < nbParentNeighbors; k++)
   {
     const Node* n = parentNeighbors[k]; // This neighbor
     parentBitsets[k] = &parentData->getBitsetsArrayForNeighbor(n->getId());
-    parentScores[k] = &parentData->getScoresArrayForNeighbor(n->getId());
+    parentScores[k] = parentData->getScoreForNeighbor(n->getId());
   }
 
   const DRTreeParsimonyNodeData* grandFatherData = &parsimonyData_->getNodeData(grandFather->getId());
-  const vector<Bitset>* uncleBitsets = &grandFatherData->getBitsetsArrayForNeighbor(uncle->getId());
-  const vector<unsigned int>* uncleScores  = &grandFatherData->getScoresArrayForNeighbor(uncle->getId());
+  const vector<ParsimonyWord>* uncleBitsets = &grandFatherData->getBitsetsArrayForNeighbor(uncle->getId());
+  unsigned int uncleScore = grandFatherData->getScoreForNeighbor(uncle->getId());
   vector<const Node*> grandFatherNeighbors = TreeTemplateTools::getRemainingNeighbors(grandFather, parent, uncle);
   size_t nbGrandFatherNeighbors = grandFatherNeighbors.size();
-  vector< const vector<Bitset>*> grandFatherBitsets(nbGrandFatherNeighbors);
-  vector< const vector<unsigned int>*> grandFatherScores(nbGrandFatherNeighbors);
+  vector< const vector<ParsimonyWord>*> grandFatherBitsets(nbGrandFatherNeighbors);
+  vector<unsigned int> grandFatherScores(nbGrandFatherNeighbors);
   for (unsigned int k = 0; k < nbGrandFatherNeighbors; k++)
   {
     const Node* n = grandFatherNeighbors[k]; // This neighbor
     grandFatherBitsets[k] = &grandFatherData->getBitsetsArrayForNeighbor(n->getId());
-    grandFatherScores[k] = &grandFatherData->getScoresArrayForNeighbor(n->getId());
+    grandFatherScores[k] = grandFatherData->getScoreForNeighbor(n->getId());
   }
 
   // Compute arrays and scores for grand-father node:
   grandFatherBitsets.push_back(sonBitsets);
-  grandFatherScores.push_back(sonScores);
+  grandFatherScores.push_back(sonScore);
   // Init arrays:
-  vector<Bitset> gfBitsets(sonBitsets->size()); // All arrays supposed to have the same size!
-  vector<unsigned int> gfScores(sonScores->size());
+  vector<ParsimonyWord> gfBitsets;
+  unsigned int gfScore;
   // Fill arrays:
-  computeScoresFromArrays(grandFatherBitsets, grandFatherScores, gfBitsets, gfScores);
+  computeScoresFromArrays(grandFatherBitsets, grandFatherScores, gfBitsets, gfScore);
 
   // Now computes arrays and scores for parent node:
   parentBitsets.push_back(uncleBitsets);
-  parentScores.push_back(uncleScores);
+  parentScores.push_back(uncleScore);
   parentBitsets.push_back(&gfBitsets);
-  parentScores.push_back(&gfScores);
+  parentScores.push_back(gfScore);
   // Init arrays:
-  vector<Bitset> pBitsets(sonBitsets->size()); // All arrays supposed to have the same size!
-  vector<unsigned int> pScores(sonScores->size());
+  vector<ParsimonyWord> pBitsets;
+  unsigned int pScore;
   // Fill arrays:
-  computeScoresFromArrays(parentBitsets, parentScores, pBitsets, pScores);
+  computeScoresFromArrays(parentBitsets, parentScores, pBitsets, pScore);
 
   // Final computation:
-  unsigned int score = 0;
-  for (unsigned int i = 0; i < nbDistinctSites_; i++)
-  {
-    score += pScores[i] * parsimonyData_->getWeight(i);
-  }
-  return (double)score - (double)getScore();
+  return (double)pScore - (double)getScore();
 }
 
 /******************************************************************************/
@@ -403,3 +483,223 @@ void DRTreeParsimonyScore::doNNI(int nodeId) throw (NodeException)
 
 /******************************************************************************/
 
+void DRTreeParsimonyScore::visitBranches_(
+  const Node* node,
+  const Node* from,
+  const vector<ParsimonyWord>& bitsets,
+  unsigned int score,
+  unsigned int depth,
+  unsigned int radius,
+  const std::function<void (const Node*, const Node*, const vector<ParsimonyWord>&, unsigned int)>& f) const
+{
+  if (depth > radius || node->isLeaf()) return;
+  const DRTreeParsimonyNodeData* pData = &parsimonyData_->getNodeData(node->getId());
+  vector<const Node*> neighbors = node->getNeighbors();
+  vector<ParsimonyWord> xBitsets;
+  unsigned int xScore;
+  for (size_t k = 0; k < neighbors.size(); k++)
+  {
+    const Node* son = neighbors[k];
+    if (son == from) continue;
+    // Subtree on the node side of the branch, not including the son:
+    vector< const vector<ParsimonyWord>*> iBitsets(1, &bitsets);
+    vector<unsigned int> iScores(1, score);
+    for (size_t j = 0; j < neighbors.size(); j++)
+    {
+      const Node* n = neighbors[j];
+      if (n != from && n != son)
+      {
+        iBitsets.push_back(&pData->getBitsetsArrayForNeighbor(n->getId()));
+        iScores.push_back(pData->getScoreForNeighbor(n->getId()));
+      }
+    }
+    computeScoresFromArrays(iBitsets, iScores, xBitsets, xScore);
+    f(node, son, xBitsets, xScore);
+    visitBranches_(son, node, xBitsets, xScore, depth + 1, radius, f);
+  }
+}
+
+/******************************************************************************/
+DRTreeParsimonyScore::Rearrangement DRTreeParsimonyScore::testRearrangements(int nodeId, unsigned int radius, bool tbr) const throw (NodeException)
+{
+  const Node* pruned = getTreeP_()->getNode(nodeId);
+  if (!pruned->hasFather()) throw NodePException("DRTreeParsimonyScore::testRearrangements(). Node must not be the root node.", pruned);
+  const Node* father = pruned->getFather();
+  Rearrangement best;
+  best.prunedNodeId = nodeId;
+  if (father->degree() != 3 || radius == 0) return best;
+  const DRTreeParsimonyNodeData* fatherData = &parsimonyData_->getNodeData(father->getId());
+
+  // Candidate roots of the pruned subtree, the first one being the current root:
+  vector< vector<ParsimonyWord> > subtreeBitsets(1, fatherData->getBitsetsArrayForNeighbor(nodeId));
+  vector<unsigned int> subtreeScores(1, fatherData->getScoreForNeighbor(nodeId));
+  vector< pair<int, int> > subtreeBranches(1, pair<int, int>(-1, -1));
+  if (tbr && pruned->degree() == 3)
+  {
+    const DRTreeParsimonyNodeData* prunedData = &parsimonyData_->getNodeData(nodeId);
+    vector<const Node*> sons = TreeTemplateTools::getRemainingNeighbors(pruned, father, father);
+    for (size_t k = 0; k < 2; k++)
+    {
+      const Node* other = sons[1 - k];
+      visitBranches_(sons[k], pruned,
+        prunedData->getBitsetsArrayForNeighbor(other->getId()),
+        prunedData->getScoreForNeighbor(other->getId()),
+        1, radius,
+        [&](const Node* x, const Node* y, const vector<ParsimonyWord>& xBitsets, unsigned int xScore)
+        {
+          vector< const vector<ParsimonyWord>*> iBitsets(1, &xBitsets);
+          vector<unsigned int> iScores(1, xScore);
+          iBitsets.push_back(&parsimonyData_->getBitsetsArray(x->getId(), y->getId()));
+          iScores.push_back(parsimonyData_->getScore(x->getId(), y->getId()));
+          subtreeBitsets.push_back(vector<ParsimonyWord>());
+          subtreeScores.push_back(0);
+          computeScoresFromArrays(iBitsets, iScores, subtreeBitsets.back(), subtreeScores.back());
+          subtreeBranches.push_back(pair<int, int>(x->getId(), y->getId()));
+        });
+    }
+  }
+
+  // Score all candidate roots of the pruned subtree on a regrafting branch:
+  unsigned int bestScore = getScore();
+  vector<ParsimonyWord> bitsets;
+  unsigned int score;
+  auto evaluate = [&](const vector<ParsimonyWord>& tBitsets, unsigned int tScore, int id1, int id2)
+  {
+    for (size_t i = (id1 < 0 ? 1 : 0); i < subtreeBitsets.size(); i++)
+    {
+      vector< const vector<ParsimonyWord>*> iBitsets(1, &tBitsets);
+      vector<unsigned int> iScores(1, tScore);
+      iBitsets.push_back(&subtreeBitsets[i]);
+      iScores.push_back(subtreeScores[i]);
+      computeScoresFromArrays(iBitsets, iScores, bitsets, score);
+      if (!best.isValid() || score < bestScore)
+      {
+        bestScore = score;
+        best.regraftNodeId1 = id1;
+        best.regraftNodeId2 = id2;
+        best.rerootNodeId1  = subtreeBranches[i].first;
+        best.rerootNodeId2  = subtreeBranches[i].second;
+      }
+    }
+  };
+
+  // Remaining tree, with the father of the pruned subtree removed:
+  vector<const Node*> neighbors = TreeTemplateTools::getRemainingNeighbors(father, pruned, pruned);
+  vector<ParsimonyWord> tBitsets;
+  unsigned int tScore;
+  if (subtreeBitsets.size() > 1)
+  {
+    vector< const vector<ParsimonyWord>*> iBitsets(2);
+    vector<unsigned int> iScores(2);
+    for (size_t k = 0; k < 2; k++)
+    {
+      iBitsets[k] = &fatherData->getBitsetsArrayForNeighbor(neighbors[k]->getId());
+      iScores[k]  = fatherData->getScoreForNeighbor(neighbors[k]->getId());
+    }
+    computeScoresFromArrays(iBitsets, iScores, tBitsets, tScore);
+    evaluate(tBitsets, tScore, -1, -1);
+  }
+  for (size_t k = 0; k < 2; k++)
+  {
+    const Node* other = neighbors[1 - k];
+    visitBranches_(neighbors[k], father,
+      fatherData->getBitsetsArrayForNeighbor(other->getId()),
+      fatherData->getScoreForNeighbor(other->getId()),
+      1, radius,
+      [&](const Node* x, const Node* y, const vector<ParsimonyWord>& xBitsets, unsigned int xScore)
+      {
+        vector< const vector<ParsimonyWord>*> iBitsets(1, &xBitsets);
+        vector<unsigned int> iScores(1, xScore);
+        iBitsets.push_back(&parsimonyData_->getBitsetsArray(x->getId(), y->getId()));
+        iScores.push_back(parsimonyData_->getScore(x->getId(), y->getId()));
+        computeScoresFromArrays(iBitsets, iScores, tBitsets, tScore);
+        evaluate(tBitsets, tScore, x->getId(), y->getId());
+      });
+  }
+  if (best.isValid())
+    best.scoreDifference = static_cast<double>(bestScore) - static_cast<double>(getScore());
+  return best;
+}
+
+/******************************************************************************/
+void DRTreeParsimonyScore::doRearrangement(const Rearrangement& rearrangement) throw (NodeException)
+{
+  rearrangement.apply(*getTreeP_());
+  parsimonyData_->reInit();
+  computeScores();
+}
+
+/******************************************************************************/
+vector<unsigned int> DRTreeParsimonyScore::testLeafInsertions(const string& name, vector<int>& nodeIds) const throw (Exception)
+{
+  vector<ParsimonyWord> leafBitsets;
+  parsimonyData_->computeLeafBitsets(name, getStateMap(), leafBitsets);
+
+  vector<const Node*> nodes = getTreeP_()->getNodes();
+  nodeIds.clear();
+  vector<unsigned int> scores;
+  vector<ParsimonyWord> bitsets;
+  unsigned int score;
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    const Node* son = nodes[i];
+    if (!son->hasFather()) continue;
+    const Node* father = son->getFather();
+    const DRTreeParsimonyNodeData* fatherData = &parsimonyData_->getNodeData(father->getId());
+    // The new leaf, and the subtrees on both sides of the branch:
+    vector< const vector<ParsimonyWord>*> iBitsets(1, &leafBitsets);
+    vector<unsigned int> iScores(1, 0);
+    iBitsets.push_back(&fatherData->getBitsetsArrayForNeighbor(son->getId()));
+    iScores.push_back(fatherData->getScoreForNeighbor(son->getId()));
+    if (!son->isLeaf())
+    {
+      iBitsets.push_back(&parsimonyData_->getBitsetsArray(son->getId(), father->getId()));
+      iScores.push_back(parsimonyData_->getScore(son->getId(), father->getId()));
+    }
+    else
+    {
+      // No array is stored for leaves, so we combine the other neighbors of the father:
+      vector<const Node*> neighbors = TreeTemplateTools::getRemainingNeighbors(father, son, son);
+      for (size_t k = 0; k < neighbors.size(); k++)
+      {
+        iBitsets.push_back(&fatherData->getBitsetsArrayForNeighbor(neighbors[k]->getId()));
+        iScores.push_back(fatherData->getScoreForNeighbor(neighbors[k]->getId()));
+      }
+    }
+    computeScoresFromArrays(iBitsets, iScores, bitsets, score);
+    nodeIds.push_back(son->getId());
+    scores.push_back(score);
+  }
+  return scores;
+}
+
+/******************************************************************************/
+void DRTreeParsimonyScore::doLeafInsertion(const string& name, int nodeId) throw (Exception)
+{
+  TreeTemplate<Node>* tree = getTreeP_();
+  Node* son = tree->getNode(nodeId);
+  if (!son->hasFather()) throw NodePException("DRTreeParsimonyScore::doLeafInsertion(). Node must not be the root node.", son);
+  Node* father = son->getFather();
+
+  // Compute the bitsets first, as the sequence may not be in the data set:
+  vector<ParsimonyWord> bitsets;
+  parsimonyData_->computeLeafBitsets(name, getStateMap(), bitsets);
+  unique_ptr<Sequence> seq(parsimonyData_->getSequence(name));
+  addSequence_(*seq);
+
+  Node* node = new Node(tree->getNextId());
+  size_t pos = father->getSonPosition(son);
+  father->removeSon(son);
+  father->addSon(pos, node);
+  node->addSon(son);
+  Node* leaf = new Node(tree->getNextId(), name);
+  node->addSon(leaf);
+  DRTreeParsimonyLeafData* leafData = &parsimonyData_->getLeafData(leaf->getId());
+  leafData->setNode(leaf);
+  leafData->getBitsetsArray().swap(bitsets);
+
+  parsimonyData_->reInit();
+  computeScores();
+}
+
+/******************************************************************************/
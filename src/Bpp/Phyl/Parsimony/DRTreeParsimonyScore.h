@@ -43,14 +43,27 @@
 #include "AbstractTreeParsimonyScore.h"
 #include "DRTreeParsimonyData.h"
 #include "../NNISearchable.h"
+#include "../SubtreeRearrangement.h"
 #include "../TreeTools.h"
 
+// From the STL:
+#include <functional>
+
 namespace bpp
 {
 /**
  * @brief Double recursive implementation of interface TreeParsimonyScore.
  *
  * Uses a DRTreeParsimonyData object for data storage.
+ * The Fitch algorithm is computed in a bit-parallel way, on blocks of sites
+ * (see ParsimonyWord): intersections and unions are computed for all sites of
+ * a block with bitwise operations, and score increments are obtained by counting
+ * the sites where the intersection is empty. Only the total weighted score of
+ * each subtree is stored. Scores for each site are computed on demand.
+ *
+ * Any number of states is supported, including codons (with or without stop codons).
+ * The combination kernel is instantiated for the most common numbers of states,
+ * and falls back to a generic version otherwise.
  */
 class DRTreeParsimonyScore :
   public AbstractTreeParsimonyScore,
@@ -59,6 +72,7 @@ class DRTreeParsimonyScore :
 private:
   DRTreeParsimonyData* parsimonyData_;
   size_t nbDistinctSites_;
+  mutable bool siteScoresComputed_;
 
 public:
   DRTreeParsimonyScore(
@@ -86,6 +100,54 @@ public:
 private:
   void init_(const SiteContainer& data, bool verbose);
 
+  /**
+   * @brief Compute the score of each distinct site, by counting the unions in a postorder traversal.
+   */
+  void computeSiteScores_() const;
+
+  /**
+   * @brief Visit all branches within a given radius in a subtree, with the arrays toward the starting point.
+   *
+   * For each branch (x, y), y being farther from the starting point, f(x, y, bitsets, score)
+   * is called, where bitsets and score describe the subtree on the x side of the branch.
+   * Arrays pointing away from the starting point are taken from the current tree.
+   *
+   * @param node    The node to start from.
+   * @param from    The neighbor of node not to visit.
+   * @param bitsets The bitsets of the subtree on the from side.
+   * @param score   The score of the subtree on the from side.
+   * @param depth   The distance of the branches of node.
+   * @param radius  The maximum distance.
+   * @param f       The function to call on each branch.
+   */
+  void visitBranches_(
+    const Node* node,
+    const Node* from,
+    const std::vector<ParsimonyWord>& bitsets,
+    unsigned int score,
+    unsigned int depth,
+    unsigned int radius,
+    const std::function<void (const Node*, const Node*, const std::vector<ParsimonyWord>&, unsigned int)>& f) const;
+
+  /**
+   * @brief Combine a bitsets array with another one, for all blocks of sites.
+   *
+   * @param data       The parsimony data, for the number of blocks and the weights.
+   * @param nbStates   The number of states, used if NbStates is 0.
+   * @param in         The bitsets to combine.
+   * @param out        The bitsets to update.
+   * @param siteScores If not null, the score increment of each site is added to this array.
+   * @return The weighted score increment.
+   * @tparam NbStates  The number of states, if known at compile time, 0 otherwise.
+   */
+  template<size_t NbStates>
+  static unsigned int computeFitchStep_(
+    const DRTreeParsimonyData& data,
+    size_t nbStates,
+    const ParsimonyWord* in,
+    ParsimonyWord* out,
+    std::vector<unsigned int>* siteScores);
+
 protected:
   /**
    * @brief Compute all scores.
@@ -107,41 +169,41 @@ public:
   unsigned int getScoreForSite(size_t site) const;
 
   /**
-   * @brief Compute bitsets and scores for each site for a node, in postorder.
+   * @brief Compute bitsets and score for a node, in postorder.
    *
    * @param pData    The node data to use.
    * @param rBitsets The bitset array where to store the resulting bitsets.
-   * @param rScores  The score array where to write the resulting scores.
+   * @param rScore   Where to write the resulting score.
    */
-  static void computeScoresPostorderForNode(
+  void computeScoresPostorderForNode(
     const DRTreeParsimonyNodeData& pData,
-    std::vector<Bitset>& rBitsets,
-    std::vector<unsigned int>& rScores);
+    std::vector<ParsimonyWord>& rBitsets,
+    unsigned int& rScore) const;
 
   /**
-   * @brief Compute bitsets and scores for each site for a node, in preorder.
+   * @brief Compute bitsets and score for a node, in preorder.
    *
    * @param pData    The node data to use.
    * @param source   The node where we are coming from.
    * @param rBitsets The bitset array where to store the resulting bitsets.
-   * @param rScores  The score array where to write the resulting scores.
+   * @param rScore   Where to write the resulting score.
    */
-  static void computeScoresPreorderForNode(
+  void computeScoresPreorderForNode(
     const DRTreeParsimonyNodeData& pData,
     const Node* source,
-    std::vector<Bitset>& rBitsets,
-    std::vector<unsigned int>& rScores);
+    std::vector<ParsimonyWord>& rBitsets,
+    unsigned int& rScore) const;
 
   /**
-   * @brief Compute bitsets and scores for each site for a node, in all directions.
+   * @brief Compute bitsets and score for a node, in all directions.
    *
    * @param pData    The node data to use.
    * @param rBitsets The bitset array where to store the resulting bitsets.
-   * @param rScores  The score array where to write the resulting scores.
+   * @param rScore   Where to write the resulting score.
    */
-  static void computeScoresForNode(
-    const DRTreeParsimonyNodeData& pData, std::vector<Bitset>& rBitsets,
-    std::vector<unsigned int>& rScores);
+  void computeScoresForNode(
+    const DRTreeParsimonyNodeData& pData, std::vector<ParsimonyWord>& rBitsets,
+    unsigned int& rScore) const;
 
   /**
    * @brief Compute bitsets and scores from an array of arrays.
@@ -150,16 +212,93 @@ public:
    * Depending on what is passed as input, it may computes scroes fo a subtree
    * or the whole tree.
    *
-   * @param iBitsets The vector of bitset arrays to use.
-   * @param iScores  The vector of score arrays to use.
-   * @param oBitsets The bitset array where to store the resulting bitsets.
-   * @param oScores  The score array where to write the resulting scores.
+   * @param iBitsets   The vector of bitset arrays to use.
+   * @param iScores    The scores of the corresponding subtrees.
+   * @param oBitsets   The bitset array where to store the resulting bitsets.
+   * @param oScore     Where to write the resulting (weighted) score.
+   * @param siteScores If not null, the (unweighted) score increment of each distinct site is added to this array.
+   */
+  void computeScoresFromArrays(
+    const std::vector<const std::vector<ParsimonyWord>*>& iBitsets,
+    const std::vector<unsigned int>& iScores,
+    std::vector<ParsimonyWord>& oBitsets,
+    unsigned int& oScore,
+    std::vector<unsigned int>* siteScores = 0) const;
+
+  /**
+   * @name Subtree rearrangements.
+   *
+   * See SubtreeRearrangement for a description of SPR and TBR moves.
+   *
+   * Candidate rearrangements are scored from the arrays of the current tree: only the
+   * arrays of the remaining tree pointing toward the pruning point have to be computed,
+   * which is done incrementally while visiting branches at increasing distances.
+   * Each regrafting hence costs O(sites) instead of a full new computation.
+   *
+   * @{
+   */
+
+  /**
+   * @brief Description of a subtree rearrangement.
+   */
+  typedef SubtreeRearrangement Rearrangement;
+
+  /**
+   * @brief Find the best rearrangement of the subtree defined by a node, without performing it.
+   *
+   * @param nodeId The root of the subtree to prune. Its father must have three neighbors.
+   * @param radius The maximum number of branches between the pruning point and the
+   * regrafting branch (and between the root of the pruned subtree and its rerooting branch for TBR).
+   * A radius of 1 is equivalent to NNIs.
+   * @param tbr    Tell if the pruned subtree can be rerooted (TBR) or not (SPR).
+   * @return The best rearrangement found, which is not valid if no rearrangement was possible.
+   * @throw NodeException If the node is the root node.
+   */
+  Rearrangement testRearrangements(int nodeId, unsigned int radius, bool tbr = false) const throw (NodeException);
+
+  /**
+   * @brief Perform a rearrangement and update all scores.
+   *
+   * @param rearrangement A rearrangement as returned by testRearrangements().
+   * @throw NodeException If the rearrangement does not match the current tree.
+   */
+  void doRearrangement(const Rearrangement& rearrangement) throw (NodeException);
+  /** @} */
+
+  /**
+   * @name Leaf insertion.
+   *
+   * Sequences of the data set which are not in the tree can be added one at a time,
+   * for instance to build a starting tree by stepwise addition.
+   * Each insertion is scored from the arrays of the current tree, in O(sites).
+   *
+   * @{
+   */
+
+  /**
+   * @brief Compute the score of the tree with a new leaf inserted on each branch.
+   *
+   * @param name    The name of the sequence to insert. It must be in the data set
+   * used to build this object, and must not be in the tree.
+   * @param nodeIds [out] The branches where the leaf is inserted, defined by their lower node.
+   * @return The scores of the resulting trees, in the same order as nodeIds.
+   * @throw SequenceNotFoundException If the sequence is not in the data set.
+   */
+  std::vector<unsigned int> testLeafInsertions(const std::string& name, std::vector<int>& nodeIds) const throw (Exception);
+
+  /**
+   * @brief Insert a new leaf on a branch and update all scores.
+   *
+   * A new inner node is created on the branch, and the new leaf is attached to it.
+   * The sequence is also appended to the data set of this object.
+   *
+   * @param name   The name of the sequence to insert, as in testLeafInsertions().
+   * @param nodeId The lower node of the branch where to insert the leaf.
+   * @throw NodeException If the node is the root node.
+   * @throw SequenceNotFoundException If the sequence is not in the data set.
    */
-  static void computeScoresFromArrays(
-    const std::vector<const std::vector<Bitset>*>& iBitsets,
-    const std::vector<const std::vector<unsigned int>*>& iScores,
-    std::vector<Bitset>& oBitsets,
-    std::vector<unsigned int>& oScores);
+  void doLeafInsertion(const std::string& name, int nodeId) throw (Exception);
+  /** @} */
 
   /**
    * @name Thee NNISearchable interface.
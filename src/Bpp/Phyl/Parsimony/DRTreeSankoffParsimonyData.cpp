@@ -0,0 +1,244 @@
+//
+// File: DRTreeSankoffParsimonyData.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#include "DRTreeSankoffParsimonyData.h"
+#include "../SitePatterns.h"
+
+// From SeqLib:
+#include <Bpp/Seq/Container/AlignedSequenceContainer.h>
+
+// From the STL:
+#include <limits>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+const size_t DRTreeSankoffParsimonyData::SITES_PER_BLOCK;
+
+/******************************************************************************/
+
+DRTreeSankoffParsimonyData::DRTreeSankoffParsimonyData(const DRTreeSankoffParsimonyData& data) :
+  AbstractTreeParsimonyData(data),
+  nodeData_(data.nodeData_),
+  leafData_(data.leafData_),
+  rootCosts_(data.rootCosts_),
+  rootScores_(data.rootScores_),
+  rootWeightedScore_(data.rootWeightedScore_),
+  shrunkData_(0),
+  nbSites_(data.nbSites_),
+  nbStates_(data.nbStates_),
+  nbDistinctSites_(data.nbDistinctSites_),
+  nbBlocks_(data.nbBlocks_)
+{
+  if (data.shrunkData_)
+    shrunkData_ = dynamic_cast<SiteContainer*>(data.shrunkData_->clone());
+  else
+    shrunkData_ = 0;
+}
+
+/******************************************************************************/
+
+DRTreeSankoffParsimonyData& DRTreeSankoffParsimonyData::operator=(const DRTreeSankoffParsimonyData& data)
+{
+  AbstractTreeParsimonyData::operator=(data);
+  nodeData_          = data.nodeData_;
+  leafData_          = data.leafData_;
+  rootCosts_         = data.rootCosts_;
+  rootScores_        = data.rootScores_;
+  rootWeightedScore_ = data.rootWeightedScore_;
+  if (shrunkData_) delete shrunkData_;
+  if (data.shrunkData_)
+    shrunkData_ = dynamic_cast<SiteContainer*>(data.shrunkData_->clone());
+  else
+    shrunkData_ = 0;
+  nbSites_         = data.nbSites_;
+  nbStates_        = data.nbStates_;
+  nbDistinctSites_ = data.nbDistinctSites_;
+  nbBlocks_        = data.nbBlocks_;
+  return *this;
+}
+
+/******************************************************************************/
+void DRTreeSankoffParsimonyData::init(const SiteContainer& sites, const StateMap& stateMap) throw (Exception)
+{
+  nbStates_         = stateMap.getNumberOfModelStates();
+  nbSites_          = sites.getNumberOfSites();
+  SitePatterns pattern(&sites);
+  if (shrunkData_) delete shrunkData_;
+  shrunkData_       = pattern.getSites();
+  rootWeights_      = pattern.getWeights();
+  rootPatternLinks_ = pattern.getIndices();
+  nbDistinctSites_  = shrunkData_->getNumberOfSites();
+  nbBlocks_         = (nbDistinctSites_ + SITES_PER_BLOCK - 1) / SITES_PER_BLOCK;
+
+  // Init data:
+  // Clone data for more efficiency on sequences access:
+  const SiteContainer* sequences = new AlignedSequenceContainer(*shrunkData_);
+  init(getTreeP_()->getRootNode(), *sequences, stateMap);
+  delete sequences;
+
+  // Now initialize root arrays:
+  rootCosts_.resize(getCostsArraySize());
+  rootScores_.resize(nbDistinctSites_);
+  rootWeightedScore_ = 0;
+}
+
+/******************************************************************************/
+void DRTreeSankoffParsimonyData::init(const Node* node, const SiteContainer& sites, const StateMap& stateMap) throw (Exception)
+{
+  const Alphabet* alphabet = sites.getAlphabet();
+  if (node->isLeaf())
+  {
+    const Sequence* seq;
+    try
+    {
+      seq = &sites.getSequence(node->getName());
+    }
+    catch (SequenceNotFoundException& snfe)
+    {
+      throw SequenceNotFoundException("DRTreeSankoffParsimonyData:init(node, sites). Leaf name in tree not found in site container: ", (node->getName()));
+    }
+    DRTreeSankoffParsimonyLeafData* leafData = &leafData_[node->getId()];
+    vector<double>* leafData_costs = &leafData->getCostsArray();
+    leafData->setNode(node);
+
+    // Model states corresponding to each alphabet state, as large alphabets have many of them:
+    map<int, vector<size_t> > modelStates;
+    for (size_t s = 0; s < nbStates_; s++)
+    {
+      modelStates[stateMap.getAlphabetStateAsInt(s)].push_back(s);
+    }
+
+    // Padding sites have a null cost for all states:
+    leafData_costs->assign(getCostsArraySize(), 0);
+    vector<bool> compatible(nbStates_);
+    for (size_t i = 0; i < nbDistinctSites_; i++)
+    {
+      size_t block = i / SITES_PER_BLOCK;
+      double* leafData_costs_i = &(*leafData_costs)[block * nbStates_ * SITES_PER_BLOCK + i % SITES_PER_BLOCK];
+      // Costs are null for states compatible with the character of the sequence, and infinite otherwise:
+      compatible.assign(nbStates_, false);
+      bool any = false;
+      int state = seq->getValue(i);
+      vector<int> states = alphabet->getAlias(state);
+      for (size_t j = 0; j < states.size(); j++)
+      {
+        map<int, vector<size_t> >::const_iterator it = modelStates.find(states[j]);
+        if (it == modelStates.end()) continue;
+        for (size_t s = 0; s < it->second.size(); s++)
+        {
+          compatible[it->second[s]] = true;
+          any = true;
+        }
+      }
+      // Characters with no corresponding state (gaps, if they are not a state) are considered as unknown:
+      if (!any) continue;
+      for (size_t s = 0; s < nbStates_; s++)
+      {
+        if (!compatible[s])
+          leafData_costs_i[s * SITES_PER_BLOCK] = numeric_limits<double>::infinity();
+      }
+    }
+  }
+  else
+  {
+    DRTreeSankoffParsimonyNodeData* nodeData = &nodeData_[node->getId()];
+    nodeData->setNode(node);
+    nodeData->eraseNeighborArrays();
+
+    int nbSons = static_cast<int>(node->getNumberOfSons());
+
+    for (int n = (node->hasFather() ? -1 : 0); n < nbSons; n++)
+    {
+      const Node* neighbor = (*node)[n];
+      nodeData->getCostsArrayForNeighbor(neighbor->getId()).resize(getCostsArraySize());
+    }
+  }
+
+  // We initialize each son node:
+  size_t nbSonNodes = node->getNumberOfSons();
+  for (unsigned int l = 0; l < nbSonNodes; l++)
+  {
+    // For each son node,
+    init(node->getSon(l), sites, stateMap);
+  }
+}
+
+/******************************************************************************/
+void DRTreeSankoffParsimonyData::reInit() throw (Exception)
+{
+  reInit(getTreeP_()->getRootNode());
+}
+
+/******************************************************************************/
+void DRTreeSankoffParsimonyData::reInit(const Node* node) throw (Exception)
+{
+  if (node->isLeaf())
+  {
+    return;
+  }
+  else
+  {
+    DRTreeSankoffParsimonyNodeData* nodeData = &nodeData_[node->getId()];
+    nodeData->setNode(node);
+    nodeData->eraseNeighborArrays();
+
+    int nbSons = static_cast<int>(node->getNumberOfSons());
+
+    for (int n = (node->hasFather() ? -1 : 0); n < nbSons; n++)
+    {
+      const Node* neighbor = (*node)[n];
+      nodeData->getCostsArrayForNeighbor(neighbor->getId()).resize(getCostsArraySize());
+    }
+  }
+
+  // We initialize each son node:
+  size_t nbSonNodes = node->getNumberOfSons();
+  for (unsigned int l = 0; l < nbSonNodes; l++)
+  {
+    // For each son node,
+    reInit(node->getSon(l));
+  }
+}
+
+/******************************************************************************/
+
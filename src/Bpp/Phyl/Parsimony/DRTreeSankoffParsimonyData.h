@@ -0,0 +1,324 @@
+//
+// File: DRTreeSankoffParsimonyData.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#ifndef _DRTREESANKOFFPARSIMONYDATA_H_
+#define _DRTREESANKOFFPARSIMONYDATA_H_
+
+#include "AbstractTreeParsimonyData.h"
+#include "../Model/StateMap.h"
+
+// From SeqLib
+#include <Bpp/Seq/Container/SiteContainer.h>
+
+// From the STL:
+#include <map>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Sankoff parsimony data structure for a node.
+ *
+ * This class is for use with the DRTreeSankoffParsimonyData class.
+ *
+ * Store for each neighbor node a vector of costs, that is, for each site and each state
+ * of the neighbor, the minimum cost of the subtree on the neighbor side.
+ *
+ * @see DRTreeSankoffParsimonyData
+ */
+class DRTreeSankoffParsimonyNodeData :
+  public TreeParsimonyNodeData
+{
+private:
+  mutable std::map<int, std::vector<double> > nodeCosts_;
+  const Node* node_;
+
+public:
+  DRTreeSankoffParsimonyNodeData() :
+    nodeCosts_(),
+    node_(0)
+  {}
+
+  DRTreeSankoffParsimonyNodeData(const DRTreeSankoffParsimonyNodeData& tpnd) :
+    nodeCosts_(tpnd.nodeCosts_),
+    node_(tpnd.node_)
+  {}
+
+  DRTreeSankoffParsimonyNodeData& operator=(const DRTreeSankoffParsimonyNodeData& tpnd)
+  {
+    nodeCosts_ = tpnd.nodeCosts_;
+    node_      = tpnd.node_;
+    return *this;
+  }
+
+  DRTreeSankoffParsimonyNodeData* clone() const { return new DRTreeSankoffParsimonyNodeData(*this); }
+
+public:
+  const Node* getNode() const { return node_; }
+
+  void setNode(const Node* node) { node_ = node; }
+
+  std::vector<double>& getCostsArrayForNeighbor(int neighborId)
+  {
+    return nodeCosts_[neighborId];
+  }
+  const std::vector<double>& getCostsArrayForNeighbor(int neighborId) const
+  {
+    return nodeCosts_[neighborId];
+  }
+
+  bool isNeighbor(int neighborId) const
+  {
+    return nodeCosts_.find(neighborId) != nodeCosts_.end();
+  }
+
+  void eraseNeighborArrays()
+  {
+    nodeCosts_.erase(nodeCosts_.begin(), nodeCosts_.end());
+  }
+};
+
+/**
+ * @brief Sankoff parsimony data structure for a leaf.
+ *
+ * This class is for use with the DRTreeSankoffParsimonyData class.
+ *
+ * Store the vector of costs associated to a leaf: 0 for the states
+ * compatible with the observed character, infinity otherwise.
+ *
+ * @see DRTreeSankoffParsimonyData
+ */
+class DRTreeSankoffParsimonyLeafData :
+  public TreeParsimonyNodeData
+{
+private:
+  mutable std::vector<double> leafCosts_;
+  const Node* leaf_;
+
+public:
+  DRTreeSankoffParsimonyLeafData() :
+    leafCosts_(),
+    leaf_(0)
+  {}
+
+  DRTreeSankoffParsimonyLeafData(const DRTreeSankoffParsimonyLeafData& tpld) :
+    leafCosts_(tpld.leafCosts_),
+    leaf_(tpld.leaf_)
+  {}
+
+  DRTreeSankoffParsimonyLeafData& operator=(const DRTreeSankoffParsimonyLeafData& tpld)
+  {
+    leafCosts_ = tpld.leafCosts_;
+    leaf_      = tpld.leaf_;
+    return *this;
+  }
+
+  DRTreeSankoffParsimonyLeafData* clone() const { return new DRTreeSankoffParsimonyLeafData(*this); }
+
+public:
+  const Node* getNode() const { return leaf_; }
+  void setNode(const Node* node) { leaf_ = node; }
+
+  std::vector<double>& getCostsArray()
+  {
+    return leafCosts_;
+  }
+  const std::vector<double>& getCostsArray() const
+  {
+    return leafCosts_;
+  }
+};
+
+/**
+ * @brief Sankoff parsimony data structure for double-recursive (DR) algorithm.
+ *
+ * Costs are stored by blocks of SITES_PER_BLOCK sites: an array of costs for n states
+ * is stored as [block][state][site], so that the min-plus products of the Sankoff
+ * algorithm are computed on contiguous sites, in a way compilers can vectorize.
+ * For each inner node in the tree, we store a DRTreeSankoffParsimonyNodeData object in nodeData_.
+ * For each leaf node in the tree, we store a DRTreeSankoffParsimonyLeafData object in leafData_.
+ *
+ * The dataset is first compressed, removing all identical sites.
+ * The resulting dataset is stored in shrunkData_.
+ * The corresponding positions are stored in rootPatternLinks_, inherited from AbstractTreeParsimonyData.
+ * The last block is padded with sites where all states have a null cost.
+ */
+class DRTreeSankoffParsimonyData :
+  public AbstractTreeParsimonyData
+{
+public:
+  /**
+   * @brief The number of sites in a block.
+   */
+  static const size_t SITES_PER_BLOCK = 8;
+
+private:
+  mutable std::map<int, DRTreeSankoffParsimonyNodeData> nodeData_;
+  mutable std::map<int, DRTreeSankoffParsimonyLeafData> leafData_;
+  mutable std::vector<double> rootCosts_;
+  mutable std::vector<double> rootScores_;
+  mutable double rootWeightedScore_;
+  SiteContainer* shrunkData_;
+  size_t nbSites_;
+  size_t nbStates_;
+  size_t nbDistinctSites_;
+  size_t nbBlocks_;
+
+public:
+  DRTreeSankoffParsimonyData(const TreeTemplate<Node>* tree) :
+    AbstractTreeParsimonyData(tree),
+    nodeData_(),
+    leafData_(),
+    rootCosts_(),
+    rootScores_(),
+    rootWeightedScore_(0),
+    shrunkData_(0),
+    nbSites_(0),
+    nbStates_(0),
+    nbDistinctSites_(0),
+    nbBlocks_(0)
+  {}
+
+  DRTreeSankoffParsimonyData(const DRTreeSankoffParsimonyData& data);
+
+  DRTreeSankoffParsimonyData& operator=(const DRTreeSankoffParsimonyData& data);
+
+  virtual ~DRTreeSankoffParsimonyData() { delete shrunkData_; }
+
+  DRTreeSankoffParsimonyData* clone() const { return new DRTreeSankoffParsimonyData(*this); }
+
+public:
+  /**
+   * @brief Set the tree associated to the data.
+   *
+   * All node data will be actualized accordingly by calling the setNode() method on the corresponding nodes.
+   * @warning: the old tree and the new tree must be two clones! And particularly, they have to share the
+   * same topology and nodes id.
+   *
+   * @param tree The tree to be associated to this data.
+   */
+  void setTree(const TreeTemplate<Node>* tree)
+  {
+    AbstractTreeParsimonyData::setTreeP_(tree);
+    for (std::map<int, DRTreeSankoffParsimonyNodeData>::iterator it = nodeData_.begin(); it != nodeData_.end(); it++)
+    {
+      int id = it->second.getNode()->getId();
+      it->second.setNode(tree_->getNode(id));
+    }
+    for (std::map<int, DRTreeSankoffParsimonyLeafData>::iterator it = leafData_.begin(); it != leafData_.end(); it++)
+    {
+      int id = it->second.getNode()->getId();
+      it->second.setNode(tree_->getNode(id));
+    }
+  }
+
+  DRTreeSankoffParsimonyNodeData& getNodeData(int nodeId)
+  {
+    return nodeData_[nodeId];
+  }
+  const DRTreeSankoffParsimonyNodeData& getNodeData(int nodeId) const
+  {
+    return nodeData_[nodeId];
+  }
+
+  DRTreeSankoffParsimonyLeafData& getLeafData(int nodeId)
+  {
+    return leafData_[nodeId];
+  }
+  const DRTreeSankoffParsimonyLeafData& getLeafData(int nodeId) const
+  {
+    return leafData_[nodeId];
+  }
+
+  std::vector<double>& getCostsArray(int nodeId, int neighborId)
+  {
+    return nodeData_[nodeId].getCostsArrayForNeighbor(neighborId);
+  }
+  const std::vector<double>& getCostsArray(int nodeId, int neighborId) const
+  {
+    return nodeData_[nodeId].getCostsArrayForNeighbor(neighborId);
+  }
+
+  size_t getArrayPosition(int parentId, int sonId, size_t currentPosition) const
+  {
+    return currentPosition;
+  }
+
+  std::vector<double>& getRootCosts() { return rootCosts_; }
+  const std::vector<double>& getRootCosts() const { return rootCosts_; }
+
+  /**
+   * @return The score of each distinct site.
+   */
+  std::vector<double>& getRootScores() { return rootScores_; }
+  const std::vector<double>& getRootScores() const { return rootScores_; }
+  double getRootScore(size_t i) const { return rootScores_[i]; }
+
+  /**
+   * @return The total score, that is, the sum of the scores of all sites.
+   */
+  double& getRootWeightedScore() { return rootWeightedScore_; }
+  double getRootWeightedScore() const { return rootWeightedScore_; }
+
+  size_t getNumberOfDistinctSites() const { return nbDistinctSites_; }
+  size_t getNumberOfSites() const { return nbSites_; }
+  size_t getNumberOfStates() const { return nbStates_; }
+
+  /**
+   * @return The number of blocks of sites.
+   */
+  size_t getNumberOfBlocks() const { return nbBlocks_; }
+
+  /**
+   * @return The size of an array of costs.
+   */
+  size_t getCostsArraySize() const { return nbBlocks_ * nbStates_ * SITES_PER_BLOCK; }
+
+  void init(const SiteContainer& sites, const StateMap& stateMap) throw (Exception);
+  void reInit() throw (Exception);
+
+protected:
+  void init(const Node* node, const SiteContainer& sites, const StateMap& stateMap) throw (Exception);
+  void reInit(const Node* node) throw (Exception);
+};
+} // end of namespace bpp.
+
+#endif // _DRTREESANKOFFPARSIMONYDATA_H_
+
@@ -0,0 +1,550 @@
+//
+// File: DRTreeSankoffParsimonyScore.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#include "DRTreeSankoffParsimonyScore.h"
+#include "../PatternTools.h"
+#include "../TreeTemplateTools.h"
+#include <Bpp/App/ApplicationTools.h>
+#include <Bpp/Numeric/NumConstants.h>
+#include <Bpp/Seq/Alphabet/AlphabetExceptions.h>
+
+// From the STL:
+#include <cmath>
+#include <memory>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+DRTreeSankoffParsimonyScore::DRTreeSankoffParsimonyScore(
+  const Tree& tree,
+  const SiteContainer& data,
+  const Matrix<double>& costs,
+  bool verbose,
+  bool includeGaps)
+throw (Exception) :
+  tree_(0),
+  statesMap_(0),
+  nbStates_(0),
+  costs_(),
+  parsimonyData_(0),
+  nbDistinctSites_(0)
+{
+  // The object is only responsible for its members once fully built:
+  unique_ptr< TreeTemplate<Node> > treeGuard(new TreeTemplate<Node>(tree));
+  unique_ptr<StateMap> statesMapGuard(new CanonicalStateMap(data.getAlphabet(), includeGaps));
+  tree_      = treeGuard.get();
+  statesMap_ = statesMapGuard.get();
+  nbStates_  = statesMap_->getNumberOfModelStates();
+  if (costs.getNumberOfRows() != nbStates_ || costs.getNumberOfColumns() != nbStates_)
+    throw DimensionException("DRTreeSankoffParsimonyScore. The cost matrix must have one row and one column per state.", costs.getNumberOfRows(), nbStates_);
+  costs_.resize(nbStates_ * nbStates_);
+  for (size_t i = 0; i < nbStates_; i++)
+  {
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      costs_[i * nbStates_ + j] = costs(i, j);
+    }
+  }
+  init_(data, verbose);
+  treeGuard.release();
+  statesMapGuard.release();
+}
+
+DRTreeSankoffParsimonyScore::DRTreeSankoffParsimonyScore(
+  const Tree& tree,
+  const SiteContainer& data,
+  const Matrix<double>& costs,
+  StateMap* statesMap,
+  bool verbose)
+throw (Exception) :
+  tree_(0),
+  statesMap_(0),
+  nbStates_(0),
+  costs_(),
+  parsimonyData_(0),
+  nbDistinctSites_(0)
+{
+  // The object is only responsible for its members once fully built:
+  unique_ptr<StateMap> statesMapGuard(statesMap);
+  unique_ptr< TreeTemplate<Node> > treeGuard(new TreeTemplate<Node>(tree));
+  tree_      = treeGuard.get();
+  statesMap_ = statesMapGuard.get();
+  nbStates_  = statesMap_->getNumberOfModelStates();
+  if (costs.getNumberOfRows() != nbStates_ || costs.getNumberOfColumns() != nbStates_)
+    throw DimensionException("DRTreeSankoffParsimonyScore. The cost matrix must have one row and one column per state.", costs.getNumberOfRows(), nbStates_);
+  costs_.resize(nbStates_ * nbStates_);
+  for (size_t i = 0; i < nbStates_; i++)
+  {
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      costs_[i * nbStates_ + j] = costs(i, j);
+    }
+  }
+  init_(data, verbose);
+  treeGuard.release();
+  statesMapGuard.release();
+}
+
+DRTreeSankoffParsimonyScore::DRTreeSankoffParsimonyScore(
+  const Tree& tree,
+  const SiteContainer& data,
+  const AlphabetIndex2& index,
+  bool verbose)
+throw (Exception) :
+  tree_(0),
+  statesMap_(0),
+  nbStates_(0),
+  costs_(),
+  parsimonyData_(0),
+  nbDistinctSites_(0)
+{
+  if (index.getAlphabet()->getAlphabetType() != data.getAlphabet()->getAlphabetType())
+    throw AlphabetMismatchException("DRTreeSankoffParsimonyScore. Data and index must have the same alphabet type.", data.getAlphabet(), index.getAlphabet());
+  // The object is only responsible for its members once fully built:
+  unique_ptr< TreeTemplate<Node> > treeGuard(new TreeTemplate<Node>(tree));
+  unique_ptr<StateMap> statesMapGuard(new CanonicalStateMap(data.getAlphabet(), false));
+  tree_      = treeGuard.get();
+  statesMap_ = statesMapGuard.get();
+  nbStates_  = statesMap_->getNumberOfModelStates();
+  costs_.resize(nbStates_ * nbStates_);
+  for (size_t i = 0; i < nbStates_; i++)
+  {
+    for (size_t j = 0; j < nbStates_; j++)
+    {
+      costs_[i * nbStates_ + j] = index.getIndex(statesMap_->getAlphabetStateAsInt(i), statesMap_->getAlphabetStateAsInt(j));
+    }
+  }
+  init_(data, verbose);
+  treeGuard.release();
+  statesMapGuard.release();
+}
+
+void DRTreeSankoffParsimonyScore::init_(const SiteContainer& data, bool verbose) throw (Exception)
+{
+  for (size_t i = 0; i < nbStates_; i++)
+  {
+    for (size_t j = 0; j < i; j++)
+    {
+      if (abs(costs_[i * nbStates_ + j] - costs_[j * nbStates_ + i]) > NumConstants::TINY())
+        throw Exception("DRTreeSankoffParsimonyScore::init_. The cost matrix must be symmetric.");
+    }
+  }
+  if (tree_->isRooted())
+  {
+    if (verbose)
+      ApplicationTools::displayWarning("Tree has been unrooted.");
+    tree_->unroot();
+  }
+  TreeTemplateTools::deleteBranchLengths(*tree_->getRootNode());
+
+  if (verbose)
+    ApplicationTools::displayTask("Initializing data structure");
+  unique_ptr<DRTreeSankoffParsimonyData> parsimonyData(new DRTreeSankoffParsimonyData(tree_));
+  parsimonyData_ = parsimonyData.get();
+  parsimonyData_->init(data, *statesMap_);
+  nbDistinctSites_ = parsimonyData_->getNumberOfDistinctSites();
+  computeScores();
+  parsimonyData.release();
+  if (verbose)
+    ApplicationTools::displayTaskDone();
+  if (verbose)
+    ApplicationTools::displayResult("Number of distinct sites",
+                                    TextTools::toString(nbDistinctSites_));
+}
+
+/******************************************************************************/
+
+DRTreeSankoffParsimonyScore::DRTreeSankoffParsimonyScore(const DRTreeSankoffParsimonyScore& tp) :
+  tree_(tp.tree_->clone()),
+  statesMap_(tp.statesMap_->clone()),
+  nbStates_(tp.nbStates_),
+  costs_(tp.costs_),
+  parsimonyData_(tp.parsimonyData_->clone()),
+  nbDistinctSites_(tp.nbDistinctSites_)
+{
+  parsimonyData_->setTree(tree_);
+}
+
+/******************************************************************************/
+
+DRTreeSankoffParsimonyScore& DRTreeSankoffParsimonyScore::operator=(const DRTreeSankoffParsimonyScore& tp)
+{
+  if (this != &tp)
+  {
+    delete tree_;
+    delete statesMap_;
+    delete parsimonyData_;
+    tree_            = tp.tree_->clone();
+    statesMap_       = tp.statesMap_->clone();
+    nbStates_        = tp.nbStates_;
+    costs_           = tp.costs_;
+    parsimonyData_   = tp.parsimonyData_->clone();
+    parsimonyData_->setTree(tree_);
+    nbDistinctSites_ = tp.nbDistinctSites_;
+  }
+  return *this;
+}
+
+/******************************************************************************/
+
+DRTreeSankoffParsimonyScore::~DRTreeSankoffParsimonyScore()
+{
+  delete parsimonyData_;
+  delete statesMap_;
+  delete tree_;
+}
+
+/******************************************************************************/
+void DRTreeSankoffParsimonyScore::computeScores()
+{
+  computeScoresPostorder(tree_->getRootNode());
+  computeScoresPreorder(tree_->getRootNode());
+  const Node* root = tree_->getRootNode();
+  const DRTreeSankoffParsimonyNodeData& pData = parsimonyData_->getNodeData(root->getId());
+  vector<const Node*> neighbors = root->getNeighbors();
+  vector< const vector<double>*> iCosts(neighbors.size());
+  for (size_t k = 0; k < neighbors.size(); k++)
+  {
+    iCosts[k] = &pData.getCostsArrayForNeighbor(neighbors[k]->getId());
+  }
+  computeCostsFromArrays(iCosts, parsimonyData_->getRootCosts());
+  parsimonyData_->getRootWeightedScore() = computeScoreFromCosts_(parsimonyData_->getRootCosts(), &parsimonyData_->getRootScores());
+}
+
+void DRTreeSankoffParsimonyScore::computeScoresPostorder(const Node* node)
+{
+  if (node->isLeaf()) return;
+  DRTreeSankoffParsimonyNodeData* pData = &parsimonyData_->getNodeData(node->getId());
+  for (unsigned int k = 0; k < node->getNumberOfSons(); k++)
+  {
+    const Node* son = node->getSon(k);
+    computeScoresPostorder(son);
+    vector<double>* costs = &pData->getCostsArrayForNeighbor(son->getId());
+    if (son->isLeaf())
+    {
+      // son has no NodeData associated, must use LeafData instead
+      *costs = parsimonyData_->getLeafData(son->getId()).getCostsArray();
+    }
+    else
+    {
+      const DRTreeSankoffParsimonyNodeData* sonData = &parsimonyData_->getNodeData(son->getId());
+      vector< const vector<double>*> iCosts;
+      for (unsigned int l = 0; l < son->getNumberOfSons(); l++)
+      {
+        iCosts.push_back(&sonData->getCostsArrayForNeighbor(son->getSon(l)->getId()));
+      }
+      computeCostsFromArrays(iCosts, *costs);
+    }
+  }
+}
+
+void DRTreeSankoffParsimonyScore::computeScoresPreorder(const Node* node)
+{
+  if (node->getNumberOfSons() == 0) return;
+  DRTreeSankoffParsimonyNodeData* pData = &parsimonyData_->getNodeData(node->getId());
+  if (node->hasFather())
+  {
+    const Node* father = node->getFather();
+    vector<double>* costs = &pData->getCostsArrayForNeighbor(father->getId());
+    if (father->isLeaf())
+    {
+      *costs = parsimonyData_->getLeafData(father->getId()).getCostsArray();
+    }
+    else
+    {
+      const DRTreeSankoffParsimonyNodeData* fatherData = &parsimonyData_->getNodeData(father->getId());
+      vector<const Node*> neighbors = father->getNeighbors();
+      vector< const vector<double>*> iCosts;
+      for (size_t k = 0; k < neighbors.size(); k++)
+      {
+        if (neighbors[k] != node)
+          iCosts.push_back(&fatherData->getCostsArrayForNeighbor(neighbors[k]->getId()));
+      }
+      computeCostsFromArrays(iCosts, *costs);
+    }
+  }
+  // Recurse call:
+  for (unsigned int k = 0; k < node->getNumberOfSons(); k++)
+  {
+    computeScoresPreorder(node->getSon(k));
+  }
+}
+
+/******************************************************************************/
+void DRTreeSankoffParsimonyScore::computeCostsFromArrays(
+  const vector<const vector<double>*>& iCosts,
+  vector<double>& oCosts) const
+{
+  if (iCosts.size() < 1)
+    throw Exception("DRTreeSankoffParsimonyScore::computeCostsFromArrays(); Error, input arrays must have a size >= 1.");
+  oCosts.assign(parsimonyData_->getCostsArraySize(), 0.);
+  for (size_t k = 0; k < iCosts.size(); k++)
+  {
+    addMinPlusProduct_(iCosts[k]->data(), oCosts.data());
+  }
+}
+
+void DRTreeSankoffParsimonyScore::addMinPlusProduct_(const double* in, double* out) const
+{
+  const size_t nbSites = DRTreeSankoffParsimonyData::SITES_PER_BLOCK;
+  size_t nbBlocks = parsimonyData_->getNumberOfBlocks();
+  double m[nbSites];
+  for (size_t b = 0; b < nbBlocks; b++)
+  {
+    const double* in_b = in + b * nbStates_ * nbSites;
+    double* out_b = out + b * nbStates_ * nbSites;
+    for (size_t x = 0; x < nbStates_; x++)
+    {
+      const double* costs_x = &costs_[x * nbStates_];
+      // Loops on sites have a fixed length, and are vectorized by the compiler:
+      for (size_t i = 0; i < nbSites; i++)
+      {
+        m[i] = costs_x[0] + in_b[i];
+      }
+      for (size_t y = 1; y < nbStates_; y++)
+      {
+        const double c = costs_x[y];
+        const double* in_b_y = in_b + y * nbSites;
+        for (size_t i = 0; i < nbSites; i++)
+        {
+          double v = c + in_b_y[i];
+          m[i] = (v < m[i] ? v : m[i]);
+        }
+      }
+      double* out_b_x = out_b + x * nbSites;
+      for (size_t i = 0; i < nbSites; i++)
+      {
+        out_b_x[i] += m[i];
+      }
+    }
+  }
+}
+
+double DRTreeSankoffParsimonyScore::computeScoreFromCosts_(const vector<double>& costs, vector<double>* siteScores) const
+{
+  const size_t nbSites = DRTreeSankoffParsimonyData::SITES_PER_BLOCK;
+  if (siteScores)
+    siteScores->resize(nbDistinctSites_);
+  double score = 0;
+  for (size_t i = 0; i < nbDistinctSites_; i++)
+  {
+    const double* costs_i = &costs[(i / nbSites) * nbStates_ * nbSites + i % nbSites];
+    double m = costs_i[0];
+    for (size_t x = 1; x < nbStates_; x++)
+    {
+      if (costs_i[x * nbSites] < m) m = costs_i[x * nbSites];
+    }
+    if (siteScores)
+      (*siteScores)[i] = m;
+    score += m * parsimonyData_->getWeight(i);
+  }
+  return score;
+}
+
+/******************************************************************************/
+double DRTreeSankoffParsimonyScore::getScore() const
+{
+  return parsimonyData_->getRootWeightedScore();
+}
+
+/******************************************************************************/
+double DRTreeSankoffParsimonyScore::getScoreForSite(size_t site) const
+{
+  return parsimonyData_->getRootScore(parsimonyData_->getRootArrayPosition(site));
+}
+
+/******************************************************************************/
+Vdouble DRTreeSankoffParsimonyScore::getScoreForEachSite() const
+{
+  Vdouble scores(parsimonyData_->getNumberOfSites());
+  for (size_t i = 0; i < scores.size(); i++)
+  {
+    scores[i] = getScoreForSite(i);
+  }
+  return scores;
+}
+
+/******************************************************************************/
+double DRTreeSankoffParsimonyScore::testNNI(int nodeId) const throw (NodeException)
+{
+  const Node* son = tree_->getNode(nodeId);
+  if (!son->hasFather()) throw NodePException("DRTreeSankoffParsimonyScore::testNNI(). Node 'son' must not be the root node.", son);
+  const Node* parent = son->getFather();
+  if (!parent->hasFather()) throw NodePException("DRTreeSankoffParsimonyScore::testNNI(). Node 'parent' must not be the root node.", parent);
+  const Node* grandFather = parent->getFather();
+  // From here: Bifurcation assumed.
+  // In case of multifurcation, an arbitrary uncle is chosen.
+  size_t parentPosition = grandFather->getSonPosition(parent);
+  const Node* uncle = grandFather->getSon(parentPosition > 1 ? parentPosition - 1 : 1 - parentPosition);
+
+  // Compute costs for grand-father node, with son instead of uncle:
+  const DRTreeSankoffParsimonyNodeData* grandFatherData = &parsimonyData_->getNodeData(grandFather->getId());
+  vector<const Node*> grandFatherNeighbors = TreeTemplateTools::getRemainingNeighbors(grandFather, parent, uncle);
+  vector< const vector<double>*> grandFatherCosts;
+  for (size_t k = 0; k < grandFatherNeighbors.size(); k++)
+  {
+    grandFatherCosts.push_back(&grandFatherData->getCostsArrayForNeighbor(grandFatherNeighbors[k]->getId()));
+  }
+  const DRTreeSankoffParsimonyNodeData* parentData = &parsimonyData_->getNodeData(parent->getId());
+  grandFatherCosts.push_back(&parentData->getCostsArrayForNeighbor(son->getId()));
+  vector<double> gfCosts;
+  computeCostsFromArrays(grandFatherCosts, gfCosts);
+
+  // Now computes costs for parent node, with uncle instead of son:
+  vector<const Node*> parentNeighbors = TreeTemplateTools::getRemainingNeighbors(parent, grandFather, son);
+  vector< const vector<double>*> parentCosts;
+  for (size_t k = 0; k < parentNeighbors.size(); k++)
+  {
+    parentCosts.push_back(&parentData->getCostsArrayForNeighbor(parentNeighbors[k]->getId()));
+  }
+  parentCosts.push_back(&grandFatherData->getCostsArrayForNeighbor(uncle->getId()));
+  parentCosts.push_back(&gfCosts);
+  vector<double> pCosts;
+  computeCostsFromArrays(parentCosts, pCosts);
+
+  // Final computation:
+  return computeScoreFromCosts_(pCosts) - getScore();
+}
+
+/******************************************************************************/
+void DRTreeSankoffParsimonyScore::doNNI(int nodeId) throw (NodeException)
+{
+  Node* son = tree_->getNode(nodeId);
+  if (!son->hasFather()) throw NodePException("DRTreeSankoffParsimonyScore::doNNI(). Node 'son' must not be the root node.", son);
+  Node* parent = son->getFather();
+  if (!parent->hasFather()) throw NodePException("DRTreeSankoffParsimonyScore::doNNI(). Node 'parent' must not be the root node.", parent);
+  Node* grandFather = parent->getFather();
+  // From here: Bifurcation assumed.
+  // In case of multifurcation, an arbitrary uncle is chosen.
+  size_t parentPosition = grandFather->getSonPosition(parent);
+  Node* uncle = grandFather->getSon(parentPosition > 1 ? parentPosition - 1 : 1 - parentPosition);
+  // Swap nodes:
+  parent->removeSon(son);
+  grandFather->removeSon(uncle);
+  parent->addSon(uncle);
+  grandFather->addSon(son);
+}
+
+/******************************************************************************/
+void DRTreeSankoffParsimonyScore::visitBranches_(
+  const Node* node,
+  const Node* from,
+  const vector<double>& costs,
+  unsigned int depth,
+  unsigned int radius,
+  const std::function<void (const Node*, const Node*, const vector<double>&)>& f) const
+{
+  if (depth > radius || node->isLeaf()) return;
+  const DRTreeSankoffParsimonyNodeData* pData = &parsimonyData_->getNodeData(node->getId());
+  vector<const Node*> neighbors = node->getNeighbors();
+  vector<double> xCosts;
+  for (size_t k = 0; k < neighbors.size(); k++)
+  {
+    const Node* son = neighbors[k];
+    if (son == from) continue;
+    // Subtree on the node side of the branch, not including the son:
+    vector< const vector<double>*> iCosts(1, &costs);
+    for (size_t j = 0; j < neighbors.size(); j++)
+    {
+      const Node* n = neighbors[j];
+      if (n != from && n != son)
+        iCosts.push_back(&pData->getCostsArrayForNeighbor(n->getId()));
+    }
+    computeCostsFromArrays(iCosts, xCosts);
+    f(node, son, xCosts);
+    visitBranches_(son, node, xCosts, depth + 1, radius, f);
+  }
+}
+
+/******************************************************************************/
+DRTreeSankoffParsimonyScore::Rearrangement DRTreeSankoffParsimonyScore::testRearrangements(int nodeId, unsigned int radius) const throw (NodeException)
+{
+  const Node* pruned = tree_->getNode(nodeId);
+  if (!pruned->hasFather()) throw NodePException("DRTreeSankoffParsimonyScore::testRearrangements(). Node must not be the root node.", pruned);
+  const Node* father = pruned->getFather();
+  Rearrangement best;
+  best.prunedNodeId = nodeId;
+  if (father->degree() != 3 || radius == 0) return best;
+  const DRTreeSankoffParsimonyNodeData* fatherData = &parsimonyData_->getNodeData(father->getId());
+  const vector<double>* prunedCosts = &fatherData->getCostsArrayForNeighbor(nodeId);
+
+  // Visit the remaining tree, with the father of the pruned subtree removed:
+  double bestScore = getScore();
+  vector<const Node*> neighbors = TreeTemplateTools::getRemainingNeighbors(father, pruned, pruned);
+  vector<double> costs;
+  for (size_t k = 0; k < 2; k++)
+  {
+    const Node* other = neighbors[1 - k];
+    visitBranches_(neighbors[k], father,
+      fatherData->getCostsArrayForNeighbor(other->getId()),
+      1, radius,
+      [&](const Node* x, const Node* y, const vector<double>& xCosts)
+      {
+        // The father of the pruned subtree is inserted on branch (x, y):
+        vector< const vector<double>*> iCosts(1, &xCosts);
+        iCosts.push_back(&parsimonyData_->getCostsArray(x->getId(), y->getId()));
+        iCosts.push_back(prunedCosts);
+        computeCostsFromArrays(iCosts, costs);
+        double score = computeScoreFromCosts_(costs);
+        if (!best.isValid() || score < bestScore)
+        {
+          bestScore = score;
+          best.regraftNodeId1 = x->getId();
+          best.regraftNodeId2 = y->getId();
+        }
+      });
+  }
+  if (best.isValid())
+    best.scoreDifference = bestScore - getScore();
+  return best;
+}
+
+/******************************************************************************/
+void DRTreeSankoffParsimonyScore::doRearrangement(const Rearrangement& rearrangement) throw (NodeException)
+{
+  rearrangement.apply(*tree_);
+  parsimonyData_->reInit();
+  computeScores();
+}
+
+/******************************************************************************/
+
@@ -0,0 +1,293 @@
+//
+// File: DRTreeSankoffParsimonyScore.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#ifndef _DRTREESANKOFFPARSIMONYSCORE_H_
+#define _DRTREESANKOFFPARSIMONYSCORE_H_
+
+#include "DRTreeSankoffParsimonyData.h"
+#include "../NNISearchable.h"
+#include "../SubtreeRearrangement.h"
+#include "../TreeTemplate.h"
+
+#include <Bpp/Numeric/VectorTools.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
+#include <Bpp/Seq/AlphabetIndex/AlphabetIndex2.h>
+#include <Bpp/Seq/Container/SiteContainer.h>
+
+// From the STL:
+#include <functional>
+
+namespace bpp
+{
+/**
+ * @brief Double recursive implementation of weighted (Sankoff) parsimony.
+ *
+ * Each change from state i to state j costs c(i, j), as given by a user-defined
+ * cost matrix or by an AlphabetIndex2 object. The score of a tree is the minimum
+ * total cost over all ancestral states. The cost matrix must be symmetric, so that
+ * the score does not depend on the root of the tree.
+ *
+ * Uses a DRTreeSankoffParsimonyData object for data storage. For each node
+ * and each neighbor, the minimum cost of the subtree on the neighbor side is
+ * stored for each state of the neighbor. The combination of an array through a
+ * branch is a min-plus product with the cost matrix, computed on blocks of contiguous
+ * sites (see DRTreeSankoffParsimonyData::SITES_PER_BLOCK), in a way compilers can vectorize.
+ *
+ * As for DRTreeParsimonyScore, NNIs and SPRs are scored from the arrays of the
+ * current tree, in O(sites) each.
+ */
+class DRTreeSankoffParsimonyScore :
+  public virtual NNISearchable
+{
+public:
+  typedef SubtreeRearrangement Rearrangement;
+
+private:
+  TreeTemplate<Node>* tree_;
+  StateMap* statesMap_;
+  size_t nbStates_;
+  std::vector<double> costs_;
+  DRTreeSankoffParsimonyData* parsimonyData_;
+  size_t nbDistinctSites_;
+
+public:
+  /**
+   * @param tree        The tree to use.
+   * @param data        The sequences to use.
+   * @param costs       The cost matrix, of size equal to the number of states (including gaps if includeGaps is true).
+   * @param verbose     Tell if some information should be displayed.
+   * @param includeGaps Tell if gaps must be considered as a state.
+   * @throw Exception If the cost matrix has a wrong size or is not symmetric.
+   */
+  DRTreeSankoffParsimonyScore(
+    const Tree& tree,
+    const SiteContainer& data,
+    const Matrix<double>& costs,
+    bool verbose = true,
+    bool includeGaps = false)
+  throw (Exception);
+
+  /**
+   * @param tree      The tree to use.
+   * @param data      The sequences to use.
+   * @param costs     The cost matrix, of size equal to the number of model states.
+   * @param statesMap The states map to use. This object will own it.
+   * @param verbose   Tell if some information should be displayed.
+   * @throw Exception If the cost matrix has a wrong size or is not symmetric.
+   */
+  DRTreeSankoffParsimonyScore(
+    const Tree& tree,
+    const SiteContainer& data,
+    const Matrix<double>& costs,
+    StateMap* statesMap,
+    bool verbose = true)
+  throw (Exception);
+
+  /**
+   * @brief Build a score with costs given by an index, such as a chemical distance between amino acids.
+   *
+   * Gaps are not considered as a state.
+   *
+   * @param tree    The tree to use.
+   * @param data    The sequences to use.
+   * @param index   The index giving the cost of each change.
+   * @param verbose Tell if some information should be displayed.
+   * @throw Exception If the index is not symmetric or has not the same alphabet as the data.
+   */
+  DRTreeSankoffParsimonyScore(
+    const Tree& tree,
+    const SiteContainer& data,
+    const AlphabetIndex2& index,
+    bool verbose = true)
+  throw (Exception);
+
+  DRTreeSankoffParsimonyScore(const DRTreeSankoffParsimonyScore& tp);
+
+  DRTreeSankoffParsimonyScore& operator=(const DRTreeSankoffParsimonyScore& tp);
+
+  virtual ~DRTreeSankoffParsimonyScore();
+
+  DRTreeSankoffParsimonyScore* clone() const { return new DRTreeSankoffParsimonyScore(*this); }
+
+private:
+  void init_(const SiteContainer& data, bool verbose) throw (Exception);
+
+  /**
+   * @brief Add the min-plus product of an array with the cost matrix to another array.
+   *
+   * For each site and each state x, out(x) += min_y [c(x, y) + in(y)].
+   *
+   * @param in  The costs for each state of a neighbor.
+   * @param out The costs to update, for each state of the node.
+   */
+  void addMinPlusProduct_(const double* in, double* out) const;
+
+  /**
+   * @brief Compute the score of each site and the weighted score from the costs at a node.
+   *
+   * @param costs      The costs of the whole tree for each state of a node.
+   * @param siteScores If not null, where to store the score of each distinct site.
+   * @return The weighted score.
+   */
+  double computeScoreFromCosts_(const std::vector<double>& costs, std::vector<double>* siteScores = 0) const;
+
+  /**
+   * @brief Visit all branches within a given radius in a subtree, with the arrays toward the starting point.
+   *
+   * For each branch (x, y), y being farther from the starting point, f(x, y, costs)
+   * is called, where costs describe the subtree on the x side of the branch, for each state of x.
+   *
+   * @param node   The node to start from.
+   * @param from   The neighbor of node not to visit.
+   * @param costs  The costs of the subtree on the from side.
+   * @param depth  The distance of the branches of node.
+   * @param radius The maximum distance.
+   * @param f      The function to call on each branch.
+   */
+  void visitBranches_(
+    const Node* node,
+    const Node* from,
+    const std::vector<double>& costs,
+    unsigned int depth,
+    unsigned int radius,
+    const std::function<void (const Node*, const Node*, const std::vector<double>&)>& f) const;
+
+protected:
+  /**
+   * @brief Compute all arrays and scores.
+   */
+  virtual void computeScores();
+  /**
+   * @brief Compute arrays (preorder algorithm).
+   */
+  virtual void computeScoresPreorder(const Node*);
+  /**
+   * @brief Compute arrays (postorder algorithm).
+   */
+  virtual void computeScoresPostorder(const Node*);
+
+public:
+  const Tree& getTree() const { return *tree_; }
+  const StateMap& getStateMap() const { return *statesMap_; }
+
+  /**
+   * @return The cost of a change from model state i to model state j.
+   */
+  double getCost(size_t i, size_t j) const { return costs_[i * nbStates_ + j]; }
+
+  /**
+   * @return The minimum total cost of changes in the tree.
+   */
+  double getScore() const;
+
+  /**
+   * @param site The corresponding site.
+   * @return The minimum total cost of changes in the tree for site 'site'.
+   */
+  double getScoreForSite(size_t site) const;
+
+  /**
+   * @return The minimum total cost of changes in the tree for each site.
+   */
+  Vdouble getScoreForEachSite() const;
+
+  /**
+   * @brief Compute costs from an array of arrays.
+   *
+   * @param iCosts The costs of the subtrees of the neighbors of a node.
+   * @param oCosts The resulting costs for each state of the node.
+   */
+  void computeCostsFromArrays(
+    const std::vector<const std::vector<double>*>& iCosts,
+    std::vector<double>& oCosts) const;
+
+  /**
+   * @name Subtree rearrangements.
+   *
+   * See SubtreeRearrangement and DRTreeParsimonyScore. Only SPRs are supported.
+   *
+   * @{
+   */
+
+  /**
+   * @brief Find the best SPR of the subtree defined by a node, without performing it.
+   *
+   * @param nodeId The root of the subtree to prune. Its father must have three neighbors.
+   * @param radius The maximum number of branches between the pruning point and the regrafting branch.
+   * @return The best rearrangement found, which is not valid if no rearrangement was possible.
+   * @throw NodeException If the node is the root node.
+   */
+  Rearrangement testRearrangements(int nodeId, unsigned int radius) const throw (NodeException);
+
+  /**
+   * @brief Perform a rearrangement and update all scores.
+   *
+   * @param rearrangement A rearrangement as returned by testRearrangements().
+   * @throw NodeException If the rearrangement does not match the current tree.
+   */
+  void doRearrangement(const Rearrangement& rearrangement) throw (NodeException);
+  /** @} */
+
+  /**
+   * @name The NNISearchable interface.
+   *
+   * @{
+   */
+  double getTopologyValue() const throw (Exception) { return getScore(); }
+
+  double testNNI(int nodeId) const throw (NodeException);
+
+  void doNNI(int nodeId) throw (NodeException);
+
+  const Tree& getTopology() const { return getTree(); }
+
+  void topologyChangeTested(const TopologyChangeEvent& event)
+  {
+    parsimonyData_->reInit();
+    computeScores();
+  }
+
+  void topologyChangeSuccessful(const TopologyChangeEvent& event) {}
+  /**@} */
+};
+} // end of namespace bpp.
+
+#endif // _DRTREESANKOFFPARSIMONYSCORE_H_
+
@@ -0,0 +1,199 @@
+//
+// File: ParsimonyStepwiseAddition.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#include "ParsimonyStepwiseAddition.h"
+#include "DRTreeParsimonyScore.h"
+#include "../ParallelTools.h"
+
+// From the STL:
+#include <algorithm>
+#include <memory>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+ParsimonyStepwiseAddition::ParsimonyStepwiseAddition(
+  const SiteContainer& data,
+  bool includeGaps,
+  unsigned int seed)
+throw (Exception) :
+  data_(0),
+  statesMap_(new CanonicalStateMap(data.getAlphabet(), includeGaps)),
+  seed_(seed)
+{
+  if (data.getNumberOfSequences() < 3)
+  {
+    delete statesMap_;
+    throw Exception("ParsimonyStepwiseAddition. At least three sequences are needed.");
+  }
+  data_ = dynamic_cast<SiteContainer*>(data.clone());
+}
+
+ParsimonyStepwiseAddition::ParsimonyStepwiseAddition(
+  const SiteContainer& data,
+  StateMap* statesMap,
+  unsigned int seed)
+throw (Exception) :
+  data_(0),
+  statesMap_(statesMap),
+  seed_(seed)
+{
+  if (data.getNumberOfSequences() < 3)
+  {
+    delete statesMap_;
+    throw Exception("ParsimonyStepwiseAddition. At least three sequences are needed.");
+  }
+  data_ = dynamic_cast<SiteContainer*>(data.clone());
+}
+
+ParsimonyStepwiseAddition::ParsimonyStepwiseAddition(const ParsimonyStepwiseAddition& psa) :
+  data_(dynamic_cast<SiteContainer*>(psa.data_->clone())),
+  statesMap_(psa.statesMap_->clone()),
+  seed_(psa.seed_)
+{}
+
+ParsimonyStepwiseAddition& ParsimonyStepwiseAddition::operator=(const ParsimonyStepwiseAddition& psa)
+{
+  if (this != &psa)
+  {
+    delete data_;
+    delete statesMap_;
+    data_      = dynamic_cast<SiteContainer*>(psa.data_->clone());
+    statesMap_ = psa.statesMap_->clone();
+    seed_      = psa.seed_;
+  }
+  return *this;
+}
+
+ParsimonyStepwiseAddition::~ParsimonyStepwiseAddition()
+{
+  delete data_;
+  delete statesMap_;
+}
+
+/******************************************************************************/
+
+TreeTemplate<Node>* ParsimonyStepwiseAddition::buildTree(size_t index, unsigned int* score) const throw (Exception)
+{
+  return buildTree_(*data_, index, score);
+}
+
+/******************************************************************************/
+
+TreeTemplate<Node>* ParsimonyStepwiseAddition::buildTree_(const SiteContainer& data, size_t index, unsigned int* score) const throw (Exception)
+{
+  seed_seq seq = {
+    seed_,
+    static_cast<unsigned int>(index & 0xFFFFFFFF), static_cast<unsigned int>(static_cast<unsigned long long>(index) >> 32)
+  };
+  RandomEngine engine(seq);
+
+  vector<string> names = data.getSequencesNames();
+  shuffle(names.begin(), names.end(), engine);
+
+  // Starting tree with three leaves:
+  Node* root = new Node(0);
+  for (int i = 0; i < 3; i++)
+  {
+    root->addSon(new Node(i + 1, names[static_cast<size_t>(i)]));
+  }
+  TreeTemplate<Node> tree(root);
+  DRTreeParsimonyScore tp(tree, data, statesMap_->clone(), false);
+
+  // Add all other taxa:
+  vector<int> nodeIds;
+  vector<size_t> bestBranches;
+  for (size_t i = 3; i < names.size(); i++)
+  {
+    vector<unsigned int> scores = tp.testLeafInsertions(names[i], nodeIds);
+    unsigned int bestScore = *min_element(scores.begin(), scores.end());
+    bestBranches.clear();
+    for (size_t j = 0; j < scores.size(); j++)
+    {
+      if (scores[j] == bestScore)
+        bestBranches.push_back(j);
+    }
+    uniform_int_distribution<size_t> distribution(0, bestBranches.size() - 1);
+    tp.doLeafInsertion(names[i], nodeIds[bestBranches[distribution(engine)]]);
+  }
+
+  if (score)
+    *score = tp.getScore();
+  return new TreeTemplate<Node>(tp.getTree());
+}
+
+/******************************************************************************/
+
+vector<TreeTemplate<Node>*> ParsimonyStepwiseAddition::buildTrees(
+  size_t nbTrees,
+  unsigned int nbThreads,
+  vector<unsigned int>* scores) const throw (Exception)
+{
+  vector<TreeTemplate<Node>*> trees(nbTrees, 0);
+  if (scores)
+    scores->assign(nbTrees, 0);
+  try
+  {
+    ParallelTools::forEachBlock(nbTrees, nbThreads,
+      [&](size_t begin, size_t end, unsigned int)
+      {
+        // Containers may build their sequences lazily, so each thread works on its own copy:
+        unique_ptr<SiteContainer> data(dynamic_cast<SiteContainer*>(data_->clone()));
+        for (size_t i = begin; i < end; ++i)
+        {
+          trees[i] = buildTree_(*data, i, scores ? &(*scores)[i] : 0);
+        }
+      });
+  }
+  catch (...)
+  {
+    for (size_t i = 0; i < nbTrees; ++i)
+    {
+      delete trees[i];
+    }
+    throw;
+  }
+  return trees;
+}
+
+/******************************************************************************/
+
@@ -0,0 +1,142 @@
+//
+// File: ParsimonyStepwiseAddition.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#ifndef _PARSIMONYSTEPWISEADDITION_H_
+#define _PARSIMONYSTEPWISEADDITION_H_
+
+#include "../TreeTemplate.h"
+#include "../Node.h"
+#include "../Model/StateMap.h"
+
+#include <Bpp/Seq/Container/SiteContainer.h>
+
+// From the STL:
+#include <random>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Build starting trees by randomized stepwise addition under parsimony.
+ *
+ * Taxa are added in a random order, starting from a tree with three leaves.
+ * Each taxon is inserted on the branch minimizing the parsimony score, ties
+ * being broken at random. Insertions are scored with DRTreeParsimonyScore::testLeafInsertions(),
+ * in O(sites) for each branch.
+ *
+ * The random generator of each tree is seeded from the global seed and the index of the tree,
+ * so that the index-th tree only depends on the seed. Several trees can hence be built in
+ * parallel, the result not depending on the number of threads.
+ */
+class ParsimonyStepwiseAddition
+{
+public:
+  typedef std::mt19937 RandomEngine;
+
+private:
+  SiteContainer* data_;
+  StateMap* statesMap_;
+  unsigned int seed_;
+
+public:
+  /**
+   * @param data        The sequences to use, which must be at least three.
+   * @param includeGaps Tell if gaps must be considered as a state.
+   * @param seed        The global seed of the random generators.
+   * @throw Exception If there are less than three sequences.
+   */
+  ParsimonyStepwiseAddition(
+    const SiteContainer& data,
+    bool includeGaps = false,
+    unsigned int seed = 0)
+  throw (Exception);
+
+  /**
+   * @param data      The sequences to use, which must be at least three.
+   * @param statesMap The states map to use. This object will own it.
+   * @param seed      The global seed of the random generators.
+   * @throw Exception If there are less than three sequences.
+   */
+  ParsimonyStepwiseAddition(
+    const SiteContainer& data,
+    StateMap* statesMap,
+    unsigned int seed = 0)
+  throw (Exception);
+
+  ParsimonyStepwiseAddition(const ParsimonyStepwiseAddition& psa);
+
+  ParsimonyStepwiseAddition& operator=(const ParsimonyStepwiseAddition& psa);
+
+  virtual ~ParsimonyStepwiseAddition();
+
+public:
+  unsigned int getSeed() const { return seed_; }
+
+  /**
+   * @brief Build a random tree.
+   *
+   * @param index The index of the tree, used to seed its random generator.
+   * @param score [out] If not null, the parsimony score of the tree.
+   * @return A new unrooted tree, without branch lengths.
+   */
+  TreeTemplate<Node>* buildTree(size_t index, unsigned int* score = 0) const throw (Exception);
+
+  /**
+   * @brief Build several random trees, on several threads.
+   *
+   * The i-th tree is the one returned by buildTree(i).
+   *
+   * @param nbTrees   The number of trees to build.
+   * @param nbThreads The maximum number of threads to use (0 means all available cores).
+   * @param scores    [out] If not null, the parsimony score of each tree.
+   * @return A vector of new trees.
+   */
+  std::vector<TreeTemplate<Node>*> buildTrees(
+    size_t nbTrees,
+    unsigned int nbThreads = 1,
+    std::vector<unsigned int>* scores = 0) const throw (Exception);
+
+private:
+  TreeTemplate<Node>* buildTree_(const SiteContainer& data, size_t index, unsigned int* score) const throw (Exception);
+};
+} // end of namespace bpp.
+
+#endif // _PARSIMONYSTEPWISEADDITION_H_
+
@@ -0,0 +1,129 @@
+//
+// File: SPRSearchable.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#ifndef _SPRSEARCHABLE_H_
+#define _SPRSEARCHABLE_H_
+
+#include "Node.h"
+#include "TreeTemplate.h"
+#include "TopologySearch.h"
+#include "SubtreeRearrangement.h"
+
+// From the STL:
+#include <vector>
+
+namespace bpp
+{
+
+/**
+ * @brief Interface for Subtree Pruning and Regrafting algorithms.
+ *
+ * A SPR movement prunes the subtree defined by a node and its father,
+ * and regrafts it on another branch of the remaining tree
+ * (see SubtreeRearrangement for details).
+ * The father of the pruned subtree must have three neighbors.
+ *
+ * SPRs are evaluated in two steps: all regrafting branches within a given radius
+ * of the pruning point are first scored roughly (testSPRs), and the most
+ * promising ones are then scored more accurately (testSPR).
+ * As for NNISearchable objects, score variations are to be minimized.
+ */
+class SPRSearchable:
+  public virtual TopologyListener,
+  public virtual Clonable
+{
+  public:
+    SPRSearchable() {}
+    virtual ~SPRSearchable() {}
+
+    virtual SPRSearchable* clone() const = 0;
+
+  public:
+
+    /**
+     * @brief Roughly score all SPR movements of a subtree, without performing them.
+     *
+     * @param nodeId The root of the subtree to prune.
+     * @param radius The maximum number of branches between the pruning point and the
+     * regrafting branch. A radius of 1 is equivalent to NNIs.
+     * @return All movements tested, with their approximate score variation.
+     * @throw NodeException If the node is the root node.
+     */
+    virtual std::vector<SubtreeRearrangement> testSPRs(int nodeId, unsigned int radius) const throw (NodeException) = 0;
+
+    /**
+     * @brief Accurately score a SPR movement, without performing it.
+     *
+     * @param move A movement as returned by testSPRs().
+     * @return The score variation of the movement.
+     * @throw NodeException If the movement does not match the current tree.
+     */
+    virtual double testSPR(const SubtreeRearrangement& move) const throw (NodeException) = 0;
+
+    /**
+     * @brief Perform a SPR movement.
+     *
+     * As for NNIs, the score is to be updated when the topology change is notified.
+     *
+     * @param move The movement to perform.
+     * @throw NodeException If the movement does not match the current tree.
+     */
+    virtual void doSPR(const SubtreeRearrangement& move) throw (NodeException) = 0;
+
+    /**
+     * @brief Get the tree associated to this SPRSearchable object.
+     *
+     * @return The tree associated to this instance.
+     */
+    virtual const Tree& getTopology() const = 0;
+
+    /**
+     * @brief Get the current score of this SPRSearchable object.
+     *
+     * @return The current score of this instance.
+     */
+    virtual double getTopologyValue() const throw (Exception) = 0;
+
+};
+
+} //end of namespace bpp.
+
+#endif //_SPRSEARCHABLE_H_
+
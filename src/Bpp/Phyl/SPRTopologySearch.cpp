@@ -0,0 +1,123 @@
+//
+// File: SPRTopologySearch.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#include "SPRTopologySearch.h"
+
+#include <Bpp/Text/TextTools.h>
+#include <Bpp/App/ApplicationTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+
+using namespace std;
+
+/******************************************************************************/
+
+void SPRTopologySearch::notifyAllPerformed(const TopologyChangeEvent& event)
+{
+  searchableTree_->topologyChangePerformed(event);
+  for (size_t i = 0; i < topoListeners_.size(); i++)
+  {
+    topoListeners_[i]->topologyChangePerformed(event);
+  }
+}
+
+/******************************************************************************/
+
+void SPRTopologySearch::search() throw (Exception)
+{
+  bool test = true;
+  do
+  {
+    test = false;
+    // Node ids do not change when a SPR is performed:
+    vector<int> ids = searchableTree_->getTopology().getNodesId();
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+      int nodeId = ids[i];
+      if (nodeId == searchableTree_->getTopology().getRootId()) continue;
+      vector<SubtreeRearrangement> moves = searchableTree_->testSPRs(nodeId, radius_);
+      if (moves.size() == 0) continue;
+
+      // Accurately score the best candidates only:
+      size_t nbCandidates = min(moves.size(), static_cast<size_t>(nbCandidates_));
+      partial_sort(moves.begin(), moves.begin() + static_cast<ptrdiff_t>(nbCandidates), moves.end(),
+        [](const SubtreeRearrangement& m1, const SubtreeRearrangement& m2) { return m1.scoreDifference < m2.scoreDifference; });
+      size_t best = 0;
+      for (size_t j = 0; j < nbCandidates; j++)
+      {
+        moves[j].scoreDifference = searchableTree_->testSPR(moves[j]);
+        if (verbose_ >= 3)
+        {
+          ApplicationTools::displayResult("   Testing node " + TextTools::toString(nodeId)
+                                          + " at " + TextTools::toString(moves[j].regraftNodeId1)
+                                          + "-" + TextTools::toString(moves[j].regraftNodeId2),
+                                          TextTools::toString(moves[j].scoreDifference));
+        }
+        if (moves[j].scoreDifference < moves[best].scoreDifference)
+          best = j;
+      }
+
+      if (moves[best].scoreDifference < 0.)
+      { // Good SPR found...
+        if (verbose_ >= 2)
+        {
+          ApplicationTools::displayResult("   Moving node " + TextTools::toString(nodeId)
+                                          + " to " + TextTools::toString(moves[best].regraftNodeId1)
+                                          + "-" + TextTools::toString(moves[best].regraftNodeId2),
+                                          TextTools::toString(moves[best].scoreDifference));
+        }
+        searchableTree_->doSPR(moves[best]);
+        // Notify:
+        notifyAllPerformed(TopologyChangeEvent());
+        test = true;
+
+        if (verbose_ >= 1)
+          ApplicationTools::displayResult("   Current value", TextTools::toString(searchableTree_->getTopologyValue(), 10));
+      }
+    }
+  }
+  while (test);
+}
+
+/******************************************************************************/
+
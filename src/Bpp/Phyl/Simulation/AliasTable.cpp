@@ -0,0 +1,129 @@
+//
+// File: AliasTable.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "AliasTable.h"
+
+#include <Bpp/Numeric/Random/RandomTools.h>
+
+// From the STL:
+#include <cmath>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+void AliasTable::setWeights(const vector<double>& weights)
+{
+  size_t n = weights.size();
+  probabilities_.clear();
+  aliases_.clear();
+  double sum = 0;
+  for (size_t i = 0; i < n; i++)
+  {
+    if (weights[i] > 0) sum += weights[i];
+  }
+  if (!(sum > 0) || std::isinf(sum))
+    return;
+
+  // Scaled probabilities, with mean 1:
+  probabilities_.resize(n);
+  aliases_.resize(n);
+  vector<size_t> small, large;
+  small.reserve(n);
+  large.reserve(n);
+  double scale = static_cast<double>(n) / sum;
+  for (size_t i = 0; i < n; i++)
+  {
+    probabilities_[i] = (weights[i] > 0) ? weights[i] * scale : 0;
+    aliases_[i] = i;
+    if (probabilities_[i] < 1.)
+      small.push_back(i);
+    else
+      large.push_back(i);
+  }
+
+  while (small.size() > 0 && large.size() > 0)
+  {
+    size_t s = small.back();
+    small.pop_back();
+    size_t l = large.back();
+    aliases_[s] = l;
+    probabilities_[l] -= 1. - probabilities_[s];
+    if (probabilities_[l] < 1.)
+    {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // What remains only differs from 1 because of rounding errors:
+  for (size_t i = 0; i < large.size(); i++)
+  {
+    probabilities_[large[i]] = 1.;
+  }
+  for (size_t i = 0; i < small.size(); i++)
+  {
+    probabilities_[small[i]] = 1.;
+  }
+}
+
+/******************************************************************************/
+
+size_t AliasTable::draw() const throw (Exception)
+{
+  return draw(RandomTools::giveRandomNumberBetweenZeroAndEntry(1.));
+}
+
+/******************************************************************************/
+
+double AliasTable::getProbability(size_t i) const
+{
+  size_t n = probabilities_.size();
+  if (i >= n) return 0;
+  double p = probabilities_[i];
+  for (size_t k = 0; k < n; k++)
+  {
+    if (aliases_[k] == i && k != i)
+      p += 1. - probabilities_[k];
+  }
+  return p / static_cast<double>(n);
+}
+
+/******************************************************************************/
+
@@ -0,0 +1,139 @@
+//
+// File: AliasTable.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef _ALIASTABLE_H_
+#define _ALIASTABLE_H_
+
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <vector>
+
+namespace bpp
+{
+
+/**
+ * @brief Walker's alias table for drawing from a discrete distribution.
+ *
+ * The table is built once from a vector of (non normalized) weights,
+ * using Vose's algorithm, in linear time. Each draw then takes a constant
+ * time, independently of the number of outcomes, and uses a single uniform
+ * random number: its integer part after scaling selects a column, and its
+ * fractional part decides between the column and its alias.
+ *
+ * Tiny negative weights, as obtained from numerical rounding in transition
+ * probabilities, are considered as zero. A table built from weights with a
+ * null or undefined sum is empty, and cannot be drawn from.
+ */
+class AliasTable
+{
+  private:
+    std::vector<double> probabilities_;
+    std::vector<size_t> aliases_;
+
+  public:
+    AliasTable() : probabilities_(), aliases_() {}
+
+    /**
+     * @brief Build a table from a set of weights.
+     *
+     * @param weights The weights of each outcome.
+     */
+    AliasTable(const std::vector<double>& weights) : probabilities_(), aliases_()
+    {
+      setWeights(weights);
+    }
+
+    virtual ~AliasTable() {}
+
+  public:
+    /**
+     * @brief (Re)build the table from a set of weights.
+     *
+     * @param weights The weights of each outcome.
+     */
+    void setWeights(const std::vector<double>& weights);
+
+    /**
+     * @return The number of outcomes of the distribution, 0 if the table is empty.
+     */
+    size_t getNumberOfOutcomes() const { return probabilities_.size(); }
+
+    bool isEmpty() const { return probabilities_.size() == 0; }
+
+    /**
+     * @brief Get the outcome corresponding to a uniform random number.
+     *
+     * @param u A random number drawn uniformly in [0, 1).
+     * @return The index of the outcome.
+     * @throw Exception If the table is empty.
+     */
+    size_t draw(double u) const throw (Exception)
+    {
+      size_t n = probabilities_.size();
+      if (n == 0)
+        throw Exception("AliasTable::draw. Empty table.");
+      double x = u * static_cast<double>(n);
+      size_t k = static_cast<size_t>(x);
+      if (k >= n) k = n - 1;
+      return (x - static_cast<double>(k) < probabilities_[k]) ? k : aliases_[k];
+    }
+
+    /**
+     * @brief Draw an outcome using RandomTools.
+     *
+     * @return The index of the outcome.
+     * @throw Exception If the table is empty.
+     */
+    size_t draw() const throw (Exception);
+
+    /**
+     * @return The probability of a given outcome, as encoded in the table.
+     *
+     * This is computed in linear time, and is mainly meant for testing purposes.
+     *
+     * @param i The index of the outcome.
+     */
+    double getProbability(size_t i) const;
+};
+
+} //end of namespace bpp.
+
+#endif //_ALIASTABLE_H_
+
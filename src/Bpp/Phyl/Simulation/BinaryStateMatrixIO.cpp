@@ -0,0 +1,229 @@
+//
+// File: BinaryStateMatrixIO.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "BinaryStateMatrixIO.h"
+#include "../Io/BinaryIOTools.h"
+
+#include <Bpp/Text/TextTools.h>
+
+// From SeqLib:
+#include <Bpp/Seq/Container/VectorSiteContainer.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+/******************************************************************************/
+
+namespace
+{
+  const char MAGIC[BinaryIOTools::MAGIC_SIZE] = { 'B', 'P', 'P', 'S', 'T', 'A', 'T', '1' };
+
+  size_t getPadding_(size_t length)
+  {
+    return (8 - length % 8) % 8;
+  }
+}
+
+/******************************************************************************/
+
+size_t BinaryStateMatrixFormat::getNumberOfBytesPerState(const Alphabet* alphabet)
+{
+  return alphabet->getSize() < 128 ? 1 : sizeof(int32_t);
+}
+
+/******************************************************************************/
+
+void BinaryStateMatrixWriter::doInit_() throw (Exception)
+{
+  if (!out_)
+    throw IOException("BinaryStateMatrixWriter::init. Can't write to stream.");
+  bytesPerState_ = BinaryStateMatrixFormat::getNumberOfBytesPerState(alphabet_);
+  BinaryIOTools::writeHeader(out_, MAGIC);
+  BinaryIOTools::writeValue<uint32_t>(out_, static_cast<uint32_t>(bytesPerState_));
+  BinaryIOTools::writeValue<uint64_t>(out_, names_.size());
+  BinaryIOTools::writeValue<uint64_t>(out_, nbSites_);
+  size_t length = 0;
+  for (size_t k = 0; k < names_.size(); ++k)
+  {
+    BinaryIOTools::writeValue<uint32_t>(out_, static_cast<uint32_t>(names_[k].size()));
+    out_.write(names_[k].data(), static_cast<streamsize>(names_[k].size()));
+    length += sizeof(uint32_t) + names_[k].size();
+  }
+  string zeros(getPadding_(length), '\0');
+  out_.write(zeros.data(), static_cast<streamsize>(zeros.size()));
+  if (!out_)
+    throw IOException("BinaryStateMatrixWriter::init. Could not write header.");
+}
+
+/******************************************************************************/
+
+void BinaryStateMatrixWriter::doWriteBlock_(const vector< vector<int> >& states, size_t nbBlockSites) throw (Exception)
+{
+  size_t nbSequences = states.size();
+  buffer_.resize(nbBlockSites * nbSequences * bytesPerState_);
+  char* p = buffer_.size() > 0 ? &buffer_[0] : 0;
+  for (size_t j = 0; j < nbBlockSites; ++j)
+  {
+    for (size_t k = 0; k < nbSequences; ++k)
+    {
+      int state = states[k][j];
+      if (bytesPerState_ == 1)
+      {
+        if (state < -128 || state > 127)
+          throw Exception("BinaryStateMatrixWriter::writeBlock. State out of range: " + TextTools::toString(state) + ".");
+        *p = static_cast<char>(state);
+      }
+      else
+      {
+        int32_t value = static_cast<int32_t>(state);
+        memcpy(p, &value, sizeof(int32_t));
+      }
+      p += bytesPerState_;
+    }
+  }
+  if (buffer_.size() > 0)
+    out_.write(&buffer_[0], static_cast<streamsize>(buffer_.size()));
+  if (!out_)
+    throw IOException("BinaryStateMatrixWriter::writeBlock. Could not write sites.");
+}
+
+/******************************************************************************/
+
+void BinaryStateMatrixWriter::doFinish_() throw (Exception)
+{
+  out_.flush();
+  if (!out_)
+    throw IOException("BinaryStateMatrixWriter::finish. Could not write sites.");
+}
+
+/******************************************************************************/
+
+BinaryStateMatrixReader::BinaryStateMatrixReader(istream& in) throw (IOException) :
+  in_(in),
+  dataStart_(),
+  names_(),
+  nbSites_(0),
+  bytesPerState_(1)
+{
+  BinaryIOTools::readHeader(in_, MAGIC, "BinaryStateMatrixReader", "binary state matrix");
+  bytesPerState_ = static_cast<size_t>(BinaryIOTools::readValue<uint32_t>(in_));
+  if (bytesPerState_ != 1 && bytesPerState_ != sizeof(int32_t))
+    throw IOException("BinaryStateMatrixReader. Unsupported number of bytes per state: " + TextTools::toString(bytesPerState_) + ".");
+  size_t nbSequences = static_cast<size_t>(BinaryIOTools::readValue<uint64_t>(in_));
+  nbSites_ = static_cast<size_t>(BinaryIOTools::readValue<uint64_t>(in_));
+  if (!in_)
+    throw IOException("BinaryStateMatrixReader. Truncated header.");
+  names_.resize(nbSequences);
+  size_t length = 0;
+  for (size_t k = 0; k < nbSequences; ++k)
+  {
+    size_t n = static_cast<size_t>(BinaryIOTools::readValue<uint32_t>(in_));
+    names_[k].resize(n);
+    if (n > 0)
+      in_.read(&names_[k][0], static_cast<streamsize>(n));
+    length += sizeof(uint32_t) + n;
+    if (!in_)
+      throw IOException("BinaryStateMatrixReader. Truncated header.");
+  }
+  in_.ignore(static_cast<streamsize>(getPadding_(length)));
+  dataStart_ = in_.tellg();
+  if (!in_)
+    throw IOException("BinaryStateMatrixReader. Truncated header.");
+}
+
+/******************************************************************************/
+
+void BinaryStateMatrixReader::readSites(size_t firstSite, size_t nbSites, vector< vector<int> >& states) throw (Exception)
+{
+  if (firstSite + nbSites > nbSites_)
+    throw IndexOutOfBoundsException("BinaryStateMatrixReader::readSites. Bad range of sites.", firstSite + nbSites, 0, nbSites_);
+  size_t nbSequences = names_.size();
+  states.resize(nbSequences);
+  for (size_t k = 0; k < nbSequences; ++k)
+  {
+    states[k].resize(nbSites);
+  }
+  if (nbSites == 0 || nbSequences == 0)
+    return;
+
+  vector<char> buffer(nbSites * nbSequences * bytesPerState_);
+  in_.clear();
+  in_.seekg(dataStart_ + static_cast<streamoff>(firstSite * nbSequences * bytesPerState_));
+  in_.read(&buffer[0], static_cast<streamsize>(buffer.size()));
+  if (!in_)
+    throw IOException("BinaryStateMatrixReader::readSites. Could not read sites.");
+  const char* p = &buffer[0];
+  for (size_t j = 0; j < nbSites; ++j)
+  {
+    for (size_t k = 0; k < nbSequences; ++k)
+    {
+      if (bytesPerState_ == 1)
+        states[k][j] = static_cast<int>(static_cast<signed char>(*p));
+      else
+      {
+        int32_t value;
+        memcpy(&value, p, sizeof(int32_t));
+        states[k][j] = static_cast<int>(value);
+      }
+      p += bytesPerState_;
+    }
+  }
+}
+
+/******************************************************************************/
+
+SiteContainer* BinaryStateMatrixReader::read(const Alphabet* alphabet) throw (Exception)
+{
+  vector< vector<int> > states;
+  readSites(0, nbSites_, states);
+  VectorSiteContainer* sites = new VectorSiteContainer(alphabet);
+  for (size_t k = 0; k < names_.size(); ++k)
+  {
+    sites->addSequence(BasicSequence(names_[k], states[k], alphabet), false);
+  }
+  return sites;
+}
+
+/******************************************************************************/
+
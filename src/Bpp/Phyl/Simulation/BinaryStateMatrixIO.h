@@ -0,0 +1,175 @@
+//
+// File: BinaryStateMatrixIO.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef _BINARYSTATEMATRIXIO_H_
+#define _BINARYSTATEMATRIXIO_H_
+
+#include "SimulationSink.h"
+
+#include <Bpp/Exceptions.h>
+
+// From SeqLib:
+#include <Bpp/Seq/Container/SiteContainer.h>
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Compact binary format for matrices of alphabet states.
+ *
+ * The file starts with a header:
+ * - the magic string "BPPSTAT1" (8 bytes),
+ * - the 32 bits integer 0x01020304, used to check the byte order,
+ *   followed by the number of bytes used for each state (1 or 4),
+ *   as a 32 bits unsigned integer,
+ * - the numbers of sequences and sites, as 64 bits unsigned integers,
+ * - the name of each sequence, as its length (32 bits unsigned integer)
+ *   followed by its characters, padded with zeros to a multiple of 8 bytes.
+ *
+ * States follow site by site, as signed integers, so that any range of
+ * sites is contiguous. One byte is used for alphabets with less than 128
+ * states, which covers nucleotides, proteins and codons.
+ */
+class BinaryStateMatrixFormat
+{
+public:
+  /**
+   * @return The number of bytes used to store each state of a given alphabet.
+   */
+  static size_t getNumberOfBytesPerState(const Alphabet* alphabet);
+};
+
+/**
+ * @brief Write simulated sequences as a binary state matrix.
+ *
+ * Blocks of sites are appended to the stream as they are received.
+ *
+ * @see BinaryStateMatrixFormat
+ */
+class BinaryStateMatrixWriter :
+  public AbstractSimulationSink
+{
+private:
+  std::ostream& out_;
+  size_t bytesPerState_;
+  std::vector<char> buffer_;
+
+public:
+  /**
+   * @param out The stream to write to.
+   */
+  BinaryStateMatrixWriter(std::ostream& out) :
+    AbstractSimulationSink(), out_(out), bytesPerState_(1), buffer_()
+  {}
+
+  virtual ~BinaryStateMatrixWriter() {}
+
+private:
+  BinaryStateMatrixWriter(const BinaryStateMatrixWriter&);
+  BinaryStateMatrixWriter& operator=(const BinaryStateMatrixWriter&);
+
+protected:
+  void doInit_() throw (Exception);
+  void doWriteBlock_(const std::vector< std::vector<int> >& states, size_t nbBlockSites) throw (Exception);
+  void doFinish_() throw (Exception);
+};
+
+/**
+ * @brief Read a binary state matrix.
+ *
+ * Only the header is read on construction: sites are then read by range.
+ *
+ * @see BinaryStateMatrixFormat
+ */
+class BinaryStateMatrixReader
+{
+private:
+  std::istream& in_;
+  std::streampos dataStart_;
+  std::vector<std::string> names_;
+  size_t nbSites_;
+  size_t bytesPerState_;
+
+public:
+  /**
+   * @param in The stream to read from.
+   * @throw IOException If the header is not valid.
+   */
+  BinaryStateMatrixReader(std::istream& in) throw (IOException);
+
+  virtual ~BinaryStateMatrixReader() {}
+
+private:
+  BinaryStateMatrixReader(const BinaryStateMatrixReader&);
+  BinaryStateMatrixReader& operator=(const BinaryStateMatrixReader&);
+
+public:
+  const std::vector<std::string>& getSequencesNames() const { return names_; }
+  size_t getNumberOfSequences() const { return names_.size(); }
+  size_t getNumberOfSites() const { return nbSites_; }
+  size_t getNumberOfBytesPerState() const { return bytesPerState_; }
+
+  /**
+   * @brief Read a range of sites.
+   *
+   * @param firstSite The index of the first site to read.
+   * @param nbSites   The number of sites to read.
+   * @param states [out] The states, one vector for each sequence.
+   * @throw Exception If the range is wrong or if reading failed.
+   */
+  void readSites(size_t firstSite, size_t nbSites, std::vector< std::vector<int> >& states) throw (Exception);
+
+  /**
+   * @brief Read the whole matrix.
+   *
+   * @param alphabet The alphabet of the sequences.
+   * @return A new container with all sequences.
+   * @throw Exception If reading failed.
+   */
+  SiteContainer* read(const Alphabet* alphabet) throw (Exception);
+};
+
+} // end of namespace bpp.
+
+#endif // _BINARYSTATEMATRIXIO_H_
+
@@ -49,6 +49,12 @@ using namespace bpp;
 size_t AbstractMutationProcess::mutate(size_t state) const
 {
   double alea = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.0);
+  if (aliasTables_.size() > 0)
+  {
+    if (aliasTables_[state].isEmpty())
+      throw Exception("AbstractMutationProcess::mutate. Repartition function is incomplete for state " + TextTools::toString(state));
+    return aliasTables_[state].draw(alea);
+  }
   for (size_t j = 0; j < size_; j++)
   {
     if (alea < repartition_[state][j]) return j;
@@ -63,17 +69,32 @@ size_t AbstractMutationProcess::mutate(size_t state, unsigned int n) const
   size_t s = state;
   for (unsigned int k = 0; k < n; k++)
   {
-    double alea = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.0);
-    for (size_t j = 1; j < size_ + 1; j++)
+    s = mutate(s);
+  }
+  return s;
+}
+
+/******************************************************************************/
+
+void AbstractMutationProcess::initAliasTables_()
+{
+  aliasTables_.resize(size_);
+  Vdouble weights(size_);
+  for (size_t i = 0; i < size_; i++)
+  {
+    double previous = 0;
+    for (size_t j = 0; j < size_; j++)
     {
-      if (alea < repartition_[s][j])
+      if (repartition_[i][j] < 0)
+        weights[j] = 0;
+      else
       {
-        s = j;
-        break;
+        weights[j] = repartition_[i][j] - previous;
+        previous = repartition_[i][j];
       }
     }
+    aliasTables_[i].setWeights(weights);
   }
-  return s;
 }
 
 /******************************************************************************/
@@ -147,7 +168,8 @@ SimpleMutationProcess::SimpleMutationProcess(const SubstitutionModel* model) :
     }
   }
   // Note that I use cumulative probabilities in repartition_ (hence the name).
-  // These cumulative probabilities are useful for the 'mutate(...)' function.
+  // The 'mutate(...)' function draws from the corresponding alias tables:
+  initAliasTables_();
 }
 
 SimpleMutationProcess::~SimpleMutationProcess() {}
@@ -156,12 +178,13 @@ SimpleMutationProcess::~SimpleMutationProcess() {}
 
 size_t SimpleMutationProcess::evolve(size_t initialState, double time) const
 {
-  // Compute all cumulative pijt:
+  // Compute all cumulative pijt, from a single evaluation of the transition matrix:
+  const Matrix<double>& P = model_->getPij_t(time);
   Vdouble pijt(size_);
-  pijt[0] = model_->Pij_t(initialState, 0, time);
+  pijt[0] = P(initialState, 0);
   for (size_t i = 1; i < size_; i++)
   {
-    pijt[i] = pijt[i - 1] + model_->Pij_t(initialState, i, time);
+    pijt[i] = pijt[i - 1] + P(initialState, i);
   }
   double rand = RandomTools::giveRandomNumberBetweenZeroAndEntry(1);
   for (size_t i = 0; i < size_; i++)
@@ -190,7 +213,8 @@ SelfMutationProcess::SelfMutationProcess(size_t alphabetSize) :
     }
   }
   // Note that I use cumulative probabilities in repartition_ (hence the name).
-  // These cumulative probabilities are useful for the 'mutate(...)' function.
+  // The 'mutate(...)' function draws from the corresponding alias tables:
+  initAliasTables_();
 }
 
 SelfMutationProcess::~SelfMutationProcess() {}
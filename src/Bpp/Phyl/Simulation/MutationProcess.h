@@ -40,6 +40,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef _MUTATIONPROCESS_H_
 #define _MUTATIONPROCESS_H_
 
+#include "AliasTable.h"
 #include "../Model/SubstitutionModel.h"
 #include "../Mapping/SubstitutionRegister.h"
 
@@ -146,6 +147,17 @@ class MutationPath
      */
     size_t getNumberOfEvents() const { return states_.size(); }
 
+    /**
+     * @return The states taken, without initial state.
+     */
+    const std::vector<size_t>& getStates() const { return states_; }
+
+    /**
+     * @return The times between states.
+     * The first element is the time between the initial state and the first event.
+     */
+    const std::vector<double>& getTimes() const { return times_; }
+
     /**
      * @brief Retrieve the number of substitution events per type of substitution.
      *
@@ -273,6 +285,8 @@ class MutationProcess
  * corresponding character using the bijection of the repartition function.
  *
  * All derived classes must initialize the repartition_ and size_ fields.
+ * They may then call initAliasTables_(), so that the mutate function draws
+ * new states in constant time instead of scanning the repartition function.
  */
 class AbstractMutationProcess :
   public virtual MutationProcess
@@ -296,14 +310,21 @@ class AbstractMutationProcess :
      * we'll be in state <= j at time t+1.
      */
     VVdouble repartition_;
+
+    /**
+     * @brief Alias tables built from the repartition function, one per state.
+     *
+     * Empty if initAliasTables_() was not called.
+     */
+    std::vector<AliasTable> aliasTables_;
   
   public:
     AbstractMutationProcess(const SubstitutionModel* model) :
-      model_(model), size_(), repartition_()
+      model_(model), size_(), repartition_(), aliasTables_()
     {}
 
     AbstractMutationProcess(const AbstractMutationProcess& amp) :
-      model_(amp.model_), size_(amp.size_), repartition_(amp.repartition_)
+      model_(amp.model_), size_(amp.size_), repartition_(amp.repartition_), aliasTables_(amp.aliasTables_)
     {}
 
     AbstractMutationProcess& operator=(const AbstractMutationProcess& amp)
@@ -311,6 +332,7 @@ class AbstractMutationProcess :
       model_       = amp.model_;
       size_        = amp.size_;
       repartition_ = amp.repartition_;
+      aliasTables_ = amp.aliasTables_;
       return *this;
     }
 
@@ -323,6 +345,14 @@ class AbstractMutationProcess :
     size_t evolve(size_t initialState, double time) const;
     MutationPath detailedEvolve(size_t initialState, double time) const;
     const SubstitutionModel* getSubstitutionModel() const { return model_; }
+
+  protected:
+    /**
+     * @brief Build the alias tables from the repartition_ field.
+     *
+     * Negative values in repartition_ denote forbidden transitions.
+     */
+    void initAliasTables_();
 };
 
 /**
@@ -41,6 +41,7 @@
 
 #include "NonHomogeneousSequenceSimulator.h"
 #include "../Model/SubstitutionModelSetTools.h"
+#include "../ParallelTools.h"
 
 #include <Bpp/App/ApplicationTools.h>
 #include <Bpp/Numeric/VectorTools.h>
@@ -49,6 +50,10 @@
 // From SeqLib:
 #include <Bpp/Seq/Container/VectorSiteContainer.h>
 
+// From the STL:
+#include <algorithm>
+#include <random>
+
 using namespace bpp;
 using namespace std;
 
@@ -130,31 +135,32 @@ void NonHomogeneousSequenceSimulator::init()
       seqNames_[i] = leaves_[i]->getName();
     }
   }
-  // Initialize cumulative pxy:
+  // Initialize alias tables for pxy:
   nodes.pop_back(); // remove root
   nbNodes_ = nodes.size();
 
+  Vdouble px(nbStates_);
   for (size_t i = 0; i < nodes.size(); i++)
   {
     SNode* node = nodes[i];
     node->getInfos().model = modelSet_->getModelForNode(node->getId());
+    const SubstitutionModel* sm = dynamic_cast<const SubstitutionModel*>(node->getInfos().model);
+    node->getInfos().process.reset(sm ? new SimpleMutationProcess(sm) : 0);
     double d = node->getDistanceToFather();
-    VVVdouble* cumpxy_node_ = &node->getInfos().cumpxy;
-    cumpxy_node_->resize(nbClasses_);
+    vector< vector<AliasTable> >* pxy_node_ = &node->getInfos().pxy;
+    pxy_node_->resize(nbClasses_);
     for (size_t c = 0; c < nbClasses_; c++)
     {
-      VVdouble* cumpxy_node_c_ = &(*cumpxy_node_)[c];
-      cumpxy_node_c_->resize(nbStates_);
+      vector<AliasTable>* pxy_node_c_ = &(*pxy_node_)[c];
+      pxy_node_c_->resize(nbStates_);
       RowMatrix<double> P = node->getInfos().model->getPij_t(d * rate_->getCategory(c));
       for (size_t x = 0; x < nbStates_; x++)
       {
-        Vdouble* cumpxy_node_c_x_ = &(*cumpxy_node_c_)[x];
-        cumpxy_node_c_x_->resize(nbStates_);
-        (*cumpxy_node_c_x_)[0] = P(x, 0);
-        for (size_t y = 1; y < nbStates_; y++)
+        for (size_t y = 0; y < nbStates_; y++)
         {
-          (*cumpxy_node_c_x_)[y] = (*cumpxy_node_c_x_)[y - 1] + P(x, y);
+          px[y] = P(x, y);
         }
+        (*pxy_node_c_)[x].setWeights(px);
       }
     }
   }
@@ -306,20 +312,10 @@ Site* NonHomogeneousSequenceSimulator::simulateSite(double rate) const
 SiteContainer* NonHomogeneousSequenceSimulator::simulate(size_t numberOfSites) const
 {
   vector<size_t> ancestralStateIndices(numberOfSites, 0);
+  AliasTable rootFreqs(modelSet_->getRootFrequencies());
   for (size_t j = 0; j < numberOfSites; j++)
   {
-    double r = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
-    double cumprob = 0;
-    vector<double> freqs = modelSet_->getRootFrequencies();
-    for (size_t i = 0; i < nbStates_; i++)
-    {
-      cumprob += freqs[i];
-      if (r <= cumprob)
-      {
-        ancestralStateIndices[j] = i;
-        break;
-      }
-    }
+    ancestralStateIndices[j] = rootFreqs.draw(RandomTools::giveRandomNumberBetweenZeroAndEntry(1.));
   }
   if (continuousRates_)
   {
@@ -352,6 +348,226 @@ SiteContainer* NonHomogeneousSequenceSimulator::simulate(size_t numberOfSites) c
 
 /******************************************************************************/
 
+SiteContainer* NonHomogeneousSequenceSimulator::simulate(size_t numberOfSites, unsigned int seed, unsigned int nbThreads, size_t blockSize) const throw (Exception)
+{
+  if (blockSize == 0)
+    throw Exception("NonHomogeneousSequenceSimulator::simulate. Block size must be positive.");
+  size_t nbBlocks = (numberOfSites + blockSize - 1) / blockSize;
+  vector< vector<int> > sequences(seqNames_.size(), vector<int>(numberOfSites));
+
+  // Blocks are written at their own position, whatever the thread which simulates them:
+  ParallelTools::forEachBlock(nbBlocks, nbThreads,
+    [&](size_t begin, size_t end, unsigned int)
+    {
+      vector< vector<int> > states;
+      for (size_t b = begin; b < end; ++b)
+      {
+        size_t first = b * blockSize;
+        simulateBlock(b, min(blockSize, numberOfSites - first), seed, states);
+        for (size_t k = 0; k < states.size(); ++k)
+        {
+          copy(states[k].begin(), states[k].end(), sequences[k].begin() + static_cast<ptrdiff_t>(first));
+        }
+      }
+    });
+
+  AlignedSequenceContainer* sites = new AlignedSequenceContainer(alphabet_);
+  for (size_t k = 0; k < sequences.size(); ++k)
+  {
+    sites->addSequence(BasicSequence(seqNames_[k], sequences[k], alphabet_), false);
+  }
+  return sites;
+}
+
+/******************************************************************************/
+
+void NonHomogeneousSequenceSimulator::simulate(
+    size_t numberOfSites,
+    SimulationSink& sink,
+    unsigned int seed,
+    unsigned int nbThreads,
+    size_t blockSize,
+    SimulationSink* ancestralSink) const throw (Exception)
+{
+  if (blockSize == 0)
+    throw Exception("NonHomogeneousSequenceSimulator::simulate. Block size must be positive.");
+
+  // Tell which sequences go to which sink:
+  vector<const SNode*> nodes;
+  vector<size_t> fathers, rows;
+  getSimulationPlan_(nodes, fathers, rows);
+  bool splitAncestors = outputInternalSequences_ && ancestralSink;
+  vector<bool> isAncestral(rows.size(), false);
+  vector<string> names, ancestralNames;
+  for (size_t r = 0; r < rows.size(); ++r)
+  {
+    isAncestral[r] = splitAncestors && !nodes[rows[r]]->isLeaf();
+    if (isAncestral[r])
+      ancestralNames.push_back(seqNames_[r]);
+    else
+      names.push_back(seqNames_[r]);
+  }
+  sink.init(names, alphabet_, numberOfSites);
+  if (splitAncestors)
+    ancestralSink->init(ancestralNames, alphabet_, numberOfSites);
+
+  // Blocks are simulated in rounds of one block per thread, then written in order:
+  size_t nbBlocks = (numberOfSites + blockSize - 1) / blockSize;
+  size_t roundSize = static_cast<size_t>(nbThreads == 0 ? ParallelTools::getNumberOfCores() : nbThreads);
+  vector< vector< vector<int> > > states(min(roundSize, nbBlocks));
+  vector< vector<int> > leafStates, ancestralStates;
+  for (size_t round = 0; round < nbBlocks; round += roundSize)
+  {
+    size_t n = min(roundSize, nbBlocks - round);
+    ParallelTools::forEachBlock(n, nbThreads,
+      [&](size_t begin, size_t end, unsigned int)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          size_t first = (round + i) * blockSize;
+          simulateBlock(round + i, min(blockSize, numberOfSites - first), seed, states[i]);
+        }
+      });
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (!splitAncestors)
+      {
+        sink.writeBlock(states[i]);
+        continue;
+      }
+      leafStates.clear();
+      ancestralStates.clear();
+      for (size_t r = 0; r < rows.size(); ++r)
+      {
+        if (isAncestral[r])
+          ancestralStates.push_back(std::move(states[i][r]));
+        else
+          leafStates.push_back(std::move(states[i][r]));
+      }
+      sink.writeBlock(leafStates);
+      ancestralSink->writeBlock(ancestralStates);
+    }
+  }
+
+  sink.finish();
+  if (splitAncestors)
+    ancestralSink->finish();
+}
+
+/******************************************************************************/
+
+void NonHomogeneousSequenceSimulator::simulateBlock(size_t blockIndex, size_t numberOfSites, unsigned int seed, vector< vector<int> >& states) const
+{
+  vector<const SNode*> nodes;
+  vector<size_t> fathers, rows;
+  getSimulationPlan_(nodes, fathers, rows);
+  size_t nbNodes = nodes.size();
+
+  // Each block has its own stream:
+  seed_seq seq = {
+    seed,
+    static_cast<unsigned int>(blockIndex & 0xFFFFFFFF), static_cast<unsigned int>(static_cast<unsigned long long>(blockIndex) >> 32)
+  };
+  mt19937 engine(seq);
+  uniform_real_distribution<double> unif(0., 1.);
+
+  AliasTable rootFreqs(modelSet_->getRootFrequencies());
+  AliasTable rateClasses(rate_->getProbabilities());
+
+  // With continuous rates, transition matrices are computed on private
+  // copies of the models, as models keep internal buffers:
+  vector<const TransitionModel*> models(nbNodes, 0);
+  map<const TransitionModel*, shared_ptr<TransitionModel> > copies;
+  for (size_t k = 1; k < nbNodes; ++k)
+  {
+    models[k] = nodes[k]->getInfos().model;
+    if (continuousRates_)
+    {
+      shared_ptr<TransitionModel>& m = copies[models[k]];
+      if (!m)
+        m.reset(models[k]->clone());
+      models[k] = m.get();
+    }
+  }
+
+  vector< vector<size_t> > nodeStates(nbNodes, vector<size_t>(numberOfSites));
+  for (size_t j = 0; j < numberOfSites; ++j)
+  {
+    nodeStates[0][j] = rootFreqs.draw(unif(engine));
+    if (continuousRates_)
+    {
+      double rate = rate_->qProb(unif(engine));
+      for (size_t k = 1; k < nbNodes; ++k)
+      {
+        const Matrix<double>& P = models[k]->getPij_t(rate * nodes[k]->getDistanceToFather());
+        size_t x = nodeStates[fathers[k]][j];
+        double u = unif(engine);
+        double cumpxy = 0;
+        size_t y = 0;
+        // Rounding errors are attributed to the last state:
+        while (y < nbStates_ - 1 && u >= (cumpxy += P(x, y)))
+          y++;
+        nodeStates[k][j] = y;
+      }
+    }
+    else
+    {
+      size_t c = rateClasses.draw(unif(engine));
+      for (size_t k = 1; k < nbNodes; ++k)
+      {
+        size_t x = nodeStates[fathers[k]][j];
+        const AliasTable& pxy_node_c_x_ = nodes[k]->getInfos().pxy[c][x];
+        if (pxy_node_c_x_.isEmpty())
+          throw Exception("NonHomogeneousSequenceSimulator::simulateBlock. The impossible happened! Transition probabilities do not sum to one for state " + TextTools::toString(x) + ".");
+        nodeStates[k][j] = pxy_node_c_x_.draw(unif(engine));
+      }
+    }
+  }
+
+  // Now convert to alphabet states. As the root has no model, we take the one of its first son:
+  states.resize(rows.size());
+  for (size_t r = 0; r < rows.size(); ++r)
+  {
+    size_t k = rows[r];
+    const TransitionModel* model = (k > 0) ? nodes[k]->getInfos().model : (nbNodes > 1 ? nodes[1]->getInfos().model : modelSet_->getModel(0));
+    states[r].resize(numberOfSites);
+    for (size_t j = 0; j < numberOfSites; ++j)
+    {
+      states[r][j] = model->getAlphabetStateAsInt(nodeStates[k][j]);
+    }
+  }
+}
+
+/******************************************************************************/
+
+void NonHomogeneousSequenceSimulator::getSimulationPlan_(vector<const SNode*>& nodes, vector<size_t>& fathers, vector<size_t>& rows) const
+{
+  const TreeTemplate<SNode>& tree = tree_;
+  map<int, size_t> indices;
+  nodes.assign(1, tree.getRootNode());
+  fathers.assign(1, 0);
+  indices[nodes[0]->getId()] = 0;
+  for (size_t k = 0; k < nodes.size(); ++k)
+  {
+    for (size_t i = 0; i < nodes[k]->getNumberOfSons(); ++i)
+    {
+      const SNode* son = nodes[k]->getSon(i);
+      indices[son->getId()] = nodes.size();
+      nodes.push_back(son);
+      fathers.push_back(k);
+    }
+  }
+  // Sequences are in the same order as seqNames_:
+  vector<const SNode*> sequences = outputInternalSequences_ ? tree.getNodes() : tree.getLeaves();
+  rows.resize(sequences.size());
+  for (size_t r = 0; r < sequences.size(); ++r)
+  {
+    rows[r] = indices[sequences[r]->getId()];
+  }
+}
+
+/******************************************************************************/
+
 RASiteSimulationResult* NonHomogeneousSequenceSimulator::dSimulateSite() const
 {
   // Draw an initial state randomly according to equilibrum frequencies:
@@ -432,13 +648,10 @@ RASiteSimulationResult* NonHomogeneousSequenceSimulator::dSimulateSite(double ra
 
 size_t NonHomogeneousSequenceSimulator::evolve(const SNode* node, size_t initialStateIndex, size_t rateClass) const
 {
-  const Vdouble* cumpxy_node_c_x_ = &node->getInfos().cumpxy[rateClass][initialStateIndex];
-  double rand = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
-  for (size_t y = 0; y < nbStates_; y++)
-  {
-    if (rand < (*cumpxy_node_c_x_)[y]) return y;
-  }
-  throw Exception("HomogeneousSequenceSimulator::evolve. The impossible happened! rand = " + TextTools::toString(rand) + ".");
+  const AliasTable& pxy_node_c_x_ = node->getInfos().pxy[rateClass][initialStateIndex];
+  if (pxy_node_c_x_.isEmpty())
+    throw Exception("NonHomogeneousSequenceSimulator::evolve. The impossible happened! Transition probabilities do not sum to one for state " + TextTools::toString(initialStateIndex) + ".");
+  return pxy_node_c_x_.draw(RandomTools::giveRandomNumberBetweenZeroAndEntry(1.));
 }
 
 /******************************************************************************/
@@ -448,13 +661,14 @@ size_t NonHomogeneousSequenceSimulator::evolve(const SNode* node, size_t initial
   double cumpxy = 0;
   double rand = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
   double l = rate * node->getDistanceToFather();
-  const TransitionModel* model = node->getInfos().model;
+  // Compute the whole matrix once, rather than each probability separately:
+  RowMatrix<double> pijt = node->getInfos().model->getPij_t(l);
   for (size_t y = 0; y < nbStates_; y++)
   {
-    cumpxy += model->Pij_t(initialStateIndex, y, l);
+    cumpxy += pijt(initialStateIndex, y);
     if (rand < cumpxy) return y;
   }
-  MatrixTools::print(model->getPij_t(l));
+  MatrixTools::print(pijt);
   throw Exception("HomogeneousSequenceSimulator::evolve. The impossible happened! rand = " + TextTools::toString(rand) + ".");
 }
 
@@ -466,19 +680,13 @@ void NonHomogeneousSequenceSimulator::multipleEvolve(
     const vector<size_t>& rateClasses,
     std::vector<size_t>& finalStateIndices) const
 {
-  const VVVdouble* cumpxy_node_ = &node->getInfos().cumpxy;
+  const vector< vector<AliasTable> >& pxy_node_ = node->getInfos().pxy;
   for (size_t i = 0; i < initialStateIndices.size(); i++)
   {
-    const Vdouble* cumpxy_node_c_x_ = &(*cumpxy_node_)[rateClasses[i]][initialStateIndices[i]];
-    double rand = RandomTools::giveRandomNumberBetweenZeroAndEntry(1.);
-    for (size_t y = 0; y < nbStates_; y++)
-    {
-      if (rand < (*cumpxy_node_c_x_)[y])
-      {
-        finalStateIndices[i] = y;
-        break;
-      }
-    }
+    const AliasTable& pxy_node_c_x_ = pxy_node_[rateClasses[i]][initialStateIndices[i]];
+    if (pxy_node_c_x_.isEmpty())
+      throw Exception("NonHomogeneousSequenceSimulator::multipleEvolve. The impossible happened! Transition probabilities do not sum to one for state " + TextTools::toString(initialStateIndices[i]) + ".");
+    finalStateIndices[i] = pxy_node_c_x_.draw(RandomTools::giveRandomNumberBetweenZeroAndEntry(1.));
   }
 }
 
@@ -612,13 +820,11 @@ void NonHomogeneousSequenceSimulator::dEvolveInternal(SNode* node, double rate,
     cerr << "DEBUG: NonHomogeneousSequenceSimulator::evolveInternal. Forbidden call of method on root node." << endl;
     return;
   }
-  const TransitionModel* tm=node->getInfos().model;
-  if (dynamic_cast<const SubstitutionModel*>(tm)==0)
+  // The process only depends on the model of the branch, so it was built once in init():
+  if (!node->getInfos().process)
     throw Exception("NonHomogeneousSequenceSimulator::dEvolveInternal : detailed simulation not possible for non-markovian model");
-  
-  SimpleMutationProcess process(dynamic_cast<const SubstitutionModel*>(tm));
-  
-  MutationPath mp = process.detailedEvolve(node->getFather()->getInfos().state, node->getDistanceToFather() * rate);
+
+  MutationPath mp = node->getInfos().process->detailedEvolve(node->getFather()->getInfos().state, node->getDistanceToFather() * rate);
   node->getInfos().state = mp.getFinalState();
 
   // Now append infos in rassr:
@@ -41,8 +41,10 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef _NONHOMOGENEOUSSEQUENCESIMULATOR_H_
 #define _NONHOMOGENEOUSSEQUENCESIMULATOR_H_
 
+#include "AliasTable.h"
 #include "DetailedSiteSimulator.h"
 #include "SequenceSimulator.h"
+#include "SimulationSink.h"
 #include "../TreeTemplate.h"
 #include "../NodeTemplate.h"
 #include "../Model/SubstitutionModel.h"
@@ -57,6 +59,7 @@ knowledge of the CeCILL license and that you accept its terms.
 
 // From the STL:
 #include <map>
+#include <memory>
 #include <vector>
 
 #include "../Model/SubstitutionModelSet.h"
@@ -69,18 +72,27 @@ class SimData
   public:
     size_t state;
     std::vector<size_t> states;
-    VVVdouble cumpxy;
+    /**
+     * @brief Alias tables for the transition probabilities, per rate class and initial state.
+     */
+    std::vector< std::vector<AliasTable> > pxy;
     const TransitionModel* model;
+    /**
+     * @brief The mutation process used for detailed simulations, built once with the alias tables
+     * (null if the model of the branch is not a substitution model).
+     */
+    std::shared_ptr<const SimpleMutationProcess> process;
 
   public:
-    SimData(): state(), states(), cumpxy(), model(0) {}
-    SimData(const SimData& sd): state(sd.state), states(sd.states), cumpxy(), model(sd.model) {}
+    SimData(): state(), states(), pxy(), model(0), process() {}
+    SimData(const SimData& sd): state(sd.state), states(sd.states), pxy(sd.pxy), model(sd.model), process(sd.process) {}
     SimData& operator=(const SimData& sd)
     {
       state  = sd.state;
       states = sd.states;
-      cumpxy = sd.cumpxy;
+      pxy    = sd.pxy;
       model  = sd.model;
+      process = sd.process;
       return *this;
     }
 };
@@ -192,6 +204,15 @@ class NonHomogeneousSequenceSimulator:
      */
     void init();
 
+    /**
+     * @brief Get the nodes in an order suitable for simulation, without modifying the tree.
+     *
+     * @param nodes   [out] All nodes, fathers before their sons, starting with the root.
+     * @param fathers [out] The index of the father of each node in nodes (0 for the root).
+     * @param rows    [out] The index in nodes of each output sequence.
+     */
+    void getSimulationPlan_(std::vector<const SNode*>& nodes, std::vector<size_t>& fathers, std::vector<size_t>& rows) const;
+
   public:
 
     /**
@@ -232,6 +253,72 @@ class NonHomogeneousSequenceSimulator:
     SiteContainer* simulate(size_t numberOfSites) const;
     /** @} */
 
+    /**
+     * @name Reproducible simulations.
+     *
+     * Sites are simulated by blocks of consecutive positions. Each block has its
+     * own random generator, seeded from a global seed and the index of the block,
+     * and RandomTools is not used. Blocks can hence be simulated in any order and
+     * on several threads: the result only depends on the seed and the block size.
+     *
+     * Ancestral states are drawn from the root frequencies, and rate classes
+     * according to the probabilities of the rate distribution. With continuous
+     * rates, the rate of each site is drawn using the quantile function of the
+     * distribution.
+     *
+     * @{
+     */
+
+    /**
+     * @brief Simulate a set of sites, possibly on several threads.
+     *
+     * @param numberOfSites The number of sites to simulate.
+     * @param seed          The global seed of the simulation.
+     * @param nbThreads     The maximum number of threads to use (0 means all available cores).
+     * @param blockSize     The number of sites in each block.
+     * @return A container with the same sequences as simulate(numberOfSites).
+     * @throw Exception If the block size is 0.
+     */
+    SiteContainer* simulate(size_t numberOfSites, unsigned int seed, unsigned int nbThreads, size_t blockSize = 1000) const throw (Exception);
+
+    /**
+     * @brief Simulate the states of a block of sites.
+     *
+     * This method does not modify the simulator, and several blocks can be
+     * simulated concurrently.
+     *
+     * @param blockIndex    The index of the block, used to seed its generator.
+     * @param numberOfSites The number of sites in the block.
+     * @param seed          The global seed of the simulation.
+     * @param states [out]  The simulated alphabet states, one vector for each sequence,
+     * in the order of getSequencesNames().
+     */
+    void simulateBlock(size_t blockIndex, size_t numberOfSites, unsigned int seed, std::vector< std::vector<int> >& states) const;
+
+    /**
+     * @brief Simulate a set of sites and send them to a sink, block by block.
+     *
+     * The sites are the same as with simulate(numberOfSites, seed, nbThreads, blockSize),
+     * but at most one block per thread is kept in memory.
+     *
+     * @param numberOfSites The number of sites to simulate.
+     * @param sink          The sink receiving the sequences, in the order of getSequencesNames().
+     * @param seed          The global seed of the simulation.
+     * @param nbThreads     The maximum number of threads to use (0 means all available cores).
+     * @param blockSize     The number of sites in each block.
+     * @param ancestralSink If not null and internal sequences are output, the sink receiving
+     * the sequences of inner nodes, which are then not sent to sink.
+     * @throw Exception If the block size is 0, or if a sink failed.
+     */
+    void simulate(
+        size_t numberOfSites,
+        SimulationSink& sink,
+        unsigned int seed,
+        unsigned int nbThreads = 1,
+        size_t blockSize = 1000,
+        SimulationSink* ancestralSink = 0) const throw (Exception);
+    /** @} */
+
     /**
      * @name SiteSimulator and SequenceSimulator interface
      *
@@ -293,7 +380,8 @@ class NonHomogeneousSequenceSimulator:
     /**
      * @brief Evolve from an initial state along a branch, knowing the evolutionary rate class.
      *
-     * This method is fast since all pijt have been computed in the constructor of the class.
+     * This method is fast since alias tables for all pijt have been computed in the constructor of the class,
+     * so that each draw takes a constant time.
      * This method is used for the implementation of the SiteSimulator interface.
      */
     size_t evolve(const SNode* node, size_t initialStateIndex, size_t rateClass) const;
@@ -302,6 +390,8 @@ class NonHomogeneousSequenceSimulator:
      * @brief Evolve from an initial state along a branch, knowing the evolutionary rate.
      *
      * This method is slower than the previous one since exponential terms must be computed.
+     * The whole transition matrix of the branch is computed once per call, in a local workspace,
+     * rather than each transition probability separately.
      * This method is used for the implementation of the SiteSimulator interface.
      */
     size_t evolve(const SNode* node, size_t initialStateIndex, double rate) const;
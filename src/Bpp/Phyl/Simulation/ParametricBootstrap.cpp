@@ -0,0 +1,204 @@
+//
+// File: ParametricBootstrap.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "ParametricBootstrap.h"
+#include "../OptimizationTools.h"
+#include "../ParallelTools.h"
+#include "../SitePatterns.h"
+#include "../Likelihood/DRHomogeneousMixedTreeLikelihood.h"
+#include "../Likelihood/DRNonHomogeneousTreeLikelihood.h"
+#include "../Likelihood/AbstractNonHomogeneousTreeLikelihood.h"
+
+// From the STL:
+#include <algorithm>
+#include <memory>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+ParametricBootstrap::ParametricBootstrap(
+  const NonHomogeneousSequenceSimulator& simulator,
+  const DRTreeLikelihood& likelihood,
+  size_t numberOfSites,
+  unsigned int seed) :
+  simulator_(&simulator),
+  likelihood_(&likelihood),
+  nbSites_(numberOfSites),
+  seed_(seed),
+  parametersToEstimate_(),
+  tolerance_(0.000001),
+  maxNumberOfEvaluations_(1000000),
+  optimizationMethod_(OptimizationTools::OPTIMIZATION_NEWTON),
+  statistics_(),
+  initialLogLikelihoods_(),
+  logLikelihoods_(),
+  numbersOfPatterns_(),
+  parameterNames_(),
+  parameterValues_(),
+  statisticsValues_()
+{}
+
+/******************************************************************************/
+
+void ParametricBootstrap::setOptimizationOptions(double tolerance, unsigned int maxNumberOfEvaluations, const string& method)
+{
+  tolerance_ = tolerance;
+  maxNumberOfEvaluations_ = maxNumberOfEvaluations;
+  optimizationMethod_ = method;
+}
+
+/******************************************************************************/
+
+void ParametricBootstrap::run(size_t numberOfReplicates, unsigned int nbThreads) throw (Exception)
+{
+  // Only keep the simulated sequences of the leaves of the tree:
+  vector<string> names = likelihood_->getTree().getLeavesNames();
+  vector<string> simulatedNames = simulator_->getSequencesNames();
+  vector<size_t> rows(names.size());
+  for (size_t k = 0; k < names.size(); ++k)
+  {
+    vector<string>::const_iterator it = find(simulatedNames.begin(), simulatedNames.end(), names[k]);
+    if (it == simulatedNames.end())
+      throw Exception("ParametricBootstrap::run. Leaf '" + names[k] + "' is not simulated.");
+    rows[k] = static_cast<size_t>(it - simulatedNames.begin());
+  }
+
+  parameterNames_ = likelihood_->getParameters().getParameterNames();
+  initialLogLikelihoods_.assign(numberOfReplicates, 0.);
+  logLikelihoods_.assign(numberOfReplicates, 0.);
+  numbersOfPatterns_.assign(numberOfReplicates, 0);
+  parameterValues_.assign(numberOfReplicates, Vdouble(parameterNames_.size()));
+  statisticsValues_.assign(numberOfReplicates, Vdouble());
+
+  // Replicates are independent, and results are stored at their own position.
+  // Each thread works on its own copy of the likelihood function:
+  ParameterList generatingParameters = likelihood_->getParameters();
+  ParallelTools::forEachBlock(numberOfReplicates, nbThreads,
+    [&](size_t begin, size_t end, unsigned int)
+    {
+      unique_ptr<TransitionModel> model;
+      unique_ptr<SubstitutionModelSet> modelSet;
+      unique_ptr<DiscreteDistribution> rDist;
+      unique_ptr<DRTreeLikelihood> tl(createWorkspace_(model, modelSet, rDist));
+      for (size_t r = begin; r < end; ++r)
+      {
+        vector< vector<int> > states;
+        simulator_->simulateBlock(r, nbSites_, seed_, states);
+        vector< vector<int> > leafStates(rows.size());
+        for (size_t k = 0; k < rows.size(); ++k)
+        {
+          leafStates[k].swap(states[rows[k]]);
+        }
+        SitePatterns patterns(names, leafStates, simulator_->getAlphabet());
+        numbersOfPatterns_[r] = patterns.getWeights().size();
+
+        // Start from the parameter values of the original likelihood function:
+        setSitePatterns_(*tl, patterns);
+        tl->initialize();
+        tl->matchParametersValues(generatingParameters);
+        initialLogLikelihoods_[r] = tl->getLogLikelihood();
+
+        ParameterList parameters = tl->getParameters();
+        if (parametersToEstimate_.size() > 0)
+          parameters = parameters.subList(parametersToEstimate_);
+        OptimizationTools::optimizeNumericalParameters2(
+            tl.get(), parameters, 0,
+            tolerance_, maxNumberOfEvaluations_, 0, 0, false, false, 0, optimizationMethod_);
+
+        logLikelihoods_[r] = tl->getLogLikelihood();
+        const ParameterList& estimates = tl->getParameters();
+        for (size_t i = 0; i < parameterNames_.size(); ++i)
+        {
+          parameterValues_[r][i] = estimates.getParameterValue(parameterNames_[i]);
+        }
+        if (statistics_)
+          statisticsValues_[r] = statistics_(*tl);
+      }
+      // The likelihood function must be destroyed before its models:
+      tl.reset();
+    });
+}
+
+/******************************************************************************/
+
+DRTreeLikelihood* ParametricBootstrap::createWorkspace_(
+  unique_ptr<TransitionModel>& model,
+  unique_ptr<SubstitutionModelSet>& modelSet,
+  unique_ptr<DiscreteDistribution>& rDist) const throw (Exception)
+{
+  if (dynamic_cast<const DRHomogeneousMixedTreeLikelihood*>(likelihood_))
+    throw Exception("ParametricBootstrap. Mixed likelihood functions are not supported.");
+
+  // Copies of likelihood functions share their models, which are hence copied too:
+  unique_ptr<DRTreeLikelihood> tl(likelihood_->clone());
+  if (AbstractHomogeneousTreeLikelihood* htl = dynamic_cast<AbstractHomogeneousTreeLikelihood*>(tl.get()))
+  {
+    model.reset(htl->getModel()->clone());
+    htl->setModel(model.get());
+  }
+  else if (AbstractNonHomogeneousTreeLikelihood* nhtl = dynamic_cast<AbstractNonHomogeneousTreeLikelihood*>(tl.get()))
+  {
+    modelSet.reset(nhtl->getSubstitutionModelSet()->clone());
+    nhtl->setSubstitutionModelSet(modelSet.get());
+  }
+  else
+    throw Exception("ParametricBootstrap. Unsupported likelihood function.");
+
+  AbstractDiscreteRatesAcrossSitesTreeLikelihood* rtl = dynamic_cast<AbstractDiscreteRatesAcrossSitesTreeLikelihood*>(tl.get());
+  if (!rtl)
+    throw Exception("ParametricBootstrap. Unsupported likelihood function.");
+  rDist.reset(rtl->getRateDistribution()->clone());
+  rtl->setRateDistribution(rDist.get());
+  return tl.release();
+}
+
+/******************************************************************************/
+
+void ParametricBootstrap::setSitePatterns_(DRTreeLikelihood& tl, const SitePatterns& patterns) throw (Exception)
+{
+  if (DRHomogeneousTreeLikelihood* htl = dynamic_cast<DRHomogeneousTreeLikelihood*>(&tl))
+    htl->setSitePatterns(patterns);
+  else if (DRNonHomogeneousTreeLikelihood* nhtl = dynamic_cast<DRNonHomogeneousTreeLikelihood*>(&tl))
+    nhtl->setSitePatterns(patterns);
+  else
+    throw Exception("ParametricBootstrap. Unsupported likelihood function.");
+}
+
@@ -0,0 +1,251 @@
+//
+// File: ParametricBootstrap.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef _PARAMETRICBOOTSTRAP_H_
+#define _PARAMETRICBOOTSTRAP_H_
+
+#include "NonHomogeneousSequenceSimulator.h"
+#include "../Likelihood/DRTreeLikelihood.h"
+
+#include <Bpp/Numeric/VectorTools.h>
+
+// From the STL:
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+
+/**
+ * @brief Parametric bootstrap: simulate replicates, refit the model on each of them and collect statistics.
+ *
+ * Each replicate is simulated with NonHomogeneousSequenceSimulator::simulateBlock(),
+ * using the index of the replicate as block index, so that replicates only depend
+ * on the seed. Simulated states are compressed directly into SitePatterns, which
+ * are given to a copy of the likelihood function (see DRHomogeneousTreeLikelihood::setSitePatterns()
+ * and DRNonHomogeneousTreeLikelihood::setSitePatterns()), so that sites are not compressed again.
+ *
+ * Each fit starts from the parameter values of the likelihood function, which are
+ * typically the generating ones: the optimization is hence warm-started. Replicates
+ * are distributed over several threads, each thread working on its own copy of
+ * the likelihood function, models and rate distribution, and results are stored by
+ * replicate index. They hence do not depend on the number of threads.
+ * Only homogeneous and non-homogeneous (non-mixed) likelihood functions are supported.
+ *
+ * The simulator and the likelihood function must not be modified during run().
+ * As copies inherit the verbosity of the likelihood function, it should be built
+ * in non-verbose mode.
+ */
+class ParametricBootstrap
+{
+  public:
+    /**
+     * @brief A function computing user-defined statistics from a fitted replicate.
+     *
+     * It may be called from several threads at the same time.
+     */
+    typedef std::function<Vdouble (const DRTreeLikelihood&)> StatisticsFunction;
+
+  private:
+    const NonHomogeneousSequenceSimulator* simulator_;
+    const DRTreeLikelihood* likelihood_;
+    size_t nbSites_;
+    unsigned int seed_;
+    std::vector<std::string> parametersToEstimate_;
+    double tolerance_;
+    unsigned int maxNumberOfEvaluations_;
+    std::string optimizationMethod_;
+    StatisticsFunction statistics_;
+
+    std::vector<double> initialLogLikelihoods_;
+    std::vector<double> logLikelihoods_;
+    std::vector<size_t> numbersOfPatterns_;
+    std::vector<std::string> parameterNames_;
+    VVdouble parameterValues_;
+    VVdouble statisticsValues_;
+
+  private:
+    /**
+     * @brief Copy the likelihood function, together with its models and rate distribution.
+     *
+     * The copies of the models are stored in the given pointers, which must
+     * outlive the returned likelihood function.
+     */
+    DRTreeLikelihood* createWorkspace_(
+        std::unique_ptr<TransitionModel>& model,
+        std::unique_ptr<SubstitutionModelSet>& modelSet,
+        std::unique_ptr<DiscreteDistribution>& rDist) const throw (Exception);
+
+    /**
+     * @brief Give the patterns of a replicate to a copy of the likelihood function.
+     */
+    static void setSitePatterns_(DRTreeLikelihood& tl, const SitePatterns& patterns) throw (Exception);
+
+  public:
+    /**
+     * @param simulator     The simulator to use, set up with the generating model.
+     * @param likelihood    The likelihood function to fit on each replicate. It must be initialized.
+     * @param numberOfSites The number of sites of each replicate.
+     * @param seed          The global seed of the simulations.
+     */
+    ParametricBootstrap(
+        const NonHomogeneousSequenceSimulator& simulator,
+        const DRTreeLikelihood& likelihood,
+        size_t numberOfSites,
+        unsigned int seed = 0);
+
+    ParametricBootstrap(const ParametricBootstrap& pb) :
+      simulator_(pb.simulator_),
+      likelihood_(pb.likelihood_),
+      nbSites_(pb.nbSites_),
+      seed_(pb.seed_),
+      parametersToEstimate_(pb.parametersToEstimate_),
+      tolerance_(pb.tolerance_),
+      maxNumberOfEvaluations_(pb.maxNumberOfEvaluations_),
+      optimizationMethod_(pb.optimizationMethod_),
+      statistics_(pb.statistics_),
+      initialLogLikelihoods_(pb.initialLogLikelihoods_),
+      logLikelihoods_(pb.logLikelihoods_),
+      numbersOfPatterns_(pb.numbersOfPatterns_),
+      parameterNames_(pb.parameterNames_),
+      parameterValues_(pb.parameterValues_),
+      statisticsValues_(pb.statisticsValues_)
+    {}
+
+    ParametricBootstrap& operator=(const ParametricBootstrap& pb)
+    {
+      simulator_              = pb.simulator_;
+      likelihood_             = pb.likelihood_;
+      nbSites_                = pb.nbSites_;
+      seed_                   = pb.seed_;
+      parametersToEstimate_   = pb.parametersToEstimate_;
+      tolerance_              = pb.tolerance_;
+      maxNumberOfEvaluations_ = pb.maxNumberOfEvaluations_;
+      optimizationMethod_     = pb.optimizationMethod_;
+      statistics_             = pb.statistics_;
+      initialLogLikelihoods_  = pb.initialLogLikelihoods_;
+      logLikelihoods_         = pb.logLikelihoods_;
+      numbersOfPatterns_      = pb.numbersOfPatterns_;
+      parameterNames_         = pb.parameterNames_;
+      parameterValues_        = pb.parameterValues_;
+      statisticsValues_       = pb.statisticsValues_;
+      return *this;
+    }
+
+    virtual ~ParametricBootstrap() {}
+
+  public:
+    /**
+     * @brief Set the parameters to estimate on each replicate (all parameters by default).
+     *
+     * @param parameters The names of the parameters, as in the likelihood function.
+     */
+    void setParametersToEstimate(const std::vector<std::string>& parameters) { parametersToEstimate_ = parameters; }
+
+    /**
+     * @brief Set the options of the optimization.
+     *
+     * @see OptimizationTools::optimizeNumericalParameters2
+     * @param tolerance              The tolerance to use in the algorithm.
+     * @param maxNumberOfEvaluations The maximum number of function evaluations.
+     * @param method                 The optimization method to use for derivable parameters.
+     */
+    void setOptimizationOptions(double tolerance, unsigned int maxNumberOfEvaluations, const std::string& method);
+
+    /**
+     * @brief Set a function computing additional statistics on each fitted replicate.
+     */
+    void setStatisticsFunction(const StatisticsFunction& statistics) { statistics_ = statistics; }
+
+    /**
+     * @brief Simulate and fit all replicates.
+     *
+     * Previous results are discarded.
+     *
+     * @param numberOfReplicates The number of replicates.
+     * @param nbThreads          The maximum number of threads to use (0 means all available cores).
+     * @throw Exception If a leaf of the tree is not simulated, or if a replicate could not be fitted.
+     */
+    void run(size_t numberOfReplicates, unsigned int nbThreads = 1) throw (Exception);
+
+    /**
+     * @name Results, indexed by replicate.
+     *
+     * @{
+     */
+    size_t getNumberOfReplicates() const { return logLikelihoods_.size(); }
+
+    /**
+     * @return The log-likelihood of each replicate, before optimization.
+     */
+    const std::vector<double>& getInitialLogLikelihoods() const { return initialLogLikelihoods_; }
+
+    /**
+     * @return The log-likelihood of each replicate, after optimization.
+     */
+    const std::vector<double>& getLogLikelihoods() const { return logLikelihoods_; }
+
+    /**
+     * @return The number of distinct site patterns of each replicate.
+     */
+    const std::vector<size_t>& getNumbersOfPatterns() const { return numbersOfPatterns_; }
+
+    /**
+     * @return The names of all parameters of the likelihood function.
+     */
+    const std::vector<std::string>& getParameterNames() const { return parameterNames_; }
+
+    /**
+     * @return The values of all parameters, after optimization, in the order of getParameterNames().
+     */
+    const VVdouble& getParameterValues() const { return parameterValues_; }
+
+    /**
+     * @return The additional statistics of each replicate (empty if no function was set).
+     */
+    const VVdouble& getStatistics() const { return statisticsValues_; }
+    /** @} */
+};
+
+} //end of namespace bpp.
+
+#endif //_PARAMETRICBOOTSTRAP_H_
+
@@ -0,0 +1,235 @@
+//
+// File: SimulationSink.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include "SimulationSink.h"
+#include "../Io/OutputStreamTools.h"
+
+#include <Bpp/Numeric/VectorTools.h>
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+void AbstractSimulationSink::init(const vector<string>& names, const Alphabet* alphabet, size_t numberOfSites) throw (Exception)
+{
+  names_ = names;
+  alphabet_ = alphabet;
+  nbSites_ = numberOfSites;
+  nbWrittenSites_ = 0;
+  doInit_();
+}
+
+/******************************************************************************/
+
+void AbstractSimulationSink::writeBlock(const vector< vector<int> >& states) throw (Exception)
+{
+  if (states.size() != names_.size())
+    throw DimensionException("AbstractSimulationSink::writeBlock. Bad number of sequences.", states.size(), names_.size());
+  size_t n = states.size() > 0 ? states[0].size() : 0;
+  for (size_t k = 1; k < states.size(); ++k)
+  {
+    if (states[k].size() != n)
+      throw DimensionException("AbstractSimulationSink::writeBlock. Sequences in a block must have the same number of sites.", states[k].size(), n);
+  }
+  if (nbWrittenSites_ + n > nbSites_)
+    throw Exception("AbstractSimulationSink::writeBlock. Too many sites: " + TextTools::toString(nbWrittenSites_ + n) + " > " + TextTools::toString(nbSites_) + ".");
+  doWriteBlock_(states, n);
+  nbWrittenSites_ += n;
+}
+
+/******************************************************************************/
+
+void AbstractSimulationSink::finish() throw (Exception)
+{
+  if (nbWrittenSites_ != nbSites_)
+    throw Exception("AbstractSimulationSink::finish. Only " + TextTools::toString(nbWrittenSites_) + " sites out of " + TextTools::toString(nbSites_) + " were written.");
+  doFinish_();
+}
+
+/******************************************************************************/
+
+void PhylipSimulationSink::doInit_() throw (Exception)
+{
+  if (!out_)
+    throw IOException("PhylipSimulationSink::init. Can't write to stream.");
+  nameWidth_ = 0;
+  for (size_t k = 0; k < names_.size(); ++k)
+  {
+    if (names_[k].size() > nameWidth_)
+      nameWidth_ = names_[k].size();
+  }
+  nbWrittenLines_ = 0;
+  buffers_.assign(names_.size(), "");
+  nbBufferedSites_ = 0;
+  out_ << names_.size() << " " << nbSites_ << endl;
+}
+
+/******************************************************************************/
+
+void PhylipSimulationSink::doWriteBlock_(const vector< vector<int> >& states, size_t nbBlockSites) throw (Exception)
+{
+  for (size_t k = 0; k < states.size(); ++k)
+  {
+    for (size_t j = 0; j < nbBlockSites; ++j)
+    {
+      buffers_[k] += alphabet_->intToChar(states[k][j]);
+    }
+  }
+  nbBufferedSites_ += nbBlockSites;
+  while (nbBufferedSites_ >= charsByLine_)
+  {
+    writeLines_(charsByLine_);
+  }
+}
+
+/******************************************************************************/
+
+void PhylipSimulationSink::doFinish_() throw (Exception)
+{
+  if (nbBufferedSites_ > 0)
+    writeLines_(nbBufferedSites_);
+  out_.flush();
+  if (!out_)
+    throw IOException("PhylipSimulationSink::finish. Could not write sequences.");
+}
+
+/******************************************************************************/
+
+void PhylipSimulationSink::writeLines_(size_t nbLineSites) throw (IOException)
+{
+  size_t length = nbLineSites * alphabet_->getStateCodingSize();
+  // Sections are separated by a blank line, and only the first one has names:
+  if (nbWrittenLines_ > 0)
+    out_ << endl;
+  for (size_t k = 0; k < buffers_.size(); ++k)
+  {
+    if (nbWrittenLines_ == 0)
+      out_ << TextTools::resizeRight(names_[k], nameWidth_) << "  ";
+    out_.write(buffers_[k].data(), static_cast<streamsize>(length));
+    out_ << endl;
+    buffers_[k].erase(0, length);
+  }
+  nbBufferedSites_ -= nbLineSites;
+  nbWrittenLines_++;
+  if (!out_)
+    throw IOException("PhylipSimulationSink. Could not write sequences.");
+}
+
+/******************************************************************************/
+
+void FastaSimulationSink::doInit_() throw (Exception)
+{
+  if (!out_)
+    throw IOException("FastaSimulationSink::init. Can't write to stream.");
+  start_ = out_.tellp();
+  stateSize_ = alphabet_->getStateCodingSize();
+  recordOffsets_.resize(names_.size());
+  size_t nbLines = (nbSites_ + charsByLine_ - 1) / charsByLine_;
+  size_t offset = 0;
+  for (size_t k = 0; k < names_.size(); ++k)
+  {
+    recordOffsets_[k] = offset;
+    offset += names_[k].size() + 2 + nbSites_ * stateSize_ + nbLines;
+  }
+}
+
+/******************************************************************************/
+
+void FastaSimulationSink::doWriteBlock_(const vector< vector<int> >& states, size_t nbBlockSites) throw (Exception)
+{
+  size_t first = nbWrittenSites_;
+  string text;
+  for (size_t k = 0; k < states.size(); ++k)
+  {
+    text.clear();
+    if (first == 0)
+      text = ">" + names_[k] + "\n";
+    for (size_t j = 0; j < nbBlockSites; ++j)
+    {
+      string c = alphabet_->intToChar(states[k][j]);
+      if (c.size() != stateSize_)
+        throw Exception("FastaSimulationSink::writeBlock. Unexpected state: '" + c + "'.");
+      text += c;
+      size_t site = first + j + 1;
+      if (site % charsByLine_ == 0 || site == nbSites_)
+        text += "\n";
+    }
+    write_(recordOffsets_[k] + (first == 0 ? 0 : getSiteOffset_(k, first)), text);
+  }
+}
+
+/******************************************************************************/
+
+void FastaSimulationSink::doFinish_() throw (Exception)
+{
+  // Without any site, names have not been written yet:
+  if (nbSites_ == 0)
+  {
+    for (size_t k = 0; k < names_.size(); ++k)
+    {
+      write_(recordOffsets_[k], ">" + names_[k] + "\n");
+    }
+  }
+  out_.seekp(0, ios::end);
+  out_.flush();
+  if (!out_)
+    throw IOException("FastaSimulationSink::finish. Could not write sequences.");
+}
+
+/******************************************************************************/
+
+size_t FastaSimulationSink::getSiteOffset_(size_t sequence, size_t site) const
+{
+  return names_[sequence].size() + 2 + site * stateSize_ + site / charsByLine_;
+}
+
+/******************************************************************************/
+
+void FastaSimulationSink::write_(size_t offset, const string& text) throw (IOException)
+{
+  OutputStreamTools::seekOrExtend(out_, start_, offset);
+  out_.write(text.data(), static_cast<streamsize>(text.size()));
+  if (!out_)
+    throw IOException("FastaSimulationSink. Could not write sequences.");
+}
+
+/******************************************************************************/
+
@@ -0,0 +1,250 @@
+//
+// File: SimulationSink.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#ifndef _SIMULATIONSINK_H_
+#define _SIMULATIONSINK_H_
+
+#include <Bpp/Exceptions.h>
+
+// From SeqLib:
+#include <Bpp/Seq/Alphabet/Alphabet.h>
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+
+/**
+ * @brief Receive simulated sequences block of sites by block of sites.
+ *
+ * Sinks allow to output large simulations without storing the whole
+ * alignment in memory. init() is called first, then writeBlock() for each
+ * block of consecutive sites, in order, and finally finish().
+ *
+ * @see NonHomogeneousSequenceSimulator::simulate
+ */
+class SimulationSink
+{
+  public:
+    SimulationSink() {}
+    virtual ~SimulationSink() {}
+
+  public:
+    /**
+     * @brief Start a new simulation.
+     *
+     * @param names         The names of the sequences.
+     * @param alphabet      The alphabet of the sequences.
+     * @param numberOfSites The total number of sites to be written.
+     * @throw Exception If the output could not be initialized.
+     */
+    virtual void init(const std::vector<std::string>& names, const Alphabet* alphabet, size_t numberOfSites) throw (Exception) = 0;
+
+    /**
+     * @brief Write the next block of sites.
+     *
+     * @param states The alphabet states, one vector for each sequence, all with the same size.
+     * @throw Exception If the block does not match the simulation or could not be written.
+     */
+    virtual void writeBlock(const std::vector< std::vector<int> >& states) throw (Exception) = 0;
+
+    /**
+     * @brief Complete the output, once all sites have been written.
+     *
+     * @throw Exception If some sites are missing or could not be written.
+     */
+    virtual void finish() throw (Exception) = 0;
+};
+
+/**
+ * @brief Partial implementation of the SimulationSink interface,
+ * checking the dimensions of blocks.
+ */
+class AbstractSimulationSink :
+  public virtual SimulationSink
+{
+  protected:
+    std::vector<std::string> names_;
+    const Alphabet* alphabet_;
+    size_t nbSites_;
+    size_t nbWrittenSites_;
+
+  public:
+    AbstractSimulationSink() : names_(), alphabet_(0), nbSites_(0), nbWrittenSites_(0) {}
+
+    AbstractSimulationSink(const AbstractSimulationSink& ass) :
+      names_(ass.names_), alphabet_(ass.alphabet_), nbSites_(ass.nbSites_), nbWrittenSites_(ass.nbWrittenSites_)
+    {}
+
+    AbstractSimulationSink& operator=(const AbstractSimulationSink& ass)
+    {
+      names_          = ass.names_;
+      alphabet_       = ass.alphabet_;
+      nbSites_        = ass.nbSites_;
+      nbWrittenSites_ = ass.nbWrittenSites_;
+      return *this;
+    }
+
+    virtual ~AbstractSimulationSink() {}
+
+  public:
+    void init(const std::vector<std::string>& names, const Alphabet* alphabet, size_t numberOfSites) throw (Exception);
+    void writeBlock(const std::vector< std::vector<int> >& states) throw (Exception);
+    void finish() throw (Exception);
+
+    size_t getNumberOfSequences() const { return names_.size(); }
+    size_t getNumberOfSites() const { return nbSites_; }
+    size_t getNumberOfWrittenSites() const { return nbWrittenSites_; }
+
+  protected:
+    /**
+     * @brief Called by init(), once names_, alphabet_ and nbSites_ are set.
+     */
+    virtual void doInit_() throw (Exception) = 0;
+
+    /**
+     * @brief Called by writeBlock(), once the dimensions have been checked,
+     * before nbWrittenSites_ is updated.
+     */
+    virtual void doWriteBlock_(const std::vector< std::vector<int> >& states, size_t nbBlockSites) throw (Exception) = 0;
+
+    /**
+     * @brief Called by finish(), once all sites have been written.
+     */
+    virtual void doFinish_() throw (Exception) = 0;
+};
+
+/**
+ * @brief Write simulated sequences in the interleaved Phylip format.
+ *
+ * Sites are buffered until a full line can be written for all sequences,
+ * so that the memory used only depends on the line length. Names are
+ * written in full (as in the extended format), followed by two spaces.
+ */
+class PhylipSimulationSink :
+  public AbstractSimulationSink
+{
+  private:
+    std::ostream& out_;
+    size_t charsByLine_;
+    size_t nameWidth_;
+    size_t nbWrittenLines_;
+    std::vector<std::string> buffers_;
+    size_t nbBufferedSites_;
+
+  public:
+    /**
+     * @param out         The stream to write to.
+     * @param charsByLine The number of sites on each line.
+     */
+    PhylipSimulationSink(std::ostream& out, size_t charsByLine = 60) :
+      AbstractSimulationSink(), out_(out), charsByLine_(charsByLine == 0 ? 1 : charsByLine),
+      nameWidth_(0), nbWrittenLines_(0), buffers_(), nbBufferedSites_(0)
+    {}
+
+    virtual ~PhylipSimulationSink() {}
+
+  private:
+    PhylipSimulationSink(const PhylipSimulationSink&);
+    PhylipSimulationSink& operator=(const PhylipSimulationSink&);
+
+  protected:
+    void doInit_() throw (Exception);
+    void doWriteBlock_(const std::vector< std::vector<int> >& states, size_t nbBlockSites) throw (Exception);
+    void doFinish_() throw (Exception);
+
+  private:
+    void writeLines_(size_t nbLineSites) throw (IOException);
+};
+
+/**
+ * @brief Write simulated sequences in the Fasta format.
+ *
+ * As sequences are received site block by site block, each block is
+ * written directly at its position in each sequence, which is fixed by
+ * the number of sites and the line length. The stream must hence allow
+ * to seek, as a file does: nothing is buffered.
+ */
+class FastaSimulationSink :
+  public AbstractSimulationSink
+{
+  private:
+    std::ostream& out_;
+    std::streampos start_;
+    size_t charsByLine_;
+    size_t stateSize_;
+    std::vector<size_t> recordOffsets_;
+
+  public:
+    /**
+     * @param out         The stream to write to.
+     * @param charsByLine The number of sites on each line.
+     */
+    FastaSimulationSink(std::ostream& out, size_t charsByLine = 60) :
+      AbstractSimulationSink(), out_(out), start_(), charsByLine_(charsByLine == 0 ? 1 : charsByLine),
+      stateSize_(1), recordOffsets_()
+    {}
+
+    virtual ~FastaSimulationSink() {}
+
+  private:
+    FastaSimulationSink(const FastaSimulationSink&);
+    FastaSimulationSink& operator=(const FastaSimulationSink&);
+
+  protected:
+    void doInit_() throw (Exception);
+    void doWriteBlock_(const std::vector< std::vector<int> >& states, size_t nbBlockSites) throw (Exception);
+    void doFinish_() throw (Exception);
+
+  private:
+    /**
+     * @return The offset of a site in the record of a sequence, with respect to the start of the record.
+     */
+    size_t getSiteOffset_(size_t sequence, size_t site) const;
+
+    void write_(size_t offset, const std::string& text) throw (IOException);
+};
+
+} //end of namespace bpp.
+
+#endif //_SIMULATIONSINK_H_
+
@@ -44,6 +44,9 @@
 #include <Bpp/Seq/SiteTools.h>
 #include <Bpp/Seq/Container/VectorSiteContainer.h>
 
+// From the STL:
+#include <algorithm>
+
 using namespace bpp;
 using namespace std;
 
@@ -107,6 +110,72 @@ SitePatterns::SitePatterns(const SiteContainer* sequences, bool own) :
 
 /******************************************************************************/
 
+SitePatterns::SitePatterns(const vector<string>& names, const vector< vector<int> >& states, const Alphabet* alphabet) throw (DimensionException) :
+  names_(names),
+  sites_(),
+  weights_(),
+  indices_(),
+  sequences_(0),
+  alpha_(alphabet),
+  own_(true)
+{
+  if (states.size() != names.size())
+    throw DimensionException("SitePatterns. Bad number of sequences.", states.size(), names.size());
+  size_t nbSequences = states.size();
+  size_t nbSites = nbSequences > 0 ? states[0].size() : 0;
+  for (size_t k = 1; k < nbSequences; k++)
+  {
+    if (states[k].size() != nbSites)
+      throw DimensionException("SitePatterns. Sequences must have the same number of sites.", states[k].size(), nbSites);
+  }
+
+  // Sort site positions according to site contents:
+  vector<size_t> positions(nbSites);
+  for (size_t i = 0; i < nbSites; i++)
+  {
+    positions[i] = i;
+  }
+  auto compare = [&](size_t i, size_t j) -> int
+  {
+    for (size_t k = 0; k < nbSequences; k++)
+    {
+      if (states[k][i] != states[k][j])
+        return states[k][i] < states[k][j] ? -1 : 1;
+    }
+    return 0;
+  };
+  stable_sort(positions.begin(), positions.end(), [&](size_t i, size_t j) { return compare(i, j) < 0; });
+
+  // Now build patterns, and only create sites for them:
+  VectorSiteContainer* sites = new VectorSiteContainer(names_.size(), alphabet);
+  sites->setSequencesNames(names_, false);
+  indices_.resize(nbSites);
+  Vint content(nbSequences);
+  for (size_t i = 0; i < nbSites; i++)
+  {
+    size_t pos = positions[i];
+    if (i == 0 || compare(pos, positions[i - 1]) != 0)
+    {
+      for (size_t k = 0; k < nbSequences; k++)
+      {
+        content[k] = states[k][pos];
+      }
+      sites->addSite(Site(content, alphabet, static_cast<int>(weights_.size() + 1)), false);
+      weights_.push_back(1);
+    }
+    else
+      weights_.back()++;
+    indices_[pos] = weights_.size() - 1;
+  }
+  for (size_t i = 0; i < sites->getNumberOfSites(); i++)
+  {
+    sites_.push_back(&sites->getSite(i));
+  }
+  sequences_ = sites;
+}
+
+/******************************************************************************/
+
 SiteContainer* SitePatterns::getSites() const
 {
   SiteContainer* sites = new VectorSiteContainer(sites_, alpha_);
@@ -126,6 +126,20 @@ class SitePatterns :
      */
     SitePatterns(const SiteContainer* sequences, bool own = false);
 
+    /**
+     * @brief Build a new SitePattern object from a matrix of states.
+     *
+     * Patterns are found directly from the states, so that Site objects
+     * are only created for unique sites. The resulting container is owned
+     * by this instance.
+     *
+     * @param names    The sequence names.
+     * @param states   The alphabet states, one vector for each sequence, all with the same size.
+     * @param alphabet The alphabet of the sequences.
+     * @throw DimensionException If the dimensions of the matrix do not match.
+     */
+    SitePatterns(const std::vector<std::string>& names, const std::vector< std::vector<int> >& states, const Alphabet* alphabet) throw (DimensionException);
+
     virtual ~SitePatterns()
     {
       if(own_) delete sequences_;
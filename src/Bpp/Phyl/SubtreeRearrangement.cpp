@@ -0,0 +1,116 @@
+//
+// File: SubtreeRearrangement.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#include "SubtreeRearrangement.h"
+
+// From the STL:
+#include <algorithm>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+/******************************************************************************/
+
+void SubtreeRearrangement::apply(TreeTemplate<Node>& tree) const throw (NodeException)
+{
+  Node* pruned = tree.getNode(prunedNodeId);
+  if (!pruned->hasFather()) throw NodePException("SubtreeRearrangement::apply(). Node must not be the root node.", pruned);
+  Node* father = pruned->getFather();
+  if (father->degree() != 3) throw NodePException("SubtreeRearrangement::apply(). Father node must have three neighbors.", father);
+
+  // Root the tree on the pruning point, so that all other branches are oriented away from it:
+  tree.rootAt(father);
+  father->removeSon(pruned);
+  Node* root = father;
+  if (regraftNodeId1 >= 0)
+  {
+    Node* u = tree.getNode(regraftNodeId1);
+    Node* v = tree.getNode(regraftNodeId2);
+    if (v->getFather() != u) std::swap(u, v);
+    if (v->getFather() != u || u == father)
+      throw NodePException("SubtreeRearrangement::apply(). Invalid regrafting branch.", v);
+    // Find the side of the regrafting branch:
+    Node* a = u;
+    while (a->hasFather() && a->getFather() != father) a = a->getFather();
+    if (!a->hasFather())
+      throw NodePException("SubtreeRearrangement::apply(). Regrafting branch is in the pruned subtree.", v);
+    Node* b = father->getSon(father->getSon(0) == a ? 1 : 0);
+    // Remove the father from the remaining tree, now rooted on a, and insert it on the regrafting branch:
+    father->removeSon(a);
+    father->removeSon(b);
+    a->addSon(b);
+    u->removeSon(v);
+    u->addSon(father);
+    father->addSon(v);
+    root = a;
+  }
+  if (rerootNodeId1 >= 0)
+  {
+    Node* x = tree.getNode(rerootNodeId1);
+    Node* y = tree.getNode(rerootNodeId2);
+    if (y->getFather() != x) std::swap(x, y);
+    if (y->getFather() != x || x == pruned || pruned->getNumberOfSons() != 2)
+      throw NodePException("SubtreeRearrangement::apply(). Invalid rerooting branch.", y);
+    vector<Node*> path(1, x);
+    while (path.back()->hasFather() && path.back()->getFather() != pruned) path.push_back(path.back()->getFather());
+    if (!path.back()->hasFather())
+      throw NodePException("SubtreeRearrangement::apply(). Rerooting branch is not in the pruned subtree.", y);
+    Node* c1 = path.back();
+    Node* c2 = pruned->getSon(pruned->getSon(0) == c1 ? 1 : 0);
+    // Remove the root of the pruned subtree, and insert it on the rerooting branch:
+    pruned->removeSon(c1);
+    pruned->removeSon(c2);
+    c1->addSon(c2);
+    for (size_t i = path.size() - 1; i > 0; i--)
+    {
+      path[i]->removeSon(path[i - 1]);
+      path[i - 1]->addSon(path[i]);
+    }
+    x->removeSon(y);
+    pruned->addSon(x);
+    pruned->addSon(y);
+  }
+  father->addSon(pruned);
+  tree.setRootNode(root);
+}
+
+/******************************************************************************/
+
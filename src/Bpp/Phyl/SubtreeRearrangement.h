@@ -0,0 +1,108 @@
+//
+// File: SubtreeRearrangement.h
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+  Copyright or © or Copr. Bio++ Development Team, (November 16, 2004)
+
+  This software is a computer program whose purpose is to provide classes
+  for phylogenetic data analysis.
+
+  This software is governed by the CeCILL  license under French law and
+  abiding by the rules of distribution of free software.  You can  use,
+  modify and/ or redistribute the software under the terms of the CeCILL
+  license as circulated by CEA, CNRS and INRIA at the following URL
+  "http://www.cecill.info".
+
+  As a counterpart to the access to the source code and  rights to copy,
+  modify and redistribute granted by the license, users are provided only
+  with a limited warranty  and the software's author,  the holder of the
+  economic rights,  and the successive licensors  have only  limited
+  liability.
+
+  In this respect, the user's attention is drawn to the risks associated
+  with loading,  using,  modifying and/or developing or reproducing the
+  software by the user in light of its specific status of free software,
+  that may mean  that it is complicated to manipulate,  and  that  also
+  therefore means  that it is reserved for developers  and  experienced
+  professionals having in-depth computer knowledge. Users are therefore
+  encouraged to load and test the software's suitability as regards their
+  requirements in conditions enabling the security of their systems and/or
+  data to be ensured and,  more generally, to use and operate it in the
+  same conditions as regards security.
+
+  The fact that you are presently reading this means that you have had
+  knowledge of the CeCILL license and that you accept its terms.
+*/
+
+
+#ifndef _SUBTREEREARRANGEMENT_H_
+#define _SUBTREEREARRANGEMENT_H_
+
+#include "TreeTemplate.h"
+#include "Node.h"
+#include "TreeExceptions.h"
+
+namespace bpp
+{
+/**
+ * @brief Description of a subtree rearrangement (SPR or TBR).
+ *
+ * The subtree defined by a node and its father is pruned, and regrafted on another
+ * branch of the remaining tree (SPR). The pruned subtree may also be rerooted on one
+ * of its own branches before being regrafted (TBR).
+ * Bifurcating trees are assumed, the father of the pruned subtree being removed from
+ * the remaining tree and inserted on the regrafting branch.
+ *
+ * Branches are defined by the ids of their two nodes.
+ */
+class SubtreeRearrangement
+{
+public:
+  /**
+   * @brief The root of the pruned subtree (its father is pruned with it).
+   */
+  int prunedNodeId;
+  /**
+   * @brief The regrafting branch, or -1 to keep the pruned subtree at its current position.
+   */
+  int regraftNodeId1, regraftNodeId2;
+  /**
+   * @brief The branch of the pruned subtree where to reroot it, or -1 to keep its root (SPR).
+   */
+  int rerootNodeId1, rerootNodeId2;
+  /**
+   * @brief The score variation of the rearrangement.
+   */
+  double scoreDifference;
+
+public:
+  SubtreeRearrangement() :
+    prunedNodeId(-1),
+    regraftNodeId1(-1), regraftNodeId2(-1),
+    rerootNodeId1(-1), rerootNodeId2(-1),
+    scoreDifference(0)
+  {}
+
+public:
+  /**
+   * @return True if this rearrangement changes the topology.
+   */
+  bool isValid() const { return regraftNodeId1 >= 0 || rerootNodeId1 >= 0; }
+
+  /**
+   * @brief Perform the rearrangement on a tree.
+   *
+   * The tree is rerooted in the process, and node ids are preserved.
+   *
+   * @param tree The tree to modify.
+   * @throw NodeException If the rearrangement does not match the tree.
+   */
+  void apply(TreeTemplate<Node>& tree) const throw (NodeException);
+};
+} // end of namespace bpp.
+
+#endif // _SUBTREEREARRANGEMENT_H_
+
@@ -0,0 +1,97 @@
+//
+// File: test_covarion.cpp
+// Created by: agent
+// Created on: Mon Oct 19 2026
+//
+
+/*
+Copyright or © or Copr. Bio++ Development Team, (November 17, 2004)
+
+This software is a computer program whose purpose is to provide classes
+for numerical calculus. This file is part of the Bio++ project.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+
+#include <Bpp/Numeric/Prob/GammaDiscreteDistribution.h>
+#include <Bpp/Numeric/Matrix/MatrixTools.h>
+#include <Bpp/Numeric/VectorTools.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Phyl/Model/Nucleotide/GTR.h>
+#include <Bpp/Phyl/Model/G2001.h>
+#include <iostream>
+
+using namespace bpp;
+using namespace std;
+
+double maxDiff(const Matrix<double>& m1, const Matrix<double>& m2)
+{
+  double d = 0;
+  for (size_t i = 0; i < m1.getNumberOfRows(); ++i)
+    for (size_t j = 0; j < m1.getNumberOfColumns(); ++j)
+      d = max(d, abs(m1(i, j) - m2(i, j)));
+  return d;
+}
+
+int main() {
+  GTR* gtr = new GTR(&AlphabetTools::DNA_ALPHABET, 1., 0.2, 0.3, 0.4, 0.4, 0.1, 0.35, 0.35, 0.2);
+  G2001 model(gtr, new GammaDiscreteDistribution(4, 0.5), 2.);
+  size_t n = model.getNumberOfStates();
+
+  //Left and right eigen vectors must be inverse of each other:
+  RowMatrix<double> id, tmp;
+  MatrixTools::mult(model.getColumnRightEigenVectors(), model.getRowLeftEigenVectors(), tmp);
+  MatrixTools::getId(n, id);
+  cout << "|UU^-1 - I| = " << maxDiff(tmp, id) << endl;
+  if (maxDiff(tmp, id) > 1e-8) return 1;
+
+  //Block-structured transition probabilities vs full decomposition:
+  double t = 0.15;
+  Vdouble ev = model.getEigenValues();
+  RowMatrix<double> pFull, dpFull, d2pFull;
+  MatrixTools::mult(model.getColumnRightEigenVectors(), VectorTools::exp(ev * t), model.getRowLeftEigenVectors(), pFull);
+  MatrixTools::mult(model.getColumnRightEigenVectors(), ev * VectorTools::exp(ev * t), model.getRowLeftEigenVectors(), dpFull);
+  MatrixTools::mult(model.getColumnRightEigenVectors(), VectorTools::sqr(ev) * VectorTools::exp(ev * t), model.getRowLeftEigenVectors(), d2pFull);
+  RowMatrix<double> p = model.getPij_t(t);
+  cout << "|P - Pfull| = " << maxDiff(p, pFull) << endl;
+  if (maxDiff(p, pFull) > 1e-8) return 1;
+  if (maxDiff(model.getdPij_dt(t), dpFull) > 1e-8) return 1;
+  if (maxDiff(model.getd2Pij_dt2(t), d2pFull) > 1e-8) return 1;
+
+  //Rows must sum to one:
+  for (size_t i = 0; i < n; ++i) {
+    double s = 0;
+    for (size_t j = 0; j < n; ++j)
+      s += p(i, j);
+    if (abs(s - 1.) > 1e-8) {
+      cerr << "Row " << i << " sums to " << s << endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -45,6 +45,9 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <Bpp/Phyl/Model/RateDistribution/GammaDiscreteRateDistribution.h>
 #include <Bpp/Phyl/Simulation/HomogeneousSequenceSimulator.h>
 #include <Bpp/Phyl/Likelihood/RHomogeneousTreeLikelihood.h>
+#include <Bpp/Phyl/Likelihood/SPRHomogeneousTreeLikelihood.h>
+#include <Bpp/Phyl/SPRTopologySearch.h>
+#include <Bpp/Phyl/NNITopologySearch.h>
 #include <Bpp/Phyl/OptimizationTools.h>
 #include <iostream>
 
@@ -87,6 +90,66 @@ void fitModelHDR(SubstitutionModel* model, DiscreteDistribution* rdist, const Tr
     throw Exception("Incorrect final value.");
 }
 
+void testSPR(SubstitutionModel* model, DiscreteDistribution* rdist, const SiteContainer& sites) {
+  unique_ptr<TreeTemplate<Node> > tree(TreeTemplateTools::parenthesisToTree("(((A:0.01, F:0.05):0.02, (B:0.02, E:0.03):0.04):0.03,C:0.01,D:0.1);"));
+  SPRHomogeneousTreeLikelihood tl(*tree, sites, model, rdist, true, false);
+  tl.initialize();
+  double value = tl.getValue();
+  // Scores of SPRs must match the likelihood of the new trees:
+  vector<int> ids = tl.getTree().getNodesId();
+  for (size_t i = 0; i < ids.size(); i++) {
+    if (ids[i] == tl.getTree().getRootId()) continue;
+    vector<SubtreeRearrangement> moves = tl.testSPRs(ids[i], 3);
+    for (size_t j = 0; j < moves.size(); j++) {
+      double diff = tl.testSPR(moves[j]);
+      if (diff > moves[j].scoreDifference + 0.001)
+        throw Exception("SPR score increased after branch lengths optimization.");
+      SPRHomogeneousTreeLikelihood tl2(*tree, sites, model, rdist, true, false);
+      tl2.initialize();
+      diff = tl2.testSPR(moves[j]);
+      tl2.doSPR(moves[j]);
+      tl2.topologyChangeTested(TopologyChangeEvent());
+      if (abs(tl2.getValue() - (value + diff)) > 0.000001)
+        throw Exception("Incorrect SPR score.");
+    }
+  }
+  SPRTopologySearch topoSearch(tl, 3, 5, 0);
+  topoSearch.search();
+  ApplicationTools::displayResult("* likelihood after SPR search", tl.getValue());
+  if (tl.getValue() > value)
+    throw Exception("SPR search decreased the likelihood.");
+}
+
+void testParallelNNI(SubstitutionModel* model, DiscreteDistribution* rdist, const SiteContainer& sites) {
+  unique_ptr<TreeTemplate<Node> > tree(TreeTemplateTools::parenthesisToTree("(((A:0.01, F:0.05):0.02, (B:0.02, E:0.03):0.04):0.03,C:0.01,D:0.1);"));
+  NNIHomogeneousTreeLikelihood tl(*tree, sites, model, rdist, true, false);
+  tl.initialize();
+  vector<int> ids;
+  vector<const Node*> nodes = tl.getTree().getNodes();
+  for (size_t i = 0; i < nodes.size(); i++) {
+    if (nodes[i]->hasFather() && nodes[i]->getFather()->hasFather())
+      ids.push_back(nodes[i]->getId());
+  }
+  // Scores must not depend on the number of threads:
+  vector<double> diffs1 = tl.testNNIs(ids, 1);
+  vector<double> diffs3 = tl.testNNIs(ids, 3);
+  for (size_t i = 0; i < ids.size(); i++) {
+    if (abs(diffs1[i] - tl.testNNI(ids[i])) > 0.000001 || abs(diffs1[i] - diffs3[i]) > 0.000001)
+      throw Exception("Parallel NNI scores differ from serial ones.");
+  }
+  NNIHomogeneousTreeLikelihood tl1(*tree, sites, model, rdist, true, false);
+  tl1.initialize();
+  NNIHomogeneousTreeLikelihood tl3(*tree, sites, model, rdist, true, false);
+  tl3.initialize();
+  NNITopologySearch topoSearch1(tl1, NNITopologySearch::PHYML, 0, 1);
+  topoSearch1.search();
+  NNITopologySearch topoSearch3(tl3, NNITopologySearch::PHYML, 0, 3);
+  topoSearch3.search();
+  ApplicationTools::displayResult("* likelihood after NNI search", tl3.getValue());
+  if (abs(tl1.getValue() - tl3.getValue()) > 0.000001)
+    throw Exception("Parallel NNI search differs from serial one.");
+}
+
 int main() {
   unique_ptr<TreeTemplate<Node> > tree(TreeTemplateTools::parenthesisToTree("((A:0.01, B:0.02):0.03,C:0.01,D:0.1);"));
   vector<string> seqNames= tree->getLeavesNames();
@@ -121,6 +184,24 @@ int main() {
     return 1;
   }  
 
+  VectorSiteContainer sites6(sites);
+  sites6.addSequence(BasicSequence("E", "GACTGCATCTGAACGTC", alphabet));
+  sites6.addSequence(BasicSequence("F", "AAATGGCTGTCCACGTA", alphabet));
+  try {
+    cout << "Testing SPR topology search..." << endl;
+    testSPR(model.get(), rdist.get(), sites6);
+  } catch (Exception& ex) {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+  try {
+    cout << "Testing parallel NNI topology search..." << endl;
+    testParallelNNI(model.get(), rdist.get(), sites6);
+  } catch (Exception& ex) {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+
   //Let's compare the derivatives:
   RHomogeneousTreeLikelihood tlsr(*tree, sites, model.get(), rdist.get());
   tlsr.initialize();
@@ -57,8 +57,14 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <Bpp/Phyl/Mapping/NaiveSubstitutionCount.h>
 #include <Bpp/Phyl/Mapping/ProbabilisticSubstitutionMapping.h>
 #include <Bpp/Phyl/Mapping/SubstitutionMappingTools.h>
+#include <Bpp/Phyl/Mapping/BinarySubstitutionMappingIO.h>
+#include <Bpp/Phyl/Mapping/CompactProbabilisticSubstitutionMapping.h>
+#include <Bpp/Phyl/Mapping/StochasticMapping.h>
+#include <Bpp/Phyl/Mapping/RewardMappingTools.h>
 #include <Bpp/Seq/AlphabetIndex/GranthamAAVolumeIndex.h>
+#include <Bpp/Seq/AlphabetIndex/UserAlphabetIndex1.h>
 #include <iostream>
+#include <sstream>
 
 using namespace bpp;
 using namespace std;
@@ -80,6 +86,20 @@ int main() {
   TotalSubstitutionRegister* totReg = new TotalSubstitutionRegister(model);
   ComprehensiveSubstitutionRegister* detReg = new ComprehensiveSubstitutionRegister(model);
 
+  //Check the precomputed tables of substitution types:
+  size_t nbStates = model->getNumberOfStates();
+  const vector<size_t>& detTypes = detReg->getTypeTable();
+  if (detTypes.size() != nbStates * nbStates) {
+    throw Exception("Error, the table of substitution types has a wrong size.");
+  }
+  for (size_t i = 0; i < nbStates; ++i) {
+    for (size_t j = 0; j < nbStates; ++j) {
+      if (detTypes[i * nbStates + j] != detReg->getType(i, j) || totReg->getTypeTable()[i * nbStates + j] != totReg->getType(i, j)) {
+        throw Exception("Error, the table of substitution types does not match the register.");
+      }
+    }
+  }
+
   size_t n = 50000;
   vector< vector<double> > realMap(n);
   vector< vector< vector<double> > > realMapTotal(n);
@@ -179,6 +199,169 @@ int main() {
   ProbabilisticSubstitutionMapping* probMapUniDet = 
     SubstitutionMappingTools::computeSubstitutionVectors(drhtl, ids, *sCountUniDet);
 
+  //Batched counts must match the ones computed length by length:
+  Vdouble lengths(3);
+  lengths[0] = 0.5; lengths[1] = 0.01; lengths[2] = 2.;
+  vector< vector< RowMatrix<double> > > batch;
+  sCountUniDet->getAllNumbersOfSubstitutionsForEachLength(lengths, batch);
+  for (size_t l = 0; l < lengths.size(); ++l) {
+    for (size_t t = 0; t < sCountUniDet->getNumberOfSubstitutionTypes(); ++t) {
+      m = sCountUniDet->getAllNumbersOfSubstitutions(lengths[l], t + 1);
+      for (size_t x = 0; x < m->getNumberOfRows(); ++x)
+        for (size_t y = 0; y < m->getNumberOfColumns(); ++y)
+          if (abs((*m)(x, y) - batch[l][t](x, y)) > 1e-10)
+            throw Exception("Batched uniformization counts differ for length " + TextTools::toString(lengths[l]));
+      delete m;
+    }
+  }
+
+  //Same for the decomposition method, with a repeated length:
+  lengths.push_back(0.5);
+  sCountDecDet->getAllNumbersOfSubstitutionsForEachLength(lengths, batch);
+  for (size_t l = 0; l < lengths.size(); ++l) {
+    for (size_t t = 0; t < sCountDecDet->getNumberOfSubstitutionTypes(); ++t) {
+      m = sCountDecDet->getAllNumbersOfSubstitutions(lengths[l], t + 1);
+      for (size_t x = 0; x < m->getNumberOfRows(); ++x)
+        for (size_t y = 0; y < m->getNumberOfColumns(); ++y)
+          if (abs((*m)(x, y) - batch[l][t](x, y)) > 1e-10)
+            throw Exception("Batched decomposition counts differ for length " + TextTools::toString(lengths[l]));
+      delete m;
+    }
+  }
+
+  //Mapping on several threads must give exactly the serial result:
+  ProbabilisticSubstitutionMapping* probMapUniDetPar =
+    SubstitutionMappingTools::computeSubstitutionVectors(drhtl, ids, *sCountUniDet, false, 3);
+  for (size_t j = 0; j < probMapUniDet->getNumberOfBranches(); ++j)
+    for (size_t i = 0; i < n; ++i)
+      for (size_t t = 0; t < sCountUniDet->getNumberOfSubstitutionTypes(); ++t)
+        if ((*probMapUniDetPar)(j, i, t) != (*probMapUniDet)(j, i, t))
+          throw Exception("Parallel substitution mapping differs from the serial one.");
+  delete probMapUniDetPar;
+
+  //Binary output must be read back exactly, as a whole or by parts:
+  stringstream binMap;
+  SubstitutionMappingTools::writeToBinaryStream(*probMapUniDet, sites, binMap);
+  ProbabilisticSubstitutionMapping probMapUniDetBin(*tree, sCountUniDet, 0);
+  SubstitutionMappingTools::readFromBinaryStream(binMap, probMapUniDetBin);
+  stringstream binMapStream;
+  SubstitutionMappingTools::computeSubstitutionVectorsToStream(drhtl, ids, *sCountUniDet, binMapStream, false);
+  BinarySubstitutionMappingReader binReader(binMapStream);
+  Vdouble binCounts;
+  for (size_t j = 0; j < probMapUniDet->getNumberOfBranches(); ++j) {
+    size_t br = binReader.getBranchIndex(probMapUniDet->getNode(j)->getId());
+    for (size_t t = 0; t < sCountUniDet->getNumberOfSubstitutionTypes(); ++t) {
+      binReader.readCounts(br, t, 10, 100, binCounts);
+      for (size_t i = 0; i < n; ++i) {
+        if (probMapUniDetBin(j, i, t) != (*probMapUniDet)(j, i, t))
+          throw Exception("Binary substitution mapping differs from the original one.");
+        if (i >= 10 && i < 110 && binCounts[i - 10] != (*probMapUniDet)(j, i, t))
+          throw Exception("Streamed substitution mapping differs from the original one.");
+      }
+    }
+  }
+
+  //Compact storage must match the double precision mapping, up to float precision
+  //and to the threshold in sparse mode:
+  unique_ptr<CompactProbabilisticSubstitutionMapping> probMapUniDetFloat(
+    SubstitutionMappingTools::computeCompactSubstitutionVectors(drhtl, ids, *sCountUniDet, -1, false, 2));
+  unique_ptr<CompactProbabilisticSubstitutionMapping> probMapUniDetSparse(
+    SubstitutionMappingTools::computeCompactSubstitutionVectors(drhtl, ids, *sCountUniDet, 0.001, false));
+  cout << "Sparse mapping: " << probMapUniDetSparse->getNumberOfStoredValues() << " values stored out of " << probMapUniDetFloat->getNumberOfStoredValues() << "." << endl;
+  for (size_t j = 0; j < probMapUniDet->getNumberOfBranches(); ++j)
+    for (size_t i = 0; i < n; ++i)
+      for (size_t t = 0; t < sCountUniDet->getNumberOfSubstitutionTypes(); ++t) {
+        double x = (*probMapUniDet)(j, i, t);
+        if (abs(probMapUniDetFloat->getCount(j, i, t) - x) > 1e-6 * abs(x) + 1e-30)
+          throw Exception("Float substitution mapping differs from the original one.");
+        double y = probMapUniDetSparse->getCount(j, i, t);
+        if (abs(x) > 0.001 ? abs(y - x) > 1e-6 * abs(x) : y != 0)
+          throw Exception("Sparse substitution mapping differs from the original one.");
+      }
+  VVVdouble countsDense, countsSparse;
+  SubstitutionMappingTools::computeCountsPerSitePerBranchPerType(*probMapUniDet, ids, countsDense);
+  SubstitutionMappingTools::computeCountsPerSitePerBranchPerType(*probMapUniDetSparse, ids, countsSparse);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < ids.size(); ++j)
+      for (size_t t = 0; t < sCountUniDet->getNumberOfSubstitutionTypes(); ++t)
+        if (abs(countsDense[i][j][t] - countsSparse[i][j][t]) > 0.001 + 1e-6 * abs(countsDense[i][j][t]))
+          throw Exception("Counts from the sparse mapping differ from the original ones.");
+
+  //Dwell times in all states must sum to the branch length, whatever
+  //the number of threads and when streamed:
+  vector<ProbabilisticRewardMapping*> dwellMaps(4);
+  vector<UserAlphabetIndex1*> dwellIndices(4);
+  vector<DecompositionReward*> dwellRewards(4);
+  for (size_t s = 0; s < 4; ++s) {
+    dwellIndices[s] = new UserAlphabetIndex1(alphabet);
+    for (size_t s2 = 0; s2 < 4; ++s2)
+      dwellIndices[s]->setIndex(static_cast<int>(s2), s2 == s ? 1. : 0.);
+    dwellRewards[s] = new DecompositionReward(model, dwellIndices[s]);
+    dwellMaps[s] = RewardMappingTools::computeRewardVectors(drhtl, ids, *dwellRewards[s], false, static_cast<unsigned int>(s + 1));
+  }
+  for (size_t j = 0; j < dwellMaps[0]->getNumberOfBranches(); ++j) {
+    double d = dwellMaps[0]->getNode(j)->getDistanceToFather();
+    for (size_t i = 0; i < n; ++i) {
+      double total = 0;
+      for (size_t s = 0; s < 4; ++s)
+        total += (*dwellMaps[s])(j, i);
+      if (abs(total - d) > 1e-6 * d)
+        throw Exception("Dwell times do not sum to the branch length: " + TextTools::toString(total) + " instead of " + TextTools::toString(d));
+    }
+  }
+  for (size_t s = 1; s < 4; ++s) {
+    unique_ptr<ProbabilisticRewardMapping> dwellMapSerial(
+      RewardMappingTools::computeRewardVectors(drhtl, ids, *dwellRewards[s], false, 1));
+    for (size_t j = 0; j < dwellMaps[s]->getNumberOfBranches(); ++j)
+      for (size_t i = 0; i < n; ++i)
+        if ((*dwellMaps[s])(j, i) != (*dwellMapSerial)(j, i))
+          throw Exception("Parallel reward mapping differs from the serial one.");
+  }
+  stringstream dwellStream;
+  RewardMappingTools::computeRewardVectorsToStream(drhtl, ids, *dwellRewards[0], dwellStream, false, 3);
+  BinarySubstitutionMappingReader dwellReader(dwellStream);
+  Vdouble dwellValues;
+  for (size_t j = 0; j < dwellMaps[0]->getNumberOfBranches(); ++j) {
+    dwellReader.readCounts(dwellReader.getBranchIndex(dwellMaps[0]->getNode(j)->getId()), 0, 0, n, dwellValues);
+    for (size_t i = 0; i < n; ++i)
+      if (dwellValues[i] != (*dwellMaps[0])(j, i))
+        throw Exception("Streamed reward mapping differs from the original one.");
+  }
+  for (size_t s = 0; s < 4; ++s) {
+    delete dwellMaps[s];
+    delete dwellRewards[s];
+    delete dwellIndices[s];
+  }
+
+  //Sampled histories must not depend on the number of threads, and their
+  //mean numbers of substitutions must match the expected ones:
+  StochasticMapping stochMap(drhtl, 42);
+  vector<int> stochIds = stochMap.getBranchIds();
+  size_t nbStochSamples = 40;
+  VVdouble stochCounts(n, Vdouble(stochIds.size(), 0.));
+  VVdouble stochCountsPar(n, Vdouble(stochIds.size(), 0.));
+  stochMap.sampleHistories(nbStochSamples, [&](size_t site, size_t, const vector<MutationPath>& paths) {
+    for (size_t j = 0; j < paths.size(); ++j)
+      stochCounts[site][j] += static_cast<double>(paths[j].getNumberOfEvents());
+  });
+  stochMap.sampleHistories(nbStochSamples, [&](size_t site, size_t, const vector<MutationPath>& paths) {
+    for (size_t j = 0; j < paths.size(); ++j)
+      stochCountsPar[site][j] += static_cast<double>(paths[j].getNumberOfEvents());
+  }, 3);
+  if (stochCounts != stochCountsPar)
+    throw Exception("Parallel stochastic mapping differs from the serial one.");
+  for (size_t j = 0; j < stochIds.size(); ++j) {
+    double totalSampled = 0;
+    double totalExpected = 0;
+    for (size_t i = 0; i < n; ++i) {
+      totalSampled += stochCounts[i][j] / static_cast<double>(nbStochSamples);
+      totalExpected += probMapUniTot->getNumberOfSubstitutions(stochIds[j], i, 0);
+    }
+    cout << "Stochastic mapping, branch " << stochIds[j] << ": " << totalSampled << " sampled, " << totalExpected << " expected." << endl;
+    if (abs(totalSampled - totalExpected) / totalExpected > 0.1)
+      throw Exception("Stochastic mapping failed, sampled: " + TextTools::toString(totalSampled) + ", expected " + TextTools::toString(totalExpected));
+  }
+
   //Check saturation:
   cout << "checking saturation..." << endl;
   double td[] = {0.001, 0.01, 0.1, 1, 2, 3, 4, 10};
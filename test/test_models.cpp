@@ -38,17 +38,31 @@ knowledge of the CeCILL license and that you accept its terms.
 */
 
 #include <Bpp/Phyl/Model/Nucleotide/GTR.h>
+#include <Bpp/Phyl/Model/Nucleotide/JCnuc.h>
+#include <Bpp/Phyl/Model/Nucleotide/K80.h>
+#include <Bpp/Phyl/Model/Nucleotide/T92.h>
+#include <Bpp/Phyl/Model/Nucleotide/F84.h>
+#include <Bpp/Phyl/Model/Nucleotide/HKY85.h>
+#include <Bpp/Phyl/Model/Nucleotide/TN93.h>
+#include <Bpp/Phyl/Model/RE08.h>
+#include <Bpp/Phyl/Model/MixtureOfASubstitutionModel.h>
 #include <Bpp/Phyl/Model/Codon/YN98.h>
+#include <Bpp/Phyl/Model/Codon/MG94.h>
+#include <Bpp/Phyl/Model/Codon/CodonDistanceCpGSubstitutionModel.h>
 #include <Bpp/Phyl/Model/FrequenciesSet/CodonFrequenciesSet.h>
+#include <Bpp/Phyl/ParallelTools.h>
 #include <Bpp/Seq/Alphabet/AlphabetTools.h>
 #include <Bpp/Seq/Alphabet/CodonAlphabet.h>
 #include <Bpp/Seq/GeneticCode/StandardGeneticCode.h>
+#include <Bpp/Seq/AlphabetIndex/GranthamAAChemicalDistance.h>
 #include <Bpp/Numeric/Function/Functions.h>
 #include <Bpp/Numeric/Function/ReparametrizationFunctionWrapper.h>
 #include <Bpp/Numeric/ParameterList.h>
 #include <Bpp/Numeric/AbstractParametrizable.h>
 #include <Bpp/Numeric/Random/RandomTools.h>
+#include <Bpp/Numeric/Prob/GammaDiscreteDistribution.h>
 #include <iostream>
+#include <memory>
 
 using namespace bpp;
 using namespace std;
@@ -110,10 +124,352 @@ bool testModel(SubstitutionModel& model) {
   return true;
 }
 
+bool sameMatrices(const SubstitutionModel& model, const string& what, const Vdouble& times, const VVVdouble& m1, const Matrix<double>& (SubstitutionModel::*get)(double) const) {
+  for (size_t k = 0; k < times.size(); ++k) {
+    const Matrix<double>& m2 = (model.*get)(times[k]);
+    for (size_t i = 0; i < model.getNumberOfStates(); ++i) {
+      for (size_t j = 0; j < model.getNumberOfStates(); ++j) {
+        if (abs(m1[k][i][j] - m2(i, j)) > 0.0000001) {
+          cerr << "ERROR in " << what << " for model " << model.getName() << ", t=" << times[k] << ": " << m1[k][i][j] << "<>" << m2(i, j) << endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool testFillPij_t(const SubstitutionModel& model) {
+  Vdouble times(3);
+  times[0] = 0.; times[1] = 0.05; times[2] = 1.3;
+  VVVdouble pijt, dpijt, d2pijt;
+  model.fillPij_t(times, pijt);
+  model.filldPij_dt(times, dpijt);
+  model.filld2Pij_dt2(times, d2pijt);
+  return sameMatrices(model, "fillPij_t", times, pijt, &SubstitutionModel::getPij_t)
+      && sameMatrices(model, "filldPij_dt", times, dpijt, &SubstitutionModel::getdPij_dt)
+      && sameMatrices(model, "filld2Pij_dt2", times, d2pijt, &SubstitutionModel::getd2Pij_dt2);
+}
+
+bool testStationarity(const SubstitutionModel& model) {
+  //The equilibrium frequencies must be stationary, and P(t) stochastic:
+  const Matrix<double>& p = model.getPij_t(0.7);
+  const Vdouble& freq = model.getFrequencies();
+  size_t n = model.getNumberOfStates();
+  for (size_t j = 0; j < n; ++j) {
+    double fj = 0, sj = 0;
+    for (size_t i = 0; i < n; ++i) {
+      fj += freq[i] * p(i, j);
+      sj += p(j, i);
+    }
+    if (abs(fj - freq[j]) > 0.0000001 || (abs(sj - 1.) > 0.0000001 && freq[j] > 0)) {
+      cerr << "ERROR in transition probabilities of model " << model.getName() << " for state " << j << ": " << fj << "<>" << freq[j] << ", sum=" << sj << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool testCodonGenerator(const AbstractCodonSubstitutionModel& model) {
+  //Off-diagonal rates must be proportional to the nucleotide rate times getCodonsMulRate():
+  const Matrix<double>& gen = model.getGenerator();
+  const Matrix<double>& nucGen = model.getNModel(0)->getGenerator();
+  const GeneticCode* gc = model.getGeneticCode();
+  size_t n = model.getNumberOfStates();
+  double ratio = 0;
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      if (i == j) continue;
+      size_t nbChanges = 0, a = 0, b = 0;
+      for (size_t p = 0; p < 3; ++p) {
+        size_t d = (p == 0 ? 16 : (p == 1 ? 4 : 1));
+        if ((i / d) % 4 != (j / d) % 4) {
+          nbChanges++;
+          a = (i / d) % 4;
+          b = (j / d) % 4;
+        }
+      }
+      double expected = 0;
+      if (nbChanges == 1 && !gc->isStop(static_cast<int>(i)) && !gc->isStop(static_cast<int>(j)))
+        expected = nucGen(a, b) * model.getCodonsMulRate(i, j);
+      if (expected == 0) {
+        if (abs(gen(i, j)) > 0.0000001) {
+          cerr << "ERROR in generator of model " << model.getName() << ": rate " << i << "->" << j << " should be null." << endl;
+          return false;
+        }
+        continue;
+      }
+      if (ratio == 0)
+        ratio = gen(i, j) / expected;
+      if (abs(gen(i, j) - ratio * expected) > 0.0000001 * abs(gen(i, j))) {
+        cerr << "ERROR in generator of model " << model.getName() << ": rate " << i << "->" << j << ": " << gen(i, j) << "<>" << ratio * expected << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool testBatchUpdate(const SubstitutionModel& model) {
+  //Changing all parameters within a batch must give the same matrices as one change at a time:
+  SubstitutionModel* single = model.clone();
+  SubstitutionModel* batched = model.clone();
+  ParameterList pl = model.getParameters();
+  for (size_t i = 0; i < pl.size(); ++i)
+    pl[i].setValue(0.8 * pl[i].getValue() + 0.05);
+  for (size_t i = 0; i < pl.size(); ++i) {
+    ParameterList pli;
+    pli.addParameter(pl[i]);
+    single->matchParametersValues(pli);
+  }
+  {
+    SubstitutionModelBatchUpdate batch(batched);
+    for (size_t i = 0; i < pl.size(); ++i) {
+      ParameterList pli;
+      pli.addParameter(pl[i]);
+      batched->matchParametersValues(pli);
+    }
+    batch.commit();
+  }
+  bool ok = true;
+  size_t n = model.getNumberOfStates();
+  const Matrix<double>& g1 = single->getGenerator();
+  const Matrix<double>& g2 = batched->getGenerator();
+  const Matrix<double>& p1 = single->getPij_t(0.3);
+  const Matrix<double>& p2 = batched->getPij_t(0.3);
+  for (size_t i = 0; ok && i < n; ++i) {
+    for (size_t j = 0; ok && j < n; ++j) {
+      if (abs(g1(i, j) - g2(i, j)) > 0.0000001 || abs(p1(i, j) - p2(i, j)) > 0.0000001) {
+        cerr << "ERROR in batch update of model " << model.getName() << " at " << i << "," << j << ": " << g1(i, j) << "<>" << g2(i, j) << ", " << p1(i, j) << "<>" << p2(i, j) << endl;
+        ok = false;
+      }
+    }
+  }
+  delete single;
+  delete batched;
+  return ok;
+}
+
+//HKY85 counting the computations of its matrices:
+class CountingHKY85 :
+  public HKY85
+{
+  public:
+    unsigned int nbUpdates;
+
+    CountingHKY85() : HKY85(&AlphabetTools::DNA_ALPHABET), nbUpdates(0) {}
+
+    CountingHKY85* clone() const { return new CountingHKY85(*this); }
+
+    void updateMatrices() { nbUpdates++; HKY85::updateMatrices(); }
+};
+
+//Bibliographic model wrapping it, as YN98 or MG94 wrap codon models:
+class BiblioHKY85 :
+  public AbstractBiblioSubstitutionModel
+{
+  private:
+    unique_ptr<CountingHKY85> pmodel_;
+
+  public:
+    BiblioHKY85() :
+      AbstractBiblioSubstitutionModel("Biblio."),
+      pmodel_(new CountingHKY85())
+    {
+      pmodel_->setNamespace("Biblio.");
+      addParameters_(pmodel_->getParameters());
+      lParPmodel_.addParameters(pmodel_->getParameters());
+      for (size_t i = 0; i < lParPmodel_.size(); ++i)
+        mapParNamesFromPmodel_[lParPmodel_[i].getName()] = getParameterNameWithoutNamespace(lParPmodel_[i].getName());
+      updateMatrices();
+    }
+
+    BiblioHKY85(const BiblioHKY85& model) :
+      AbstractBiblioSubstitutionModel(model),
+      pmodel_(new CountingHKY85(*model.pmodel_))
+    {}
+
+    BiblioHKY85* clone() const { return new BiblioHKY85(*this); }
+
+    string getName() const { return "BiblioHKY85"; }
+
+    const SubstitutionModel& getSubstitutionModel() const { return *pmodel_; }
+
+    unsigned int getNumberOfUpdates() const { return pmodel_->nbUpdates; }
+
+  protected:
+    SubstitutionModel& getSubstitutionModel() { return *pmodel_; }
+};
+
+bool testBiblioBatchUpdate() {
+  //A batch on a bibliographic model must compute the matrices of the wrapped model only once:
+  BiblioHKY85 model;
+  ParameterList pl = model.getParameters();
+  for (size_t i = 0; i < pl.size(); ++i)
+    pl[i].setValue(0.8 * pl[i].getValue() + 0.05);
+  unsigned int nbUpdates = model.getNumberOfUpdates();
+  {
+    SubstitutionModelBatchUpdate batch(&model);
+    for (size_t i = 0; i < pl.size(); ++i) {
+      ParameterList pli;
+      pli.addParameter(pl[i]);
+      model.matchParametersValues(pli);
+    }
+    if (model.getNumberOfUpdates() != nbUpdates) {
+      cerr << "ERROR in batch update of model " << model.getName() << ": " << model.getNumberOfUpdates() - nbUpdates << " updates before commit." << endl;
+      return false;
+    }
+    batch.commit();
+  }
+  if (model.getNumberOfUpdates() != nbUpdates + 1) {
+    cerr << "ERROR in batch update of model " << model.getName() << ": " << model.getNumberOfUpdates() - nbUpdates << " updates instead of 1." << endl;
+    return false;
+  }
+  return true;
+}
+
+bool samePij(const SubstitutionModel& m1, const SubstitutionModel& m2, double t) {
+  const Matrix<double>& p1 = m1.getPij_t(t);
+  const Matrix<double>& p2 = m2.getPij_t(t);
+  for (size_t i = 0; i < m1.getNumberOfStates(); ++i) {
+    for (size_t j = 0; j < m1.getNumberOfStates(); ++j) {
+      if (abs(p1(i, j) - p2(i, j)) > 0.0000001) {
+        cerr << "ERROR in transition probabilities of model " << m1.getName() << " at " << i << "," << j << ": " << p1(i, j) << "<>" << p2(i, j) << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool testLazyUpdate(const AbstractSubstitutionModel& model) {
+  //A lazy model is only updated when queried, with the same result as an eager one:
+  AbstractSubstitutionModel* eager = model.clone();
+  AbstractSubstitutionModel* lazy = model.clone();
+  lazy->enableLazyUpdates(true);
+  ParameterList pl = model.getParameters();
+  for (size_t i = 0; i < pl.size(); ++i)
+    pl[i].setValue(0.7 * pl[i].getValue() + 0.1);
+  eager->matchParametersValues(pl);
+  lazy->matchParametersValues(pl);
+  bool ok = lazy->hasPendingUpdate() && !eager->hasPendingUpdate();
+  if (!ok)
+    cerr << "ERROR in lazy update of model " << model.getName() << ": update not deferred." << endl;
+  ok = ok && samePij(*eager, *lazy, 0.4) && !lazy->hasPendingUpdate();
+  delete eager;
+  delete lazy;
+  return ok;
+}
+
+bool testMixtureUpdate(const MixtureOfASubstitutionModel& mixture) {
+  //Submodels computed on several threads must match the serial computation,
+  //and be left without pending update so that they can be read concurrently:
+  MixtureOfASubstitutionModel* serial = mixture.clone();
+  MixtureOfASubstitutionModel* parallel = mixture.clone();
+  serial->setNumberOfThreads(1);
+  parallel->setNumberOfThreads(4);
+  ParameterList pl = mixture.getParameters();
+  for (size_t i = 0; i < pl.size(); ++i)
+    pl[i].setValue(0.9 * pl[i].getValue() + 0.05);
+  serial->matchParametersValues(pl);
+  parallel->matchParametersValues(pl);
+
+  bool ok = samePij(*serial, *parallel, 0.3);
+  size_t n = parallel->getNumberOfModels();
+  for (size_t k = 0; ok && k < n; ++k) {
+    const AbstractSubstitutionModel* pm = dynamic_cast<const AbstractSubstitutionModel*>(parallel->getNModel(k));
+    if (!pm || pm->hasPendingUpdate()) {
+      cerr << "ERROR in mixture update: submodel " << k << " left with a pending update." << endl;
+      ok = false;
+    }
+  }
+  if (ok) {
+    size_t nbStates = mixture.getNumberOfStates();
+    vector<VVdouble> pijs(n, VVdouble(nbStates, Vdouble(nbStates)));
+    const MixtureOfASubstitutionModel* shared = parallel;
+    ParallelTools::forEachBlock(n, 4,
+      [&pijs, shared, nbStates](size_t begin, size_t end, unsigned int) {
+        for (size_t k = begin; k < end; ++k) {
+          const Matrix<double>& p = shared->getNModel(k)->getPij_t(0.3);
+          for (size_t i = 0; i < nbStates; ++i)
+            for (size_t j = 0; j < nbStates; ++j)
+              pijs[k][i][j] = p(i, j);
+        }
+      });
+    for (size_t k = 0; ok && k < n; ++k) {
+      const Matrix<double>& p = serial->getNModel(k)->getPij_t(0.3);
+      for (size_t i = 0; ok && i < nbStates; ++i) {
+        for (size_t j = 0; ok && j < nbStates; ++j) {
+          if (abs(pijs[k][i][j] - p(i, j)) > 0.0000001) {
+            cerr << "ERROR in concurrent transition probabilities of submodel " << k << ": " << pijs[k][i][j] << "<>" << p(i, j) << endl;
+            ok = false;
+          }
+        }
+      }
+    }
+  }
+  delete serial;
+  delete parallel;
+  return ok;
+}
+
+bool testFrequenciesUpdate(const SubstitutionModel& model, const string& otherParameter) {
+  //Changing only the frequencies must give the same matrices as a full update:
+  SubstitutionModel* incremental = model.clone();
+  SubstitutionModel* full = model.clone();
+  double other = full->getParameterValue(otherParameter);
+  full->setParameterValue(otherParameter, other * 1.5);
+  ParameterList fpl = model.getParameters();
+  ParameterList pl;
+  for (size_t i = 0; i < fpl.size(); ++i)
+    if (fpl[i].getName().find("theta") != string::npos) {
+      fpl[i].setValue(0.25 + 0.05 * static_cast<double>(i % 7));
+      pl.addParameter(fpl[i]);
+    }
+  incremental->matchParametersValues(pl);
+  pl.addParameter(full->getParameter(otherParameter));
+  pl.setParameterValue(full->getParameter(otherParameter).getName(), other);
+  full->matchParametersValues(pl);
+  bool ok = samePij(*full, *incremental, 0.2);
+  const Matrix<double>& g1 = full->getGenerator();
+  const Matrix<double>& g2 = incremental->getGenerator();
+  for (size_t i = 0; ok && i < model.getNumberOfStates(); ++i) {
+    for (size_t j = 0; ok && j < model.getNumberOfStates(); ++j) {
+      if (abs(g1(i, j) - g2(i, j)) > 0.0000001) {
+        cerr << "ERROR in frequency update of model " << model.getName() << " at " << i << "," << j << ": " << g1(i, j) << "<>" << g2(i, j) << endl;
+        ok = false;
+      }
+    }
+  }
+  delete incremental;
+  delete full;
+  return ok;
+}
+
 int main() {
   //Nucleotide models:
   GTR gtr(&AlphabetTools::DNA_ALPHABET);
   if (!testModel(gtr)) return 1;
+  if (!testFillPij_t(gtr)) return 1;
+  if (!testStationarity(gtr)) return 1;
+
+  //Models with closed-form transition probabilities:
+  JCnuc jc(&AlphabetTools::DNA_ALPHABET);
+  K80 k80(&AlphabetTools::DNA_ALPHABET, 3.);
+  T92 t92(&AlphabetTools::DNA_ALPHABET, 3., 0.6);
+  F84 f84(&AlphabetTools::DNA_ALPHABET, 2., 0.1, 0.2, 0.3, 0.4);
+  HKY85 hky(&AlphabetTools::DNA_ALPHABET, 2., 0.1, 0.2, 0.3, 0.4);
+  TN93 tn93(&AlphabetTools::DNA_ALPHABET, 2., 4., 0.1, 0.2, 0.3, 0.4);
+  if (!jc.hasClosedFormPij_t() || gtr.hasClosedFormPij_t()) return 1;
+  if (!testFillPij_t(jc)) return 1;
+  if (!testFillPij_t(k80)) return 1;
+  if (!testFillPij_t(t92)) return 1;
+  if (!testFillPij_t(f84)) return 1;
+  if (!testFillPij_t(hky)) return 1;
+  if (!testFillPij_t(tn93)) return 1;
+  //Wrapped models keep the closed formulas of the model they wrap:
+  BiblioHKY85 biblioHky;
+  if (!biblioHky.hasClosedFormPij_t() || !testFillPij_t(biblioHky)) return 1;
 
   //Codon models:
   StandardGeneticCode gc(&AlphabetTools::DNA_ALPHABET);
@@ -121,6 +477,55 @@ int main() {
   FrequenciesSet* fset = CodonFrequenciesSet::getFrequenciesSetForCodons(CodonFrequenciesSet::F3X4, &gc);
   YN98 yn98(&gc, fset);
   if (!testModel(yn98)) return 1;
+  if (!testStationarity(yn98)) return 1;
+  //Change the frequencies only:
+  ParameterList fpl = yn98.getParameters();
+  for (size_t i = 0; i < fpl.size(); ++i)
+    if (fpl[i].getName().find("theta") != string::npos)
+      fpl[i].setValue(0.3 + 0.04 * static_cast<double>(i % 5));
+  yn98.matchParametersValues(fpl);
+  if (!testStationarity(yn98)) return 1;
+  if (!testFrequenciesUpdate(yn98, "omega")) return 1;
+
+  //Codon generators, assembled from the codon pair tables:
+  yn98.setParameterValue("kappa", 2.5);
+  yn98.setParameterValue("omega", 0.3);
+  if (!testCodonGenerator(dynamic_cast<const AbstractCodonSubstitutionModel&>(yn98.getSubstitutionModel()))) return 1;
+  MG94 mg94(&gc, CodonFrequenciesSet::getFrequenciesSetForCodons(CodonFrequenciesSet::F3X4, &gc));
+  mg94.setParameterValue("rho", 0.4);
+  if (!testCodonGenerator(dynamic_cast<const AbstractCodonSubstitutionModel&>(mg94.getSubstitutionModel()))) return 1;
+  GranthamAAChemicalDistance grantham;
+  CodonDistanceCpGSubstitutionModel cpg(&gc, new K80(&AlphabetTools::DNA_ALPHABET, 2.), &grantham);
+  cpg.setParameterValue("rho", 3.);
+  cpg.setParameterValue("alpha", 200.);
+  cpg.setParameterValue("beta", 0.5);
+  if (!testCodonGenerator(cpg)) return 1;
+
+  //Batched parameter changes:
+  RE08 re08(new GTR(&AlphabetTools::DNA_ALPHABET), 0.1, 0.2);
+  if (!testBatchUpdate(gtr)) return 1;
+  if (!testBatchUpdate(hky)) return 1;
+  if (!testBatchUpdate(re08)) return 1;
+  if (!testBatchUpdate(yn98)) return 1;
+  if (!testBatchUpdate(cpg)) return 1;
+  if (!testBiblioBatchUpdate()) return 1;
+  {
+    SubstitutionModelBatchUpdate batch(&yn98);
+    yn98.setParameterValue("kappa", 2.);
+    yn98.setParameterValue("omega", 0.5);
+    if (!dynamic_cast<const AbstractSubstitutionModel&>(yn98.getSubstitutionModel()).hasPendingUpdate()) return 1;
+  }
+
+  //Lazy updates, and submodels of a mixture:
+  if (!testLazyUpdate(gtr)) return 1;
+  if (!testLazyUpdate(cpg)) return 1;
+  GammaDiscreteDistribution gammaA(3, 1.);
+  GammaDiscreteDistribution gammaB(3, 2.);
+  map<string, DiscreteDistribution*> distributions;
+  distributions["a"] = &gammaA;
+  distributions["b"] = &gammaB;
+  MixtureOfASubstitutionModel mixture(&AlphabetTools::DNA_ALPHABET, &gtr, distributions);
+  if (!testMixtureUpdate(mixture)) return 1;
 
   delete codonAlphabet;
 
@@ -38,15 +38,88 @@ knowledge of the CeCILL license and that you accept its terms.
 */
 
 #include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/Alphabet/CodonAlphabet.h>
+#include <Bpp/Seq/AlphabetIndex/AlphabetIndex2.h>
+#include <Bpp/Seq/Container/VectorSiteContainer.h>
 #include <Bpp/Seq/Io/Phylip.h>
 #include <Bpp/Phyl/Tree.h>
 #include <Bpp/Phyl/Io/Newick.h>
 #include <Bpp/Phyl/Parsimony/DRTreeParsimonyScore.h>
+#include <Bpp/Phyl/Parsimony/DRTreeSankoffParsimonyScore.h>
+#include <Bpp/Phyl/Parsimony/ParsimonyStepwiseAddition.h>
+#include <Bpp/Phyl/OptimizationTools.h>
+#include <Bpp/Phyl/TreeTemplate.h>
+#include <Bpp/Phyl/TreeTemplateTools.h>
+#include <Bpp/Numeric/VectorTools.h>
+#include <Bpp/Numeric/Matrix/Matrix.h>
 #include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
 
 using namespace bpp;
 using namespace std;
 
+//Naive Fitch parsimony for one site, states being coded as bit sets:
+unsigned int fitch(const Node* node, const map<string, unsigned int>& states, unsigned int& score) {
+  if (node->isLeaf())
+    return states.find(node->getName())->second;
+  unsigned int stateSet = fitch(node->getSon(0), states, score);
+  for (size_t i = 1; i < node->getNumberOfSons(); ++i) {
+    unsigned int sonSet = fitch(node->getSon(i), states, score);
+    if (stateSet & sonSet)
+      stateSet &= sonSet;
+    else {
+      stateSet |= sonSet;
+      score++;
+    }
+  }
+  return stateSet;
+}
+
+//Brute-force Sankoff parsimony for one site, trying all states at inner nodes:
+double sankoff(const vector<Node*>& innerNodes, size_t k, map<const Node*, size_t>& states, const Matrix<double>& costs) {
+  if (k == innerNodes.size()) {
+    double cost = 0;
+    for (map<const Node*, size_t>::const_iterator it = states.begin(); it != states.end(); ++it)
+      if (it->first->hasFather())
+        cost += costs(states[it->first->getFather()], it->second);
+    return cost;
+  }
+  double best = numeric_limits<double>::infinity();
+  for (size_t s = 0; s < costs.getNumberOfRows(); ++s) {
+    states[innerNodes[k]] = s;
+    best = min(best, sankoff(innerNodes, k + 1, states, costs));
+  }
+  return best;
+}
+
+//Transitions cost 1, transversions cost 2:
+class TsTvIndex :
+  public virtual AlphabetIndex2
+{
+  public:
+    TsTvIndex* clone() const { return new TsTvIndex(); }
+    double getIndex(int state1, int state2) const {
+      if (state1 == state2) return 0.;
+      return (state1 % 2 == state2 % 2 ? 1. : 2.);
+    }
+    double getIndex(const string& state1, const string& state2) const {
+      return getIndex(getAlphabet()->charToInt(state1), getAlphabet()->charToInt(state2));
+    }
+    const Alphabet* getAlphabet() const { return &AlphabetTools::DNA_ALPHABET; }
+    Matrix<double>* getIndexMatrix() const {
+      RowMatrix<double>* m = new RowMatrix<double>(4, 4);
+      for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+          (*m)(static_cast<size_t>(i), static_cast<size_t>(j)) = getIndex(i, j);
+      return m;
+    }
+};
+
 int main() {
   try {
     Newick treeReader;
@@ -59,6 +132,185 @@ int main() {
     cout << "Parsimony score: " << pars.getScore() << endl;
 
     if (pars.getScore() != 9) return 1;
+
+    //Site scores are computed separately and must sum up to the total score:
+    if (VectorTools::sum(pars.getScoreForEachSite()) != pars.getScore()) return 1;
+
+    //Score differences for NNIs must match the score of the rearranged tree:
+    vector<int> ids = pars.getTree().getInnerNodesId();
+    for (size_t i = 0; i < ids.size(); ++i) {
+      const Node* node = dynamic_cast<const TreeTemplate<Node>&>(pars.getTree()).getNode(ids[i]);
+      if (!node->hasFather() || !node->getFather()->hasFather()) continue;
+      double delta = pars.testNNI(ids[i]);
+      DRTreeParsimonyScore pars2(pars);
+      pars2.doNNI(ids[i]);
+      pars2.topologyChangeTested(TopologyChangeEvent());
+      cout << "NNI on node " << ids[i] << ": " << pars2.getScore() << endl;
+      if (abs(static_cast<double>(pars2.getScore()) - static_cast<double>(pars.getScore()) - delta) > 1e-12) return 1;
+    }
+
+    //Rearrangements are scored from cached arrays, and must match the score of the rearranged tree:
+    vector<int> allIds = pars.getTree().getNodesId();
+    for (size_t i = 0; i < allIds.size(); ++i) {
+      if (allIds[i] == pars.getTree().getRootId()) continue;
+      DRTreeParsimonyScore::Rearrangement move = pars.testRearrangements(allIds[i], 3, true);
+      if (!move.isValid()) continue;
+      DRTreeParsimonyScore pars2(pars);
+      pars2.doRearrangement(move);
+      cout << "TBR of node " << allIds[i] << ": " << pars2.getScore() << endl;
+      if (abs(static_cast<double>(pars2.getScore()) - static_cast<double>(pars.getScore()) - move.scoreDifference) > 1e-12) return 1;
+    }
+    DRTreeParsimonyScore pars3(pars);
+    OptimizationTools::optimizeTreeSPR(&pars3, 3, true, 0);
+    if (pars3.getScore() > pars.getScore()) return 1;
+
+    //Sankoff parsimony with unit costs is equivalent to Fitch parsimony:
+    size_t nbStates = pars.getStateMap().getNumberOfModelStates();
+    RowMatrix<double> costs(nbStates, nbStates);
+    for (size_t i = 0; i < nbStates; ++i)
+      for (size_t j = 0; j < nbStates; ++j)
+        costs(i, j) = (i == j ? 0. : 1.);
+    DRTreeSankoffParsimonyScore sankoff(*tree, *sites, costs, false, true);
+    cout << "Sankoff parsimony score: " << sankoff.getScore() << endl;
+    if (abs(sankoff.getScore() - pars.getScore()) > 1e-12) return 1;
+    if (abs(VectorTools::sum(sankoff.getScoreForEachSite()) - sankoff.getScore()) > 1e-12) return 1;
+
+    //Sankoff NNIs and SPRs must match the score of the rearranged tree:
+    for (size_t i = 0; i < allIds.size(); ++i) {
+      if (allIds[i] == sankoff.getTree().getRootId()) continue;
+      const Node* node = dynamic_cast<const TreeTemplate<Node>&>(sankoff.getTree()).getNode(allIds[i]);
+      if (node->getFather()->hasFather()) {
+        double delta = sankoff.testNNI(allIds[i]);
+        DRTreeSankoffParsimonyScore sankoff2(sankoff);
+        sankoff2.doNNI(allIds[i]);
+        sankoff2.topologyChangeTested(TopologyChangeEvent());
+        if (abs(sankoff2.getScore() - sankoff.getScore() - delta) > 1e-12) return 1;
+      }
+      DRTreeSankoffParsimonyScore::Rearrangement move = sankoff.testRearrangements(allIds[i], 3);
+      if (!move.isValid()) continue;
+      DRTreeSankoffParsimonyScore sankoff2(sankoff);
+      sankoff2.doRearrangement(move);
+      cout << "Sankoff SPR of node " << allIds[i] << ": " << sankoff2.getScore() << endl;
+      if (abs(sankoff2.getScore() - sankoff.getScore() - move.scoreDifference) > 1e-12) return 1;
+    }
+
+    //Leaves inserted one at a time must give the same scores as the full tree:
+    vector<string> seqNames = sites->getSequencesNames();
+    Node* start = new Node(0);
+    for (int i = 0; i < 3; ++i)
+      start->addSon(new Node(i + 1, seqNames[static_cast<size_t>(i)]));
+    TreeTemplate<Node> startTree(start);
+    DRTreeParsimonyScore insertion(startTree, *sites, false, true);
+    for (size_t i = 3; i < seqNames.size(); ++i)
+      insertion.doLeafInsertion(seqNames[i], static_cast<int>(i % 3) + 1);
+    DRTreeParsimonyScore inserted(insertion.getTree(), *sites, false, true);
+    if (insertion.getScore() != inserted.getScore()) return 1;
+    if (insertion.getScoreForEachSite() != inserted.getScoreForEachSite()) return 1;
+
+    //Stepwise addition trees only depend on the seed and the index of the tree:
+    ParsimonyStepwiseAddition builder(*sites, true, 42);
+    vector<unsigned int> scores1, scores2;
+    vector<TreeTemplate<Node>*> trees1 = builder.buildTrees(4, 1, &scores1);
+    vector<TreeTemplate<Node>*> trees2 = builder.buildTrees(4, 2, &scores2);
+    bool sameTrees = (scores1 == scores2);
+    for (size_t i = 0; i < trees1.size(); ++i) {
+      string newick = TreeTemplateTools::treeToParenthesis(*trees1[i]);
+      cout << "Stepwise addition tree " << i << ": " << scores1[i] << " " << newick << endl;
+      if (newick != TreeTemplateTools::treeToParenthesis(*trees2[i])) sameTrees = false;
+      if (trees1[i]->getNumberOfLeaves() != sites->getNumberOfSequences()) sameTrees = false;
+      DRTreeParsimonyScore pars4(*trees1[i], *sites, false, true);
+      if (pars4.getScore() != scores1[i]) sameTrees = false;
+      delete trees1[i];
+      delete trees2[i];
+    }
+    if (!sameTrees) return 1;
+
+    //Randomized alignment with many repeated patterns, spanning several blocks of
+    //sites and weight bit-planes, checked against a naive Fitch algorithm:
+    unique_ptr< TreeTemplate<Node> > randomTree(TreeTemplateTools::parenthesisToTree(
+      "((A:0.1,B:0.1):0.1,(C:0.1,(D:0.1,E:0.1):0.1):0.1,((F:0.1,G:0.1):0.1,H:0.1):0.1);"));
+    vector<string> names = randomTree->getLeavesNames();
+    mt19937 generator(42);
+    uniform_int_distribution<int> randomState(0, 3);
+    string nucleotides = "ACGT";
+    vector<string> patterns;
+    set<string> distinctPatterns;
+    while (patterns.size() < 320) {
+      string pattern;
+      for (size_t k = 0; k < names.size(); ++k)
+        pattern += nucleotides[static_cast<size_t>(randomState(generator))];
+      if (distinctPatterns.insert(pattern).second)
+        patterns.push_back(pattern);
+    }
+    vector<size_t> columns;
+    for (size_t p = 0; p < patterns.size(); ++p)
+      columns.insert(columns.end(), p % 7 + 1, p);
+    shuffle(columns.begin(), columns.end(), generator);
+    VectorSiteContainer randomSites(&AlphabetTools::DNA_ALPHABET);
+    for (size_t k = 0; k < names.size(); ++k) {
+      string seq;
+      for (size_t i = 0; i < columns.size(); ++i)
+        seq += patterns[columns[i]][k];
+      randomSites.addSequence(BasicSequence(names[k], seq, &AlphabetTools::DNA_ALPHABET));
+    }
+    cout << "Randomized alignment: " << columns.size() << " sites, " << patterns.size() << " patterns." << endl;
+    DRTreeParsimonyScore randomPars(*randomTree, randomSites, false, false);
+    unsigned int naiveScore = 0;
+    vector<unsigned int> siteScores = randomPars.getScoreForEachSite();
+    if (siteScores.size() != columns.size()) return 1;
+    for (size_t i = 0; i < columns.size(); ++i) {
+      map<string, unsigned int> states;
+      for (size_t k = 0; k < names.size(); ++k)
+        states[names[k]] = 1u << nucleotides.find(patterns[columns[i]][k]);
+      unsigned int siteScore = 0;
+      fitch(randomTree->getRootNode(), states, siteScore);
+      if (siteScores[i] != siteScore || randomPars.getScoreForSite(i) != siteScore) return 1;
+      naiveScore += siteScore;
+    }
+    cout << "Randomized parsimony score: " << randomPars.getScore() << endl;
+    if (randomPars.getScore() != naiveScore) return 1;
+
+    //Sankoff parsimony with non-uniform costs, from a matrix or an index, checked against brute force:
+    TsTvIndex tsTv;
+    unique_ptr< Matrix<double> > tsTvCosts(tsTv.getIndexMatrix());
+    VectorSiteContainer tsTvSites(&AlphabetTools::DNA_ALPHABET);
+    for (size_t k = 0; k < names.size(); ++k) {
+      string seq;
+      for (size_t p = 0; p < 40; ++p)
+        seq += patterns[p][k];
+      tsTvSites.addSequence(BasicSequence(names[k], seq, &AlphabetTools::DNA_ALPHABET));
+    }
+    DRTreeSankoffParsimonyScore tsTvSankoff(*randomTree, tsTvSites, *tsTvCosts, false, false);
+    DRTreeSankoffParsimonyScore indexSankoff(*randomTree, tsTvSites, tsTv, false);
+    vector<Node*> innerNodes = randomTree->getInnerNodes();
+    double bruteForceScore = 0;
+    for (size_t i = 0; i < 40; ++i) {
+      map<const Node*, size_t> states;
+      for (size_t k = 0; k < names.size(); ++k)
+        states[randomTree->getNode(names[k])] = nucleotides.find(patterns[i][k]);
+      double siteScore = sankoff(innerNodes, 0, states, *tsTvCosts);
+      if (abs(tsTvSankoff.getScoreForSite(i) - siteScore) > 1e-12) return 1;
+      if (abs(indexSankoff.getScoreForSite(i) - siteScore) > 1e-12) return 1;
+      bruteForceScore += siteScore;
+    }
+    cout << "Ts/Tv Sankoff parsimony score: " << tsTvSankoff.getScore() << endl;
+    if (abs(tsTvSankoff.getScore() - bruteForceScore) > 1e-12) return 1;
+    if (abs(indexSankoff.getScore() - bruteForceScore) > 1e-12) return 1;
+
+    //Codon alignments are scored directly, with or without gaps as a state:
+    CodonAlphabet codonAlphabet(&AlphabetTools::DNA_ALPHABET);
+    VectorSiteContainer codons(&codonAlphabet);
+    codons.addSequence(BasicSequence("A", "AAAAAAAAA", &codonAlphabet));
+    codons.addSequence(BasicSequence("B", "AAAAAACCC", &codonAlphabet));
+    codons.addSequence(BasicSequence("C", "AAACCCGGG", &codonAlphabet));
+    codons.addSequence(BasicSequence("D", "AAACCCTTT", &codonAlphabet));
+    unique_ptr< TreeTemplate<Node> > codonTree(TreeTemplateTools::parenthesisToTree("((A:0.01, B:0.02):0.03,C:0.01,D:0.1);"));
+    DRTreeParsimonyScore codonPars(*codonTree, codons, false, false);
+    cout << "Codon parsimony score: " << codonPars.getScore() << endl;
+    if (codonPars.getStateMap().getNumberOfModelStates() != 64 || codonPars.getScore() != 4) return 1;
+    if (codonPars.getScoreForSite(2) != 3) return 1;
+    DRTreeParsimonyScore codonGapPars(*codonTree, codons, false, true);
+    if (codonGapPars.getScore() != 4) return 1;
     
   } catch (Exception& ex) {
     cerr << ex.what() << endl;
@@ -46,14 +46,64 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <Bpp/Phyl/Model/RateDistribution/GammaDiscreteRateDistribution.h>
 #include <Bpp/Phyl/Model/SubstitutionModelSetTools.h>
 #include <Bpp/Phyl/Simulation/HomogeneousSequenceSimulator.h>
+#include <Bpp/Phyl/Simulation/AliasTable.h>
+#include <Bpp/Phyl/Simulation/BinaryStateMatrixIO.h>
+#include <Bpp/Phyl/Simulation/SimulationSink.h>
+#include <Bpp/Phyl/Simulation/ParametricBootstrap.h>
 #include <Bpp/Phyl/Likelihood/RNonHomogeneousTreeLikelihood.h>
+#include <Bpp/Phyl/Likelihood/DRNonHomogeneousTreeLikelihood.h>
+#include <Bpp/Phyl/Likelihood/DRHomogeneousTreeLikelihood.h>
 #include <Bpp/Phyl/OptimizationTools.h>
 #include <iostream>
+#include <sstream>
 
 using namespace bpp;
 using namespace std;
 
+//Fasta output expected for a given alignment:
+string toFasta(const SiteContainer& sites, size_t charsByLine) {
+  string text;
+  for (size_t i = 0; i < sites.getNumberOfSequences(); ++i) {
+    string seq = sites.getSequence(i).toString();
+    text += ">" + sites.getSequence(i).getName() + "\n";
+    for (size_t j = 0; j < seq.size(); j += charsByLine)
+      text += seq.substr(j, charsByLine) + "\n";
+  }
+  return text;
+}
+
+//Interleaved Phylip output expected for a given alignment:
+string toPhylip(const SiteContainer& sites, size_t charsByLine) {
+  size_t width = 0;
+  for (size_t i = 0; i < sites.getNumberOfSequences(); ++i)
+    width = max(width, sites.getSequence(i).getName().size());
+  string text = TextTools::toString(sites.getNumberOfSequences()) + " " + TextTools::toString(sites.getNumberOfSites()) + "\n";
+  for (size_t j = 0; j < sites.getNumberOfSites(); j += charsByLine) {
+    if (j > 0)
+      text += "\n";
+    for (size_t i = 0; i < sites.getNumberOfSequences(); ++i) {
+      if (j == 0)
+        text += TextTools::resizeRight(sites.getSequence(i).getName(), width) + "  ";
+      text += sites.getSequence(i).toString().substr(j, charsByLine) + "\n";
+    }
+  }
+  return text;
+}
+
 int main() {
+  //Alias tables must encode the normalized weights:
+  vector<double> weights(5);
+  weights[0] = 0.2; weights[1] = 0.; weights[2] = 1.1; weights[3] = 0.05; weights[4] = 0.65;
+  AliasTable table(weights);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    if (abs(table.getProbability(i) - weights[i] / 2.) > 1e-12)
+      return 1;
+  }
+  for (unsigned int i = 0; i < 1000; ++i) {
+    if (table.draw() == 1)
+      return 1;
+  }
+
   TreeTemplate<Node>* tree = TreeTemplateTools::parenthesisToTree("((A:0.01, B:0.02):0.03,C:0.01,D:0.1);");
   vector<string> seqNames= tree->getLeavesNames();
   vector<int> ids = tree->getNodesId();
@@ -77,6 +127,142 @@ int main() {
   }
   NonHomogeneousSequenceSimulator simulator(modelSet, rdist, tree);
 
+  //Reproducible simulations must not depend on the number of threads:
+  unique_ptr<SiteContainer> sim1(simulator.simulate(2500, 42, 1, 100));
+  unique_ptr<SiteContainer> sim4(simulator.simulate(2500, 42, 4, 100));
+  if (sim1->getNumberOfSites() != 2500 || sim4->getNumberOfSequences() != seqNames.size())
+    return 1;
+  for (size_t i = 0; i < sim1->getNumberOfSequences(); ++i) {
+    if (sim1->getSequence(i).getContent() != sim4->getSequence(i).getContent())
+      return 1;
+  }
+
+  //Streaming simulations must give the same sites:
+  stringstream binary;
+  BinaryStateMatrixWriter writer(binary);
+  simulator.simulate(2500, writer, 42, 3, 100);
+  BinaryStateMatrixReader reader(binary);
+  unique_ptr<SiteContainer> sim3(reader.read(alphabet));
+  if (sim3->getSequencesNames() != sim1->getSequencesNames())
+    return 1;
+  for (size_t i = 0; i < sim1->getNumberOfSequences(); ++i) {
+    if (sim1->getSequence(i).getContent() != sim3->getSequence(i).getContent())
+      return 1;
+  }
+
+  //Fasta sinks write each block at its place, after what the stream already contains:
+  stringstream fasta;
+  fasta << "; simulated\n";
+  FastaSimulationSink fastaSink(fasta, 70);
+  simulator.simulate(2500, fastaSink, 42, 3, 100);
+  if (fasta.str() != "; simulated\n" + toFasta(*sim1, 70))
+    return 1;
+  //Blocks of any size, across line ends:
+  stringstream fasta2;
+  FastaSimulationSink fastaSink2(fasta2, 64);
+  fastaSink2.init(sim1->getSequencesNames(), alphabet, 2500);
+  for (size_t first = 0, size = 1; first < 2500; first += size, ++size) {
+    size = min(size, 2500 - first);
+    vector< vector<int> > block(sim1->getNumberOfSequences());
+    for (size_t i = 0; i < block.size(); ++i) {
+      const vector<int>& content = sim1->getSequence(i).getContent();
+      block[i].assign(content.begin() + static_cast<ptrdiff_t>(first), content.begin() + static_cast<ptrdiff_t>(first + size));
+    }
+    fastaSink2.writeBlock(block);
+  }
+  fastaSink2.finish();
+  if (fasta2.str() != toFasta(*sim1, 64))
+    return 1;
+
+  //Phylip sinks buffer sites up to full lines:
+  stringstream phylip;
+  PhylipSimulationSink phylipSink(phylip, 60);
+  simulator.simulate(2500, phylipSink, 42, 2, 100);
+  if (phylip.str() != toPhylip(*sim1, 60))
+    return 1;
+
+  //Ancestral sequences may be sent to their own sink:
+  simulator.outputInternalSequences(true);
+  unique_ptr<SiteContainer> simAll(simulator.simulate(2500, 42, 1, 100));
+  stringstream leafBinary, ancestralBinary;
+  BinaryStateMatrixWriter leafWriter(leafBinary), ancestralWriter(ancestralBinary);
+  simulator.simulate(2500, leafWriter, 42, 3, 100, &ancestralWriter);
+  simulator.outputInternalSequences(false);
+  BinaryStateMatrixReader leafReader(leafBinary), ancestralReader(ancestralBinary);
+  unique_ptr<SiteContainer> simLeaves(leafReader.read(alphabet));
+  unique_ptr<SiteContainer> simAncestors(ancestralReader.read(alphabet));
+  if (simLeaves->getSequencesNames() != sim1->getSequencesNames())
+    return 1;
+  if (simLeaves->getNumberOfSequences() + simAncestors->getNumberOfSequences() != simAll->getNumberOfSequences())
+    return 1;
+  for (size_t i = 0; i < simLeaves->getNumberOfSequences(); ++i) {
+    if (simLeaves->getSequence(i).getContent() != simAll->getSequence(simLeaves->getSequence(i).getName()).getContent())
+      return 1;
+  }
+  for (size_t i = 0; i < simAncestors->getNumberOfSequences(); ++i) {
+    if (tree->getNode(TextTools::toInt(simAncestors->getSequence(i).getName()))->isLeaf())
+      return 1;
+    if (simAncestors->getSequence(i).getContent() != simAll->getSequence(simAncestors->getSequence(i).getName()).getContent())
+      return 1;
+  }
+
+  //Parametric bootstrap must not depend on the number of threads either:
+  SubstitutionModelSet* modelSetPb = modelSet->clone();
+  DRNonHomogeneousTreeLikelihood tlPb(*tree, *sim1, modelSetPb, rdist, false);
+  tlPb.initialize();
+  ParametricBootstrap pb1(simulator, tlPb, 1000, 7);
+  pb1.setOptimizationOptions(0.0001, 10000, OptimizationTools::OPTIMIZATION_NEWTON);
+  pb1.run(4, 1);
+  ParametricBootstrap pb2(simulator, tlPb, 1000, 7);
+  pb2.setOptimizationOptions(0.0001, 10000, OptimizationTools::OPTIMIZATION_NEWTON);
+  pb2.run(4, 2);
+  if (pb1.getNumberOfReplicates() != 4 || pb1.getLogLikelihoods() != pb2.getLogLikelihoods())
+    return 1;
+  for (size_t r = 0; r < 4; ++r) {
+    if (pb1.getLogLikelihoods()[r] < pb1.getInitialLogLikelihoods()[r] - 1e-6)
+      return 1;
+  }
+  //The original likelihood function must be left untouched:
+  if (abs(tlPb.getParameterValue("T92.theta_1") - thetas[0]) > 1e-12)
+    return 1;
+  delete modelSetPb;
+
+  //Patterns given directly to a likelihood function must be equivalent to the sites:
+  T92 modelH(alphabet, 3., 0.4);
+  DRHomogeneousTreeLikelihood tlH(*tree, *sim1, &modelH, rdist, false, false);
+  tlH.initialize();
+  DRHomogeneousTreeLikelihood tlHPatterns(*tree, &modelH, rdist, false, false);
+  SitePatterns patterns(sim1.get());
+  tlHPatterns.setSitePatterns(patterns);
+  tlHPatterns.initialize();
+  if (tlHPatterns.getNumberOfSites() != 2500)
+    return 1;
+  //Only distinct sites are stored, all sites are built on request, also in copies:
+  unique_ptr<DRHomogeneousTreeLikelihood> tlHPatternsCopy(tlHPatterns.clone());
+  if (tlHPatternsCopy->getNumberOfSites() != 2500 || tlHPatternsCopy->getData()->getNumberOfSites() != 2500)
+    return 1;
+  if (tlHPatterns.getData()->getNumberOfSites() != 2500)
+    return 1;
+  if (abs(tlHPatterns.getLogLikelihood() - tlH.getLogLikelihood()) > 1e-8)
+    return 1;
+  for (size_t i = 0; i < 2500; ++i) {
+    if (tlHPatterns.getData()->getSite(i).getContent() != tlH.getData()->getSite(i).getContent())
+      return 1;
+  }
+
+  //Homogeneous likelihood functions are refitted on their own copies of the model:
+  HomogeneousSequenceSimulator simulatorH(&modelH, rdist, tree);
+  ParametricBootstrap pbH1(simulatorH, tlH, 1000, 11);
+  pbH1.setOptimizationOptions(0.0001, 10000, OptimizationTools::OPTIMIZATION_NEWTON);
+  pbH1.run(4, 1);
+  ParametricBootstrap pbH2(simulatorH, tlH, 1000, 11);
+  pbH2.setOptimizationOptions(0.0001, 10000, OptimizationTools::OPTIMIZATION_NEWTON);
+  pbH2.run(4, 3);
+  if (pbH1.getLogLikelihoods() != pbH2.getLogLikelihoods())
+    return 1;
+  if (modelH.getParameterValue("kappa") != 3. || modelH.getParameterValue("theta") != 0.4)
+    return 1;
+
   unsigned int n = 100000;
   OutputStream* profiler  = new StlOutputStream(new ofstream("profile.txt", ios::out));
   OutputStream* messenger = new StlOutputStream(new ofstream("messages.txt", ios::out));